@@ -1,7 +1,9 @@
 #include "ofmi.h"
 
+#include <algorithm>
 #include <cstring>
 
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/sharing/binary_2p.h"
@@ -101,6 +103,37 @@ void OFMIKey::Deserialize(const std::vector<uint8_t> &buffer) {
     }
 }
 
+size_t OFMIKey::CalculateLegacySerializedSize(const OFMIParameters &params) {
+    return 2 * sizeof(uint64_t) +
+           2 * params.GetQuerySize() * wm::OWMKey::CalculateLegacySerializedSize(params.GetOWMParameters()) +
+           params.GetQuerySize() * proto::ZeroTestKey::CalculateLegacySerializedSize(params.GetZeroTestParameters());
+}
+
+void OFMIKey::ConvertLegacy(const OFMIParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed) {
+    if (legacy.size() != CalculateLegacySerializedSize(params)) {
+        throw std::invalid_argument("Invalid legacy OFMIKey: size " + ToString(legacy.size()) + " != " + ToString(CalculateLegacySerializedSize(params)));
+    }
+    const size_t wm_key_size = wm::OWMKey::CalculateLegacySerializedSize(params.GetOWMParameters());
+    const size_t zt_key_size = proto::ZeroTestKey::CalculateLegacySerializedSize(params.GetZeroTestParameters());
+    auto         it          = legacy.begin();
+
+    // Number of WM and ZT keys
+    packed.insert(packed.end(), it, it + 2 * sizeof(uint64_t));
+    it += 2 * sizeof(uint64_t);
+
+    // WM keys (f, then g)
+    for (uint64_t i = 0; i < 2 * params.GetQuerySize(); ++i) {
+        wm::OWMKey::ConvertLegacy(params.GetOWMParameters(), std::vector<uint8_t>(it, it + wm_key_size), packed);
+        it += wm_key_size;
+    }
+
+    // ZT keys
+    for (uint64_t i = 0; i < params.GetQuerySize(); ++i) {
+        proto::ZeroTestKey::ConvertLegacy(params.GetZeroTestParameters(), std::vector<uint8_t>(it, it + zt_key_size), packed);
+        it += zt_key_size;
+    }
+}
+
 void OFMIKey::PrintKey(const bool detailed) const {
     Logger::DebugLog(LOC, Logger::StrWithSep("OFMI Key"));
     for (const auto &wm_key : wm_f_keys) {
@@ -124,8 +157,8 @@ OFMIKeyGenerator::OFMIKeyGenerator(
       rss_(rss) {
 }
 
-void OFMIKeyGenerator::OfflineSetUp(const std::string &file_path) {
-    wm_gen_.GetRingOaKeyGenerator().OfflineSetUp(params_.GetSigma() * params_.GetQuerySize() * 2, file_path);
+void OFMIKeyGenerator::OfflineSetUp(const std::string &file_path, const uint64_t num_lpm) {
+    wm_gen_.GetRingOaKeyGenerator().OfflineSetUp(params_.GetSigma() * params_.GetQuerySize() * 2 * num_lpm, file_path);
 }
 
 std::array<sharing::RepShareMat64, 3> OFMIKeyGenerator::GenerateDatabaseU64Share(const wm::FMIndex &fm) const {
@@ -141,44 +174,56 @@ std::array<sharing::RepShareMat64, 3> OFMIKeyGenerator::GenerateQueryU64Share(co
 }
 
 std::array<OFMIKey, 3> OFMIKeyGenerator::GenerateKeys() const {
-    // Initialize keys
-    std::array<OFMIKey, 3> keys = {
-        OFMIKey(0, params_),
-        OFMIKey(1, params_),
-        OFMIKey(2, params_)};
+    return std::move(GenerateKeys(1)[0]);
+}
 
+std::vector<std::array<OFMIKey, 3>> OFMIKeyGenerator::GenerateKeys(const uint64_t count) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, Logger::StrWithSep("Generate OWM keys"));
 #endif
 
-    for (uint64_t i = 0; i < keys[0].num_wm_keys; ++i) {
-        // Generate the OWMKey keys
-        std::array<wm::OWMKey, 3> wm_f_key = wm_gen_.GenerateKeys();
-        std::array<wm::OWMKey, 3> wm_g_key = wm_gen_.GenerateKeys();
-
-        // Set the OWMKey keys
-        keys[0].wm_f_keys[i] = std::move(wm_f_key[0]);
-        keys[1].wm_f_keys[i] = std::move(wm_f_key[1]);
-        keys[2].wm_f_keys[i] = std::move(wm_f_key[2]);
-        keys[0].wm_g_keys[i] = std::move(wm_g_key[0]);
-        keys[1].wm_g_keys[i] = std::move(wm_g_key[1]);
-        keys[2].wm_g_keys[i] = std::move(wm_g_key[2]);
+    // Initialize keys
+    std::vector<std::array<OFMIKey, 3>> keys;
+    keys.reserve(count);
+    for (uint64_t k = 0; k < count; ++k) {
+        keys.push_back({OFMIKey(0, params_), OFMIKey(1, params_), OFMIKey(2, params_)});
     }
 
-    for (uint64_t i = 0; i < keys[0].num_zt_keys; ++i) {
-        // Generate the ZeroTestKey
-        std::pair<proto::ZeroTestKey, proto::ZeroTestKey> zt_key = zt_gen_.GenerateKeys();
+    // Generate the OWMKey keys (f and g for every query position) in one batch
+    const uint64_t                         qs      = params_.GetQuerySize();
+    std::vector<std::array<wm::OWMKey, 3>> wm_keys = wm_gen_.GenerateKeys(2 * qs * count);
+
+    for (uint64_t k = 0; k < count; ++k) {
+        for (uint64_t i = 0; i < qs; ++i) {
+            std::array<wm::OWMKey, 3> &wm_f_key = wm_keys[2 * (k * qs + i)];
+            std::array<wm::OWMKey, 3> &wm_g_key = wm_keys[2 * (k * qs + i) + 1];
+
+            // Set the OWMKey keys
+            keys[k][0].wm_f_keys[i] = std::move(wm_f_key[0]);
+            keys[k][1].wm_f_keys[i] = std::move(wm_f_key[1]);
+            keys[k][2].wm_f_keys[i] = std::move(wm_f_key[2]);
+            keys[k][0].wm_g_keys[i] = std::move(wm_g_key[0]);
+            keys[k][1].wm_g_keys[i] = std::move(wm_g_key[1]);
+            keys[k][2].wm_g_keys[i] = std::move(wm_g_key[2]);
+        }
+
+        for (uint64_t i = 0; i < qs; ++i) {
+            // Generate the ZeroTestKey
+            std::pair<proto::ZeroTestKey, proto::ZeroTestKey> zt_key = zt_gen_.GenerateKeys();
 
-        // Set the ZeroTestKey keys
-        keys[1].zt_keys[i] = std::move(zt_key.first);
-        keys[2].zt_keys[i] = std::move(zt_key.second);
+            // Set the ZeroTestKey keys
+            keys[k][1].zt_keys[i] = std::move(zt_key.first);
+            keys[k][2].zt_keys[i] = std::move(zt_key.second);
+        }
     }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "OWM keys generated");
-    keys[0].PrintKey();
-    keys[1].PrintKey();
-    keys[2].PrintKey();
+    for (const auto &key : keys) {
+        key[0].PrintKey();
+        key[1].PrintKey();
+        key[2].PrintKey();
+    }
 #endif
 
     // Return the keys
@@ -199,6 +244,15 @@ void OFMIEvaluator::OnlineSetUp(const uint64_t party_id, const std::string &file
     wm_eval_.GetRingOaEvaluator().OnlineSetUp(party_id, file_path);
 }
 
+uint64_t OFMIEvaluator::PrecomputeFde(const OFMIKey &key) const {
+    uint64_t num_keys = 0;
+    for (uint64_t i = 0; i < params_.GetQuerySize(); ++i) {
+        num_keys += wm_eval_.PrecomputeFde(key.wm_f_keys[i]);
+        num_keys += wm_eval_.PrecomputeFde(key.wm_g_keys[i]);
+    }
+    return num_keys;
+}
+
 void OFMIEvaluator::EvaluateLPM(Channels                     &chls,
                                 const OFMIKey                &key,
                                 std::vector<block>           &uv_prev,
@@ -255,62 +309,7 @@ void OFMIEvaluator::EvaluateLPM(Channels                     &chls,
     Logger::DebugLog(LOC, party_str + "Interval: " + ToString(interval));
 #endif
 
-    // Convert RSS to (2, 2)-sharing between P1 and P2 and Evaluate ZeroTest
-    std::vector<uint64_t> masked_intervals_0(qs), masked_intervals_1(qs), masked_intervals(qs);
-    std::vector<uint64_t> zt_0(qs), zt_1(qs), recon_zt(qs);
-    sharing::RepShare64   r_sh;
-    rss_.Rand(r_sh);
-    if (party_id == 1) {
-        for (uint64_t i = 0; i < qs; ++i) {
-            uint64_t interval_0 = Mod2N(interval_sh.data[0][i] + interval_sh.data[1][i] + r_sh.data[1], d);
-            uint64_t masked_interval_0;
-            ass_next_.EvaluateAdd(interval_0, key.zt_keys[i].shr_in, masked_interval_0);
-            masked_intervals_0[i] = masked_interval_0;
-        }
-        ass_next_.Reconst(0, chls.next, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_0[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-        ass_next_.Reconst(0, chls.next, zt_0, zt_1, recon_zt);
-        Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
-#endif
-    } else if (party_id == 2) {
-        for (uint64_t i = 0; i < qs; ++i) {
-            uint64_t interval_1 = Mod2N(interval_sh.data[0][i] - r_sh.data[0], d);
-            uint64_t masked_interval_1;
-            ass_prev_.EvaluateAdd(interval_1, key.zt_keys[i].shr_in, masked_interval_1);
-            masked_intervals_1[i] = masked_interval_1;
-        }
-        ass_prev_.Reconst(1, chls.prev, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_1[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-        ass_prev_.Reconst(1, chls.prev, zt_0, zt_1, recon_zt);
-        Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
-#endif
-    }
-
-    // Convert (2, 2)-sharing to RSS
-    if (party_id == 0) {
-        for (uint64_t i = 0; i < qs; ++i) {
-            rss_.Rand(r_sh);
-            result[0][i] = Mod2N(r_sh.data[1] - r_sh.data[0], d);
-        }
-    } else if (party_id == 1) {
-        for (uint64_t i = 0; i < qs; ++i) {
-            rss_.Rand(r_sh);
-            result[0][i] = Mod2N(zt_0[i] + r_sh.data[1] - r_sh.data[0], d);
-        }
-    } else {
-        for (uint64_t i = 0; i < qs; ++i) {
-            rss_.Rand(r_sh);
-            result[0][i] = Mod2N(zt_1[i] + r_sh.data[1] - r_sh.data[0], d);
-        }
-    }
-    chls.next.send(result[0]);
-    chls.prev.recv(result[1]);
+    EvaluateZeroTest(chls, key, sharing::RepShareView64(interval_sh), result);
 }
 
 void OFMIEvaluator::EvaluateLPM_Parallel(Channels                     &chls,
@@ -368,6 +367,159 @@ void OFMIEvaluator::EvaluateLPM_Parallel(Channels                     &chls,
     Logger::DebugLog(LOC, party_str + "Interval: " + ToString(interval));
 #endif
 
+    EvaluateZeroTest(chls, key, sharing::RepShareView64(interval_sh), result);
+}
+
+void OFMIEvaluator::EvaluateLPM_Pipelined(Channels                                     &chls,
+                                          std::span<const OFMIKey *const>               keys,
+                                          std::vector<block>                           &uv_prev,
+                                          std::vector<block>                           &uv_next,
+                                          const sharing::RepShareMat64                 &wm_tables,
+                                          std::span<const sharing::RepShareMat64 *const> queries,
+                                          sharing::RepShareMat64                       &result,
+                                          const uint64_t                                depth) const {
+    uint64_t qs        = params_.GetQuerySize();
+    uint64_t party_id  = chls.party_id;
+    uint64_t num_query = keys.size();
+
+    if (queries.size() != num_query) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_query) + ", queries=" + ToString(queries.size()));
+        return;
+    }
+    if (result.rows != num_query || result.cols != qs) {
+        result = sharing::RepShareMat64(num_query, qs);
+    }
+
+    // Position 2k is f and 2k + 1 is g of query k, as in EvaluateLPM_Parallel
+    sharing::RepShareVec64 fg_sh(2 * num_query);
+    sharing::RepShareVec64 fg_next_sh(2 * num_query);
+    for (uint64_t k = 0; k < num_query; ++k) {
+        if (party_id == 0) {
+            fg_sh.data[0][2 * k + 1] = wm_tables.RowView(0).Size() - 1;
+        } else if (party_id == 1) {
+            fg_sh.data[1][2 * k + 1] = wm_tables.RowView(0).Size() - 1;
+        }
+    }
+
+    sharing::RepShareMat64 interval_sh(num_query, qs);
+
+    std::vector<const wm::OWMKey *>      wm_keys(2 * num_query);
+    std::vector<sharing::RepShareView64> char_sh;
+    char_sh.reserve(2 * num_query);
+    for (uint64_t i = 0; i < qs; ++i) {
+        char_sh.clear();
+        for (uint64_t k = 0; k < num_query; ++k) {
+            wm_keys[2 * k]     = &keys[k]->wm_f_keys[i];
+            wm_keys[2 * k + 1] = &keys[k]->wm_g_keys[i];
+            char_sh.push_back(queries[k]->RowView(i));
+            char_sh.push_back(queries[k]->RowView(i));
+        }
+        wm_eval_.EvaluateRankCF_Pipelined(chls, wm_keys, uv_prev, uv_next, wm_tables, char_sh, fg_sh, fg_next_sh, depth);
+        fg_sh = fg_next_sh;
+        for (uint64_t k = 0; k < num_query; ++k) {
+            sharing::RepShare64 fg_sub_sh;
+            rss_.EvaluateSub(fg_sh.At(2 * k + 1), fg_sh.At(2 * k), fg_sub_sh);
+            interval_sh.shares.Set(k * qs + i, fg_sub_sh);
+        }
+    }
+
+    EvaluateZeroTestBatch(chls, keys, interval_sh, result);
+}
+
+void OFMIEvaluator::EvaluateLPMBatch(Channels                                     &chls,
+                                     std::span<const OFMIKey *const>               keys,
+                                     std::vector<block>                           &uv_prev,
+                                     std::vector<block>                           &uv_next,
+                                     const sharing::RepShareMat64                 &wm_tables,
+                                     std::span<const sharing::RepShareMat64 *const> queries,
+                                     sharing::RepShareMat64                       &result) const {
+    uint64_t qs        = params_.GetQuerySize();
+    uint64_t party_id  = chls.party_id;
+    uint64_t num_query = keys.size();
+
+    if (queries.size() != num_query) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_query) + ", queries=" + ToString(queries.size()));
+        return;
+    }
+    if (result.rows != num_query || result.cols != qs) {
+        result = sharing::RepShareMat64(num_query, qs);
+    }
+
+    // Position 2k is f and 2k + 1 is g of query k, as in EvaluateLPM_Parallel
+    sharing::RepShareVec64 fg_sh(2 * num_query);
+    for (uint64_t k = 0; k < num_query; ++k) {
+        if (party_id == 0) {
+            fg_sh.data[0][2 * k + 1] = wm_tables.RowView(0).Size() - 1;
+        } else if (party_id == 1) {
+            fg_sh.data[1][2 * k + 1] = wm_tables.RowView(0).Size() - 1;
+        }
+    }
+
+    sharing::RepShareMat64 interval_sh(num_query, qs);
+
+    std::vector<const wm::OWMKey *>      wm_keys(2 * num_query);
+    std::vector<sharing::RepShareView64> char_sh;
+    char_sh.reserve(2 * num_query);
+    for (uint64_t i = 0; i < qs; ++i) {
+        char_sh.clear();
+        for (uint64_t k = 0; k < num_query; ++k) {
+            wm_keys[2 * k]     = &keys[k]->wm_f_keys[i];
+            wm_keys[2 * k + 1] = &keys[k]->wm_g_keys[i];
+            char_sh.push_back(queries[k]->RowView(i));
+            char_sh.push_back(queries[k]->RowView(i));
+        }
+        wm_eval_.EvaluateRankCF_Batch(chls, wm_keys, uv_prev, uv_next, wm_tables, char_sh, fg_sh, fg_sh);
+        for (uint64_t k = 0; k < num_query; ++k) {
+            sharing::RepShare64 fg_sub_sh;
+            rss_.EvaluateSub(fg_sh.At(2 * k + 1), fg_sh.At(2 * k), fg_sub_sh);
+            interval_sh.shares.Set(k * qs + i, fg_sub_sh);
+        }
+    }
+
+    EvaluateZeroTestBatch(chls, keys, interval_sh, result);
+}
+
+CoTask OFMIEvaluator::EvaluateLPM_Co(CoScheduler                  &sched,
+                                     Channels                     &chls,
+                                     const OFMIKey                &key,
+                                     std::vector<block>           &uv_prev,
+                                     std::vector<block>           &uv_next,
+                                     const sharing::RepShareMat64 &wm_tables,
+                                     const sharing::RepShareMat64 &query,
+                                     sharing::RepShareVec64       &result) const {
+    uint64_t qs       = params_.GetQuerySize();
+    uint64_t party_id = chls.party_id;
+
+    sharing::RepShare64    f_sh(0, 0), g_sh(0, 0);
+    sharing::RepShareVec64 interval_sh(qs);
+    if (party_id == 0) {
+        g_sh.data[0] = wm_tables.RowView(0).Size() - 1;
+    } else if (party_id == 1) {
+        g_sh.data[1] = wm_tables.RowView(0).Size() - 1;
+    }
+
+    for (uint64_t i = 0; i < qs; ++i) {
+        co_await wm_eval_.EvaluateRankCF_Co(sched, chls, key.wm_f_keys[i], uv_prev, uv_next, wm_tables, query.RowView(i), f_sh, f_sh);
+        co_await wm_eval_.EvaluateRankCF_Co(sched, chls, key.wm_g_keys[i], uv_prev, uv_next, wm_tables, query.RowView(i), g_sh, g_sh);
+        sharing::RepShare64 fg_sub_sh;
+        rss_.EvaluateSub(g_sh, f_sh, fg_sub_sh);
+        interval_sh.Set(i, fg_sub_sh);
+    }
+    co_await EvaluateZeroTest_Co(sched, chls, key, sharing::RepShareView64(interval_sh), result);
+}
+
+void OFMIEvaluator::EvaluateZeroTest(Channels                      &chls,
+                                     const OFMIKey                 &key,
+                                     const sharing::RepShareView64 &interval_sh,
+                                     sharing::RepShareVec64        &result) const {
+    uint64_t d        = params_.GetDatabaseBitSize();
+    uint64_t qs       = params_.GetQuerySize();
+    uint64_t party_id = chls.party_id;
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    std::string party_str = "[P" + ToString(party_id) + "] ";
+#endif
+
     // Convert RSS to (2, 2)-sharing between P1 and P2 and Evaluate ZeroTest
     std::vector<uint64_t> masked_intervals_0(qs), masked_intervals_1(qs), masked_intervals(qs);
     std::vector<uint64_t> zt_0(qs), zt_1(qs), recon_zt(qs);
@@ -375,30 +527,26 @@ void OFMIEvaluator::EvaluateLPM_Parallel(Channels                     &chls,
     rss_.Rand(r_sh);
     if (party_id == 1) {
         for (uint64_t i = 0; i < qs; ++i) {
-            uint64_t interval_0 = Mod2N(interval_sh.data[0][i] + interval_sh.data[1][i] + r_sh.data[1], d);
+            uint64_t interval_0 = Mod2N(interval_sh.share0[i] + interval_sh.share1[i] + r_sh.data[1], d);
             uint64_t masked_interval_0;
             ass_next_.EvaluateAdd(interval_0, key.zt_keys[i].shr_in, masked_interval_0);
             masked_intervals_0[i] = masked_interval_0;
         }
         ass_next_.Reconst(0, chls.next, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_0[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_0);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_next_.Reconst(0, chls.next, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
 #endif
     } else if (party_id == 2) {
         for (uint64_t i = 0; i < qs; ++i) {
-            uint64_t interval_1 = Mod2N(interval_sh.data[0][i] - r_sh.data[0], d);
+            uint64_t interval_1 = Mod2N(interval_sh.share0[i] - r_sh.data[0], d);
             uint64_t masked_interval_1;
             ass_prev_.EvaluateAdd(interval_1, key.zt_keys[i].shr_in, masked_interval_1);
             masked_intervals_1[i] = masked_interval_1;
         }
         ass_prev_.Reconst(1, chls.prev, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_1[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_1);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_prev_.Reconst(1, chls.prev, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
@@ -426,5 +574,108 @@ void OFMIEvaluator::EvaluateLPM_Parallel(Channels                     &chls,
     chls.prev.recv(result[1]);
 }
 
+void OFMIEvaluator::EvaluateZeroTestBatch(Channels                       &chls,
+                                          std::span<const OFMIKey *const> keys,
+                                          const sharing::RepShareMat64   &interval_sh,
+                                          sharing::RepShareMat64         &result) const {
+    uint64_t d         = params_.GetDatabaseBitSize();
+    uint64_t qs        = params_.GetQuerySize();
+    uint64_t party_id  = chls.party_id;
+    uint64_t num_query = keys.size();
+    uint64_t n         = num_query * qs;
+
+    if (result.rows != num_query || result.cols != qs) {
+        result = sharing::RepShareMat64(num_query, qs);
+    }
+
+    // Convert RSS to (2, 2)-sharing between P1 and P2 (one mask per query, as in
+    // EvaluateZeroTest) and open the masked intervals of all queries in one message
+    std::vector<uint64_t> masked_intervals_0(n), masked_intervals_1(n), masked_intervals(n);
+    std::vector<uint64_t> zt(n, 0);
+    sharing::RepShare64   r_sh;
+    for (uint64_t k = 0; k < num_query; ++k) {
+        rss_.Rand(r_sh);
+        for (uint64_t i = 0; i < qs && party_id != 0; ++i) {
+            const uint64_t j = k * qs + i;
+            if (party_id == 1) {
+                uint64_t interval_0 = Mod2N(interval_sh.shares[0][j] + interval_sh.shares[1][j] + r_sh.data[1], d);
+                ass_next_.EvaluateAdd(interval_0, keys[k]->zt_keys[i].shr_in, masked_intervals_0[j]);
+            } else {
+                uint64_t interval_1 = Mod2N(interval_sh.shares[0][j] - r_sh.data[0], d);
+                ass_prev_.EvaluateAdd(interval_1, keys[k]->zt_keys[i].shr_in, masked_intervals_1[j]);
+            }
+        }
+    }
+    if (party_id == 1) {
+        ass_next_.Reconst(0, chls.next, masked_intervals_0, masked_intervals_1, masked_intervals);
+    } else if (party_id == 2) {
+        ass_prev_.Reconst(1, chls.prev, masked_intervals_0, masked_intervals_1, masked_intervals);
+    }
+    if (party_id != 0) {
+        std::vector<uint64_t> masked_k(qs), zt_k(qs);
+        for (uint64_t k = 0; k < num_query; ++k) {
+            std::copy_n(masked_intervals.begin() + k * qs, qs, masked_k.begin());
+            zt_eval_.EvaluateMaskedInput(keys[k]->zt_keys, masked_k, zt_k);
+            std::copy_n(zt_k.begin(), qs, zt.begin() + k * qs);
+        }
+    }
+
+    // Convert (2, 2)-sharing to RSS (zt is 0 for P0)
+    for (uint64_t j = 0; j < n; ++j) {
+        rss_.Rand(r_sh);
+        result.shares[0][j] = Mod2N(zt[j] + r_sh.data[1] - r_sh.data[0], d);
+    }
+    chls.next.send(result.shares[0]);
+    chls.prev.recv(result.shares[1]);
+}
+
+CoTask OFMIEvaluator::EvaluateZeroTest_Co(CoScheduler                   &sched,
+                                          Channels                      &chls,
+                                          const OFMIKey                 &key,
+                                          const sharing::RepShareView64  interval_sh,
+                                          sharing::RepShareVec64        &result) const {
+    uint64_t d        = params_.GetDatabaseBitSize();
+    uint64_t qs       = params_.GetQuerySize();
+    uint64_t party_id = chls.party_id;
+
+    if (result.Size() != qs) {
+        result = sharing::RepShareVec64(qs);
+    }
+
+    // Round 1: the intervals, masked, are opened between P1 and P2; P0 keeps in step
+    std::vector<uint64_t> masked_own(qs), masked_peer(qs), masked_intervals(qs), zt(qs, 0);
+    sharing::RepShare64   r_sh;
+    rss_.Rand(r_sh);
+    if (party_id == 1) {
+        for (uint64_t i = 0; i < qs; ++i) {
+            uint64_t interval_0 = Mod2N(interval_sh.share0[i] + interval_sh.share1[i] + r_sh.data[1], d);
+            ass_next_.EvaluateAdd(interval_0, key.zt_keys[i].shr_in, masked_own[i]);
+        }
+        chls.next.asyncSendCopy(masked_own.data(), qs);
+        co_await sched.Wait(chls.next.asyncRecv(masked_peer.data(), qs));
+    } else if (party_id == 2) {
+        for (uint64_t i = 0; i < qs; ++i) {
+            uint64_t interval_1 = Mod2N(interval_sh.share0[i] - r_sh.data[0], d);
+            ass_prev_.EvaluateAdd(interval_1, key.zt_keys[i].shr_in, masked_own[i]);
+        }
+        chls.prev.asyncSendCopy(masked_own.data(), qs);
+        co_await sched.Wait(chls.prev.asyncRecv(masked_peer.data(), qs));
+    } else {
+        co_await sched.Yield();
+    }
+    if (party_id != 0) {
+        ass_next_.EvaluateAdd(masked_own, masked_peer, masked_intervals);
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt);
+    }
+
+    // Round 2: convert the (2, 2)-sharing to RSS
+    for (uint64_t i = 0; i < qs; ++i) {
+        rss_.Rand(r_sh);
+        result[0][i] = Mod2N(zt[i] + r_sh.data[1] - r_sh.data[0], d);
+    }
+    chls.next.asyncSendCopy(result[0].data(), qs);
+    co_await sched.Wait(chls.prev.asyncRecv(result[1].data(), qs));
+}
+
 }    // namespace fm_index
 }    // namespace ringoa
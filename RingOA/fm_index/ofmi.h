@@ -89,6 +89,12 @@ struct OFMIKey {
 
     void Serialize(std::vector<uint8_t> &buffer) const;
     void Deserialize(const std::vector<uint8_t> &buffer);
+
+    // Serialized size of the legacy form (DPF keys with one byte per control bit) for 'params'.
+    static size_t CalculateLegacySerializedSize(const OFMIParameters &params);
+    // Rewrites a key serialized with legacy DPF keys into the current form (see DpfKey::ConvertLegacy).
+    static void ConvertLegacy(const OFMIParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
@@ -103,12 +109,20 @@ public:
         sharing::AdditiveSharing2P   &ass,
         sharing::ReplicatedSharing3P &rss);
 
-    void OfflineSetUp(const std::string &file_path);
+    // Beaver triples for 'num_lpm' LPM evaluations (EvaluateLPM_Pipelined, EvaluateLPMBatch and
+    // EvaluateLPM_Co sessions use one set per query).
+    void OfflineSetUp(const std::string &file_path, const uint64_t num_lpm = 1);
 
     std::array<sharing::RepShareMat64, 3> GenerateDatabaseU64Share(const wm::FMIndex &fm) const;
     std::array<sharing::RepShareMat64, 3> GenerateQueryU64Share(const wm::FMIndex &fm, std::string &query) const;
 
-    std::array<OFMIKey, 3> GenerateKeys() const;
+    // Threads used for the RingOA keys (see RingOaKeyGenerator::GenerateKeys(count)).
+    void SetNumThreads(const uint64_t num_threads) {
+        wm_gen_.SetNumThreads(num_threads);
+    }
+
+    std::array<OFMIKey, 3>              GenerateKeys() const;
+    std::vector<std::array<OFMIKey, 3>> GenerateKeys(const uint64_t count) const;
 
 private:
     OFMIParameters                params_;
@@ -127,6 +141,14 @@ public:
 
     void OnlineSetUp(const uint64_t party_id, const std::string &file_path);
 
+    // FDE cache used by the RingOA evaluations (see RingOaEvaluator::SetFdeCache).
+    void SetFdeCache(proto::RingOaFdeCache *cache) {
+        wm_eval_.SetFdeCache(cache);
+    }
+    // Precomputes (or queues) the RingOA keys of 'key' on that cache in the order EvaluateLPM
+    // uses them; returns the number of keys cached or queued (0 without a cache).
+    uint64_t PrecomputeFde(const OFMIKey &key) const;
+
     void EvaluateLPM(Channels                     &chls,
                      const OFMIKey                &key,
                      std::vector<block>           &uv_prev,
@@ -143,7 +165,60 @@ public:
                               const sharing::RepShareMat64 &query,
                               sharing::RepShareVec64       &result) const;
 
+    // LPM for K independent queries: result row k is the LPM of queries[k] under keys[k]. Each
+    // character step evaluates the 2K rank queries (f and g of every query) with
+    // OWMEvaluator::EvaluateRankCF_Pipelined, keeping 'depth' RingOA accesses in flight.
+    void EvaluateLPM_Pipelined(Channels                                     &chls,
+                               std::span<const OFMIKey *const>               keys,
+                               std::vector<block>                           &uv_prev,
+                               std::vector<block>                           &uv_next,
+                               const sharing::RepShareMat64                 &wm_tables,
+                               std::span<const sharing::RepShareMat64 *const> queries,
+                               sharing::RepShareMat64                       &result,
+                               const uint64_t                                depth = proto::RingOaEvaluator::kPipelineDepth) const;
+
+    // LPM for B queries in lockstep: result row k is the LPM of queries[k] under keys[k]. Each
+    // character step evaluates the 2B rank queries with OWMEvaluator::EvaluateRankCF_Batch (one
+    // batched RingOA and one merged select per level) and the zero tests of all B queries share
+    // their two rounds, so the number of rounds is that of a single EvaluateLPM_Parallel.
+    void EvaluateLPMBatch(Channels                                     &chls,
+                          std::span<const OFMIKey *const>               keys,
+                          std::vector<block>                           &uv_prev,
+                          std::vector<block>                           &uv_next,
+                          const sharing::RepShareMat64                 &wm_tables,
+                          std::span<const sharing::RepShareMat64 *const> queries,
+                          sharing::RepShareMat64                       &result) const;
+
+    // Coroutine form of EvaluateLPM for sessions run by a CoScheduler (see
+    // OWMEvaluator::EvaluateRankCF_Co). key, wm_tables, query and result must outlive the task.
+    CoTask EvaluateLPM_Co(CoScheduler                  &sched,
+                          Channels                     &chls,
+                          const OFMIKey                &key,
+                          std::vector<block>           &uv_prev,
+                          std::vector<block>           &uv_next,
+                          const sharing::RepShareMat64 &wm_tables,
+                          const sharing::RepShareMat64 &query,
+                          sharing::RepShareVec64       &result) const;
+
 private:
+    // Converts the intervals g - f to a (2, 2)-sharing between P1 and P2, zero-tests them and
+    // reshares the results (the common tail of the EvaluateLPM variants).
+    void EvaluateZeroTest(Channels                      &chls,
+                          const OFMIKey                 &key,
+                          const sharing::RepShareView64 &interval_sh,
+                          sharing::RepShareVec64        &result) const;
+    CoTask EvaluateZeroTest_Co(CoScheduler                   &sched,
+                               Channels                      &chls,
+                               const OFMIKey                 &key,
+                               const sharing::RepShareView64  interval_sh,
+                               sharing::RepShareVec64        &result) const;
+    // EvaluateZeroTest for the rows of interval_sh (row k under keys[k]) with one message per
+    // round for all of them.
+    void EvaluateZeroTestBatch(Channels                       &chls,
+                               std::span<const OFMIKey *const> keys,
+                               const sharing::RepShareMat64   &interval_sh,
+                               sharing::RepShareMat64         &result) const;
+
     OFMIParameters                params_;
     wm::OWMEvaluator              wm_eval_;
     proto::ZeroTestEvaluator      zt_eval_;
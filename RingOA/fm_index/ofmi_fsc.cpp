@@ -267,9 +267,7 @@ void OFMIFscEvaluator::EvaluateLPM(Channels                      &chls,
             masked_intervals_0[i] = masked_interval_0;
         }
         ass_next_.Reconst(0, chls.next, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_0[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_0);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_next_.Reconst(0, chls.next, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
@@ -282,9 +280,7 @@ void OFMIFscEvaluator::EvaluateLPM(Channels                      &chls,
             masked_intervals_1[i] = masked_interval_1;
         }
         ass_prev_.Reconst(1, chls.prev, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_1[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_1);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_prev_.Reconst(1, chls.prev, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
@@ -381,9 +377,7 @@ void OFMIFscEvaluator::EvaluateLPM_Parallel(Channels                      &chls,
             masked_intervals_0[i] = masked_interval_0;
         }
         ass_next_.Reconst(0, chls.next, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_0[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_0);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_next_.Reconst(0, chls.next, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
@@ -396,9 +390,7 @@ void OFMIFscEvaluator::EvaluateLPM_Parallel(Channels                      &chls,
             masked_intervals_1[i] = masked_interval_1;
         }
         ass_prev_.Reconst(1, chls.prev, masked_intervals_0, masked_intervals_1, masked_intervals);
-        for (uint64_t i = 0; i < qs; ++i) {
-            zt_1[i] = zt_eval_.EvaluateMaskedInput(key.zt_keys[i], masked_intervals[i]);
-        }
+        zt_eval_.EvaluateMaskedInput(key.zt_keys, masked_intervals, zt_1);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         ass_prev_.Reconst(1, chls.prev, zt_0, zt_1, recon_zt);
         Logger::DebugLog(LOC, party_str + "Reconstructed ZT: " + ToString(recon_zt));
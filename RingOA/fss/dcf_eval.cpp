@@ -1,6 +1,6 @@
 #include "dcf_eval.h"
 
-#include <stack>
+#include <stdexcept>
 
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/timer.h"
@@ -29,27 +29,30 @@ uint64_t DcfEvaluator::EvaluateAt(const DcfKey &key, uint64_t x) const {
     Logger::DebugLog(LOC, "Input: " + ToString(x));
 #endif
 
-    uint64_t n = params_.GetInputBitsize();
-    uint64_t e = params_.GetOutputBitsize();
+    uint64_t n  = params_.GetInputBitsize();
+    uint64_t e  = params_.GetOutputBitsize();
+    uint64_t nu = params_.GetTerminateBitsize();
 
     // Get the seed and control bit from the given DCF key
     block    seed        = key.init_seed;
     bool     control_bit = key.party_id != 0;
     uint64_t value       = 0;
 
-    // Evaluate the DCF key
-    std::array<block, 2> expanded_seeds;           // expanded_seeds[keep or lose]
-    std::array<bool, 2>  expanded_control_bits;    // expanded_control_bits[keep or lose]
-    std::array<block, 2> expanded_values;          // expanded_values[keep or lose]
+    // Evaluate the DCF key, expanding only the child on the path of x
+    block expanded_value;
+    for (uint64_t i = 0; i < nu; ++i) {
+        bool      current_bit = (x & (1U << (n - i - 1))) != 0;
+        prg::Side side        = current_bit ? prg::Side::kRight : prg::Side::kLeft;
+        G_.ExpandValue(seed, expanded_value, side);
+        G_.Expand(seed, seed, side);
 
-    for (uint64_t i = 0; i < n; ++i) {
-        EvaluateNextSeed(i, seed, control_bit, expanded_seeds, expanded_values, expanded_control_bits, key);
-
-        // Update the seed and control bit based on the current bit
-        bool current_bit = (x & (1U << (n - i - 1))) != 0;
-        value            = Mod2N(Sign(key.party_id != 0) * (Convert(expanded_values[current_bit], e) + (control_bit * key.cw_value[i])) + value, e);
-        seed             = expanded_seeds[current_bit];
-        control_bit      = expanded_control_bits[current_bit];
+        // Apply correction word if control bit is true
+        bool cw_control = current_bit ? key.cw_control_right[i] : key.cw_control_left[i];
+        bool next_bit   = GetLsb(seed) ^ (cw_control & control_bit);
+        SetLsbZero(seed);
+        seed ^= key.cw_seed[i] & zero_and_all_one[control_bit];
+        value       = Mod2N(Sign(key.party_id != 0) * (Convert(expanded_value, e) + (control_bit * key.cw_value[i])) + value, e);
+        control_bit = next_bit;
 
 #if LOG_LEVEL >= LOG_LEVEL_TRACE
         std::string level_str = "|Level=" + ToString(i) + "| ";
@@ -61,8 +64,205 @@ uint64_t DcfEvaluator::EvaluateAt(const DcfKey &key, uint64_t x) const {
     }
     // Compute the final output
     G_.Expand(seed, seed, prg::Side::kLeft);
-    uint64_t output = Sign(key.party_id != 0) * (Convert(seed, e) + (control_bit * key.output)) + value;
-    return Mod2N(output, e);
+    block output_block = CorrectOutputBlock(seed, control_bit, key);
+    return GetLeafValue(output_block, GetLowerNBits(x, n - nu), value);
+}
+
+void DcfEvaluator::EvaluateAt(const std::vector<DcfKey> &keys, const std::vector<uint64_t> &x, std::vector<uint64_t> &outputs) const {
+    if (keys.size() != x.size()) {
+        throw std::invalid_argument(
+            "DcfEvaluator::EvaluateAt: keys.size() != x.size() (" +
+            std::to_string(keys.size()) + " vs " + std::to_string(x.size()) + ")");
+    }
+
+    if (outputs.size() != x.size()) {
+        outputs.resize(x.size());
+    }
+
+    std::vector<const DcfKey *> key_ptrs(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        key_ptrs[i] = &keys[i];
+    }
+    EvaluateAt(std::span<const DcfKey *const>(key_ptrs), std::span<const uint64_t>(x), std::span<uint64_t>(outputs));
+}
+
+void DcfEvaluator::EvaluateAt(std::span<const DcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const {
+    if (keys.size() != x.size() || outputs.size() != x.size()) {
+        throw std::invalid_argument(
+            "DcfEvaluator::EvaluateAt: keys, x and outputs must have the same size (" +
+            std::to_string(keys.size()) + ", " + std::to_string(x.size()) + ", " + std::to_string(outputs.size()) + ")");
+    }
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (!ValidateInput(x[i])) {
+            throw std::invalid_argument("DcfEvaluator::EvaluateAt: invalid input x[" + ToString(i) + "]=" + ToString(x[i]) +
+                                        " (expected 0 <= x < 2^" + ToString(params_.GetInputBitsize()) + ")");
+        }
+    }
+    if (keys.empty()) {
+        return;
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate " + ToString(keys.size()) + " inputs with DCF keys"));
+#endif
+
+    // Lane count follows the PRG backend, capped by the number of keys
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), keys.size(), [&]<size_t N>() {
+        EvaluateAtBatched<N>(keys, x, outputs);
+    });
+}
+
+void DcfEvaluator::EvaluateFullDomain(const DcfKey &key, std::vector<uint64_t> &outputs) const {
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate full domain with DCF key"));
+    Logger::DebugLog(LOC, "Party ID: " + ToString(key.party_id));
+#endif
+
+    constexpr uint64_t kBatch = 8;
+
+    uint64_t n          = params_.GetInputBitsize();
+    uint64_t e          = params_.GetOutputBitsize();
+    uint64_t nu         = params_.GetTerminateBitsize();
+    uint64_t num_leaves = 1ULL << nu;
+    uint64_t lane_bits  = n - nu;
+    uint64_t sign       = Sign(key.party_id != 0);
+
+    if (outputs.size() != (1ULL << n)) {
+        outputs.resize(1ULL << n);
+    }
+
+    // Breadth-first expansion; node i of a level has children 2i and 2i+1 on the next one
+    std::vector<block>    seeds(num_leaves);
+    std::vector<uint8_t>  control_bits(num_leaves);
+    std::vector<uint64_t> values(num_leaves);
+    seeds[0]        = key.init_seed;
+    control_bits[0] = key.party_id != 0;
+    values[0]       = 0;
+
+    auto set_child = [&](const uint64_t level, const uint64_t parent, const uint64_t child,
+                         const bool control_bit, const uint64_t value, const block &expanded_seed, const block &expanded_value) {
+        bool     cw_control = child == kRight ? key.cw_control_right[level] : key.cw_control_left[level];
+        uint64_t idx        = 2 * parent + child;
+        block    next_seed  = expanded_seed;
+        SetLsbZero(next_seed);
+        control_bits[idx] = GetLsb(expanded_seed) ^ (cw_control & control_bit);
+        seeds[idx]        = next_seed ^ (key.cw_seed[level] & zero_and_all_one[control_bit]);
+        values[idx]       = Mod2N(sign * (Convert(expanded_value, e) + (control_bit * key.cw_value[level])) + value, e);
+    };
+
+    std::array<block, kBatch>    in, left, right, value_left, value_right;
+    std::array<bool, kBatch>     in_control_bits;
+    std::array<uint64_t, kBatch> in_values;
+    for (uint64_t level = 0; level < nu; ++level) {
+        uint64_t width = 1ULL << level;
+        if (width < kBatch) {
+            // Walk the nodes from the back so the children can overwrite them in place
+            for (uint64_t i = width; i-- > 0;) {
+                bool                 control_bit = control_bits[i];
+                uint64_t             value       = values[i];
+                std::array<block, 2> expanded_seeds, expanded_values;
+                G_.DoubleExpand(seeds[i], expanded_seeds);
+                G_.DoubleExpandValue(seeds[i], expanded_values);
+                set_child(level, i, kLeft, control_bit, value, expanded_seeds[kLeft], expanded_values[kLeft]);
+                set_child(level, i, kRight, control_bit, value, expanded_seeds[kRight], expanded_values[kRight]);
+            }
+            continue;
+        }
+        for (uint64_t base = width; base > 0;) {
+            base -= kBatch;
+            for (uint64_t j = 0; j < kBatch; ++j) {
+                in[j]              = seeds[base + j];
+                in_control_bits[j] = control_bits[base + j];
+                in_values[j]       = values[base + j];
+            }
+            G_.Expand<kBatch>(in, left, prg::Side::kLeft);
+            G_.Expand<kBatch>(in, right, prg::Side::kRight);
+            G_.ExpandValue<kBatch>(in, value_left, prg::Side::kLeft);
+            G_.ExpandValue<kBatch>(in, value_right, prg::Side::kRight);
+            for (uint64_t j = 0; j < kBatch; ++j) {
+                set_child(level, base + j, kLeft, in_control_bits[j], in_values[j], left[j], value_left[j]);
+                set_child(level, base + j, kRight, in_control_bits[j], in_values[j], right[j], value_right[j]);
+            }
+        }
+    }
+
+    // Seed expansion for the leaf blocks, then one output per lane
+    for (uint64_t i = 0; i < num_leaves; i += kBatch) {
+        uint64_t count = std::min<uint64_t>(kBatch, num_leaves - i);
+        for (uint64_t j = 0; j < count; ++j) {
+            in[j] = seeds[i + j];
+        }
+        if (count == kBatch) {
+            G_.Expand<kBatch>(in, in, prg::Side::kLeft);
+        } else {
+            for (uint64_t j = 0; j < count; ++j) {
+                G_.Expand(in[j], in[j], prg::Side::kLeft);
+            }
+        }
+        for (uint64_t j = 0; j < count; ++j) {
+            block    output_block = CorrectOutputBlock(in[j], control_bits[i + j], key);
+            uint64_t offset       = (i + j) << lane_bits;
+            for (uint64_t lane = 0; lane < (1ULL << lane_bits); ++lane) {
+                outputs[offset + lane] = GetLeafValue(output_block, lane, values[i + j]);
+            }
+        }
+    }
+}
+
+template <size_t N>
+void DcfEvaluator::EvaluateAtBatched(std::span<const DcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const {
+    uint64_t n  = params_.GetInputBitsize();
+    uint64_t e  = params_.GetOutputBitsize();
+    uint64_t nu = params_.GetTerminateBitsize();
+
+    std::array<const DcfKey *, N> lane_keys;
+    std::array<uint64_t, N>       lane_x;
+    std::array<block, N>          seeds;
+    std::array<block, N>          expanded_values;
+    std::array<bool, N>           control_bits;
+    std::array<uint64_t, N>       values;
+    std::array<prg::Side, N>      sides;
+
+    for (std::size_t base = 0; base < keys.size(); base += N) {
+        // Load N keys; a short last batch repeats its final key in the unused lanes
+        std::size_t num_lanes = std::min<std::size_t>(N, keys.size() - base);
+        for (uint64_t i = 0; i < N; ++i) {
+            std::size_t k   = base + std::min<std::size_t>(i, num_lanes - 1);
+            lane_keys[i]    = keys[k];
+            lane_x[i]       = x[k];
+            seeds[i]        = keys[k]->init_seed;
+            control_bits[i] = keys[k]->party_id != 0;
+            values[i]       = 0;
+        }
+
+        // Advance every lane one level at a time, expanding only the child on its path
+        for (uint64_t level = 0; level < nu; ++level) {
+            for (uint64_t i = 0; i < N; ++i) {
+                sides[i] = (lane_x[i] >> (n - level - 1)) & 1ULL ? prg::Side::kRight : prg::Side::kLeft;
+            }
+            G_.ExpandValue<N>(seeds, expanded_values, sides);
+            G_.Expand<N>(seeds, seeds, sides);
+
+            // Apply correction word if control bit is true
+            for (uint64_t i = 0; i < N; ++i) {
+                const DcfKey &key         = *lane_keys[i];
+                bool          control_bit = GetLsb(seeds[i]);
+                bool          cw_control  = sides[i] == prg::Side::kRight ? key.cw_control_right[level] : key.cw_control_left[level];
+                SetLsbZero(seeds[i]);
+                seeds[i] ^= key.cw_seed[level] & zero_and_all_one[control_bits[i]];
+                values[i]       = Mod2N(Sign(key.party_id != 0) * (Convert(expanded_values[i], e) + (control_bits[i] * key.cw_value[level])) + values[i], e);
+                control_bits[i] = control_bit ^ (cw_control & control_bits[i]);
+            }
+        }
+
+        // Seed expansion for the final output
+        G_.Expand<N>(seeds, seeds, prg::Side::kLeft);
+
+        for (uint64_t i = 0; i < num_lanes; ++i) {
+            block output_block = CorrectOutputBlock(seeds[i], control_bits[i], *lane_keys[i]);
+            outputs[base + i]  = GetLeafValue(output_block, GetLowerNBits(lane_x[i], n - nu), values[i]);
+        }
+    }
 }
 
 bool DcfEvaluator::ValidateInput(const uint64_t x) const {
@@ -108,6 +308,17 @@ void DcfEvaluator::EvaluateNextSeed(
     expanded_control_bits[kRight] ^= control_mask_right;
 }
 
+block DcfEvaluator::CorrectOutputBlock(const block &expanded_seed, const bool control_bit, const DcfKey &key) const {
+    uint64_t chunk_exp = params_.GetChunkExponent();
+    block    output    = AddLanes(expanded_seed, key.output & zero_and_all_one[control_bit], chunk_exp);
+    return key.party_id != 0 ? SubLanes(zero_block, output, chunk_exp) : output;
+}
+
+uint64_t DcfEvaluator::GetLeafValue(const block &output_block, const uint64_t lane, const uint64_t value) const {
+    uint64_t output = GetSplitBlockValue(output_block, params_.GetChunkExponent(), lane, OutputType::kShiftedAdditive);
+    return Mod2N(output + value, params_.GetOutputBitsize());
+}
+
 }    // namespace dcf
 }    // namespace fss
 }    // namespace ringoa
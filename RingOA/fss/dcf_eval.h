@@ -1,6 +1,8 @@
 #ifndef FSS_DCF_EVAL_H_
 #define FSS_DCF_EVAL_H_
 
+#include <span>
+
 #include "dcf_key.h"
 
 namespace ringoa {
@@ -20,34 +22,45 @@ namespace dcf {
  * Purpose
  * - For a threshold alpha and payload beta encoded in a DCF key, returns the party’s share of:
  *     f_{alpha, beta}(x) = beta · [x < alpha]
- *   Semantics follow DcfParameters::GetOutputType().
+ *   Two parties add their e-bit shares mod 2^e to reconstruct.
  *
- * Output semantics
- * - OutputType::kShiftedAdditive : returns an e-bit share; two parties add mod 2^e to reconstruct beta·[x < alpha].
- * - OutputType::kSingleBitMask   : returns a 0/1 share; two parties XOR to reconstruct [x < alpha].
+ * Overview
+ * - EvaluateAt(key, x) -> uint64_t
+ * - EvaluateAt(keys, x, outputs): one point per key, all keys advanced together
+ * - EvaluateFullDomain(key, outputs): outputs[x] for every x in [0, 2^n), i.e. the
+ *   comparison mask beta · [x < alpha] over the whole domain
  *
  * Usage
- *   DcfParameters params(n, e, ** eval type **, ** output type **);
+ *   DcfParameters params(n, e);
  *   dcf::DcfEvaluator eval(params);
  *   uint64_t y = eval.EvaluateAt(key, x);
  *
- * Strategy (driven by params.GetEvalType())
- * - Naive: expand all n tree levels.
- * - Optimized with early termination: expand only nu = params.GetTerminateBitsize() levels, then finish from the final seed/control bit.
+ *   std::vector<uint64_t> mask;
+ *   eval.EvaluateFullDomain(key, mask);    // mask.size() == 2^n
+ *
+ * Strategy
+ * - Early termination: expand only nu = params.GetTerminateBitsize() levels; the leaf block
+ *   holds 2^params.GetChunkExponent() lanes and the low n - nu bits of x pick the lane.
+ * - Point evaluation expands only the child on the path (one seed and one value AES per level).
+ * - EvaluateAt(keys, ...) runs lanes of GetPreferredBatchSize() keys one level at a time so the
+ *   AES calls of different keys are pipelined.
+ * - EvaluateFullDomain expands the tree breadth-first, eight nodes per AES batch.
  *
  * Contracts
- * - key must be generated with the same (n, e, EvalType, OutputType) configuration.
+ * - key must be generated with the same (n, e) configuration.
  * - Input domain: 0 <= x < 2^n where n = params.GetInputBitsize().
- * - Return value:
- *     • ShiftedAdditive: fits e bits (caller may mask to 2^e if desired).
- *     • SingleBitMask  : is 0 or 1.
+ * - Return value fits e bits.
  *
  * Complexity
- * - EvaluateAt: O(n) seed expansions; O(1) auxiliary memory.
+ * - EvaluateAt: O(nu) seed expansions; O(1) auxiliary memory.
+ * - EvaluateFullDomain: O(2^nu) seed expansions; O(2^nu) working memory plus the 2^n outputs.
  *
  * Determinism
  * - Deterministic for a fixed key and parameters; randomness derives solely from the PRG used during key generation and expansion.
  *
+ * Thread safety
+ * - All evaluations are const and only read the shared, immutable PRG; safe to call from many threads at once.
+ *
  */
 
 class DcfEvaluator {
@@ -56,10 +69,14 @@ public:
     explicit DcfEvaluator(const DcfParameters &params);
 
     uint64_t EvaluateAt(const DcfKey &key, uint64_t x) const;
+    void     EvaluateAt(const std::vector<DcfKey> &keys, const std::vector<uint64_t> &x, std::vector<uint64_t> &outputs) const;
+    void     EvaluateAt(std::span<const DcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const;
+
+    void EvaluateFullDomain(const DcfKey &key, std::vector<uint64_t> &outputs) const;
 
 private:
-    DcfParameters               params_;
-    prg::PseudoRandomGenerator &G_;
+    DcfParameters                     params_;
+    const prg::PseudoRandomGenerator &G_;
 
     bool ValidateInput(const uint64_t x) const;
 
@@ -67,6 +84,12 @@ private:
         const uint64_t current_level, const block &current_seed, const bool &current_control_bit,
         std::array<block, 2> &expanded_seeds, std::array<block, 2> &expanded_values, std::array<bool, 2> &expanded_control_bits,
         const DcfKey &key) const;
+
+    template <size_t N>
+    void EvaluateAtBatched(std::span<const DcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const;
+
+    block    CorrectOutputBlock(const block &expanded_seed, const bool control_bit, const DcfKey &key) const;
+    uint64_t GetLeafValue(const block &output_block, const uint64_t lane, const uint64_t value) const;
 };
 
 }    // namespace dcf
@@ -1,11 +1,35 @@
 #include "dcf_gen.h"
 
+#include <cstring>
+
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/rng.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
 #include "prg.h"
 
+namespace {
+
+using ringoa::block;
+
+// Block whose first 'count' lanes (of 2^chunk_exp) hold 'value' and the rest zero.
+block FillLanes(const uint64_t value, const uint64_t count, const uint64_t chunk_exp) {
+    alignas(16) uint8_t bytes[16] = {};
+    if (chunk_exp == 7) {
+        for (uint64_t i = 0; i < count; ++i) {
+            bytes[i / 8] |= static_cast<uint8_t>((value & 1) << (i % 8));
+        }
+    } else {
+        const uint64_t width = 16 >> chunk_exp;    // bytes per lane
+        for (uint64_t i = 0; i < count; ++i) {
+            std::memcpy(bytes + i * width, &value, width);
+        }
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+}
+
+}    // namespace
+
 namespace ringoa {
 namespace fss {
 namespace dcf {
@@ -28,8 +52,10 @@ std::pair<DcfKey, DcfKey> DcfKeyGenerator::GenerateKeys(uint64_t alpha, uint64_t
     Logger::DebugLog(LOC, "Beta: " + ToString(beta));
 #endif
 
-    uint64_t n = params_.GetInputBitsize();
-    uint64_t e = params_.GetOutputBitsize();
+    uint64_t n         = params_.GetInputBitsize();
+    uint64_t e         = params_.GetOutputBitsize();
+    uint64_t nu        = params_.GetTerminateBitsize();
+    uint64_t chunk_exp = params_.GetChunkExponent();
 
     std::array<DcfKey, 2>     keys     = {DcfKey(0, params_), DcfKey(1, params_)};
     std::pair<DcfKey, DcfKey> key_pair = std::make_pair(std::move(keys[0]), std::move(keys[1]));
@@ -61,7 +87,7 @@ std::pair<DcfKey, DcfKey> DcfKeyGenerator::GenerateKeys(uint64_t alpha, uint64_t
     std::array<bool, 2>  control_bit_correction;    // control_bit_correction[keep or lose]
     uint64_t             value_correction;
 
-    for (uint64_t i = 0; i < n; i++) {
+    for (uint64_t i = 0; i < nu; i++) {
         // Expand the seed and control bits
         G_.DoubleExpand(seed_0, expanded_seed_0);
         G_.DoubleExpand(seed_1, expanded_seed_1);
@@ -140,16 +166,21 @@ std::pair<DcfKey, DcfKey> DcfKeyGenerator::GenerateKeys(uint64_t alpha, uint64_t
 #endif
     }
 
-    // Set the output
+    // Set the output: lane j of the leaf reconstructs to beta·[j < alpha_hat] on the alpha path
     G_.Expand(seed_0, seed_0, prg::Side::kLeft);
     G_.Expand(seed_1, seed_1, prg::Side::kLeft);
 
-    uint64_t output        = Mod2N(Sign(control_bit_1) * (Convert(seed_1, e) - Convert(seed_0, e) - value), e);
+    uint64_t alpha_hat = GetLowerNBits(alpha, n - nu);
+    block    target    = SubLanes(FillLanes(beta, alpha_hat, chunk_exp), FillLanes(value, 1ULL << chunk_exp, chunk_exp), chunk_exp);
+    block    output    = AddLanes(SubLanes(seed_1, seed_0, chunk_exp), target, chunk_exp);
+    if (control_bit_1) {
+        output = SubLanes(zero_block, output, chunk_exp);
+    }
     key_pair.first.output  = output;
     key_pair.second.output = output;
 
 #if LOG_LEVEL >= LOG_LEVEL_TRACE
-    Logger::DebugLog(LOC, "Output: " + ToString(output));
+    Logger::DebugLog(LOC, "Output: " + Format(output));
     key_pair.first.PrintKey();
     key_pair.second.PrintKey();
 #endif
@@ -54,8 +54,8 @@ public:
     std::pair<DcfKey, DcfKey> GenerateKeys(uint64_t alpha, uint64_t beta) const;
 
 private:
-    DcfParameters               params_;
-    prg::PseudoRandomGenerator &G_;
+    DcfParameters                     params_;
+    const prg::PseudoRandomGenerator &G_;
 
     bool ValidateInput(const uint64_t alpha, const uint64_t beta) const;
 };
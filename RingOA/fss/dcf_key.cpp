@@ -1,6 +1,7 @@
 #include "dcf_key.h"
 
 #include <cstring>
+#include <stdexcept>
 
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/to_string.h"
@@ -10,8 +11,9 @@ namespace fss {
 namespace dcf {
 
 DcfParameters::DcfParameters(const uint64_t n, const uint64_t e)
-    : input_bitsize_(n), element_bitsize_(e) {
+    : input_bitsize_(n), element_bitsize_(e), terminate_bitsize_(n), chunk_exp_(0) {
 
+    Resolve_();
     if (!ValidateParameters()) {
         Logger::FatalLog(LOC, "Invalid DCF parameters");
         std::exit(EXIT_FAILURE);
@@ -28,13 +30,35 @@ bool DcfParameters::ValidateParameters() const {
         valid = false;
         Logger::FatalLog(LOC, "The input bitsize must be less than or equal to 32 (current: " + ToString(input_bitsize_) + ")");
     }
+    if (element_bitsize_ > 63) {
+        valid = false;
+        Logger::FatalLog(LOC, "The element bitsize must be less than or equal to 63 (current: " + ToString(element_bitsize_) + ")");
+    }
     return valid;
 }
 
+void DcfParameters::Resolve_() {
+    // Lane layout of the leaf block, same widths as the DPF leaves
+    if (element_bitsize_ == 1) {
+        chunk_exp_ = 7;    // 1bit ×128
+    } else if (element_bitsize_ <= 8) {
+        chunk_exp_ = 4;    // 8bit ×16
+    } else if (element_bitsize_ <= 16) {
+        chunk_exp_ = 3;    // 16bit ×8
+    } else if (element_bitsize_ <= 32) {
+        chunk_exp_ = 2;    // 32bit ×4
+    } else {
+        chunk_exp_ = 1;    // 64bit ×2
+    }
+    // A small domain fits in fewer lanes than the block holds
+    terminate_bitsize_ = input_bitsize_ > chunk_exp_ ? input_bitsize_ - chunk_exp_ : 0;
+}
+
 void DcfParameters::ReconfigureParameters(const uint64_t n, const uint64_t e) {
     input_bitsize_   = n;
     element_bitsize_ = e;
 
+    Resolve_();
     if (!ValidateParameters()) {
         Logger::FatalLog(LOC, "Invalid DCF parameters");
         std::exit(EXIT_FAILURE);
@@ -43,7 +67,7 @@ void DcfParameters::ReconfigureParameters(const uint64_t n, const uint64_t e) {
 
 std::string DcfParameters::GetParametersInfo() const {
     std::ostringstream oss;
-    oss << "(Input, Output): (" << input_bitsize_ << ", " << element_bitsize_ << ")";
+    oss << "(Input, Output, Terminate): (" << input_bitsize_ << ", " << element_bitsize_ << ", " << terminate_bitsize_ << ")";
     return oss.str();
 }
 
@@ -54,12 +78,12 @@ void DcfParameters::PrintParameters() const {
 DcfKey::DcfKey(const uint64_t id, const DcfParameters &params)
     : party_id(id),
       init_seed(zero_block),
-      cw_length(params.GetInputBitsize()),
+      cw_length(params.GetTerminateBitsize()),
       cw_seed(std::make_unique<block[]>(cw_length)),
       cw_control_left(std::make_unique<bool[]>(cw_length)),
       cw_control_right(std::make_unique<bool[]>(cw_length)),
       cw_value(std::make_unique<uint64_t[]>(cw_length)),
-      output(0),
+      output(zero_block),
       params_(params),
       serialized_size_(CalculateSerializedSize()) {
     std::fill(cw_seed.get(), cw_seed.get() + cw_length, zero_block);
@@ -115,7 +139,8 @@ void DcfKey::Serialize(std::vector<uint8_t> &buffer) const {
     buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&init_seed), reinterpret_cast<const uint8_t *>(&init_seed) + sizeof(init_seed));
 
     // Correction words
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&cw_length), reinterpret_cast<const uint8_t *>(&cw_length) + sizeof(cw_length));
+    const uint64_t flagged_length = cw_length | kEarlyTerminationFlag;
+    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&flagged_length), reinterpret_cast<const uint8_t *>(&flagged_length) + sizeof(flagged_length));
     buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_seed.get()), reinterpret_cast<const uint8_t *>(cw_seed.get()) + sizeof(block) * cw_length);
     buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_control_left.get()), reinterpret_cast<const uint8_t *>(cw_control_left.get()) + sizeof(bool) * cw_length);
     buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_control_right.get()), reinterpret_cast<const uint8_t *>(cw_control_right.get()) + sizeof(bool) * cw_length);
@@ -135,6 +160,19 @@ void DcfKey::Deserialize(const std::vector<uint8_t> &buffer) {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Deserializing DCF key");
 #endif
+    constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(block) + sizeof(uint64_t);
+    if (buffer.size() < kHeaderSize) {
+        throw std::invalid_argument("Invalid DCF key: " + ToString(buffer.size()) + " bytes");
+    }
+    if (IsLegacy(buffer)) {
+        throw std::invalid_argument("Invalid DCF key: written before early termination, regenerate the key");
+    }
+    uint64_t length = 0;
+    std::memcpy(&length, buffer.data() + kHeaderSize - sizeof(length), sizeof(length));
+    length &= ~kEarlyTerminationFlag;
+    if (length > 32 || buffer.size() < kHeaderSize + (sizeof(block) + 2 + sizeof(uint64_t)) * length + sizeof(output)) {
+        throw std::invalid_argument("Invalid DCF key: cw_length " + ToString(length) + " with " + ToString(buffer.size()) + " bytes");
+    }
     size_t offset = 0;
 
     // Party ID and Initial seed
@@ -142,7 +180,7 @@ void DcfKey::Deserialize(const std::vector<uint8_t> &buffer) {
     offset += sizeof(party_id);
     std::memcpy(&init_seed, buffer.data() + offset, sizeof(init_seed));
     offset += sizeof(init_seed);
-    std::memcpy(&cw_length, buffer.data() + offset, sizeof(cw_length));
+    cw_length = length;
     offset += sizeof(cw_length);
 
     // Correction Words
@@ -161,6 +199,19 @@ void DcfKey::Deserialize(const std::vector<uint8_t> &buffer) {
 
     // Output
     std::memcpy(&output, buffer.data() + offset, sizeof(output));
+    serialized_size_ = CalculateSerializedSize();
+}
+
+size_t DcfKey::CalculateLegacySerializedSize(const DcfParameters &params) {
+    // n levels of (seed, two control bytes, value) and a 64-bit output
+    const uint64_t n = params.GetInputBitsize();
+    return sizeof(uint64_t) + sizeof(block) + sizeof(uint64_t) + (sizeof(block) + 2 + sizeof(uint64_t)) * n + sizeof(uint64_t);
+}
+
+bool DcfKey::IsLegacy(const std::vector<uint8_t> &buffer) {
+    uint64_t length = 0;
+    std::memcpy(&length, buffer.data() + sizeof(uint64_t) + sizeof(block), sizeof(length));
+    return (length & kEarlyTerminationFlag) == 0;
 }
 
 void DcfKey::PrintKey(const bool detailed) const {
@@ -175,7 +226,7 @@ void DcfKey::PrintKey(const bool detailed) const {
             Logger::DebugLog(LOC, "Level(" + ToString(i) + ") Control bit (L, R): " + ToString(this->cw_control_left[i]) + ", " + ToString(this->cw_control_right[i]));
             Logger::DebugLog(LOC, "Level(" + ToString(i) + ") Value: " + ToString(this->cw_value[i]));
         }
-        Logger::DebugLog(LOC, "Output: " + ToString(output));
+        Logger::DebugLog(LOC, "Output: " + Format(output));
         Logger::DebugLog(LOC, kDash);
     } else {
         std::ostringstream oss;
@@ -11,6 +11,10 @@ namespace dcf {
 
 /**
  * @brief A class to hold params for the Distributed Comparison Function (DCF).
+ *
+ * The tree always terminates early: a leaf block holds 2^chunk_exp output lanes of
+ * (128 >> chunk_exp) bits, where the lane width is the smallest of {1, 8, 16, 32, 64}
+ * that fits e bits. The last n - nu input bits select a lane, so keys carry nu levels.
  */
 class DcfParameters {
 public:
@@ -23,6 +27,12 @@ public:
     uint64_t GetOutputBitsize() const {
         return element_bitsize_;
     }
+    uint64_t GetTerminateBitsize() const {
+        return terminate_bitsize_;
+    }
+    uint64_t GetChunkExponent() const {
+        return chunk_exp_;
+    }
     bool ValidateParameters() const;
 
     void ReconfigureParameters(const uint64_t n, const uint64_t e);
@@ -34,9 +44,24 @@ public:
 private:
     uint64_t input_bitsize_;
     uint64_t element_bitsize_;
+    uint64_t terminate_bitsize_;
+    uint64_t chunk_exp_;
+
+    void Resolve_();
 };
 
+/**
+ * DcfKey — one party's DCF key.
+ *
+ * Serialization
+ * - Serialize sets kEarlyTerminationFlag in the serialized cw_length. Keys written before
+ *   early termination (n levels, a 64-bit output, no flag) cannot be rewritten into this
+ *   form without the generator's state; Deserialize rejects them with std::invalid_argument
+ *   and they have to be generated again.
+ */
 struct DcfKey {
+    static constexpr uint64_t kEarlyTerminationFlag = 1ULL << 63;
+
     uint64_t                    party_id;
     block                       init_seed;
     uint64_t                    cw_length;
@@ -44,7 +69,7 @@ struct DcfKey {
     std::unique_ptr<bool[]>     cw_control_left;
     std::unique_ptr<bool[]>     cw_control_right;
     std::unique_ptr<uint64_t[]> cw_value;
-    uint64_t                    output;
+    block                       output;
 
     DcfKey() = delete;
     explicit DcfKey(const uint64_t id, const DcfParameters &params);
@@ -67,9 +92,14 @@ struct DcfKey {
 
     // Appends a binary representation of this key to 'buffer'.
     void Serialize(std::vector<uint8_t> &buffer) const;
-    // Replaces the current content with the key encoded in 'buffer'.
+    // Replaces the current content with the key encoded in 'buffer' (throws on a legacy key).
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of a key written before early termination, for 'params'.
+    static size_t CalculateLegacySerializedSize(const DcfParameters &params);
+    // True if 'buffer' starts with a key written before early termination.
+    static bool IsLegacy(const std::vector<uint8_t> &buffer);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
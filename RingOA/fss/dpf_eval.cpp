@@ -1,20 +1,49 @@
 #include "dpf_eval.h"
 
+#include <algorithm>
+#include <bit>
 #include <stack>
+#include <stdexcept>
 
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "dpf_eval_t.h"
 #include "prg.h"
 
+namespace {
+
+// Leaf blocks buffered per lane batch when streaming (16 KiB, sized to stay in L1).
+constexpr uint64_t kStreamBufferBlocks = 1024;
+
+}    // namespace
+
 namespace ringoa {
 namespace fss {
 namespace dpf {
 
 DpfEvaluator::DpfEvaluator(const DpfParameters &params)
     : params_(params),
-      G_(prg::PseudoRandomGenerator::GetInstance()) {
+      G_(prg::PseudoRandomGenerator::GetInstance()),
+      num_threads_(1),
+      split_depth_(0),
+      pool_(nullptr),
+      spec_(FindDpfSpecialization(params)) {
+}
+
+void DpfEvaluator::SetNumThreads(const uint64_t num_threads) {
+    num_threads_ = std::max<uint64_t>(num_threads, 1);
+    if (num_threads_ > 1) {
+        pool_ = std::make_shared<ThreadPool>(num_threads_);
+    } else {
+        pool_.reset();
+    }
+}
+
+void DpfEvaluator::SetSplitDepth(const uint64_t split_depth) {
+    split_depth_ = split_depth;
 }
 
 uint64_t DpfEvaluator::EvaluateAt(const DpfKey &key, uint64_t x) const {
@@ -30,7 +59,11 @@ uint64_t DpfEvaluator::EvaluateAt(const DpfKey &key, uint64_t x) const {
     Logger::DebugLog(LOC, "Input: " + ToString(x));
 #endif
 
-    if (params_.GetEnableEarlyTermination()) {
+    if (params_.GetEvalType() == EvalType::kHalfTree) {
+        return EvaluateAtHalfTree(key, x);
+    } else if (spec_) {
+        return spec_->evaluate_at(params_, key, x);
+    } else if (params_.GetEnableEarlyTermination()) {
         return EvaluateAtOptimized(key, x);
     } else {
         return EvaluateAtNaive(key, x);
@@ -48,9 +81,38 @@ void DpfEvaluator::EvaluateAt(const std::vector<DpfKey> &keys, const std::vector
         outputs.resize(x.size());
     }
 
+    std::vector<const DpfKey *> key_ptrs(keys.size());
     for (std::size_t i = 0; i < keys.size(); ++i) {
-        outputs[i] = EvaluateAt(keys[i], x[i]);    // may throw; let it propagate
+        key_ptrs[i] = &keys[i];
+    }
+    EvaluateAt(std::span<const DpfKey *const>(key_ptrs), std::span<const uint64_t>(x), std::span<uint64_t>(outputs));
+}
+
+void DpfEvaluator::EvaluateAt(std::span<const DpfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const {
+    if (keys.size() != x.size() || outputs.size() != x.size()) {
+        throw std::invalid_argument(
+            "DpfEvaluator::EvaluateAt: keys, x and outputs must have the same size (" +
+            std::to_string(keys.size()) + ", " + std::to_string(x.size()) + ", " + std::to_string(outputs.size()) + ")");
+    }
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (!ValidateInput(x[i])) {
+            throw std::invalid_argument("DpfEvaluator::EvaluateAt: invalid input x[" + ToString(i) + "]=" + ToString(x[i]) +
+                                        " (expected 0 <= x < 2^" + ToString(params_.GetInputBitsize()) + ")");
+        }
     }
+    if (keys.empty()) {
+        return;
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    std::string eval_type = (params_.GetEnableEarlyTermination()) ? "optimized" : "naive";
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate " + ToString(keys.size()) + " inputs with DPF keys(" + eval_type + " approach)"));
+#endif
+
+    // Lane count follows the PRG backend, capped by the number of keys
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), keys.size(), [&]<size_t N>() {
+        EvaluateAtBatched<N>(keys, x, outputs);
+    });
 }
 
 uint64_t DpfEvaluator::EvaluateAtNaive(const DpfKey &key, uint64_t x) const {
@@ -123,6 +185,113 @@ uint64_t DpfEvaluator::EvaluateAtOptimized(const DpfKey &key, uint64_t x) const
     return Mod2N(output, e);
 }
 
+uint64_t DpfEvaluator::EvaluateAtHalfTree(const DpfKey &key, uint64_t x) const {
+    uint64_t   n    = params_.GetInputBitsize();
+    uint64_t   e    = params_.GetOutputBitsize();
+    uint64_t   nu   = params_.GetTerminateBitsize();
+    OutputType mode = params_.GetOutputType();
+
+    // The control bit of a half-tree seed is its LSB
+    block seed = key.init_seed;
+    block hash;
+
+    for (uint64_t i = 0; i < nu; ++i) {
+        G_.HalfTreeHash(seed, hash);
+        hash ^= key.cw_seed[i] & zero_and_all_one[GetLsb(seed)];
+
+        // Left child = corrected hash, right child = seed ^ left child
+        bool current_bit = (x & (1U << (n - i - 1))) != 0;
+        seed             = current_bit ? seed ^ hash : hash;
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+        std::string level_str = "|Level=" + ToString(i) + "| ";
+        Logger::TraceLog(LOC, level_str + "Current bit: " + ToString(current_bit));
+        Logger::TraceLog(LOC, level_str + "Next seed: " + Format(seed));
+#endif
+    }
+
+    // Compute the final output
+    block    output_block = ComputeOutputBlock(seed, GetLsb(seed), key);
+    uint64_t x_hat        = GetLowerNBits(x, n - nu);
+    uint64_t output       = GetSplitBlockValue(output_block, n - nu, x_hat, mode);
+    return Mod2N(output, e);
+}
+
+template <size_t N>
+void DpfEvaluator::EvaluateAtBatched(std::span<const DpfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const {
+    uint64_t   n         = params_.GetInputBitsize();
+    uint64_t   e         = params_.GetOutputBitsize();
+    uint64_t   nu        = params_.GetTerminateBitsize();
+    OutputType mode      = params_.GetOutputType();
+    bool       et        = params_.GetEnableEarlyTermination();
+    bool       half_tree = params_.GetEvalType() == EvalType::kHalfTree;
+    uint64_t   depth     = et ? nu : n;
+
+    std::array<const DpfKey *, N> lane_keys;
+    std::array<uint64_t, N>       lane_x;
+    std::array<block, N>          seeds;
+    std::array<block, N>          hashes;
+    std::array<bool, N>           control_bits;
+    std::array<prg::Side, N>      sides;
+
+    for (std::size_t base = 0; base < keys.size(); base += N) {
+        // Load N keys; a short last batch repeats its final key in the unused lanes
+        std::size_t num_lanes = std::min<std::size_t>(N, keys.size() - base);
+        for (uint64_t i = 0; i < N; ++i) {
+            std::size_t k   = base + std::min<std::size_t>(i, num_lanes - 1);
+            lane_keys[i]    = keys[k];
+            lane_x[i]       = x[k];
+            seeds[i]        = keys[k]->init_seed;
+            control_bits[i] = half_tree ? GetLsb(seeds[i]) : keys[k]->party_id != 0;
+        }
+
+        // Advance every lane one level at a time, expanding only the child on its path
+        for (uint64_t level = 0; level < depth; ++level) {
+            if (half_tree) {
+                // One hash per lane; the right child is derived from the left one
+                G_.HalfTreeHash<N>(seeds, hashes);
+                for (uint64_t i = 0; i < N; ++i) {
+                    hashes[i] ^= lane_keys[i]->cw_seed[level] & zero_and_all_one[control_bits[i]];
+                    seeds[i]        = (lane_x[i] >> (n - level - 1)) & 1ULL ? seeds[i] ^ hashes[i] : hashes[i];
+                    control_bits[i] = GetLsb(seeds[i]);
+                }
+                continue;
+            }
+
+            for (uint64_t i = 0; i < N; ++i) {
+                sides[i] = (lane_x[i] >> (n - level - 1)) & 1ULL ? prg::Side::kRight : prg::Side::kLeft;
+            }
+            G_.Expand<N>(seeds, seeds, sides);
+
+            // Apply correction word if control bit is true
+            for (uint64_t i = 0; i < N; ++i) {
+                const DpfKey &key         = *lane_keys[i];
+                bool          control_bit = GetLsb(seeds[i]);
+                bool          cw_control  = key.GetControlBit(level, sides[i] == prg::Side::kRight);
+                SetLsbZero(seeds[i]);
+                seeds[i] ^= key.cw_seed[level] & zero_and_all_one[control_bits[i]];
+                control_bits[i] = control_bit ^ (cw_control & control_bits[i]);
+            }
+        }
+
+        // Seed expansion for the final output
+        G_.Expand<N>(seeds, seeds, prg::Side::kLeft);
+
+        for (uint64_t i = 0; i < num_lanes; ++i) {
+            const DpfKey &key = *lane_keys[i];
+            uint64_t      output;
+            if (et) {
+                block    output_block = CorrectOutputBlock(seeds[i], control_bits[i], key);
+                uint64_t x_hat        = GetLowerNBits(lane_x[i], n - nu);
+                output                = GetSplitBlockValue(output_block, n - nu, x_hat, mode);
+            } else {
+                output = Sign(key.party_id) * (Convert(seeds[i], e) + (control_bits[i] * Convert(key.output, e)));
+            }
+            outputs[base + i] = Mod2N(output, e);
+        }
+    }
+}
+
 bool DpfEvaluator::ValidateInput(const uint64_t x) const {
     bool valid = true;
     if (x >= (1UL << params_.GetInputBitsize())) {
@@ -155,7 +324,14 @@ void DpfEvaluator::EvaluateFullDomain(const DpfKey &key, std::vector<block> &out
             FullDomainRecursive(key, outputs);
             break;
         case EvalType::kHybridBatched:
-            FullDomainHybridBatched(key, outputs);
+            if (spec_ && !pool_) {
+                spec_->evaluate_full_domain(params_, key, outputs);
+            } else {
+                FullDomainHybridBatched(key, outputs);
+            }
+            break;
+        case EvalType::kHalfTree:
+            FullDomainHalfTree(key, outputs);
             break;
         default:
             throw std::invalid_argument(
@@ -199,7 +375,19 @@ void DpfEvaluator::EvaluateFullDomain(const DpfKey &key, std::vector<uint64_t> &
         case EvalType::kHybridBatched: {
             // With ET, BFS for first few levels then DFS
             std::vector<block> outputs_block(num_nodes);
-            FullDomainHybridBatched(key, outputs_block);
+            if (spec_ && !pool_) {
+                spec_->evaluate_full_domain(params_, key, outputs_block);
+            } else {
+                FullDomainHybridBatched(key, outputs_block);
+            }
+            SplitBlockToFieldVector(outputs_block, n - nu, params_.GetOutputBitsize(), outputs);
+            break;
+        }
+
+        case EvalType::kHalfTree: {
+            // With ET, half-tree BFS in the block buffer then split to field outputs
+            std::vector<block> outputs_block(num_nodes);
+            FullDomainHalfTree(key, outputs_block);
             SplitBlockToFieldVector(outputs_block, n - nu, params_.GetOutputBitsize(), outputs);
             break;
         }
@@ -216,6 +404,205 @@ void DpfEvaluator::EvaluateFullDomain(const DpfKey &key, std::vector<uint64_t> &
     }
 }
 
+void DpfEvaluator::EvaluateFullDomain(std::span<const DpfKey> keys, std::span<std::vector<block>> outputs) const {
+    std::vector<const DpfKey *>       key_ptrs(keys.size());
+    std::vector<std::vector<block> *> output_ptrs(outputs.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+        key_ptrs[k] = &keys[k];
+    }
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        output_ptrs[k] = &outputs[k];
+    }
+    EvaluateFullDomain(std::span<const DpfKey *const>(key_ptrs), std::span<std::vector<block> *const>(output_ptrs));
+}
+
+void DpfEvaluator::EvaluateFullDomain(std::span<const DpfKey *const> keys, std::span<std::vector<block> *const> outputs) const {
+    uint64_t nu        = params_.GetTerminateBitsize();
+    EvalType fde_type  = params_.GetEvalType();
+    uint64_t num_nodes = 1U << nu;
+
+    if (keys.size() != outputs.size()) {
+        throw std::invalid_argument(
+            "DpfEvaluator::EvaluateFullDomain: keys.size() != outputs.size() (" +
+            std::to_string(keys.size()) + " vs " + std::to_string(outputs.size()) + ")");
+    }
+
+    // Check output vector sizes
+    for (const std::vector<block> *out : outputs) {
+        if (out->size() != num_nodes) {
+            Logger::FatalLog(LOC, "Output vector size does not match the number of nodes: " + ToString(num_nodes));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate full domain " + GetEvalTypeString(fde_type) + " for " + ToString(keys.size()) + " keys"));
+#endif
+
+    if (fde_type == EvalType::kHybridBatched) {
+        FullDomainHybridBatched(keys, outputs);
+    } else {
+        for (size_t k = 0; k < keys.size(); ++k) {
+            EvaluateFullDomain(*keys[k], *outputs[k]);
+        }
+    }
+}
+
+void DpfEvaluator::EvaluateFullDomain(std::span<const DpfKey *const> keys, std::span<std::vector<uint64_t> *const> outputs) const {
+    uint64_t n         = params_.GetInputBitsize();
+    uint64_t nu        = params_.GetTerminateBitsize();
+    EvalType fde_type  = params_.GetEvalType();
+    uint64_t num_nodes = 1U << nu;
+
+    if (keys.size() != outputs.size()) {
+        throw std::invalid_argument(
+            "DpfEvaluator::EvaluateFullDomain: keys.size() != outputs.size() (" +
+            std::to_string(keys.size()) + " vs " + std::to_string(outputs.size()) + ")");
+    }
+
+    if (fde_type != EvalType::kHybridBatched) {
+        for (size_t k = 0; k < keys.size(); ++k) {
+            EvaluateFullDomain(*keys[k], *outputs[k]);
+        }
+        return;
+    }
+
+    // Check output vector sizes
+    for (const std::vector<uint64_t> *out : outputs) {
+        if (out->size() != 1U << n) {
+            Logger::FatalLog(LOC, "Output vector size does not match the number of nodes: " + ToString(num_nodes));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // With ET, compute the block buffers in lockstep then split each to field outputs
+    std::vector<std::vector<block>>   outputs_block(keys.size(), std::vector<block>(num_nodes));
+    std::vector<std::vector<block> *> output_ptrs(keys.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+        output_ptrs[k] = &outputs_block[k];
+    }
+    FullDomainHybridBatched(keys, std::span<std::vector<block> *const>(output_ptrs));
+    for (size_t k = 0; k < keys.size(); ++k) {
+        SplitBlockToFieldVector(outputs_block[k], n - nu, params_.GetOutputBitsize(), *outputs[k]);
+    }
+}
+
+void DpfEvaluator::StreamFullDomain(std::span<const DpfKey *const> keys, const LeafConsumer &consumer) const {
+    uint64_t nu       = params_.GetTerminateBitsize();
+    EvalType fde_type = params_.GetEvalType();
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Stream full domain " + GetEvalTypeString(fde_type) + " for " + ToString(keys.size()) + " keys"));
+#endif
+
+    if (keys.empty()) {
+        return;
+    }
+    if (fde_type == EvalType::kHybridBatched) {
+        FullDomainHybridBatched(keys, {}, &consumer);
+    } else {
+        // No streaming traversal for this type: materialise one key at a time
+        std::vector<block> leaves(1U << nu);
+        for (size_t k = 0; k < keys.size(); ++k) {
+            EvaluateFullDomain(*keys[k], leaves);
+            consumer(k, 0, leaves);
+        }
+    }
+}
+
+void DpfEvaluator::EvaluateSubtrees(std::span<const DpfKey *const> keys,
+                                    std::span<const uint64_t>      firsts,
+                                    const uint64_t                 count,
+                                    std::span<block *const>        outputs) const {
+    uint64_t nu = params_.GetTerminateBitsize();
+
+    if (count == 0 || (count & (count - 1)) != 0 || count > (1ULL << nu)) {
+        throw std::invalid_argument("DpfEvaluator::EvaluateSubtrees: count must be a power of two up to 2^nu, got " + ToString(count));
+    }
+    if (firsts.size() != keys.size() || outputs.size() != keys.size()) {
+        throw std::invalid_argument(
+            "DpfEvaluator::EvaluateSubtrees: keys, firsts and outputs must have the same size (" +
+            std::to_string(keys.size()) + ", " + std::to_string(firsts.size()) + ", " + std::to_string(outputs.size()) + ")");
+    }
+    for (const uint64_t first : firsts) {
+        if ((first & (count - 1)) != 0 || first >= (1ULL << nu)) {
+            throw std::invalid_argument("DpfEvaluator::EvaluateSubtrees: first leaf " + ToString(first) + " is not a subtree of " + ToString(count) + " leaves");
+        }
+    }
+    if (keys.empty()) {
+        return;
+    }
+
+    if (params_.GetEvalType() == EvalType::kHalfTree) {
+        // Walk each key to node firsts[k] / count as in EvaluateAtHalfTree, then expand that subtree in place
+        uint64_t depth = nu - std::countr_zero(count);
+        block    hash;
+        for (size_t k = 0; k < keys.size(); ++k) {
+            const DpfKey  &key  = *keys[k];
+            const uint64_t node = firsts[k] >> (nu - depth);
+            block          seed = key.init_seed;
+            for (uint64_t level = 0; level < depth; ++level) {
+                G_.HalfTreeHash(seed, hash);
+                hash ^= key.cw_seed[level] & zero_and_all_one[GetLsb(seed)];
+                seed = ((node >> (depth - 1 - level)) & 1U) ? seed ^ hash : hash;
+            }
+            ExpandHalfTreeSubtree(key, depth, seed, outputs[k]);
+        }
+        return;
+    }
+
+    // Lane count follows the PRG backend, capped by the number of subtrees
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), keys.size(), [&]<size_t N>() {
+        EvaluateSubtreesLanes<N>(keys, firsts, count, outputs);
+    });
+}
+
+template <size_t N>
+void DpfEvaluator::EvaluateSubtreesLanes(std::span<const DpfKey *const> keys,
+                                         std::span<const uint64_t>      firsts,
+                                         const uint64_t                 count,
+                                         std::span<block *const>        outputs) const {
+    uint64_t nu    = params_.GetTerminateBitsize();
+    uint64_t depth = nu - std::countr_zero(count);
+
+    // One subtree per lane: walk from the root of keys[k] to node firsts[k] / count at 'depth'
+    std::vector<block> scratch;
+    for (uint64_t b = 0; b < keys.size(); b += N) {
+        std::array<const DpfKey *, N> lane_keys;
+        std::array<block, N>          root_seeds;
+        std::array<bool, N>           root_control_bits;
+        std::array<block *, N>        lane_outputs;
+        for (uint64_t i = 0; i < N; ++i) {
+            if (b + i >= keys.size()) {
+                // Padding lane (the last batch is not full): evaluate a copy of lane 0 into scratch
+                scratch.resize(count);
+                lane_keys[i]         = lane_keys[0];
+                root_seeds[i]        = root_seeds[0];
+                root_control_bits[i] = root_control_bits[0];
+                lane_outputs[i]      = scratch.data();
+                continue;
+            }
+            const DpfKey        &key         = *keys[b + i];
+            const uint64_t       node        = firsts[b + i] >> (nu - depth);
+            block                seed        = key.init_seed;
+            bool                 control_bit = key.party_id != 0;
+            std::array<block, 2> expanded_seeds;
+            std::array<bool, 2>  expanded_control_bits;
+            for (uint64_t level = 0; level < depth; ++level) {
+                EvaluateNextSeed(level, seed, control_bit, expanded_seeds, expanded_control_bits, key);
+                const uint64_t side = (node >> (depth - 1 - level)) & 1U;
+                seed                = expanded_seeds[side];
+                control_bit         = expanded_control_bits[side];
+            }
+            lane_keys[i]         = &key;
+            root_seeds[i]        = seed;
+            root_control_bits[i] = control_bit;
+            lane_outputs[i]      = outputs[b + i];
+        }
+        ExpandSubtreesBatched<N>(depth, lane_keys, root_seeds, root_control_bits, lane_outputs);
+    }
+}
+
 void DpfEvaluator::EvaluateNextSeed(
     const uint64_t current_level, const block &current_seed, const bool &current_control_bit,
     std::array<block, 2> &expanded_seeds, std::array<bool, 2> &expanded_control_bits,
@@ -241,8 +628,8 @@ void DpfEvaluator::EvaluateNextSeed(
     expanded_seeds[kLeft] ^= mask;
     expanded_seeds[kRight] ^= mask;
 
-    const bool control_mask_left  = key.cw_control_left[current_level] & current_control_bit;
-    const bool control_mask_right = key.cw_control_right[current_level] & current_control_bit;
+    const bool control_mask_left  = key.GetControlLeft(current_level) & current_control_bit;
+    const bool control_mask_right = key.GetControlRight(current_level) & current_control_bit;
     expanded_control_bits[kLeft] ^= control_mask_left;
     expanded_control_bits[kRight] ^= control_mask_right;
 }
@@ -258,46 +645,162 @@ void DpfEvaluator::FullDomainRecursive(const DpfKey &key, std::vector<block> &ou
 }
 
 void DpfEvaluator::FullDomainHybridBatched(const DpfKey &key, std::vector<block> &outputs) const {
-    uint64_t nu            = params_.GetTerminateBitsize();
-    uint64_t remaining_bit = params_.GetInputBitsize() - nu;
+    const std::array<const DpfKey *, 1>       keys{&key};
+    const std::array<std::vector<block> *, 1> outs{&outputs};
+    FullDomainHybridBatched(keys, outs);
 
-    // Breadth-first traversal for 8 nodes
-    std::vector<block> start_seeds{key.init_seed}, next_seeds;
-    std::vector<bool>  start_control_bits{key.party_id != 0}, next_control_bits;
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+    for (uint64_t i = 0; i < (outputs.size() > 16 ? 16 : outputs.size()); ++i) {
+        Logger::TraceLog(LOC, "Output seed (" + ToString(i) + "): " + Format(outputs[i]));
+    }
+#endif
+}
+
+void DpfEvaluator::FullDomainHybridBatched(std::span<const DpfKey *const>      keys,
+                                           std::span<std::vector<block> *const> outputs,
+                                           const LeafConsumer                  *consumer) const {
+    uint64_t nu = params_.GetTerminateBitsize();
 
-    for (uint64_t i = 0; i < 3; ++i) {
-        std::array<block, 2> expanded_seeds;
-        std::array<bool, 2>  expanded_control_bits;
-        next_seeds.resize(1U << (i + 1));
-        next_control_bits.resize(1U << (i + 1));
-        for (size_t j = 0; j < start_seeds.size(); j++) {
-            EvaluateNextSeed(i, start_seeds[j], start_control_bits[j], expanded_seeds, expanded_control_bits, key);
-            next_seeds[j * 2]            = expanded_seeds[kLeft];
-            next_seeds[j * 2 + 1]        = expanded_seeds[kRight];
-            next_control_bits[j * 2]     = expanded_control_bits[kLeft];
-            next_control_bits[j * 2 + 1] = expanded_control_bits[kRight];
+    // Lane count follows the PRG backend, capped by the number of nodes at depth nu over all keys
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), keys.size() << nu, [&]<size_t N>() {
+        FullDomainHybridBatchedLanes<N>(keys, outputs, consumer);
+    });
+}
+
+template <size_t N>
+void DpfEvaluator::FullDomainHybridBatchedLanes(std::span<const DpfKey *const>      keys,
+                                                std::span<std::vector<block> *const> outputs,
+                                                const LeafConsumer                  *consumer) const {
+    uint64_t nu          = params_.GetTerminateBitsize();
+    uint64_t num_keys    = keys.size();
+    uint64_t split_depth = consumer ? ResolveSplitDepth(num_keys, N, /*use_pool=*/false) : ResolveSplitDepth(num_keys, N);
+
+    // Breadth-first traversal of every key down to the split depth.
+    // Subtree t belongs to key t >> split_depth and is its (t mod 2^split_depth)-th node.
+    uint64_t           num_roots = 1U << split_depth;
+    std::vector<block> start_seeds(num_keys * num_roots);
+    std::vector<bool>  start_control_bits(num_keys * num_roots);
+
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        const DpfKey      &key = *keys[k];
+        std::vector<block> level_seeds{key.init_seed}, next_seeds;
+        std::vector<bool>  level_control_bits{key.party_id != 0}, next_control_bits;
+
+        for (uint64_t i = 0; i < split_depth; ++i) {
+            std::array<block, 2> expanded_seeds;
+            std::array<bool, 2>  expanded_control_bits;
+            next_seeds.resize(1U << (i + 1));
+            next_control_bits.resize(1U << (i + 1));
+            for (size_t j = 0; j < level_seeds.size(); j++) {
+                EvaluateNextSeed(i, level_seeds[j], level_control_bits[j], expanded_seeds, expanded_control_bits, key);
+                next_seeds[j * 2]            = expanded_seeds[kLeft];
+                next_seeds[j * 2 + 1]        = expanded_seeds[kRight];
+                next_control_bits[j * 2]     = expanded_control_bits[kLeft];
+                next_control_bits[j * 2 + 1] = expanded_control_bits[kRight];
+            }
+            level_seeds        = std::move(next_seeds);
+            level_control_bits = std::move(next_control_bits);
+        }
+        for (uint64_t j = 0; j < num_roots; ++j) {
+            start_seeds[k * num_roots + j]        = level_seeds[j];
+            start_control_bits[k * num_roots + j] = level_control_bits[j];
         }
-        start_seeds        = std::move(next_seeds);
-        start_control_bits = std::move(next_control_bits);
     }
 
+    // Depth-first traversal of the subtrees, N at a time.
+    // Subtree j of a key covers its outputs [j * subtree_size, (j + 1) * subtree_size).
+    uint64_t num_subtrees = num_keys * num_roots;
+    uint64_t num_batches  = (num_subtrees + N - 1) / N;
+    uint64_t subtree_size = 1U << (nu - split_depth);
+
+    // When streaming, each lane writes into a chunk of the batch buffer that is handed to
+    // the consumer every 'chunk' leaves
+    uint64_t chunk = std::min<uint64_t>(kStreamBufferBlocks / N, subtree_size);
+
+    auto expand_batch = [&](uint64_t b) {
+        std::array<const DpfKey *, N> lane_keys;
+        std::array<block, N>          root_seeds;
+        std::array<bool, N>           root_control_bits;
+        std::array<block *, N>        lane_outputs;
+        std::vector<block>            scratch;
+        for (uint64_t i = 0; i < N; ++i) {
+            uint64_t t = b * N + i;
+            if (t < num_subtrees) {
+                lane_keys[i]         = keys[t / num_roots];
+                root_seeds[i]        = start_seeds[t];
+                root_control_bits[i] = start_control_bits[t];
+                lane_outputs[i]      = consumer ? nullptr : outputs[t / num_roots]->data() + (t % num_roots) * subtree_size;
+            } else {
+                // Padding lane (the last batch is not full): evaluate a copy of lane 0 into scratch
+                scratch.resize(consumer ? 0 : subtree_size);
+                lane_keys[i]         = lane_keys[0];
+                root_seeds[i]        = root_seeds[0];
+                root_control_bits[i] = root_control_bits[0];
+                lane_outputs[i]      = consumer ? nullptr : scratch.data();
+            }
+        }
+
+        if (!consumer) {
+            ExpandSubtreesBatched<N>(split_depth, lane_keys, root_seeds, root_control_bits, lane_outputs);
+            return;
+        }
+
+        std::array<block, N * (kStreamBufferBlocks / N)> buffer;
+        for (uint64_t i = 0; i < N; ++i) {
+            lane_outputs[i] = buffer.data() + i * chunk;
+        }
+        const std::function<void(uint64_t)> flush = [&](uint64_t first) {
+            for (uint64_t i = 0; i < N && b * N + i < num_subtrees; ++i) {
+                uint64_t t = b * N + i;
+                (*consumer)(t / num_roots, (t % num_roots) * subtree_size + first, std::span<const block>(lane_outputs[i], chunk));
+            }
+        };
+        ExpandSubtreesBatched<N>(split_depth, lane_keys, root_seeds, root_control_bits, lane_outputs, chunk - 1, &flush);
+    };
+
+    if (!consumer && pool_ && num_batches > 1) {
+        pool_->ParallelFor(num_batches, expand_batch);
+    } else {
+        for (uint64_t b = 0; b < num_batches; ++b) {
+            expand_batch(b);
+        }
+    }
+}
+
+template <size_t N>
+void DpfEvaluator::ExpandSubtreesBatched(const uint64_t                       start_level,
+                                         const std::array<const DpfKey *, N> &keys,
+                                         const std::array<block, N>          &root_seeds,
+                                         const std::array<bool, N>           &root_control_bits,
+                                         const std::array<block *, N>        &outputs,
+                                         const uint64_t                       index_mask,
+                                         const std::function<void(uint64_t)> *flush) const {
+    uint64_t nu            = params_.GetTerminateBitsize();
+    uint64_t remaining_bit = params_.GetInputBitsize() - nu;
+
     // Initialize the variables
     uint64_t current_level = 0;
     uint64_t current_idx   = 0;
-    uint64_t last_depth    = std::max(static_cast<int32_t>(nu) - 3, 0);
+    uint64_t last_depth    = nu - start_level;
     uint64_t last_idx      = 1U << last_depth;
 
+    // Per-lane key material (lanes may belong to different keys)
+    std::array<block, N> key_outputs;
+    std::array<bool, N>  party_ids;
+    for (uint64_t i = 0; i < N; ++i) {
+        key_outputs[i] = keys[i]->output;
+        party_ids[i]   = keys[i]->party_id != 0;
+    }
+
     // Store the seeds and control bits
-    std::array<block, 8>              expanded_seeds;
-    std::array<bool, 8>               expanded_control_bits;
-    std::vector<std::array<block, 8>> prev_seeds(last_depth + 1);
-    std::vector<std::array<bool, 8>>  prev_control_bits(last_depth + 1);
+    std::array<block, N>              expanded_seeds;
+    std::array<bool, N>               expanded_control_bits;
+    std::vector<std::array<block, N>> prev_seeds(last_depth + 1);
+    std::vector<std::array<bool, N>>  prev_control_bits(last_depth + 1);
 
     // Evaluate the DPF key
-    for (uint64_t i = 0; i < 8; ++i) {
-        prev_seeds[0][i]        = start_seeds[i];
-        prev_control_bits[0][i] = start_control_bits[i];
-    }
+    prev_seeds[0]        = root_seeds;
+    prev_control_bits[0] = root_control_bits;
 
     while (current_idx < last_idx) {
         while (current_level < last_depth) {
@@ -311,15 +814,15 @@ void DpfEvaluator::FullDomainHybridBatched(const DpfKey &key, std::vector<block>
             } else {
                 side = prg::Side::kLeft;
             }
-            G_.Expand(prev_seeds[current_level], expanded_seeds, side);
-            for (uint64_t i = 0; i < 8; ++i) {
+            G_.Expand<N>(prev_seeds[current_level], expanded_seeds, side);
+            for (uint64_t i = 0; i < N; ++i) {
                 expanded_control_bits[i] = GetLsb(expanded_seeds[i]);
                 SetLsbZero(expanded_seeds[i]);
             }
 
 #if LOG_LEVEL >= LOG_LEVEL_TRACE
             std::string level_str = "|Level=" + ToString(current_level) + "| ";
-            for (uint64_t i = 0; i < 8; ++i) {
+            for (uint64_t i = 0; i < N; ++i) {
                 Logger::TraceLog(LOC, level_str + "Current bit: " + ToString(current_bit));
                 Logger::TraceLog(LOC, level_str + "Current seed (" + ToString(i) + "): " + Format(prev_seeds[current_level][i]));
                 Logger::TraceLog(LOC, level_str + "Current control bit (" + ToString(i) + "): " + ToString(prev_control_bits[current_level][i]));
@@ -329,19 +832,11 @@ void DpfEvaluator::FullDomainHybridBatched(const DpfKey &key, std::vector<block>
 #endif
 
             // Apply correction word if control bit is true
-            bool  cw_control_bit = current_bit ? key.cw_control_right[current_level + 3] : key.cw_control_left[current_level + 3];
-            block cw_seed        = key.cw_seed[current_level + 3];
-            expanded_seeds[0] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][0]]);
-            expanded_seeds[1] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][1]]);
-            expanded_seeds[2] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][2]]);
-            expanded_seeds[3] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][3]]);
-            expanded_seeds[4] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][4]]);
-            expanded_seeds[5] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][5]]);
-            expanded_seeds[6] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][6]]);
-            expanded_seeds[7] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][7]]);
-
-            for (uint64_t i = 0; i < 8; ++i) {
-                // expanded_seeds[i] ^= (key.cw_seed[current_level + 3] & zero_and_all_one[prev_control_bits[current_level][i]]);
+            uint64_t cw_level = current_level + start_level;
+            for (uint64_t i = 0; i < N; ++i) {
+                const DpfKey &key            = *keys[i];
+                bool          cw_control_bit = key.GetControlBit(cw_level, current_bit);
+                expanded_seeds[i] ^= (key.cw_seed[cw_level] & zero_and_all_one[prev_control_bits[current_level][i]]);
                 expanded_control_bits[i] ^= (cw_control_bit & prev_control_bits[current_level][i]);
             }
 
@@ -349,55 +844,124 @@ void DpfEvaluator::FullDomainHybridBatched(const DpfKey &key, std::vector<block>
             current_level++;
 
             // Update the previous seeds and control bits
-            for (uint64_t i = 0; i < 8; ++i) {
+            for (uint64_t i = 0; i < N; ++i) {
                 prev_seeds[current_level][i]        = expanded_seeds[i];
                 prev_control_bits[current_level][i] = expanded_control_bits[i];
             }
         }
 
         // Seed expansion for the final output
-        G_.Expand(prev_seeds[current_level], prev_seeds[current_level], prg::Side::kLeft);
+        G_.Expand<N>(prev_seeds[current_level], prev_seeds[current_level], prg::Side::kLeft);
 
-        if (remaining_bit == 2) {
-            if (key.party_id) {
-                for (uint64_t i = 0; i < 8; ++i) {
-                    outputs[i * last_idx + current_idx] = _mm_sub_epi32(zero_block, _mm_add_epi32(prev_seeds[current_level][i], zero_and_all_one[prev_control_bits[current_level][i]] & key.output));
-                }
-            } else {
-                for (uint64_t i = 0; i < 8; ++i) {
-                    outputs[i * last_idx + current_idx] = _mm_add_epi32(prev_seeds[current_level][i], zero_and_all_one[prev_control_bits[current_level][i]] & key.output);
-                }
+        if (remaining_bit == 7) {
+            for (uint64_t i = 0; i < N; ++i) {
+                outputs[i][current_idx & index_mask] = prev_seeds[current_level][i] ^ (zero_and_all_one[prev_control_bits[current_level][i]] & key_outputs[i]);
             }
-        } else if (remaining_bit == 3) {
-            if (key.party_id) {
-                for (uint64_t i = 0; i < 8; ++i) {
-                    outputs[i * last_idx + current_idx] = _mm_sub_epi16(zero_block, _mm_add_epi16(prev_seeds[current_level][i], zero_and_all_one[prev_control_bits[current_level][i]] & key.output));
-                }
-            } else {
-                for (uint64_t i = 0; i < 8; ++i) {
-                    outputs[i * last_idx + current_idx] = _mm_add_epi16(prev_seeds[current_level][i], zero_and_all_one[prev_control_bits[current_level][i]] & key.output);
-                }
-            }
-        } else if (remaining_bit == 7) {
-            for (uint64_t i = 0; i < 8; ++i) {
-                outputs[i * last_idx + current_idx] = prev_seeds[current_level][i] ^ (zero_and_all_one[prev_control_bits[current_level][i]] & key.output);
+        } else if (remaining_bit >= 1 && remaining_bit <= 4) {
+            for (uint64_t i = 0; i < N; ++i) {
+                block sum                            = AddLanes(prev_seeds[current_level][i], zero_and_all_one[prev_control_bits[current_level][i]] & key_outputs[i], remaining_bit);
+                outputs[i][current_idx & index_mask] = party_ids[i] ? SubLanes(zero_block, sum, remaining_bit) : sum;
             }
         } else {
             Logger::FatalLog(LOC, "Invalid remaining bit: " + ToString(remaining_bit));
             std::exit(EXIT_FAILURE);
         }
 
+        // Hand a full chunk of leaves to the consumer (streaming only)
+        if (flush && ((current_idx + 1) & index_mask) == 0) {
+            (*flush)(current_idx - index_mask);
+        }
+
         // Update the current index
         int shift = (current_idx + 1U) ^ current_idx;
         current_level -= Log2Floor(shift) + 1;
         current_idx++;
     }
+}
 
-#if LOG_LEVEL >= LOG_LEVEL_TRACE
-    for (uint64_t i = 0; i < (outputs.size() > 16 ? 16 : outputs.size()); ++i) {
-        Logger::TraceLog(LOC, "Output seed (" + ToString(i) + "): " + Format(outputs[i]));
+void DpfEvaluator::FullDomainHalfTree(const DpfKey &key, std::vector<block> &outputs) const {
+    ExpandHalfTreeSubtree(key, 0, key.init_seed, outputs.data());
+}
+
+void DpfEvaluator::ExpandHalfTreeSubtree(const DpfKey &key, const uint64_t start_level, const block &root_seed, block *outputs) const {
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), ~0ULL, [&]<size_t N>() {
+        ExpandHalfTreeSubtreeLanes<N>(key, start_level, root_seed, outputs);
+    });
+}
+
+template <size_t N>
+void DpfEvaluator::ExpandHalfTreeSubtreeLanes(const DpfKey &key, const uint64_t start_level, const block &root_seed, block *outputs) const {
+    uint64_t nu = params_.GetTerminateBitsize();
+
+    // Breadth-first in place: level l occupies outputs[0, 2^(l - start_level)). Nodes are expanded
+    // from the highest index down, so children (2j, 2j + 1) never overwrite an unexpanded node.
+    std::array<block, N> seeds;
+    std::array<block, N> hashes;
+    outputs[0] = root_seed;
+    for (uint64_t level = start_level; level < nu; ++level) {
+        uint64_t num_nodes = 1ULL << (level - start_level);
+        uint64_t j         = num_nodes;
+
+        // Batches of N nodes
+        while (j >= N) {
+            j -= N;
+            std::copy_n(outputs + j, N, seeds.begin());
+            G_.HalfTreeHash<N>(seeds, hashes);
+            for (uint64_t i = N; i-- > 0;) {
+                block left               = hashes[i] ^ (key.cw_seed[level] & zero_and_all_one[GetLsb(seeds[i])]);
+                outputs[2 * (j + i)]     = left;
+                outputs[2 * (j + i) + 1] = seeds[i] ^ left;
+            }
+        }
+        // Levels narrower than a batch
+        while (j > 0) {
+            --j;
+            block seed = outputs[j];
+            block left;
+            G_.HalfTreeHash(seed, left);
+            left ^= key.cw_seed[level] & zero_and_all_one[GetLsb(seed)];
+            outputs[2 * j]     = left;
+            outputs[2 * j + 1] = seed ^ left;
+        }
+    }
+
+    // Leaf expansion and output correction
+    uint64_t num_leaves = 1ULL << (nu - start_level);
+    uint64_t j          = 0;
+    for (; j + N <= num_leaves; j += N) {
+        std::copy_n(outputs + j, N, seeds.begin());
+        G_.Expand<N>(seeds, hashes, prg::Side::kLeft);
+        for (uint64_t i = 0; i < N; ++i) {
+            outputs[j + i] = CorrectOutputBlock(hashes[i], GetLsb(seeds[i]), key);
+        }
+    }
+    for (; j < num_leaves; ++j) {
+        outputs[j] = ComputeOutputBlock(outputs[j], GetLsb(outputs[j]), key);
     }
-#endif
+}
+
+uint64_t DpfEvaluator::ResolveSplitDepth(const uint64_t num_keys, const uint64_t lanes, const bool use_pool) const {
+    uint64_t nu = params_.GetTerminateBitsize();
+
+    // Smallest depth that fills one lane batch with the subtrees of all keys
+    uint64_t min_depth = 0;
+    while ((num_keys << min_depth) < lanes && min_depth < nu) {
+        min_depth++;
+    }
+    if (!use_pool || !pool_ || num_threads_ <= 1) {
+        return min_depth;
+    }
+
+    auto     num_batches = [&](uint64_t depth) { return ((num_keys << depth) + lanes - 1) / lanes; };
+    uint64_t depth       = split_depth_;
+    if (depth == 0) {
+        // Aim for at least 4 lane batches per thread to balance the load
+        depth = min_depth;
+        while (num_batches(depth) < 4 * num_threads_ && depth < nu) {
+            depth++;
+        }
+    }
+    return std::min(std::max(depth, min_depth), nu);
 }
 
 void DpfEvaluator::FullDomainIterative(const DpfKey &key, std::vector<uint64_t> &outputs) const {
@@ -446,7 +1010,7 @@ void DpfEvaluator::FullDomainIterative(const DpfKey &key, std::vector<uint64_t>
 #endif
 
             // Apply correction word if control bit is true
-            bool  cw_control_bit = current_bit ? key.cw_control_right[current_level] : key.cw_control_left[current_level];
+            bool  cw_control_bit = key.GetControlBit(current_level, current_bit);
             block cw_seed        = key.cw_seed[current_level];
             expanded_seeds ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level]]);
 
@@ -506,32 +1070,28 @@ void DpfEvaluator::Traverse(const block &current_seed, const bool current_contro
 
 // Compute the mask block and remaining bits
 block DpfEvaluator::ComputeOutputBlock(const block &final_seed, bool final_control_bit, const DpfKey &key) const {
+    // Seed expansion for the final output
+    block expanded_seed;
+    G_.Expand(final_seed, expanded_seed, prg::Side::kLeft);
+    return CorrectOutputBlock(expanded_seed, final_control_bit, key);
+}
+
+// Apply the output correction word to an expanded final seed
+block DpfEvaluator::CorrectOutputBlock(const block &expanded_seed, bool final_control_bit, const DpfKey &key) const {
     // Compute the remaining bits
     block    mask          = zero_and_all_one[final_control_bit];
     uint64_t remaining_bit = params_.GetInputBitsize() - params_.GetTerminateBitsize();
     block    output        = zero_block;
 
-    // Seed expansion for the final output
-    block expanded_seed;
-    G_.Expand(final_seed, expanded_seed, prg::Side::kLeft);
-
-    if (remaining_bit == 2) {
-        // Reduce 2 levels (2^2=4 nodes) of the tree (Additive share)
-        if (key.party_id) {
-            output = _mm_sub_epi32(zero_block, _mm_add_epi32(expanded_seed, (mask & key.output)));
-        } else {
-            output = _mm_add_epi32(expanded_seed, (mask & key.output));
-        }
-    } else if (remaining_bit == 3) {
-        // Reduce 3 levels (2^3=8 nodes) of the tree (Additive share)
-        if (key.party_id) {
-            output = _mm_sub_epi16(zero_block, _mm_add_epi16(expanded_seed, (mask & key.output)));
-        } else {
-            output = _mm_add_epi16(expanded_seed, (mask & key.output));
-        }
-    } else if (remaining_bit == 7) {
+    if (remaining_bit == 7) {
         // Reduce 7 levels (2^7=128 nodes) of the tree (Additive share)
         output = expanded_seed ^ (mask & key.output);
+    } else if (remaining_bit >= 1 && remaining_bit <= 4) {
+        // Reduce 'remaining_bit' levels of the tree into (128 >> remaining_bit)-bit lanes (Additive share)
+        output = AddLanes(expanded_seed, (mask & key.output), remaining_bit);
+        if (key.party_id) {
+            output = SubLanes(zero_block, output, remaining_bit);
+        }
     } else {
         Logger::FatalLog(LOC, "Unsupported termination bitsize: " + ToString(remaining_bit));
         std::exit(EXIT_FAILURE);
@@ -1,9 +1,16 @@
 #ifndef FSS_DPF_EVAL_H_
 #define FSS_DPF_EVAL_H_
 
+#include <functional>
+#include <memory>
+#include <span>
+
 #include "dpf_key.h"
 
 namespace ringoa {
+
+class ThreadPool;
+
 namespace fss {
 
 namespace prg {
@@ -14,6 +21,8 @@ class PseudoRandomGenerator;
 
 namespace dpf {
 
+struct DpfSpecialization;
+
 /**
  * DpfEvaluator — evaluate Distributed Point Function (DPF) keys.
  *
@@ -22,6 +31,8 @@ namespace dpf {
  * - EvaluateFullDomain(key, outputs)
  *   • std::vector<block>& : internal 128-bit blocks for engine use
  *   • std::vector<uint64_t>& : flattened numeric outputs (e ≤ 64)
+ * - EvaluateFullDomain(keys, outputs)
+ *   • several keys at once; outputs[k] receives the evaluation of keys[k]
  *
  * Output semantics (match DpfParameters::GetOutputType()):
  * - OutputType::kShiftedAdditive :
@@ -33,9 +44,14 @@ namespace dpf {
  * - Naive: full tree, no early termination.
  * - Optimized (ET): expand only nu = GetTerminateBitsize() levels, then finish via PRG.
  * - Depth-First / Single-Batch variants exist for full-domain enumeration to trade time vs memory.
+ * - HalfTree (ET): half-tree keys from DpfKeyGenerator; one HalfTreeHash per node instead of
+ *   two PRG calls, the right child being parent ^ left child. Leaves use the same ET packing.
+ *   Full-domain evaluation is breadth-first in the caller's buffer on the calling thread.
  *
  * Complexity
  * - EvaluateAt: O(n) seed expansions.
+ * - EvaluateAt(keys, x, outputs): same count per key, but all keys advance one level at a
+ *   time in lanes of GetPreferredBatchSize(), expanding only the child on each key's path.
  * - Full-domain: O(2^n) evaluations; memory
  *     • recursion/single-batch: O(2^n) output storage
  *     • depth-first: O(n) working memory (+ output sink).
@@ -60,6 +76,53 @@ namespace dpf {
  * Determinism & PRG
  * - Deterministic for a fixed key and params. Pseudo-randomness comes from prg::PseudoRandomGenerator.
  *
+ * Thread safety
+ * - All evaluation methods are const and only read the shared, immutable PRG, so one
+ *   evaluator can serve many threads at once. Configure SetNumThreads/SetSplitDepth
+ *   before sharing it.
+ *
+ * Compile-time specialisations
+ * - If (n, nu, OutputType) is in the set compiled into DpfEvaluatorT (see dpf_eval_t.h),
+ *   EvaluateAt and single-threaded EvaluateFullDomain(key, outputs) of kHybridBatched keys run
+ *   the specialised code: unrolled levels, constant leaf width, no heap-allocated seed stack.
+ *
+ * Parallel full-domain (kHybridBatched only)
+ * - Subtrees are walked in lockstep, one lane per subtree; the lane count follows the PRG
+ *   backend (8 for AES-NI, 16/32 for VAES, see PseudoRandomGenerator::GetPreferredBatchSize).
+ * - SetNumThreads(t) with t > 1 splits the tree at depth SetSplitDepth(s) and hands the
+ *   2^s subtrees, one lane batch at a time, to a ThreadPool owned by the evaluator.
+ * - Each subtree writes a disjoint contiguous range of the caller's vector, so the output
+ *   is bit-identical to the single-threaded evaluation for any lane count.
+ * - Split depth 0 (default) picks the smallest s giving at least 4 batches per thread,
+ *   capped at nu. Copies of an evaluator share the same pool.
+ *
+ * Streaming full-domain
+ * - StreamFullDomain(keys, consumer) hands the leaves to 'consumer' in small chunks
+ *   (consumer(k, first, leaves) receives leaves [first, first + leaves.size()) of keys[k])
+ *   instead of writing a 2^nu output vector; a chunk stays in L1 until it is consumed.
+ * - VisitFullDomain(key, visitor) / VisitFullDomain(keys, visitor) call visitor(j, leaf) /
+ *   visitor(k, j, leaf) once per leaf; the visitor is inlined into the per-chunk loop.
+ * - Leaves arrive in lane order, not index order, so consumers must not depend on order
+ *   (dot products and other commutative reductions are fine).
+ * - Runs on the calling thread; for kHybridBatched no 2^nu buffer is allocated. Other
+ *   evaluation types materialise one key at a time and stream from that buffer.
+ *
+ * Subtree evaluation
+ * - EvaluateSubtrees(keys, firsts, count, outputs) writes leaves [firsts[k], firsts[k] + count)
+ *   of keys[k] to outputs[k], where count is a power of two and firsts[k] a multiple of it
+ *   (one subtree per key). The subtrees of all keys share the lane batches, so a caller can
+ *   expand and consume a few leaves of many keys at a time instead of their full domains.
+ * - The walk to each subtree root costs log2(2^nu / count) node expansions per key, for
+ *   kHalfTree keys too (one HalfTreeHash per level, as in EvaluateAt).
+ *
+ * Multi-key full-domain (kHybridBatched only)
+ * - EvaluateFullDomain(keys, outputs) walks the trees of all keys in lockstep: the
+ *   subtrees of every key are packed into the same lane batches, so a pair of keys
+ *   (the usual prev/next case) fills the AES pipeline with half the tree depth per key.
+ * - Keys must share this evaluator's parameters; party IDs may differ between keys.
+ * - Results are identical to calling EvaluateFullDomain(keys[k], outputs[k]) per key.
+ *   Other evaluation types fall back to exactly that loop.
+ *
  */
 
 class DpfEvaluator {
@@ -69,18 +132,62 @@ public:
 
     uint64_t EvaluateAt(const DpfKey &key, uint64_t x) const;
     void     EvaluateAt(const std::vector<DpfKey> &keys, const std::vector<uint64_t> &x, std::vector<uint64_t> &outputs) const;
+    void     EvaluateAt(std::span<const DpfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const;
 
     void EvaluateFullDomain(const DpfKey &key, std::vector<block> &outputs) const;
     void EvaluateFullDomain(const DpfKey &key, std::vector<uint64_t> &outputs) const;
+    void EvaluateFullDomain(std::span<const DpfKey> keys, std::span<std::vector<block>> outputs) const;
+    void EvaluateFullDomain(std::span<const DpfKey *const> keys, std::span<std::vector<block> *const> outputs) const;
+    void EvaluateFullDomain(std::span<const DpfKey *const> keys, std::span<std::vector<uint64_t> *const> outputs) const;
+
+    // Receives leaves [first_index, first_index + leaves.size()) of keys[key_index].
+    using LeafConsumer = std::function<void(uint64_t key_index, uint64_t first_index, std::span<const block> leaves)>;
+
+    void StreamFullDomain(std::span<const DpfKey *const> keys, const LeafConsumer &consumer) const;
+
+    void EvaluateSubtrees(std::span<const DpfKey *const> keys,
+                          std::span<const uint64_t>      firsts,
+                          const uint64_t                 count,
+                          std::span<block *const>        outputs) const;
+
+    template <typename Visitor>
+    void VisitFullDomain(std::span<const DpfKey *const> keys, Visitor &&visitor) const {
+        StreamFullDomain(keys, [&visitor](uint64_t key_index, uint64_t first_index, std::span<const block> leaves) {
+            for (uint64_t j = 0; j < leaves.size(); ++j) {
+                visitor(key_index, first_index + j, leaves[j]);
+            }
+        });
+    }
+    template <typename Visitor>
+    void VisitFullDomain(const DpfKey &key, Visitor &&visitor) const {
+        const std::array<const DpfKey *, 1> keys{&key};
+        VisitFullDomain(keys, [&visitor](uint64_t, uint64_t index, const block &leaf) { visitor(index, leaf); });
+    }
+
+    void     SetNumThreads(const uint64_t num_threads);
+    void     SetSplitDepth(const uint64_t split_depth);
+    uint64_t GetNumThreads() const {
+        return num_threads_;
+    }
+    uint64_t GetSplitDepth() const {
+        return split_depth_;
+    }
 
 private:
-    DpfParameters               params_;
-    prg::PseudoRandomGenerator &G_;
+    DpfParameters                     params_;
+    const prg::PseudoRandomGenerator &G_;
+    uint64_t                          num_threads_;
+    uint64_t                          split_depth_;
+    std::shared_ptr<ThreadPool>       pool_;
+    const DpfSpecialization          *spec_;
 
     bool ValidateInput(const uint64_t x) const;
 
     uint64_t EvaluateAtNaive(const DpfKey &key, uint64_t x) const;
     uint64_t EvaluateAtOptimized(const DpfKey &key, uint64_t x) const;
+    uint64_t EvaluateAtHalfTree(const DpfKey &key, uint64_t x) const;
+    template <size_t N>
+    void EvaluateAtBatched(std::span<const DpfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const;
 
     void EvaluateNextSeed(
         const uint64_t current_level, const block &current_seed, const bool &current_control_bit,
@@ -89,6 +196,31 @@ private:
 
     void FullDomainRecursive(const DpfKey &key, std::vector<block> &outputs) const;
     void FullDomainHybridBatched(const DpfKey &key, std::vector<block> &outputs) const;
+    void FullDomainHybridBatched(std::span<const DpfKey *const>      keys,
+                                 std::span<std::vector<block> *const> outputs,
+                                 const LeafConsumer                  *consumer = nullptr) const;
+    template <size_t N>
+    void FullDomainHybridBatchedLanes(std::span<const DpfKey *const>      keys,
+                                      std::span<std::vector<block> *const> outputs,
+                                      const LeafConsumer                  *consumer) const;
+    template <size_t N>
+    void EvaluateSubtreesLanes(std::span<const DpfKey *const> keys,
+                               std::span<const uint64_t>      firsts,
+                               const uint64_t                 count,
+                               std::span<block *const>        outputs) const;
+    template <size_t N>
+    void ExpandSubtreesBatched(const uint64_t                       start_level,
+                               const std::array<const DpfKey *, N> &keys,
+                               const std::array<block, N>          &root_seeds,
+                               const std::array<bool, N>           &root_control_bits,
+                               const std::array<block *, N>        &outputs,
+                               const uint64_t                       index_mask = ~0ULL,
+                               const std::function<void(uint64_t)> *flush      = nullptr) const;
+    void FullDomainHalfTree(const DpfKey &key, std::vector<block> &outputs) const;
+    void ExpandHalfTreeSubtree(const DpfKey &key, const uint64_t start_level, const block &root_seed, block *outputs) const;
+    template <size_t N>
+    void     ExpandHalfTreeSubtreeLanes(const DpfKey &key, const uint64_t start_level, const block &root_seed, block *outputs) const;
+    uint64_t ResolveSplitDepth(const uint64_t num_keys, const uint64_t lanes, const bool use_pool = true) const;
     void FullDomainIterative(const DpfKey &key, std::vector<uint64_t> &outputs) const;
     void FullDomainBruteforce(const DpfKey &key, std::vector<uint64_t> &outputs) const;
 
@@ -99,6 +231,7 @@ private:
                   std::vector<block> &outputs) const;
 
     block ComputeOutputBlock(const block &final_seed, bool final_control_bit, const DpfKey &key) const;
+    block CorrectOutputBlock(const block &expanded_seed, bool final_control_bit, const DpfKey &key) const;
 };
 
 }    // namespace dpf
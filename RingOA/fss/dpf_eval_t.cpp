@@ -0,0 +1,275 @@
+#include "dpf_eval_t.h"
+
+#include <bit>
+#include <utility>
+
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+#include "prg.h"
+
+namespace ringoa {
+namespace fss {
+namespace dpf {
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+DpfEvaluatorT<N, NU, Mode>::DpfEvaluatorT(const DpfParameters &params)
+    : G_(prg::PseudoRandomGenerator::GetInstance()),
+      element_bitsize_(params.GetOutputBitsize()) {
+    EvalType eval_type = params.GetEvalType();
+    if (params.GetInputBitsize() != N || params.GetTerminateBitsize() != NU || params.GetOutputType() != Mode ||
+        !params.GetEnableEarlyTermination() || (eval_type != EvalType::kRecursive && eval_type != EvalType::kHybridBatched)) {
+        throw std::invalid_argument("DpfEvaluatorT<" + ToString(N) + ", " + ToString(NU) + ", " + GetOutputTypeString(Mode) +
+                                    ">: parameters do not match " + params.GetParametersInfo());
+    }
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+uint64_t DpfEvaluatorT<N, NU, Mode>::EvaluateAt(const DpfKey &key, uint64_t x) const {
+    if (x >= (1ULL << N)) {
+        throw std::invalid_argument("DpfEvaluatorT::EvaluateAt: invalid input x=" + ToString(x) +
+                                    " (expected 0 <= x < 2^" + ToString(N) + ")");
+    }
+
+    // Get the seed and control bit from the given DPF key
+    block seed        = key.init_seed;
+    bool  control_bit = key.party_id != 0;
+
+    // One instantiation per level, expanding only the child on the path of x
+    [&]<uint64_t... Level>(std::integer_sequence<uint64_t, Level...>) {
+        (EvaluateNextSeed<Level>(key, x, seed, control_bit), ...);
+    }(std::make_integer_sequence<uint64_t, NU>{});
+
+    // Compute the final output
+    G_.Expand(seed, seed, prg::Side::kLeft);
+    block    output_block = CorrectLeaf(seed, control_bit, key);
+    uint64_t output       = GetLeafValue(output_block, GetLowerNBits(x, kRemainingBit));
+    return Mod2N(output, element_bitsize_);
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+void DpfEvaluatorT<N, NU, Mode>::EvaluateFullDomain(const DpfKey &key, std::vector<block> &outputs) const {
+    // Check output vector size
+    if (outputs.size() != kNumLeaves) {
+        Logger::FatalLog(LOC, "Output vector size does not match the number of nodes: " + ToString(kNumLeaves));
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Lane count follows the PRG backend, capped by the number of subtrees. The guard keeps
+    // lane widths above kNumLeaves, which DispatchLanes never picks, uninstantiated.
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), kNumLeaves, [&]<size_t L>() {
+        if constexpr (L <= kNumLeaves) {
+            FullDomainLanes<L>(key, outputs.data());
+        }
+    });
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+template <uint64_t Level>
+void DpfEvaluatorT<N, NU, Mode>::EvaluateNextSeed(const DpfKey &key, uint64_t x, block &seed, bool &control_bit) const {
+    constexpr uint64_t kShift = N - Level - 1;
+
+    bool  current_bit = (x >> kShift) & 1ULL;
+    block child;
+    G_.Expand(seed, child, current_bit ? prg::Side::kRight : prg::Side::kLeft);
+
+    // Apply correction word if control bit is true
+    bool cw_control = key.GetControlBit(Level, current_bit);
+    bool next_bit   = GetLsb(child) ^ (cw_control & control_bit);
+    SetLsbZero(child);
+    seed        = child ^ (key.cw_seed[Level] & zero_and_all_one[control_bit]);
+    control_bit = next_bit;
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+template <size_t L>
+void DpfEvaluatorT<N, NU, Mode>::FullDomainLanes(const DpfKey &key, block *outputs) const {
+    constexpr uint64_t kSplitDepth = std::bit_width(L) - 1;
+
+    // Breadth-first down to depth log2(L) in place: node j of a level expands to (2j, 2j + 1),
+    // highest index first. This leaves one subtree root per lane, in index order.
+    std::array<block, L> seeds;
+    std::array<bool, L>  control_bits;
+    seeds[0]        = key.init_seed;
+    control_bits[0] = key.party_id != 0;
+    for (uint64_t level = 0; level < kSplitDepth; ++level) {
+        for (uint64_t j = 1ULL << level; j-- > 0;) {
+            std::array<block, 2> expanded_seeds;
+            G_.DoubleExpand(seeds[j], expanded_seeds);
+            block mask      = key.cw_seed[level] & zero_and_all_one[control_bits[j]];
+            bool  left_bit  = GetLsb(expanded_seeds[kLeft]) ^ (key.GetControlLeft(level) & control_bits[j]);
+            bool  right_bit = GetLsb(expanded_seeds[kRight]) ^ (key.GetControlRight(level) & control_bits[j]);
+            SetLsbZero(expanded_seeds[kLeft]);
+            SetLsbZero(expanded_seeds[kRight]);
+            seeds[2 * j]            = expanded_seeds[kLeft] ^ mask;
+            seeds[2 * j + 1]        = expanded_seeds[kRight] ^ mask;
+            control_bits[2 * j]     = left_bit;
+            control_bits[2 * j + 1] = right_bit;
+        }
+    }
+
+    // Depth-first below the split, all L subtrees in lockstep
+    ExpandLanes<L, kSplitDepth>(key, seeds, control_bits, outputs, 0);
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+template <size_t L, uint64_t Level>
+void DpfEvaluatorT<N, NU, Mode>::ExpandLanes(const DpfKey               &key,
+                                             const std::array<block, L> &seeds,
+                                             const std::array<bool, L>  &control_bits,
+                                             block                      *outputs,
+                                             const uint64_t              index) const {
+    constexpr uint64_t kSubtreeSize = kNumLeaves / L;
+
+    if constexpr (Level == NU) {
+        // Seed expansion and correction for the final output; lane i owns subtree i
+        std::array<block, L> leaves;
+        G_.Expand<L>(seeds, leaves, prg::Side::kLeft);
+        for (size_t i = 0; i < L; ++i) {
+            outputs[i * kSubtreeSize + index] = CorrectLeaf(leaves[i], control_bits[i], key);
+        }
+    } else {
+        for (prg::Side side : {prg::Side::kLeft, prg::Side::kRight}) {
+            bool                 right      = side == prg::Side::kRight;
+            bool                 cw_control = key.GetControlBit(Level, right);
+            std::array<block, L> child_seeds;
+            std::array<bool, L>  child_control_bits;
+            G_.Expand<L>(seeds, child_seeds, side);
+
+            // Apply correction word if control bit is true
+            for (size_t i = 0; i < L; ++i) {
+                child_control_bits[i] = GetLsb(child_seeds[i]) ^ (cw_control & control_bits[i]);
+                SetLsbZero(child_seeds[i]);
+                child_seeds[i] ^= key.cw_seed[Level] & zero_and_all_one[control_bits[i]];
+            }
+            ExpandLanes<L, Level + 1>(key, child_seeds, child_control_bits, outputs, 2 * index + right);
+        }
+    }
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+block DpfEvaluatorT<N, NU, Mode>::CorrectLeaf(const block &expanded_seed, bool control_bit, const DpfKey &key) const {
+    block correction = zero_and_all_one[control_bit] & key.output;
+    if constexpr (kRemainingBit == 7) {
+        return expanded_seed ^ correction;
+    } else {
+        block output = AddLanes(expanded_seed, correction, kRemainingBit);
+        return key.party_id ? SubLanes(zero_block, output, kRemainingBit) : output;
+    }
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+uint64_t DpfEvaluatorT<N, NU, Mode>::GetLeafValue(const block &leaf, uint64_t x_hat) const {
+    if constexpr (Mode == OutputType::kSingleBitMask) {
+        // Bit (x_hat / 16) of byte (x_hat % 16)
+        auto bytes = reinterpret_cast<const uint8_t *>(&leaf);
+        return (bytes[x_hat % 16] >> (x_hat / 16)) & 1ULL;
+    } else {
+        constexpr uint64_t kLaneBits = 128 >> kRemainingBit;
+        uint64_t           bit       = x_hat * kLaneBits;
+        uint64_t           word      = leaf.get<uint64_t>()[bit >> 6];
+        if constexpr (kLaneBits == 64) {
+            return word;
+        } else {
+            return (word >> (bit & 63)) & ((1ULL << kLaneBits) - 1);
+        }
+    }
+}
+
+// Instantiated set: every leaf width for n in kSpecializedInputBitsizes
+template class DpfEvaluatorT<16, 15, OutputType::kShiftedAdditive>;    // 64-bit lanes
+template class DpfEvaluatorT<16, 14, OutputType::kShiftedAdditive>;    // 32-bit lanes
+template class DpfEvaluatorT<16, 13, OutputType::kShiftedAdditive>;    // 16-bit lanes
+template class DpfEvaluatorT<16, 12, OutputType::kShiftedAdditive>;    // 8-bit lanes
+template class DpfEvaluatorT<16, 9, OutputType::kShiftedAdditive>;     // 1-bit lanes
+template class DpfEvaluatorT<16, 9, OutputType::kSingleBitMask>;       // 1-bit lanes
+template class DpfEvaluatorT<20, 19, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<20, 18, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<20, 17, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<20, 16, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<20, 13, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<20, 13, OutputType::kSingleBitMask>;
+template class DpfEvaluatorT<24, 23, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<24, 22, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<24, 21, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<24, 20, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<24, 17, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<24, 17, OutputType::kSingleBitMask>;
+template class DpfEvaluatorT<28, 27, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<28, 26, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<28, 25, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<28, 24, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<28, 21, OutputType::kShiftedAdditive>;
+template class DpfEvaluatorT<28, 21, OutputType::kSingleBitMask>;
+
+namespace {
+
+struct SpecializationEntry {
+    uint64_t          input_bitsize;
+    uint64_t          terminate_bitsize;
+    OutputType        output_type;
+    DpfSpecialization specialization;
+};
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+uint64_t EvaluateAtT(const DpfParameters &params, const DpfKey &key, uint64_t x) {
+    return DpfEvaluatorT<N, NU, Mode>(params).EvaluateAt(key, x);
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+void EvaluateFullDomainT(const DpfParameters &params, const DpfKey &key, std::vector<block> &outputs) {
+    DpfEvaluatorT<N, NU, Mode>(params).EvaluateFullDomain(key, outputs);
+}
+
+template <uint64_t N, uint64_t NU, OutputType Mode>
+constexpr SpecializationEntry MakeEntry() {
+    return {N, NU, Mode, {&EvaluateAtT<N, NU, Mode>, &EvaluateFullDomainT<N, NU, Mode>}};
+}
+
+// The instantiations above for one input bitsize
+template <uint64_t N>
+constexpr std::array<SpecializationEntry, 6> MakeEntries() {
+    return {
+        MakeEntry<N, N - 1, OutputType::kShiftedAdditive>(),
+        MakeEntry<N, N - 2, OutputType::kShiftedAdditive>(),
+        MakeEntry<N, N - 3, OutputType::kShiftedAdditive>(),
+        MakeEntry<N, N - 4, OutputType::kShiftedAdditive>(),
+        MakeEntry<N, N - 7, OutputType::kShiftedAdditive>(),
+        MakeEntry<N, N - 7, OutputType::kSingleBitMask>(),
+    };
+}
+
+template <size_t... I>
+constexpr auto MakeTable(std::index_sequence<I...>) {
+    std::array<SpecializationEntry, 6 * sizeof...(I)> table{};
+    size_t                                             pos = 0;
+    for (const auto &entries : {MakeEntries<kSpecializedInputBitsizes[I]>()...}) {
+        for (const SpecializationEntry &entry : entries) {
+            table[pos++] = entry;
+        }
+    }
+    return table;
+}
+
+constexpr auto kSpecializations = MakeTable(std::make_index_sequence<kSpecializedInputBitsizes.size()>{});
+
+}    // namespace
+
+const DpfSpecialization *FindDpfSpecialization(const DpfParameters &params) {
+    EvalType eval_type = params.GetEvalType();
+    if (!params.GetEnableEarlyTermination() || (eval_type != EvalType::kRecursive && eval_type != EvalType::kHybridBatched)) {
+        return nullptr;
+    }
+    for (const SpecializationEntry &entry : kSpecializations) {
+        if (entry.input_bitsize == params.GetInputBitsize() &&
+            entry.terminate_bitsize == params.GetTerminateBitsize() &&
+            entry.output_type == params.GetOutputType()) {
+            return &entry.specialization;
+        }
+    }
+    return nullptr;
+}
+
+}    // namespace dpf
+}    // namespace fss
+}    // namespace ringoa
@@ -0,0 +1,109 @@
+#ifndef FSS_DPF_EVAL_T_H_
+#define FSS_DPF_EVAL_T_H_
+
+#include <array>
+#include <vector>
+
+#include "dpf_key.h"
+
+namespace ringoa {
+namespace fss {
+
+namespace prg {
+
+class PseudoRandomGenerator;
+
+}    // namespace prg
+
+namespace dpf {
+
+/**
+ * DpfEvaluatorT — DPF evaluation specialised at compile time for a fixed (n, nu, OutputType).
+ *
+ * Overview
+ * - N (input bitsize), NU (terminate bitsize) and Mode are template parameters, so the tree
+ *   depth, the leaf lane width (128 >> (N - NU) bits) and the number of leaves are constants.
+ * - Every tree level is its own instantiation (fully unrolled), the leaf correction and lane
+ *   extraction have no branch on the lane width, and the per-level seed stack of the
+ *   full-domain walk lives in fixed-size arrays on the stack.
+ * - Evaluates keys of the standard early-termination tree (EvalType::kRecursive and
+ *   kHybridBatched); results are bit-identical to DpfEvaluator.
+ *
+ * Instantiated set
+ * - Member definitions live in dpf_eval_t.cpp, explicitly instantiated for every n in
+ *   kSpecializedInputBitsizes and every leaf width (N - NU in {1, 2, 3, 4, 7}, both output
+ *   types for 7). Other combinations do not link.
+ * - FindDpfSpecialization(params) maps runtime parameters to that set. DpfEvaluator uses it
+ *   for EvaluateAt and single-threaded full-domain evaluation of kHybridBatched keys and keeps
+ *   the generic code for everything else.
+ *
+ * Usage
+ *   DpfParameters params(24, 1);                                              // nu = 17
+ *   DpfEvaluatorT<24, 17, OutputType::kShiftedAdditive> eval(params);
+ *   std::vector<block> outputs(1U << 17);
+ *   eval.EvaluateFullDomain(key, outputs);
+ *
+ * Notes
+ * - The constructor throws std::invalid_argument if params do not match (N, NU, Mode).
+ * - Full-domain evaluation runs on the calling thread with one lane per subtree
+ *   (8 / 16 / 32 lanes, following PseudoRandomGenerator::GetPreferredBatchSize).
+ */
+template <uint64_t N, uint64_t NU, OutputType Mode>
+class DpfEvaluatorT {
+public:
+    static constexpr uint64_t kInputBitsize     = N;
+    static constexpr uint64_t kTerminateBitsize = NU;
+    static constexpr uint64_t kRemainingBit     = N - NU;
+    static constexpr uint64_t kNumLeaves        = 1ULL << NU;
+
+    static_assert(NU <= N && N <= 32, "DpfEvaluatorT requires NU <= N <= 32");
+    static_assert(NU >= 3, "DpfEvaluatorT requires at least 8 subtrees (NU >= 3)");
+    static_assert((kRemainingBit >= 1 && kRemainingBit <= 4) || kRemainingBit == 7,
+                  "DpfEvaluatorT requires N - NU in {1, 2, 3, 4, 7}");
+    static_assert(Mode == OutputType::kShiftedAdditive || kRemainingBit == 7,
+                  "OutputType::kSingleBitMask requires N - NU == 7");
+
+    DpfEvaluatorT() = delete;
+    explicit DpfEvaluatorT(const DpfParameters &params);
+
+    uint64_t EvaluateAt(const DpfKey &key, uint64_t x) const;
+    void     EvaluateFullDomain(const DpfKey &key, std::vector<block> &outputs) const;
+
+private:
+    const prg::PseudoRandomGenerator &G_;
+    uint64_t                          element_bitsize_;
+
+    template <uint64_t Level>
+    void EvaluateNextSeed(const DpfKey &key, uint64_t x, block &seed, bool &control_bit) const;
+
+    template <size_t L>
+    void FullDomainLanes(const DpfKey &key, block *outputs) const;
+    template <size_t L, uint64_t Level>
+    void ExpandLanes(const DpfKey               &key,
+                     const std::array<block, L> &seeds,
+                     const std::array<bool, L>  &control_bits,
+                     block                      *outputs,
+                     const uint64_t              index) const;
+
+    block    CorrectLeaf(const block &expanded_seed, bool control_bit, const DpfKey &key) const;
+    uint64_t GetLeafValue(const block &leaf, uint64_t x_hat) const;
+};
+
+// Type-erased entry points of one instantiated DpfEvaluatorT.
+struct DpfSpecialization {
+    uint64_t (*evaluate_at)(const DpfParameters &params, const DpfKey &key, uint64_t x);
+    void (*evaluate_full_domain)(const DpfParameters &params, const DpfKey &key, std::vector<block> &outputs);
+};
+
+// Input bitsizes with a compiled DpfEvaluatorT (every leaf width each).
+inline constexpr std::array<uint64_t, 4> kSpecializedInputBitsizes = {16, 20, 24, 28};
+
+// Returns the specialisation matching params, or nullptr if (n, nu, OutputType) is not
+// instantiated or params do not describe a standard early-termination tree.
+const DpfSpecialization *FindDpfSpecialization(const DpfParameters &params);
+
+}    // namespace dpf
+}    // namespace fss
+}    // namespace ringoa
+
+#endif    // FSS_DPF_EVAL_T_H_
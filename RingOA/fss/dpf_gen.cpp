@@ -35,7 +35,9 @@ std::pair<DpfKey, DpfKey> DpfKeyGenerator::GenerateKeys(const uint64_t alpha, co
     std::pair<DpfKey, DpfKey> key_pair = std::make_pair(std::move(key_0), std::move(key_1));
 
     // Generate the DPF key
-    if (params_.GetEnableEarlyTermination()) {
+    if (params_.GetEvalType() == EvalType::kHalfTree) {
+        GenerateKeysHalfTree(alpha, beta, key_pair);
+    } else if (params_.GetEnableEarlyTermination()) {
         GenerateKeysOptimized(alpha, beta, key_pair);
     } else {
         GenerateKeysNaive(alpha, beta, key_pair);
@@ -64,7 +66,9 @@ std::pair<DpfKey, DpfKey> DpfKeyGenerator::GenerateKeys(const uint64_t alpha, co
     std::pair<DpfKey, DpfKey> key_pair = std::make_pair(std::move(key_0), std::move(key_1));
 
     // Generate the DPF key
-    if (params_.GetEnableEarlyTermination()) {
+    if (params_.GetEvalType() == EvalType::kHalfTree) {
+        GenerateKeysHalfTree(alpha, beta, final_seed_0, final_seed_1, final_control_bit_1, key_pair);
+    } else if (params_.GetEnableEarlyTermination()) {
         GenerateKeysOptimized(alpha, beta, final_seed_0, final_seed_1, final_control_bit_1, key_pair);
     } else {
         GenerateKeysNaive(alpha, beta, final_seed_0, final_seed_1, final_control_bit_1, key_pair);
@@ -73,6 +77,141 @@ std::pair<DpfKey, DpfKey> DpfKeyGenerator::GenerateKeys(const uint64_t alpha, co
     return key_pair;
 }
 
+void DpfKeyGenerator::GenerateKeys(const std::vector<uint64_t>           &alphas,
+                                   const std::vector<uint64_t>           &betas,
+                                   std::vector<std::pair<DpfKey, DpfKey>> &key_pairs) const {
+    std::vector<block> final_seeds_0, final_seeds_1;
+    std::vector<bool>  final_control_bits_1;
+    GenerateKeys(alphas, betas, key_pairs, final_seeds_0, final_seeds_1, final_control_bits_1);
+}
+
+void DpfKeyGenerator::GenerateKeys(const std::vector<uint64_t>           &alphas,
+                                   const std::vector<uint64_t>           &betas,
+                                   std::vector<std::pair<DpfKey, DpfKey>> &key_pairs,
+                                   std::vector<block>                     &final_seeds_0,
+                                   std::vector<block>                     &final_seeds_1,
+                                   std::vector<bool>                      &final_control_bits_1) const {
+    if (alphas.size() != betas.size()) {
+        throw std::invalid_argument("DpfKeyGenerator::GenerateKeys: " + ToString(alphas.size()) + " alphas but " +
+                                    ToString(betas.size()) + " betas");
+    }
+    const uint64_t num_keys = alphas.size();
+    key_pairs.clear();
+    key_pairs.reserve(num_keys);
+    final_seeds_0.assign(num_keys, zero_block);
+    final_seeds_1.assign(num_keys, zero_block);
+    final_control_bits_1.assign(num_keys, false);
+
+    // Only the early-termination tree has a batched walk; other strategies use the scalar one
+    if (params_.GetEvalType() == EvalType::kHalfTree || !params_.GetEnableEarlyTermination()) {
+        for (uint64_t i = 0; i < num_keys; ++i) {
+            bool final_control_bit_1 = false;
+            key_pairs.push_back(GenerateKeys(alphas[i], betas[i], final_seeds_0[i], final_seeds_1[i], final_control_bit_1));
+            final_control_bits_1[i] = final_control_bit_1;
+        }
+        return;
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Generate " + ToString(num_keys) + " DPF keys (batched approach)"));
+#endif
+
+    // Initialize the DPF keys (same draw order as the scalar path)
+    for (uint64_t i = 0; i < num_keys; ++i) {
+        if (!ValidateInput(alphas[i], betas[i])) {
+            Logger::FatalLog(LOC, "Invalid input values: alpha=" + ToString(alphas[i]) + ", beta=" + ToString(betas[i]));
+            std::exit(EXIT_FAILURE);
+        }
+        key_pairs.emplace_back(DpfKey(0, params_), DpfKey(1, params_));
+        key_pairs[i].first.init_seed  = GlobalRng::Rand<block>();
+        key_pairs[i].second.init_seed = GlobalRng::Rand<block>();
+    }
+
+    // Lane count follows the PRG backend, capped by the number of keys
+    prg::DispatchLanes(G_.GetPreferredBatchSize(), num_keys, [&]<size_t N>() {
+        GenerateKeysBatched<N>(alphas, key_pairs, final_seeds_0, final_seeds_1, final_control_bits_1);
+    });
+
+    // Set the outputs
+    OutputType mode = params_.GetOutputType();
+    for (uint64_t i = 0; i < num_keys; ++i) {
+        if (mode == OutputType::kShiftedAdditive) {
+            ComputeAdditiveShiftedOutput(alphas[i], betas[i], final_seeds_0[i], final_seeds_1[i], final_control_bits_1[i], key_pairs[i]);
+        } else if (mode == OutputType::kSingleBitMask) {
+            ComputeSingleBitMaskOutput(alphas[i], final_seeds_0[i], final_seeds_1[i], key_pairs[i]);
+        } else {
+            Logger::FatalLog(LOC, "Invalid output mode: " + GetOutputTypeString(mode));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+template <size_t N>
+void DpfKeyGenerator::GenerateKeysBatched(const std::vector<uint64_t>           &alphas,
+                                          std::vector<std::pair<DpfKey, DpfKey>> &key_pairs,
+                                          std::vector<block>                     &final_seeds_0,
+                                          std::vector<block>                     &final_seeds_1,
+                                          std::vector<bool>                      &final_control_bits_1) const {
+    uint64_t n  = params_.GetInputBitsize();
+    uint64_t nu = params_.GetTerminateBitsize();
+
+    std::array<block, N>                seeds_0, seeds_1;
+    std::array<std::array<block, N>, 2> expanded_0, expanded_1;    // expanded_x[left or right][lane]
+    std::array<bool, N>                 control_bits_0, control_bits_1;
+
+    for (std::size_t base = 0; base < alphas.size(); base += N) {
+        // Load N key pairs; unused lanes of a short last batch expand zero seeds and are dropped
+        std::size_t num_lanes = std::min<std::size_t>(N, alphas.size() - base);
+        for (uint64_t i = 0; i < N; ++i) {
+            seeds_0[i]        = i < num_lanes ? key_pairs[base + i].first.init_seed : zero_block;
+            seeds_1[i]        = i < num_lanes ? key_pairs[base + i].second.init_seed : zero_block;
+            control_bits_0[i] = false;
+            control_bits_1[i] = true;
+        }
+
+        for (uint64_t level = 0; level < nu; ++level) {
+            // Expand the seeds of both parties with both keys
+            G_.Expand<N>(seeds_0, expanded_0[kLeft], prg::Side::kLeft);
+            G_.Expand<N>(seeds_0, expanded_0[kRight], prg::Side::kRight);
+            G_.Expand<N>(seeds_1, expanded_1[kLeft], prg::Side::kLeft);
+            G_.Expand<N>(seeds_1, expanded_1[kRight], prg::Side::kRight);
+
+            // Same steps as GenerateNextSeed; keep/lose index the arrays so random alpha bits do not branch
+            for (uint64_t i = 0; i < num_lanes; ++i) {
+                bool                keep = (alphas[base + i] >> (n - level - 1)) & 1ULL, lose = !keep;
+                std::array<bool, 2> expanded_control_bit_0{GetLsb(expanded_0[kLeft][i]), GetLsb(expanded_0[kRight][i])};
+                std::array<bool, 2> expanded_control_bit_1{GetLsb(expanded_1[kLeft][i]), GetLsb(expanded_1[kRight][i])};
+                SetLsbZero(expanded_0[kLeft][i]);
+                SetLsbZero(expanded_0[kRight][i]);
+                SetLsbZero(expanded_1[kLeft][i]);
+                SetLsbZero(expanded_1[kRight][i]);
+
+                // Correction word: seed of the lose side, control bits of both sides
+                block               seed_correction = expanded_0[lose][i] ^ expanded_1[lose][i];
+                std::array<bool, 2> control_bit_correction{
+                    static_cast<bool>(expanded_control_bit_0[kLeft] ^ expanded_control_bit_1[kLeft] ^ keep ^ 1),
+                    static_cast<bool>(expanded_control_bit_0[kRight] ^ expanded_control_bit_1[kRight] ^ keep)};
+                key_pairs[base + i].first.cw_seed[level]  = seed_correction;
+                key_pairs[base + i].second.cw_seed[level] = seed_correction;
+                key_pairs[base + i].first.SetControlBits(level, control_bit_correction[kLeft], control_bit_correction[kRight]);
+                key_pairs[base + i].second.SetControlBits(level, control_bit_correction[kLeft], control_bit_correction[kRight]);
+
+                // Follow the keep side
+                seeds_0[i]        = expanded_0[keep][i] ^ (seed_correction & zero_and_all_one[control_bits_0[i]]);
+                seeds_1[i]        = expanded_1[keep][i] ^ (seed_correction & zero_and_all_one[control_bits_1[i]]);
+                control_bits_0[i] = expanded_control_bit_0[keep] ^ (control_bits_0[i] & control_bit_correction[keep]);
+                control_bits_1[i] = expanded_control_bit_1[keep] ^ (control_bits_1[i] & control_bit_correction[keep]);
+            }
+        }
+
+        for (uint64_t i = 0; i < num_lanes; ++i) {
+            final_seeds_0[base + i]        = seeds_0[i];
+            final_seeds_1[base + i]        = seeds_1[i];
+            final_control_bits_1[base + i] = control_bits_1[i];
+        }
+    }
+}
+
 void DpfKeyGenerator::GenerateKeysNaive(const uint64_t alpha, const uint64_t beta, std::pair<DpfKey, DpfKey> &key_pair) const {
     block final_seed_0, final_seed_1;
     bool  final_control_bit_1;
@@ -174,6 +313,56 @@ void DpfKeyGenerator::GenerateKeysOptimized(const uint64_t alpha, const uint64_t
 #endif
 }
 
+void DpfKeyGenerator::GenerateKeysHalfTree(const uint64_t alpha, const uint64_t beta, std::pair<DpfKey, DpfKey> &key_pair) const {
+    block final_seed_0, final_seed_1;
+    bool  final_control_bit_1;
+    GenerateKeysHalfTree(alpha, beta, final_seed_0, final_seed_1, final_control_bit_1, key_pair);
+}
+
+void DpfKeyGenerator::GenerateKeysHalfTree(const uint64_t alpha, const uint64_t beta, block &final_seed_0, block &final_seed_1,
+                                           bool &final_control_bit_1, std::pair<DpfKey, DpfKey> &key_pair) const {
+    uint64_t   n    = params_.GetInputBitsize();
+    uint64_t   nu   = params_.GetTerminateBitsize();
+    OutputType mode = params_.GetOutputType();
+
+    // Set the initial seeds; they differ by the global offset delta, whose LSB (the control bit) is 1
+    block delta               = GlobalRng::Rand<block>() | one_block;
+    block seed_0              = GlobalRng::Rand<block>();
+    block seed_1              = seed_0 ^ delta;
+    key_pair.first.init_seed  = seed_0;
+    key_pair.second.init_seed = seed_1;
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+    Logger::TraceLog(LOC, "Delta: " + Format(delta));
+    Logger::TraceLog(LOC, "[P0] Initial seed: " + Format(seed_0));
+    Logger::TraceLog(LOC, "[P1] Initial seed: " + Format(seed_1));
+#endif
+
+    // Generate next seed and compute correction words
+    for (uint64_t i = 0; i < nu; ++i) {
+        bool current_bit = (alpha & (1U << (n - i - 1))) != 0;
+        GenerateNextSeedHalfTree(i, current_bit, delta, seed_0, seed_1, key_pair);
+    }
+    final_seed_0        = seed_0;
+    final_seed_1        = seed_1;
+    final_control_bit_1 = GetLsb(seed_1);
+
+    // Set the output
+    if (mode == OutputType::kShiftedAdditive) {
+        ComputeAdditiveShiftedOutput(alpha, beta, final_seed_0, final_seed_1, final_control_bit_1, key_pair);
+    } else if (mode == OutputType::kSingleBitMask) {
+        ComputeSingleBitMaskOutput(alpha, final_seed_0, final_seed_1, key_pair);
+    } else {
+        Logger::FatalLog(LOC, "Invalid output mode: " + GetOutputTypeString(mode));
+        std::exit(EXIT_FAILURE);
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+    key_pair.first.PrintKey();
+    key_pair.second.PrintKey();
+#endif
+}
+
 bool DpfKeyGenerator::ValidateInput(const uint64_t alpha, const uint64_t beta) const {
     bool valid = true;
     if (alpha >= (1UL << params_.GetInputBitsize()) || beta >= (1UL << params_.GetOutputBitsize())) {
@@ -232,12 +421,10 @@ void DpfKeyGenerator::GenerateNextSeed(const uint64_t current_level, const bool
 #endif
 
     // Set the correction word
-    key_pair.first.cw_seed[current_level]           = seed_correction;
-    key_pair.first.cw_control_left[current_level]   = control_bit_correction[kLeft];
-    key_pair.first.cw_control_right[current_level]  = control_bit_correction[kRight];
-    key_pair.second.cw_seed[current_level]          = seed_correction;
-    key_pair.second.cw_control_left[current_level]  = control_bit_correction[kLeft];
-    key_pair.second.cw_control_right[current_level] = control_bit_correction[kRight];
+    key_pair.first.cw_seed[current_level]  = seed_correction;
+    key_pair.second.cw_seed[current_level] = seed_correction;
+    key_pair.first.SetControlBits(current_level, control_bit_correction[kLeft], control_bit_correction[kRight]);
+    key_pair.second.SetControlBits(current_level, control_bit_correction[kLeft], control_bit_correction[kRight]);
 
     // Update seed and control bits
     current_seed_0        = expanded_seed_0[keep];
@@ -255,6 +442,44 @@ void DpfKeyGenerator::GenerateNextSeed(const uint64_t current_level, const bool
 #endif
 }
 
+void DpfKeyGenerator::GenerateNextSeedHalfTree(const uint64_t current_level, const bool current_bit, const block &delta,
+                                               block &current_seed_0, block &current_seed_1,
+                                               std::pair<DpfKey, DpfKey> &key_pair) const {
+    // Hash the seeds; the left child is the hash and the right child is seed ^ left child
+    block hash_0, hash_1;
+    G_.HalfTreeHash(current_seed_0, hash_0);
+    G_.HalfTreeHash(current_seed_1, hash_1);
+    bool control_bit_0 = GetLsb(current_seed_0);
+    bool control_bit_1 = GetLsb(current_seed_1);
+
+    // Compute seed correction: the lose children become equal, the keep children differ by delta
+    block seed_correction = hash_0 ^ hash_1 ^ (delta & zero_and_all_one[!current_bit]);
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+    std::string level_str = "|Level=" + ToString(current_level) + "| ";
+    Logger::TraceLog(LOC, level_str + "[P0] Hash: " + Format(hash_0));
+    Logger::TraceLog(LOC, level_str + "[P1] Hash: " + Format(hash_1));
+    Logger::TraceLog(LOC, level_str + "Current bit: " + ToString(current_bit));
+    Logger::TraceLog(LOC, level_str + "Seed correction: " + Format(seed_correction));
+#endif
+
+    // Set the correction word
+    key_pair.first.cw_seed[current_level]  = seed_correction;
+    key_pair.second.cw_seed[current_level] = seed_correction;
+
+    // Correct the left children, then derive the kept child (the control bit is its LSB)
+    hash_0 ^= seed_correction & zero_and_all_one[control_bit_0];
+    hash_1 ^= seed_correction & zero_and_all_one[control_bit_1];
+
+    current_seed_0 = current_bit ? current_seed_0 ^ hash_0 : hash_0;
+    current_seed_1 = current_bit ? current_seed_1 ^ hash_1 : hash_1;
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+    Logger::TraceLog(LOC, level_str + "[P0] Next seed: " + Format(current_seed_0));
+    Logger::TraceLog(LOC, level_str + "[P1] Next seed: " + Format(current_seed_1));
+#endif
+}
+
 void DpfKeyGenerator::ComputeAdditiveShiftedOutput(uint64_t alpha, uint64_t beta,
                                                    block &final_seed_0, block &final_seed_1, bool final_control_bit_1,
                                                    std::pair<DpfKey, DpfKey> &key_pair) const {
@@ -275,7 +500,8 @@ void DpfKeyGenerator::ComputeAdditiveShiftedOutput(uint64_t alpha, uint64_t beta
         beta_block = beta_block.mm_slli_si128<8>();    // Shift left by 8 bytes (64 bits)
         beta_block = beta_block << (shift_amount - 64);
     } else {
-        // The shift of the upper bits is not necessary because the beta is 32 bits or less.
+        // The shift of the upper bits is not necessary because beta fits in one lane,
+        // which never straddles the 64-bit halves.
         beta_block = beta_block << shift_amount;
     }
 
@@ -287,22 +513,14 @@ void DpfKeyGenerator::ComputeAdditiveShiftedOutput(uint64_t alpha, uint64_t beta
 #endif
 
     // Set the output block
-    if (remaining_bit == 2) {
-        if (final_control_bit_1) {
-            // Reduce 2 levels (2^2=4 nodes) of the tree (Additive share)
-            output = _mm_sub_epi32(zero_block, _mm_add_epi32(_mm_sub_epi32(beta_block, final_seed_0), final_seed_1));
-        } else {
-            output = _mm_add_epi32(_mm_sub_epi32(beta_block, final_seed_0), final_seed_1);
-        }
-    } else if (remaining_bit == 3) {
-        // Reduce 3 levels (2^3=8 nodes) of the tree (Additive share)
+    if (remaining_bit == 7) {
+        output = beta_block ^ final_seed_0 ^ final_seed_1;
+    } else if (remaining_bit >= 1 && remaining_bit <= 4) {
+        // Reduce 'remaining_bit' levels of the tree into (128 >> remaining_bit)-bit lanes (Additive share)
+        output = AddLanes(SubLanes(beta_block, final_seed_0, remaining_bit), final_seed_1, remaining_bit);
         if (final_control_bit_1) {
-            output = _mm_sub_epi16(zero_block, _mm_add_epi16(_mm_sub_epi16(beta_block, final_seed_0), final_seed_1));
-        } else {
-            output = _mm_add_epi16(_mm_sub_epi16(beta_block, final_seed_0), final_seed_1);
+            output = SubLanes(zero_block, output, remaining_bit);
         }
-    } else if (remaining_bit == 7) {
-        output = beta_block ^ final_seed_0 ^ final_seed_1;
     } else {
         Logger::FatalLog(LOC, "Unsupported termination bitsize: " + ToString(remaining_bit));
         std::exit(EXIT_FAILURE);
@@ -25,12 +25,20 @@ namespace dpf {
  *
  * Behavior:
  *   - Dispatches to a strategy based on params.GetEvalType()
- *     (Naive / Optimized with early termination).
+ *     (Naive / Optimized with early termination / HalfTree).
+ *   - EvalType::kHalfTree builds half-tree keys: the two initial seeds differ by a
+ *     global offset Delta (LSB 1), each level costs one HalfTreeHash per seed, and
+ *     the control bit is the seed LSB, so only cw_seed is used (cw_control stays 0).
  *   - Output semantics depend on params.GetOutputType()
  *     (ShiftedAdditive vs SingleBitMask).
+ *   - GenerateKeys(alphas, betas, ...) builds one key pair per element. Early-termination
+ *     keys walk the tree together in lanes of PseudoRandomGenerator::GetPreferredBatchSize(),
+ *     so every level costs four batched Expand calls per lane group instead of four AES
+ *     calls per key. Initial seeds are drawn from GlobalRng in the same order as repeated
+ *     GenerateKeys(alpha, beta) calls, so both produce the same keys under the same seed.
  *
  * Notes:
- *   - Not thread-safe.
+ *   - Generation may run on several threads at once; each draws from its own GlobalRng.
  *   - Requires 0 <= alpha < 2^n; beta fits e bits (caller responsibility).
  *   - Specialized GenerateKeysNaive/Optimized are provided mainly for testing.
  */
@@ -42,6 +50,16 @@ public:
     std::pair<DpfKey, DpfKey> GenerateKeys(const uint64_t alpha, const uint64_t beta) const;
     std::pair<DpfKey, DpfKey> GenerateKeys(const uint64_t alpha, const uint64_t beta, block &final_seed_0, block &final_seed_1, bool &final_control_bit_1) const;
 
+    void GenerateKeys(const std::vector<uint64_t>           &alphas,
+                      const std::vector<uint64_t>           &betas,
+                      std::vector<std::pair<DpfKey, DpfKey>> &key_pairs) const;
+    void GenerateKeys(const std::vector<uint64_t>           &alphas,
+                      const std::vector<uint64_t>           &betas,
+                      std::vector<std::pair<DpfKey, DpfKey>> &key_pairs,
+                      std::vector<block>                     &final_seeds_0,
+                      std::vector<block>                     &final_seeds_1,
+                      std::vector<bool>                      &final_control_bits_1) const;
+
     void GenerateKeysNaive(const uint64_t alpha, const uint64_t beta, std::pair<DpfKey, DpfKey> &key_pair) const;
     void GenerateKeysNaive(const uint64_t alpha, const uint64_t beta, block &final_seed_0, block &final_seed_1,
                            bool &final_control_bit_1, std::pair<DpfKey, DpfKey> &key_pair) const;
@@ -50,9 +68,13 @@ public:
     void GenerateKeysOptimized(const uint64_t alpha, const uint64_t beta, block &final_seed_0, block &final_seed_1,
                                bool &final_control_bit_1, std::pair<DpfKey, DpfKey> &key_pair) const;
 
+    void GenerateKeysHalfTree(const uint64_t alpha, const uint64_t beta, std::pair<DpfKey, DpfKey> &key_pair) const;
+    void GenerateKeysHalfTree(const uint64_t alpha, const uint64_t beta, block &final_seed_0, block &final_seed_1,
+                              bool &final_control_bit_1, std::pair<DpfKey, DpfKey> &key_pair) const;
+
 private:
-    DpfParameters               params_;
-    prg::PseudoRandomGenerator &G_;
+    DpfParameters                     params_;
+    const prg::PseudoRandomGenerator &G_;
 
     bool ValidateInput(const uint64_t alpha, const uint64_t beta) const;
 
@@ -61,6 +83,17 @@ private:
                           block &current_seed_1, bool &current_control_bit_1,
                           std::pair<DpfKey, DpfKey> &key_pair) const;
 
+    template <size_t N>
+    void GenerateKeysBatched(const std::vector<uint64_t>           &alphas,
+                             std::vector<std::pair<DpfKey, DpfKey>> &key_pairs,
+                             std::vector<block>                     &final_seeds_0,
+                             std::vector<block>                     &final_seeds_1,
+                             std::vector<bool>                      &final_control_bits_1) const;
+
+    void GenerateNextSeedHalfTree(const uint64_t current_level, const bool current_bit, const block &delta,
+                                  block &current_seed_0, block &current_seed_1,
+                                  std::pair<DpfKey, DpfKey> &key_pair) const;
+
     void ComputeAdditiveShiftedOutput(uint64_t alpha, uint64_t beta,
                                       block &final_seed_0, block &final_seed_1, bool final_control_bit_1,
                                       std::pair<DpfKey, DpfKey> &key_pair) const;
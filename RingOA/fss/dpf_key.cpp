@@ -1,6 +1,7 @@
 #include "dpf_key.h"
 
 #include <cstring>
+#include <new>
 
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/to_string.h"
@@ -49,23 +50,28 @@ void DpfParameters::Resolve_() {
     }
 
     // Compute terminate_bitsize_
+    // A leaf block holds 128 / w output lanes, where w is the smallest lane width in
+    // {1, 8, 16, 32, 64} that fits e bits; the tree stops log2(128 / w) levels early.
     if (enable_et_) {
-        int32_t nu = 0;
+        int32_t remaining_bit = 0;
         if (element_bitsize_ == 1) {
-            nu = static_cast<int32_t>(input_bitsize_) - 7;    // 2^7
-        } else if (input_bitsize_ < 17) {
-            nu = static_cast<int32_t>(input_bitsize_) - 3;    // 8 blocks
-            if (output_mode_ == OutputType::kSingleBitMask) {
-                Logger::WarnLog(LOC, "Switching output to Additive for e!=1: OutputType -> ShiftedAdditive");
-                output_mode_ = OutputType::kShiftedAdditive;
+            remaining_bit = 7;    // 1bit ×128
+        } else {
+            if (element_bitsize_ <= 8) {
+                remaining_bit = 4;    // 8bit ×16
+            } else if (element_bitsize_ <= 16) {
+                remaining_bit = 3;    // 16bit ×8
+            } else if (element_bitsize_ <= 32) {
+                remaining_bit = 2;    // 32bit ×4
+            } else {
+                remaining_bit = 1;    // 64bit ×2
             }
-        } else if (input_bitsize_ < 33) {
-            nu = static_cast<int32_t>(input_bitsize_) - 2;    // 4 blocks
             if (output_mode_ == OutputType::kSingleBitMask) {
                 Logger::WarnLog(LOC, "Switching output to Additive for e!=1: OutputType -> ShiftedAdditive");
                 output_mode_ = OutputType::kShiftedAdditive;
             }
         }
+        int32_t nu         = static_cast<int32_t>(input_bitsize_) - remaining_bit;
         terminate_bitsize_ = static_cast<uint64_t>(std::max(nu, 0));
     } else {
         terminate_bitsize_ = input_bitsize_;
@@ -79,6 +85,9 @@ void DpfParameters::ValidateOrThrow_() const {
     if (input_bitsize_ > 32) {
         throw std::invalid_argument("input_bitsize must be <= 32 (got " + ToString(input_bitsize_) + ")");
     }
+    if (element_bitsize_ > 63) {
+        throw std::invalid_argument("element_bitsize must be <= 63 (got " + ToString(element_bitsize_) + ")");
+    }
     if (enable_et_) {
         if (terminate_bitsize_ > input_bitsize_) {
             throw std::invalid_argument("nu (" + ToString(terminate_bitsize_) + ") must be <= n (" + ToString(input_bitsize_) + ") when ET is enabled");
@@ -109,19 +118,31 @@ void DpfParameters::PrintParameters() const {
     Logger::DebugLog(LOC, "[DPF Parameters] " + GetParametersInfo());
 }
 
+namespace {
+
+constexpr std::align_val_t kCwSeedAlignment{64};
+
+std::unique_ptr<block[], AlignedBlockDeleter> AllocateCwSeed(const uint64_t cw_length) {
+    void *ptr = ::operator new[](sizeof(block) * std::max<uint64_t>(cw_length, 1), kCwSeedAlignment);
+    return std::unique_ptr<block[], AlignedBlockDeleter>(static_cast<block *>(ptr));
+}
+
+}    // namespace
+
+void AlignedBlockDeleter::operator()(block *ptr) const {
+    ::operator delete[](ptr, kCwSeedAlignment);
+}
+
 DpfKey::DpfKey(const uint64_t id, const DpfParameters &params)
     : party_id(id),
       init_seed(zero_block),
       cw_length(params.GetTerminateBitsize()),
-      cw_seed(std::make_unique<block[]>(cw_length)),
-      cw_control_left(std::make_unique<bool[]>(cw_length)),
-      cw_control_right(std::make_unique<bool[]>(cw_length)),
+      cw_seed(AllocateCwSeed(cw_length)),
+      cw_control(0),
       output(zero_block),
       params_(params),
       serialized_size_(CalculateSerializedSize()) {
     std::fill(cw_seed.get(), cw_seed.get() + cw_length, zero_block);
-    std::fill(cw_control_left.get(), cw_control_left.get() + cw_length, false);
-    std::fill(cw_control_right.get(), cw_control_right.get() + cw_length, false);
 }
 
 bool DpfKey::operator==(const DpfKey &rhs) const {
@@ -131,54 +152,65 @@ bool DpfKey::operator==(const DpfKey &rhs) const {
         return false;
     if (cw_length != rhs.cw_length)
         return false;
+    if (cw_control != rhs.cw_control)
+        return false;
     if (output != rhs.output)
         return false;
 
     for (uint64_t i = 0; i < cw_length; ++i) {
         if (cw_seed[i] != rhs.cw_seed[i])
             return false;
-        if (cw_control_left[i] != rhs.cw_control_left[i])
-            return false;
-        if (cw_control_right[i] != rhs.cw_control_right[i])
-            return false;
     }
     return true;
 }
 
 size_t DpfKey::CalculateSerializedSize() const {
-    // Fix bool serialization to 1 byte per element for portability.
     size_t size = 0;
     size += sizeof(party_id);
     size += sizeof(init_seed);
     size += sizeof(cw_length);
     size += sizeof(block) * cw_length;
-    size += cw_length;    // left controls (bytes)
-    size += cw_length;    // right controls (bytes)
+    size += sizeof(cw_control);
     size += sizeof(output);
     return size;
 }
 
+size_t DpfKey::CalculateLegacySerializedSize(const DpfParameters &params) {
+    // The legacy form stores each control bit as one byte.
+    const uint64_t cw_length = params.GetTerminateBitsize();
+    return sizeof(uint64_t) + sizeof(block) + sizeof(uint64_t) + (sizeof(block) + 2) * cw_length + sizeof(block);
+}
+
 void DpfKey::Serialize(std::vector<uint8_t> &buffer) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Serializing DPF key");
 #endif
+    const size_t   offset        = buffer.size();
+    const uint64_t packed_length = cw_length | kPackedFormatFlag;
+    buffer.resize(offset + serialized_size_);
+    uint8_t *dst = buffer.data() + offset;
 
     // Party ID and Initial seed
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&party_id), reinterpret_cast<const uint8_t *>(&party_id) + sizeof(party_id));
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&init_seed), reinterpret_cast<const uint8_t *>(&init_seed) + sizeof(init_seed));
+    std::memcpy(dst, &party_id, sizeof(party_id));
+    dst += sizeof(party_id);
+    std::memcpy(dst, &init_seed, sizeof(init_seed));
+    dst += sizeof(init_seed);
 
     // Correction words
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&cw_length), reinterpret_cast<const uint8_t *>(&cw_length) + sizeof(cw_length));
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_seed.get()), reinterpret_cast<const uint8_t *>(cw_seed.get()) + sizeof(block) * cw_length);
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_control_left.get()), reinterpret_cast<const uint8_t *>(cw_control_left.get()) + sizeof(bool) * cw_length);
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(cw_control_right.get()), reinterpret_cast<const uint8_t *>(cw_control_right.get()) + sizeof(bool) * cw_length);
+    std::memcpy(dst, &packed_length, sizeof(packed_length));
+    dst += sizeof(packed_length);
+    std::memcpy(dst, cw_seed.get(), sizeof(block) * cw_length);
+    dst += sizeof(block) * cw_length;
+    std::memcpy(dst, &cw_control, sizeof(cw_control));
+    dst += sizeof(cw_control);
 
     // Output
-    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&output), reinterpret_cast<const uint8_t *>(&output) + sizeof(output));
+    std::memcpy(dst, &output, sizeof(output));
+    dst += sizeof(output);
 
     // Check size
-    if (buffer.size() != serialized_size_) {
-        Logger::ErrorLog(LOC, "Serialized size mismatch: " + ToString(buffer.size()) + " != " + ToString(serialized_size_));
+    if (static_cast<size_t>(dst - buffer.data()) != buffer.size()) {
+        Logger::ErrorLog(LOC, "Serialized size mismatch: " + ToString(dst - buffer.data()) + " != " + ToString(buffer.size()));
         return;
     }
 }
@@ -194,22 +226,69 @@ void DpfKey::Deserialize(const std::vector<uint8_t> &buffer) {
     offset += sizeof(party_id);
     std::memcpy(&init_seed, buffer.data() + offset, sizeof(init_seed));
     offset += sizeof(init_seed);
-    std::memcpy(&cw_length, buffer.data() + offset, sizeof(cw_length));
-    offset += sizeof(cw_length);
 
-    // Correction Words
-    cw_seed          = std::make_unique<block[]>(cw_length);
-    cw_control_left  = std::make_unique<bool[]>(cw_length);
-    cw_control_right = std::make_unique<bool[]>(cw_length);
+    uint64_t length = 0;
+    std::memcpy(&length, buffer.data() + offset, sizeof(length));
+    offset += sizeof(length);
+    const bool packed = (length & kPackedFormatFlag) != 0;
+    length &= ~kPackedFormatFlag;
+    if (length > 32) {
+        throw std::invalid_argument("Invalid DPF key: cw_length " + ToString(length) + " exceeds 32");
+    }
+
+    // Correction Words (reuse the allocation when the length is unchanged)
+    if (length != cw_length) {
+        cw_seed   = AllocateCwSeed(length);
+        cw_length = length;
+    }
     std::memcpy(cw_seed.get(), buffer.data() + offset, sizeof(block) * cw_length);
     offset += sizeof(block) * cw_length;
-    std::memcpy(cw_control_left.get(), buffer.data() + offset, sizeof(bool) * cw_length);
-    offset += sizeof(bool) * cw_length;
-    std::memcpy(cw_control_right.get(), buffer.data() + offset, sizeof(bool) * cw_length);
-    offset += sizeof(bool) * cw_length;
+    if (packed) {
+        std::memcpy(&cw_control, buffer.data() + offset, sizeof(cw_control));
+        offset += sizeof(cw_control);
+    } else {
+        const uint8_t *left  = buffer.data() + offset;
+        const uint8_t *right = left + cw_length;
+        cw_control           = 0;
+        for (uint64_t i = 0; i < cw_length; ++i) {
+            SetControlBits(i, left[i] != 0, right[i] != 0);
+        }
+        offset += 2 * cw_length;
+    }
 
     // Output
     std::memcpy(&output, buffer.data() + offset, sizeof(output));
+    serialized_size_ = CalculateSerializedSize();
+}
+
+void DpfKey::ConvertLegacy(const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed) {
+    constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(block);
+    uint64_t         cw_length   = 0;
+    std::memcpy(&cw_length, legacy.data() + kHeaderSize, sizeof(cw_length));
+    if (cw_length & kPackedFormatFlag) {
+        packed.insert(packed.end(), legacy.begin(), legacy.end());
+        return;
+    }
+    if (cw_length > 32) {
+        throw std::invalid_argument("Invalid DPF key: cw_length " + ToString(cw_length) + " exceeds 32");
+    }
+
+    // Header and seeds are unchanged; the control bytes collapse into one word.
+    const uint8_t *seeds      = legacy.data() + kHeaderSize + sizeof(cw_length);
+    const uint8_t *left       = seeds + sizeof(block) * cw_length;
+    const uint8_t *right      = left + cw_length;
+    const uint8_t *output     = right + cw_length;
+    uint64_t       cw_control = 0;
+    for (uint64_t i = 0; i < cw_length; ++i) {
+        cw_control |= (static_cast<uint64_t>(left[i] != 0) | (static_cast<uint64_t>(right[i] != 0) << 1)) << (2 * i);
+    }
+    const uint64_t packed_length = cw_length | kPackedFormatFlag;
+
+    packed.insert(packed.end(), legacy.data(), legacy.data() + kHeaderSize);
+    packed.insert(packed.end(), reinterpret_cast<const uint8_t *>(&packed_length), reinterpret_cast<const uint8_t *>(&packed_length) + sizeof(packed_length));
+    packed.insert(packed.end(), seeds, left);
+    packed.insert(packed.end(), reinterpret_cast<const uint8_t *>(&cw_control), reinterpret_cast<const uint8_t *>(&cw_control) + sizeof(cw_control));
+    packed.insert(packed.end(), output, output + sizeof(block));
 }
 
 void DpfKey::PrintKey(const bool detailed) const {
@@ -223,7 +302,7 @@ void DpfKey::PrintKey(const bool detailed) const {
         Logger::DebugLog(LOC, Logger::StrWithSep("Correction words"));
         for (uint64_t i = 0; i < this->cw_length; ++i) {
             Logger::DebugLog(LOC, "Level(" + ToString(i) + ") Seed: " + Format(this->cw_seed[i]));
-            Logger::DebugLog(LOC, "Level(" + ToString(i) + ") Control bit (L, R): " + ToString(this->cw_control_left[i]) + ", " + ToString(this->cw_control_right[i]));
+            Logger::DebugLog(LOC, "Level(" + ToString(i) + ") Control bit (L, R): " + ToString(GetControlLeft(i)) + ", " + ToString(GetControlRight(i)));
         }
         Logger::DebugLog(LOC, "Output: " + Format(output));
         Logger::DebugLog(LOC, kDash);
@@ -57,14 +57,37 @@ private:
     void ValidateOrThrow_() const;
 };
 
+// Frees the cache-line aligned correction-word seeds of a DpfKey.
+struct AlignedBlockDeleter {
+    void operator()(block *ptr) const;
+};
+
+/**
+ * DpfKey — one party's DPF key.
+ *
+ * Layout
+ * - cw_seed holds the cw_length seed corrections in a single 64-byte aligned allocation.
+ * - cw_control packs the control-bit corrections of every level into one word: bit 2*i is
+ *   the left and bit 2*i+1 the right correction of level i (cw_length <= 32). The control
+ *   bits of the on-path child are read as GetControlBit(level, side) without a branch.
+ *
+ * Serialization
+ * - Serialize writes the packed form (cw_control as one word, kPackedFormatFlag set in the
+ *   serialized cw_length). Deserialize also accepts the legacy form (one byte per control
+ *   bit); ConvertLegacy rewrites a legacy buffer into the packed form.
+ * - Keys that hold DPF keys (RingOaKey, ZeroTestKey, OWMKey, OFMIKey) slice their children
+ *   by the packed size; their own ConvertLegacy rewrites a legacy buffer. A legacy OQuantileKey
+ *   also holds legacy DCF keys, which cannot be converted (see DcfKey).
+ */
 struct DpfKey {
-    uint64_t                 party_id;
-    block                    init_seed;
-    uint64_t                 cw_length;
-    std::unique_ptr<block[]> cw_seed;
-    std::unique_ptr<bool[]>  cw_control_left;
-    std::unique_ptr<bool[]>  cw_control_right;
-    block                    output;
+    static constexpr uint64_t kPackedFormatFlag = 1ULL << 63;
+
+    uint64_t                                      party_id;
+    block                                         init_seed;
+    uint64_t                                      cw_length;
+    std::unique_ptr<block[], AlignedBlockDeleter> cw_seed;
+    uint64_t                                      cw_control;
+    block                                         output;
 
     DpfKey() = delete;
     explicit DpfKey(const uint64_t id, const DpfParameters &params);
@@ -80,6 +103,20 @@ struct DpfKey {
         return !(*this == rhs);
     }
 
+    bool GetControlBit(const uint64_t level, const bool right) const {
+        return (cw_control >> (2 * level + right)) & 1;
+    }
+    bool GetControlLeft(const uint64_t level) const {
+        return GetControlBit(level, false);
+    }
+    bool GetControlRight(const uint64_t level) const {
+        return GetControlBit(level, true);
+    }
+    void SetControlBits(const uint64_t level, const bool left, const bool right) {
+        cw_control &= ~(3ULL << (2 * level));
+        cw_control |= (static_cast<uint64_t>(left) | (static_cast<uint64_t>(right) << 1)) << (2 * level);
+    }
+
     size_t GetSerializedSize() const {
         return serialized_size_;
     }
@@ -87,9 +124,14 @@ struct DpfKey {
 
     // Appends a binary representation of this key to 'buffer'.
     void Serialize(std::vector<uint8_t> &buffer) const;
-    // Replaces the current content with the key encoded in 'buffer'.
+    // Replaces the current content with the key encoded in 'buffer' (packed or legacy form).
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of the legacy form (one byte per control bit) for 'params'.
+    static size_t CalculateLegacySerializedSize(const DpfParameters &params);
+    // Rewrites a key serialized in the legacy form into the packed form.
+    static void ConvertLegacy(const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
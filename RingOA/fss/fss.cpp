@@ -15,6 +15,8 @@ std::string GetEvalTypeString(const EvalType eval_type) {
             return "HybridBatched";
         case EvalType::kIterative:
             return "Iterative";
+        case EvalType::kHalfTree:
+            return "HalfTree";
         default:
             return "Unknown";
     }
@@ -32,7 +34,7 @@ std::string GetOutputTypeString(const OutputType mode) {
 }
 
 uint64_t Convert(const block &b, const uint64_t bitsize) {
-    return b.get<uint64_t>()[0] & ((1U << bitsize) - 1U);
+    return b.get<uint64_t>()[0] & ((bitsize >= 64) ? ~0ULL : ((1ULL << bitsize) - 1ULL));
 }
 
 void SplitBlockToFieldVector(
@@ -51,6 +53,16 @@ void SplitBlockToFieldVector(
     alignas(16) uint8_t raw_bytes[16];
 
     switch (chunk_exp) {
+        case 1: {    // 64bit ×2
+            for (size_t i = 0; i < num_blocks; ++i) {
+                _mm_store_si128(reinterpret_cast<__m128i *>(raw_bytes), blks[i]);
+                auto   data64 = reinterpret_cast<const uint64_t *>(raw_bytes);
+                size_t base   = i * chunk_count;
+                out[base + 0] = data64[0] & mask;
+                out[base + 1] = data64[1] & mask;
+            }
+            break;
+        }
         case 2: {    // 32bit ×4
             for (size_t i = 0; i < num_blocks; ++i) {
                 _mm_store_si128(reinterpret_cast<__m128i *>(raw_bytes), blks[i]);
@@ -79,6 +91,16 @@ void SplitBlockToFieldVector(
             }
             break;
         }
+        case 4: {    // 8bit ×16
+            for (size_t i = 0; i < num_blocks; ++i) {
+                _mm_store_si128(reinterpret_cast<__m128i *>(raw_bytes), blks[i]);
+                size_t base = i * chunk_count;
+                for (size_t j = 0; j < 16; ++j) {
+                    out[base + j] = raw_bytes[j] & mask;
+                }
+            }
+            break;
+        }
         case 7: {
             // 1bit ×128
             for (size_t i = 0; i < num_blocks; ++i) {
@@ -111,6 +133,10 @@ uint64_t GetSplitBlockValue(
     _mm_store_si128(reinterpret_cast<__m128i *>(bytes), blk);
 
     switch (chunk_exp) {
+        case 1: {    // 2 element × 64bit
+            auto data64 = reinterpret_cast<const uint64_t *>(bytes);
+            return data64[element_idx];
+        }
         case 2: {    // 4 element × 32bit
             auto data32 = reinterpret_cast<const uint32_t *>(bytes);
             return uint64_t(data32[element_idx]);
@@ -119,6 +145,9 @@ uint64_t GetSplitBlockValue(
             auto data16 = reinterpret_cast<const uint16_t *>(bytes);
             return uint64_t(data16[element_idx]);
         }
+        case 4: {    // 16 element × 8bit
+            return uint64_t(bytes[element_idx]);
+        }
         case 7: {    // 128 element × 1bit
             if (mode == OutputType::kShiftedAdditive) {
                 uint64_t low  = blk.get<uint64_t>()[0];
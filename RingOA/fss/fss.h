@@ -2,6 +2,8 @@
 #define FSS_FSS_H_
 
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "RingOA/utils/block.h"
@@ -19,6 +21,7 @@ enum class EvalType
     kIterative,        // Iterative (loop-based) depth-first traversal without recursion
     kRecursive,        // Recursive traversal with AES expansion at each level
     kHybridBatched,    // Hybrid method: BFS for first levels + batched AES thereafter
+    kHalfTree,         // Half-tree keys: one hash per node, right child = parent ^ left child
 };
 
 enum class OutputType
@@ -36,7 +39,7 @@ std::string GetOutputTypeString(OutputType m);
 uint64_t Convert(const block &b, uint64_t bitsize);
 
 // Split 128-bit blocks into 2^chunk_exp lanes, mask to 'field_bits', append to 'out'.
-// Supported chunk_exp: 2, 3, 7 (4, 8, 128 lanes).
+// Supported chunk_exp: 1, 2, 3, 4, 7 (2, 4, 8, 16, 128 lanes).
 void SplitBlockToFieldVector(const std::vector<block> &blks,
                              uint64_t                  chunk_exp,
                              uint64_t                  field_bits,
@@ -48,6 +51,42 @@ uint64_t GetSplitBlockValue(const block &blk,
                             uint64_t     element_idx,
                             OutputType   mode);
 
+// Lane-wise a + b / a - b on blocks split into 2^chunk_exp lanes of (128 >> chunk_exp) bits.
+// chunk_exp 1-4 (64/32/16/8-bit lanes) are SIMD additions; chunk_exp 7 (1-bit lanes) is XOR.
+inline block AddLanes(const block &a, const block &b, const uint64_t chunk_exp) {
+    switch (chunk_exp) {
+        case 1:
+            return _mm_add_epi64(a, b);
+        case 2:
+            return _mm_add_epi32(a, b);
+        case 3:
+            return _mm_add_epi16(a, b);
+        case 4:
+            return _mm_add_epi8(a, b);
+        case 7:
+            return a ^ b;
+        default:
+            throw std::invalid_argument("Unsupported chunk_exp: " + std::to_string(chunk_exp));
+    }
+}
+
+inline block SubLanes(const block &a, const block &b, const uint64_t chunk_exp) {
+    switch (chunk_exp) {
+        case 1:
+            return _mm_sub_epi64(a, b);
+        case 2:
+            return _mm_sub_epi32(a, b);
+        case 3:
+            return _mm_sub_epi16(a, b);
+        case 4:
+            return _mm_sub_epi8(a, b);
+        case 7:
+            return a ^ b;
+        default:
+            throw std::invalid_argument("Unsupported chunk_exp: " + std::to_string(chunk_exp));
+    }
+}
+
 }    // namespace fss
 }    // namespace ringoa
 
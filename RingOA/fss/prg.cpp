@@ -1,12 +1,20 @@
 #include "prg.h"
 
+#include <immintrin.h>
+
 #include "RingOA/utils/block.h"
+#include "RingOA/utils/cpu_features.h"
 
 namespace {
 using ringoa::block;
+using ringoa::CpuFeatures;
+using ringoa::GetCpuFeatures;
 using ringoa::MakeBlock;
+using ringoa::fss::prg::Backend;
 using ringoa::fss::prg::Side;
 
+using RoundKeys = std::array<block, 11>;
+
 // Fixed keys for the singleton instance.
 const block kSeedLeft   = MakeBlock(0x00, 0x00);
 const block kSeedRight  = MakeBlock(0x00, 0x01);
@@ -16,27 +24,215 @@ const block kValueRight = MakeBlock(0x01, 0x00);
 size_t idx(Side s) noexcept {
     return static_cast<size_t>(s);
 }
+
+// sigma(xL || xR) = (xL ^ xR || xL), the linear orthomorphism of the half-tree hash.
+block Sigma(const block &x) noexcept {
+    __m128i swapped = _mm_shuffle_epi32(x.mData, 0x4E);
+    __m128i high    = _mm_and_si128(x.mData, _mm_set_epi64x(-1, 0));
+    return block(_mm_xor_si128(swapped, high));
+}
+
+// AES-128 key schedule (FIPS-197), same round keys as osuCrypto::AES::setKey.
+template <int Rcon>
+__m128i KeyExpandStep(__m128i key) {
+    __m128i t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xff);
+    key       = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key       = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key       = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, t);
+}
+
+RoundKeys ExpandKey(const block &key) {
+    RoundKeys rk;
+    rk[0]  = key;
+    rk[1]  = KeyExpandStep<0x01>(rk[0].mData);
+    rk[2]  = KeyExpandStep<0x02>(rk[1].mData);
+    rk[3]  = KeyExpandStep<0x04>(rk[2].mData);
+    rk[4]  = KeyExpandStep<0x08>(rk[3].mData);
+    rk[5]  = KeyExpandStep<0x10>(rk[4].mData);
+    rk[6]  = KeyExpandStep<0x20>(rk[5].mData);
+    rk[7]  = KeyExpandStep<0x40>(rk[6].mData);
+    rk[8]  = KeyExpandStep<0x80>(rk[7].mData);
+    rk[9]  = KeyExpandStep<0x1b>(rk[8].mData);
+    rk[10] = KeyExpandStep<0x36>(rk[9].mData);
+    return rk;
+}
+
+// ECB-encrypt N blocks in place, 4 blocks per 512-bit VAES instruction.
+// Compiled for VAES regardless of the global -m flags; only called after CPUID dispatch.
+template <size_t N>
+__attribute__((target("vaes,avx512f"))) void EncryptBlocksVaes512(const RoundKeys &rk, block *data) noexcept {
+    constexpr size_t kVecs = N / 4;
+    __m512i          x[kVecs];
+    __m512i          k = _mm512_broadcast_i32x4(rk[0].mData);
+    for (size_t v = 0; v < kVecs; ++v) {
+        x[v] = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const void *>(data + 4 * v)), k);
+    }
+    for (size_t r = 1; r < 10; ++r) {
+        k = _mm512_broadcast_i32x4(rk[r].mData);
+        for (size_t v = 0; v < kVecs; ++v) {
+            x[v] = _mm512_aesenc_epi128(x[v], k);
+        }
+    }
+    k = _mm512_broadcast_i32x4(rk[10].mData);
+    for (size_t v = 0; v < kVecs; ++v) {
+        _mm512_storeu_si512(reinterpret_cast<void *>(data + 4 * v), _mm512_aesenclast_epi128(x[v], k));
+    }
+}
+
+// ECB-encrypt N blocks in place, 2 blocks per 256-bit VAES instruction.
+template <size_t N>
+__attribute__((target("vaes,avx2"))) void EncryptBlocksVaes256(const RoundKeys &rk, block *data) noexcept {
+    constexpr size_t kVecs = N / 2;
+    __m256i          x[kVecs];
+    __m256i          k = _mm256_broadcastsi128_si256(rk[0].mData);
+    for (size_t v = 0; v < kVecs; ++v) {
+        x[v] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 2 * v)), k);
+    }
+    for (size_t r = 1; r < 10; ++r) {
+        k = _mm256_broadcastsi128_si256(rk[r].mData);
+        for (size_t v = 0; v < kVecs; ++v) {
+            x[v] = _mm256_aesenc_epi128(x[v], k);
+        }
+    }
+    k = _mm256_broadcastsi128_si256(rk[10].mData);
+    for (size_t v = 0; v < kVecs; ++v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + 2 * v), _mm256_aesenclast_epi128(x[v], k));
+    }
+}
+
+// ECB-encrypt N blocks in place with AES-NI, block i under rk[sides[i]].
+template <size_t N>
+__attribute__((target("aes,sse2"))) void EncryptBlocksMixedAesNi(const std::array<RoundKeys, 2> &rk,
+                                                                 const std::array<Side, N>      &sides,
+                                                                 block                          *data) noexcept {
+    constexpr size_t kChunk = 8;
+    for (size_t c = 0; c < N; c += kChunk) {
+        __m128i          x[kChunk];
+        const RoundKeys *k[kChunk];
+        for (size_t i = 0; i < kChunk; ++i) {
+            k[i] = &rk[idx(sides[c + i])];
+            x[i] = _mm_xor_si128(data[c + i].mData, (*k[i])[0].mData);
+        }
+        for (size_t r = 1; r < 10; ++r) {
+            for (size_t i = 0; i < kChunk; ++i) {
+                x[i] = _mm_aesenc_si128(x[i], (*k[i])[r].mData);
+            }
+        }
+        for (size_t i = 0; i < kChunk; ++i) {
+            data[c + i] = _mm_aesenclast_si128(x[i], (*k[i])[10].mData);
+        }
+    }
+}
+
+// ECB-encrypt N blocks in place, 4 per 512-bit VAES instruction, block i under rk[sides[i]].
+// The per-lane round keys are blended from the two broadcast schedules.
+template <size_t N>
+__attribute__((target("vaes,avx512f"))) void EncryptBlocksMixedVaes512(const std::array<RoundKeys, 2> &rk,
+                                                                      const std::array<Side, N>      &sides,
+                                                                      block                          *data) noexcept {
+    constexpr size_t kVecs = N / 4;
+    __m512i          x[kVecs];
+    __mmask8         m[kVecs];
+    for (size_t v = 0; v < kVecs; ++v) {
+        m[v] = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            m[v] |= static_cast<__mmask8>(idx(sides[4 * v + j]) * (0x3 << (2 * j)));
+        }
+    }
+    for (size_t r = 0; r < 11; ++r) {
+        __m512i kl = _mm512_broadcast_i32x4(rk[0][r].mData);
+        __m512i kr = _mm512_broadcast_i32x4(rk[1][r].mData);
+        for (size_t v = 0; v < kVecs; ++v) {
+            __m512i k = _mm512_mask_blend_epi64(m[v], kl, kr);
+            if (r == 0) {
+                x[v] = _mm512_xor_si512(_mm512_loadu_si512(reinterpret_cast<const void *>(data + 4 * v)), k);
+            } else if (r < 10) {
+                x[v] = _mm512_aesenc_epi128(x[v], k);
+            } else {
+                _mm512_storeu_si512(reinterpret_cast<void *>(data + 4 * v), _mm512_aesenclast_epi128(x[v], k));
+            }
+        }
+    }
+}
+
+// ECB-encrypt N blocks in place, 2 per 256-bit VAES instruction, block i under rk[sides[i]].
+template <size_t N>
+__attribute__((target("vaes,avx2"))) void EncryptBlocksMixedVaes256(const std::array<RoundKeys, 2> &rk,
+                                                                    const std::array<Side, N>      &sides,
+                                                                    block                          *data) noexcept {
+    constexpr size_t kVecs = N / 2;
+    __m256i          x[kVecs];
+    __m256i          m[kVecs];
+    for (size_t v = 0; v < kVecs; ++v) {
+        int64_t lo = -static_cast<int64_t>(idx(sides[2 * v]));
+        int64_t hi = -static_cast<int64_t>(idx(sides[2 * v + 1]));
+        m[v]       = _mm256_set_epi64x(hi, hi, lo, lo);
+    }
+    for (size_t r = 0; r < 11; ++r) {
+        __m256i kl = _mm256_broadcastsi128_si256(rk[0][r].mData);
+        __m256i kr = _mm256_broadcastsi128_si256(rk[1][r].mData);
+        for (size_t v = 0; v < kVecs; ++v) {
+            __m256i k = _mm256_blendv_epi8(kl, kr, m[v]);
+            if (r == 0) {
+                x[v] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 2 * v)), k);
+            } else if (r < 10) {
+                x[v] = _mm256_aesenc_epi128(x[v], k);
+            } else {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + 2 * v), _mm256_aesenclast_epi128(x[v], k));
+            }
+        }
+    }
+}
+
 }    // namespace
 
 namespace ringoa {
 namespace fss {
 namespace prg {
 
+std::string GetBackendString(const Backend backend) {
+    switch (backend) {
+        case Backend::kAesNi:
+            return "AES-NI";
+        case Backend::kVaes256:
+            return "VAES-256";
+        case Backend::kVaes512:
+            return "VAES-512";
+        default:
+            return "Unknown";
+    }
+}
+
+PseudoRandomGenerator::PseudoRandomGenerator(block seedL, block seedR,
+                                             block valueL, block valueR)
+    : PseudoRandomGenerator(seedL, seedR, valueL, valueR, DetectBackend()) {
+}
+
 PseudoRandomGenerator::PseudoRandomGenerator(block seedL, block seedR,
-                                             block valueL, block valueR) {
+                                             block valueL, block valueR,
+                                             Backend backend) {
     aes_seed_[0].setKey(seedL);
     aes_seed_[1].setKey(seedR);
     aes_value_[0].setKey(valueL);
     aes_value_[1].setKey(valueR);
+    seed_round_keys_[0]  = ExpandKey(seedL);
+    seed_round_keys_[1]  = ExpandKey(seedR);
+    value_round_keys_[0] = ExpandKey(valueL);
+    value_round_keys_[1] = ExpandKey(valueR);
+
+    // Never select a backend the CPU cannot run
+    Backend supported = DetectBackend();
+    backend_          = static_cast<uint8_t>(backend) <= static_cast<uint8_t>(supported) ? backend : supported;
 }
 
-void PseudoRandomGenerator::Expand(const block &in, block &out, Side side) noexcept {
+void PseudoRandomGenerator::Expand(const block &in, block &out, Side side) const noexcept {
     block tmp = in;
     aes_seed_[idx(side)].ecbEncBlock(tmp, tmp);
     out = in ^ tmp;
 }
 
-void PseudoRandomGenerator::ExpandValue(const block &in, block &out, Side side) noexcept {
+void PseudoRandomGenerator::ExpandValue(const block &in, block &out, Side side) const noexcept {
     block tmp = in;
     aes_value_[idx(side)].ecbEncBlock(tmp, tmp);
     out = in ^ tmp;
@@ -45,10 +241,22 @@ void PseudoRandomGenerator::ExpandValue(const block &in, block &out, Side side)
 template <size_t N>
 void PseudoRandomGenerator::Expand(const std::array<block, N> &in,
                                    std::array<block, N>       &out,
-                                   Side                        side) noexcept {
+                                   Side                        side) const noexcept {
+    static_assert(N % 8 == 0, "PseudoRandomGenerator::Expand<N> requires N to be a multiple of 8");
     std::array<block, N> tmp = in;
-    // osuCrypto provides templated batch encrypt; fall back to loop if unavailable.
-    aes_seed_[idx(side)].ecbEncBlocks<N>(tmp.data(), tmp.data());
+    switch (backend_) {
+        case Backend::kVaes512:
+            EncryptBlocksVaes512<N>(seed_round_keys_[idx(side)], tmp.data());
+            break;
+        case Backend::kVaes256:
+            EncryptBlocksVaes256<N>(seed_round_keys_[idx(side)], tmp.data());
+            break;
+        default:
+            for (size_t i = 0; i < N; i += 8) {
+                aes_seed_[idx(side)].ecbEncBlocks<8>(tmp.data() + i, tmp.data() + i);
+            }
+            break;
+    }
     for (size_t i = 0; i < N; ++i)
         out[i] = in[i] ^ tmp[i];
 }
@@ -56,9 +264,130 @@ void PseudoRandomGenerator::Expand(const std::array<block, N> &in,
 // Explicit instantiations you actively use (keep or extend as needed):
 template void PseudoRandomGenerator::Expand<8>(const std::array<block, 8> &,
                                                std::array<block, 8> &,
-                                               Side) noexcept;
+                                               Side) const noexcept;
+template void PseudoRandomGenerator::Expand<16>(const std::array<block, 16> &,
+                                                std::array<block, 16> &,
+                                                Side) const noexcept;
+template void PseudoRandomGenerator::Expand<32>(const std::array<block, 32> &,
+                                                std::array<block, 32> &,
+                                                Side) const noexcept;
+
+template <size_t N>
+void PseudoRandomGenerator::Expand(const std::array<block, N> &in,
+                                   std::array<block, N>       &out,
+                                   const std::array<Side, N>  &sides) const noexcept {
+    static_assert(N % 8 == 0, "PseudoRandomGenerator::Expand<N> requires N to be a multiple of 8");
+    std::array<block, N> tmp = in;
+    switch (backend_) {
+        case Backend::kVaes512:
+            EncryptBlocksMixedVaes512<N>(seed_round_keys_, sides, tmp.data());
+            break;
+        case Backend::kVaes256:
+            EncryptBlocksMixedVaes256<N>(seed_round_keys_, sides, tmp.data());
+            break;
+        default:
+            EncryptBlocksMixedAesNi<N>(seed_round_keys_, sides, tmp.data());
+            break;
+    }
+    for (size_t i = 0; i < N; ++i)
+        out[i] = in[i] ^ tmp[i];
+}
+
+template void PseudoRandomGenerator::Expand<8>(const std::array<block, 8> &,
+                                               std::array<block, 8> &,
+                                               const std::array<Side, 8> &) const noexcept;
+template void PseudoRandomGenerator::Expand<16>(const std::array<block, 16> &,
+                                                std::array<block, 16> &,
+                                                const std::array<Side, 16> &) const noexcept;
+template void PseudoRandomGenerator::Expand<32>(const std::array<block, 32> &,
+                                                std::array<block, 32> &,
+                                                const std::array<Side, 32> &) const noexcept;
 
-void PseudoRandomGenerator::DoubleExpand(const block &in, std::array<block, 2> &out) noexcept {
+template <size_t N>
+void PseudoRandomGenerator::ExpandValue(const std::array<block, N> &in,
+                                        std::array<block, N>       &out,
+                                        Side                        side) const noexcept {
+    static_assert(N % 8 == 0, "PseudoRandomGenerator::ExpandValue<N> requires N to be a multiple of 8");
+    std::array<block, N> tmp = in;
+    switch (backend_) {
+        case Backend::kVaes512:
+            EncryptBlocksVaes512<N>(value_round_keys_[idx(side)], tmp.data());
+            break;
+        case Backend::kVaes256:
+            EncryptBlocksVaes256<N>(value_round_keys_[idx(side)], tmp.data());
+            break;
+        default:
+            for (size_t i = 0; i < N; i += 8) {
+                aes_value_[idx(side)].ecbEncBlocks<8>(tmp.data() + i, tmp.data() + i);
+            }
+            break;
+    }
+    for (size_t i = 0; i < N; ++i)
+        out[i] = in[i] ^ tmp[i];
+}
+
+template void PseudoRandomGenerator::ExpandValue<8>(const std::array<block, 8> &,
+                                                    std::array<block, 8> &,
+                                                    Side) const noexcept;
+template void PseudoRandomGenerator::ExpandValue<16>(const std::array<block, 16> &,
+                                                     std::array<block, 16> &,
+                                                     Side) const noexcept;
+template void PseudoRandomGenerator::ExpandValue<32>(const std::array<block, 32> &,
+                                                     std::array<block, 32> &,
+                                                     Side) const noexcept;
+
+template <size_t N>
+void PseudoRandomGenerator::ExpandValue(const std::array<block, N> &in,
+                                        std::array<block, N>       &out,
+                                        const std::array<Side, N>  &sides) const noexcept {
+    static_assert(N % 8 == 0, "PseudoRandomGenerator::ExpandValue<N> requires N to be a multiple of 8");
+    std::array<block, N> tmp = in;
+    switch (backend_) {
+        case Backend::kVaes512:
+            EncryptBlocksMixedVaes512<N>(value_round_keys_, sides, tmp.data());
+            break;
+        case Backend::kVaes256:
+            EncryptBlocksMixedVaes256<N>(value_round_keys_, sides, tmp.data());
+            break;
+        default:
+            EncryptBlocksMixedAesNi<N>(value_round_keys_, sides, tmp.data());
+            break;
+    }
+    for (size_t i = 0; i < N; ++i)
+        out[i] = in[i] ^ tmp[i];
+}
+
+template void PseudoRandomGenerator::ExpandValue<8>(const std::array<block, 8> &,
+                                                    std::array<block, 8> &,
+                                                    const std::array<Side, 8> &) const noexcept;
+template void PseudoRandomGenerator::ExpandValue<16>(const std::array<block, 16> &,
+                                                     std::array<block, 16> &,
+                                                     const std::array<Side, 16> &) const noexcept;
+template void PseudoRandomGenerator::ExpandValue<32>(const std::array<block, 32> &,
+                                                     std::array<block, 32> &,
+                                                     const std::array<Side, 32> &) const noexcept;
+
+void PseudoRandomGenerator::HalfTreeHash(const block &in, block &out) const noexcept {
+    Expand(Sigma(in), out, Side::kRight);
+}
+
+template <size_t N>
+void PseudoRandomGenerator::HalfTreeHash(const std::array<block, N> &in,
+                                         std::array<block, N>       &out) const noexcept {
+    std::array<block, N> tmp;
+    for (size_t i = 0; i < N; ++i)
+        tmp[i] = Sigma(in[i]);
+    Expand<N>(tmp, out, Side::kRight);
+}
+
+template void PseudoRandomGenerator::HalfTreeHash<8>(const std::array<block, 8> &,
+                                                     std::array<block, 8> &) const noexcept;
+template void PseudoRandomGenerator::HalfTreeHash<16>(const std::array<block, 16> &,
+                                                      std::array<block, 16> &) const noexcept;
+template void PseudoRandomGenerator::HalfTreeHash<32>(const std::array<block, 32> &,
+                                                      std::array<block, 32> &) const noexcept;
+
+void PseudoRandomGenerator::DoubleExpand(const block &in, std::array<block, 2> &out) const noexcept {
     block l = in, r = in;
     aes_seed_[0].ecbEncBlock(l, l);
     aes_seed_[1].ecbEncBlock(r, r);
@@ -66,7 +395,7 @@ void PseudoRandomGenerator::DoubleExpand(const block &in, std::array<block, 2> &
     out[1] = in ^ r;    // Right
 }
 
-void PseudoRandomGenerator::DoubleExpandValue(const block &in, std::array<block, 2> &out) noexcept {
+void PseudoRandomGenerator::DoubleExpandValue(const block &in, std::array<block, 2> &out) const noexcept {
     block l = in, r = in;
     aes_value_[0].ecbEncBlock(l, l);
     aes_value_[1].ecbEncBlock(r, r);
@@ -74,8 +403,30 @@ void PseudoRandomGenerator::DoubleExpandValue(const block &in, std::array<block,
     out[1] = in ^ r;    // Right
 }
 
-PseudoRandomGenerator &PseudoRandomGenerator::GetInstance() noexcept {
-    static PseudoRandomGenerator instance(kSeedLeft, kSeedRight, kValueLeft, kValueRight);
+size_t PseudoRandomGenerator::GetPreferredBatchSize() const noexcept {
+    switch (backend_) {
+        case Backend::kVaes512:
+            return 32;
+        case Backend::kVaes256:
+            return 16;
+        default:
+            return 8;
+    }
+}
+
+Backend PseudoRandomGenerator::DetectBackend() noexcept {
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.vaes && cpu.avx512f) {
+        return Backend::kVaes512;
+    }
+    if (cpu.vaes && cpu.avx2) {
+        return Backend::kVaes256;
+    }
+    return Backend::kAesNi;
+}
+
+const PseudoRandomGenerator &PseudoRandomGenerator::GetInstance() noexcept {
+    static const PseudoRandomGenerator instance(kSeedLeft, kSeedRight, kValueLeft, kValueRight);
     return instance;
 }
 
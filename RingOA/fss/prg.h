@@ -2,6 +2,7 @@
 #define FSS_PRG_H_
 
 #include <cryptoTools/Crypto/AES.h>
+#include <string>
 
 #include "RingOA/utils/block.h"
 
@@ -16,45 +17,121 @@ enum class Side : uint8_t
     kRight = 1
 };
 
+// AES backend used by the batched Expand<N>.
+enum class Backend : uint8_t
+{
+    kAesNi   = 0,    // osuCrypto::AES, 128-bit AES-NI (8 blocks per call)
+    kVaes256 = 1,    // VAES + AVX2, 2 blocks per instruction
+    kVaes512 = 2,    // VAES + AVX-512F, 4 blocks per instruction
+};
+
+std::string GetBackendString(const Backend backend);
+
 // Pseudo-random generator based on osuCrypto::AES.
 // Usage:
-//   auto& prg = PseudoRandomGenerator::GetInstance();
+//   const auto& prg = PseudoRandomGenerator::GetInstance();
 //   block out;
 //   prg.Expand(seed, out, Side::Left);   // PRG(seed; key=seed_left)
 // Notes:
-//   - Not thread-safe.
-//   - Keys are fixed for the singleton instance.
-//   - AES backend: osuCrypto::AES.
+//   - Thread-safe: the AES key schedules are fixed at construction and every
+//     expansion is const, using only stack scratch. One instance can be shared
+//     by any number of threads.
+//   - Keys are fixed for the singleton instance, which is created on first use
+//     (function-local static, so initialization is race-free).
+//   - AES backend: osuCrypto::AES for single blocks. The batched Expand<N> and
+//     ExpandValue<N> (N = 8, 16, 32) use VAES when the CPU supports it, chosen once through
+//     CPUID (DetectBackend), and falls back to AES-NI otherwise. All backends
+//     produce identical output.
+//   - GetPreferredBatchSize() is the widest batch the backend keeps busy
+//     (8 / 16 / 32); full-domain evaluators size their lanes by it.
 
 class PseudoRandomGenerator {
 public:
     PseudoRandomGenerator(block seedL, block seedR, block valueL, block valueR);
+    PseudoRandomGenerator(block seedL, block seedR, block valueL, block valueR, Backend backend);
 
     // PRG for a single block with "seed" keys.
-    void Expand(const block &in, block &out, Side side) noexcept;
+    void Expand(const block &in, block &out, Side side) const noexcept;
 
     // PRG for a single block with "value" keys.
-    void ExpandValue(const block &in, block &out, Side side) noexcept;
+    void ExpandValue(const block &in, block &out, Side side) const noexcept;
 
-    // PRG for N blocks with "seed" keys.
+    // PRG for N blocks with "seed" keys (N = 8, 16 or 32). 'in' and 'out' may alias.
     template <size_t N>
     void Expand(const std::array<block, N> &in,
                 std::array<block, N>       &out,
-                Side                        side) noexcept;
+                Side                        side) const noexcept;
+
+    // PRG for N blocks with a per-block "seed" key: out[i] = PRG_{sides[i]}(in[i]).
+    // Used when every lane follows its own path down the tree (point evaluation).
+    template <size_t N>
+    void Expand(const std::array<block, N> &in,
+                std::array<block, N>       &out,
+                const std::array<Side, N>  &sides) const noexcept;
+
+    // PRG for N blocks with "value" keys (N = 8, 16 or 32). 'in' and 'out' may alias.
+    template <size_t N>
+    void ExpandValue(const std::array<block, N> &in,
+                     std::array<block, N>       &out,
+                     Side                        side) const noexcept;
+
+    // PRG for N blocks with a per-block "value" key: out[i] = PRG_value_{sides[i]}(in[i]).
+    template <size_t N>
+    void ExpandValue(const std::array<block, N> &in,
+                     std::array<block, N>       &out,
+                     const std::array<Side, N>  &sides) const noexcept;
+
+    // Half-tree hash H(x) = PRG_right(sigma(x)) with sigma(xL || xR) = (xL ^ xR || xL),
+    // a correlation-robust hash from one fixed-key AES call (EvalType::kHalfTree).
+    void HalfTreeHash(const block &in, block &out) const noexcept;
+
+    // Half-tree hash for N blocks (N = 8, 16 or 32). 'in' and 'out' may alias.
+    template <size_t N>
+    void HalfTreeHash(const std::array<block, N> &in,
+                      std::array<block, N>       &out) const noexcept;
 
     // Expand with both "seed" keys: out[0]=PRG_left(in), out[1]=PRG_right(in).
-    void DoubleExpand(const block &in, std::array<block, 2> &out) noexcept;
+    void DoubleExpand(const block &in, std::array<block, 2> &out) const noexcept;
 
     // Expand with both "value" keys.
-    void DoubleExpandValue(const block &in, std::array<block, 2> &out) noexcept;
+    void DoubleExpandValue(const block &in, std::array<block, 2> &out) const noexcept;
+
+    Backend GetBackend() const noexcept {
+        return backend_;
+    }
+    size_t GetPreferredBatchSize() const noexcept;
 
-    static PseudoRandomGenerator &GetInstance() noexcept;
+    // Widest backend supported by the running CPU and OS.
+    static Backend DetectBackend() noexcept;
+
+    static const PseudoRandomGenerator &GetInstance() noexcept;
 
 private:
-    std::array<osuCrypto::AES, 2> aes_seed_;  /**< AES instances for the PRG from osuCrypto. */
-    std::array<osuCrypto::AES, 2> aes_value_; /**< AES instances for the PRG from osuCrypto. */
+    std::array<osuCrypto::AES, 2>        aes_seed_;         /**< AES instances for the PRG from osuCrypto. */
+    std::array<osuCrypto::AES, 2>        aes_value_;        /**< AES instances for the PRG from osuCrypto. */
+    std::array<std::array<block, 11>, 2> seed_round_keys_;  /**< Expanded "seed" keys for VAES and per-block sides. */
+    std::array<std::array<block, 11>, 2> value_round_keys_; /**< Expanded "value" keys for VAES and per-block sides. */
+    Backend                              backend_;
 };
 
+// Calls f.template operator()<N>() with N = 32, 16 or 8: 'preferred' (usually
+// GetPreferredBatchSize()) halved while it exceeds 'cap', but never below 8.
+template <class F>
+decltype(auto) DispatchLanes(const uint64_t preferred, const uint64_t cap, F &&f) {
+    uint64_t lanes = preferred;
+    while (lanes > 8 && lanes > cap) {
+        lanes /= 2;
+    }
+    switch (lanes) {
+        case 32:
+            return f.template operator()<32>();
+        case 16:
+            return f.template operator()<16>();
+        default:
+            return f.template operator()<8>();
+    }
+}
+
 }    // namespace prg
 }    // namespace fss
 }    // namespace ringoa
@@ -145,5 +145,18 @@ uint64_t DdcfEvaluator::EvaluateAt(const DdcfKey &key, uint64_t x) const {
     return output;
 }
 
+void DdcfEvaluator::EvaluateAt(std::span<const DdcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const {
+    // All DCF keys advance through the tree together; the masks are added afterwards
+    std::vector<const fss::dcf::DcfKey *> dcf_keys(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        dcf_keys[i] = &keys[i]->dcf_key;
+    }
+    eval_.EvaluateAt(std::span<const fss::dcf::DcfKey *const>(dcf_keys), x, outputs);
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        outputs[i] = Mod2N(outputs[i] + keys[i]->mask, params_.GetOutputBitsize());
+    }
+}
+
 }    // namespace proto
 }    // namespace ringoa
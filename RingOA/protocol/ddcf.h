@@ -102,6 +102,7 @@ public:
     explicit DdcfEvaluator(const DdcfParameters &params);
 
     uint64_t EvaluateAt(const DdcfKey &key, uint64_t x) const;
+    void     EvaluateAt(std::span<const DdcfKey *const> keys, std::span<const uint64_t> x, std::span<uint64_t> outputs) const;
 
 private:
     DdcfParameters         params_;
@@ -0,0 +1,299 @@
+#include "dot_product.h"
+
+#include <algorithm>
+#include <immintrin.h>
+#include <vector>
+
+#include "RingOA/utils/cpu_features.h"
+
+namespace {
+
+using ringoa::CpuFeatures;
+using ringoa::GetCpuFeatures;
+using ringoa::proto::DotProductBackend;
+
+// Entries prefetched ahead of the database stream (16 cache lines).
+constexpr uint64_t kPrefetchAhead = 128;
+
+// Bits [offset, offset + n) of the bit stream (1 <= n <= 64), in the low bits of the result.
+// Does not read past the word holding bit offset + n - 1.
+inline uint64_t LoadBits(const uint64_t *bits, const uint64_t offset, const uint64_t n) noexcept {
+    const uint64_t word  = offset >> 6;
+    const uint64_t shift = offset & 63;
+    uint64_t       w     = bits[word] >> shift;
+    if (shift != 0 && shift + n > 64) {
+        w |= bits[word + 1] << (64 - shift);
+    }
+    return n == 64 ? w : w & ((1ULL << n) - 1);
+}
+
+// Segment kernels: sum of data[k] for k < count with bit (bit_offset + k) set.
+uint64_t SelectSumScalar(const uint64_t *data, const uint64_t *bits, const uint64_t bit_offset, const uint64_t count) noexcept {
+    uint64_t acc = 0;
+    for (uint64_t k = 0; k < count; k += 64) {
+        const uint64_t  n = std::min<uint64_t>(64, count - k);
+        const uint64_t  w = LoadBits(bits, bit_offset + k, n);
+        const uint64_t *p = data + k;
+        for (uint64_t j = 0; j < n; ++j) {
+            acc += p[j] & (0ULL - ((w >> j) & 1ULL));
+        }
+    }
+    return acc;
+}
+
+__attribute__((target("avx2"))) uint64_t SelectSumAvx2(const uint64_t *data, const uint64_t *bits, const uint64_t bit_offset, const uint64_t count) noexcept {
+    const __m256i sel = _mm256_set_epi64x(8, 4, 2, 1);
+    __m256i       acc = _mm256_setzero_si256();
+    uint64_t      k   = 0;
+    for (; k + 64 <= count; k += 64) {
+        const uint64_t  w = LoadBits(bits, bit_offset + k, 64);
+        const uint64_t *p = data + k;
+        _mm_prefetch(reinterpret_cast<const char *>(p + kPrefetchAhead), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char *>(p + kPrefetchAhead + 32), _MM_HINT_T0);
+        for (int g = 0; g < 16; ++g) {
+            // Lane l keeps its entry iff bit 4g + l of w is set
+            const __m256i nib  = _mm256_and_si256(_mm256_set1_epi64x(static_cast<int64_t>(w >> (4 * g))), sel);
+            const __m256i mask = _mm256_cmpeq_epi64(nib, sel);
+            const __m256i v    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 4 * g));
+            acc                = _mm256_add_epi64(acc, _mm256_and_si256(v, mask));
+        }
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    if (k < count) {
+        sum += SelectSumScalar(data + k, bits, bit_offset + k, count - k);
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f"))) uint64_t SelectSumAvx512(const uint64_t *data, const uint64_t *bits, const uint64_t bit_offset, const uint64_t count) noexcept {
+    __m512i acc = _mm512_setzero_si512();
+    for (uint64_t k = 0; k < count; k += 64) {
+        const uint64_t  n = std::min<uint64_t>(64, count - k);
+        const uint64_t  w = LoadBits(bits, bit_offset + k, n);
+        const uint64_t *p = data + k;
+        _mm_prefetch(reinterpret_cast<const char *>(p + kPrefetchAhead), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char *>(p + kPrefetchAhead + 32), _MM_HINT_T0);
+        // The 8 bits of each group are the load mask; masked-off lanes are neither read
+        // nor faulted, so the tail needs no scalar loop.
+        for (uint64_t g = 0; g < (n + 7) / 8; ++g) {
+            const __mmask8 mask = static_cast<__mmask8>(w >> (8 * g));
+            acc                 = _mm512_add_epi64(acc, _mm512_maskz_loadu_epi64(mask, p + 8 * g));
+        }
+    }
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    uint64_t sum = 0;
+    for (uint64_t l = 0; l < 8; ++l) {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+using SelectSumFn = uint64_t (*)(const uint64_t *, const uint64_t *, uint64_t, uint64_t) noexcept;
+
+SelectSumFn GetSelectSum(const DotProductBackend backend) noexcept {
+    switch (backend) {
+        case DotProductBackend::kAvx512:
+            return SelectSumAvx512;
+        case DotProductBackend::kAvx2:
+            return SelectSumAvx2;
+        default:
+            return SelectSumScalar;
+    }
+}
+
+uint64_t DotProductScalar(const uint64_t *data, const uint64_t *values, const uint64_t count) noexcept {
+    uint64_t acc = 0;
+    for (uint64_t k = 0; k < count; ++k) {
+        acc += data[k] * values[k];
+    }
+    return acc;
+}
+
+// Walks x in [x_begin, x_begin + count) as contiguous runs of database[(x + shift) mod 2^d]
+// and calls segment(start, offset, len) for each run (start = database index and offset =
+// x - x_begin of its first entry).
+template <typename Segment>
+uint64_t ForEachSegment(const uint64_t d, const uint64_t count, const uint64_t x_begin, const uint64_t shift, Segment &&segment) {
+    const uint64_t size  = 1ULL << d;
+    uint64_t       start = (x_begin + shift) & (size - 1);
+    uint64_t       sum   = 0;
+    for (uint64_t offset = 0; offset < count;) {
+        const uint64_t len = std::min(count - offset, size - start);
+        sum += segment(start, offset, len);
+        offset += len;
+        start = 0;
+    }
+    return sum;
+}
+
+}    // namespace
+
+namespace ringoa {
+namespace proto {
+
+std::string GetDotProductBackendString(const DotProductBackend backend) {
+    switch (backend) {
+        case DotProductBackend::kScalar:
+            return "Scalar";
+        case DotProductBackend::kAvx2:
+            return "AVX2";
+        case DotProductBackend::kAvx512:
+            return "AVX-512";
+        default:
+            return "Unknown";
+    }
+}
+
+DotProductBackend DetectDotProductBackend() noexcept {
+    const CpuFeatures &cpu = GetCpuFeatures();
+    if (cpu.avx512f) {
+        return DotProductBackend::kAvx512;
+    }
+    if (cpu.avx2) {
+        return DotProductBackend::kAvx2;
+    }
+    return DotProductBackend::kScalar;
+}
+
+uint64_t RotatedSelectSum(std::span<const uint64_t> database,
+                          const uint64_t            d,
+                          const uint64_t           *bits,
+                          const uint64_t            count,
+                          const uint64_t            x_begin,
+                          const uint64_t            shift) {
+    static const DotProductBackend detected = DetectDotProductBackend();
+    return RotatedSelectSum(detected, database, d, bits, count, x_begin, shift);
+}
+
+uint64_t RotatedSelectSum(const DotProductBackend   backend,
+                          std::span<const uint64_t> database,
+                          const uint64_t            d,
+                          const uint64_t           *bits,
+                          const uint64_t            count,
+                          const uint64_t            x_begin,
+                          const uint64_t            shift) {
+    const SelectSumFn select_sum = GetSelectSum(backend);
+    return ForEachSegment(d, count, x_begin, shift, [&](uint64_t start, uint64_t offset, uint64_t len) {
+        return select_sum(database.data() + start, bits, offset, len);
+    });
+}
+
+void RotatedSelectSumBatch(std::span<const uint64_t>        database,
+                           const uint64_t                   d,
+                           std::span<const uint64_t *const> bits,
+                           std::span<const uint64_t>        shifts,
+                           std::span<uint64_t>              sums) {
+    static const DotProductBackend detected = DetectDotProductBackend();
+    RotatedSelectSumBatch(detected, database, d, bits, shifts, sums);
+}
+
+void RotatedSelectSumBatch(const DotProductBackend          backend,
+                           std::span<const uint64_t>        database,
+                           const uint64_t                   d,
+                           std::span<const uint64_t *const> bits,
+                           std::span<const uint64_t>        shifts,
+                           std::span<uint64_t>              sums) {
+    const SelectSumFn select_sum = GetSelectSum(backend);
+    const uint64_t    size       = 1ULL << d;
+    const uint64_t    num_query  = bits.size();
+    std::fill(sums.begin(), sums.begin() + num_query, 0);
+
+    // Database index j holds position x = (j - shift) mod 2^d of a query, so within a tile
+    // the positions of each query are contiguous up to their own wrap point
+    for (uint64_t tile = 0; tile < size; tile += kDotProductTileEntries) {
+        const uint64_t  len = std::min(kDotProductTileEntries, size - tile);
+        const uint64_t *db  = database.data() + tile;
+        for (uint64_t q = 0; q < num_query; ++q) {
+            const uint64_t x   = (tile - shifts[q]) & (size - 1);
+            const uint64_t run = std::min(len, size - x);
+            sums[q] += select_sum(db, bits[q], x, run);
+            if (run < len) {
+                sums[q] += select_sum(db + run, bits[q], 0, len - run);
+            }
+        }
+    }
+}
+
+void RotatedSelectSumTiled(std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           std::span<const uint64_t> shifts,
+                           const SelectionTileFn    &expand,
+                           std::span<uint64_t>       sums) {
+    static const DotProductBackend detected = DetectDotProductBackend();
+    RotatedSelectSumTiled(detected, database, d, shifts, expand, sums);
+}
+
+void RotatedSelectSumTiled(const DotProductBackend   backend,
+                           std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           std::span<const uint64_t> shifts,
+                           const SelectionTileFn    &expand,
+                           std::span<uint64_t>       sums) {
+    const SelectSumFn select_sum = GetSelectSum(backend);
+    const uint64_t    size       = 1ULL << d;
+    const uint64_t    tile       = std::min(kDotProductTileEntries, size);
+    const uint64_t    num_tiles  = size / tile;
+    const uint64_t    num_query  = shifts.size();
+    std::fill(sums.begin(), sums.begin() + num_query, 0);
+
+    // Bit tile t of query q lives in slot t % 2 of the query's window
+    std::vector<uint64_t> window(num_query * 2 * (tile / 64));
+    auto                  slot = [&](uint64_t q, uint64_t t) {
+        return window.data() + (2 * q + (t & 1)) * (tile / 64);
+    };
+    std::vector<uint64_t>   queries, tiles;
+    std::vector<uint64_t *> outputs;
+    auto                    request = [&](uint64_t q, uint64_t t) {
+        queries.push_back(q);
+        tiles.push_back(t);
+        outputs.push_back(slot(q, t));
+    };
+
+    // Database index j holds position x = (j - shift) mod 2^d of a query, so database tile j0
+    // covers bit tile a from offset 'off' on, then the first 'off' bits of tile a + 1
+    for (uint64_t j0 = 0; j0 < size; j0 += tile) {
+        queries.clear();
+        tiles.clear();
+        outputs.clear();
+        for (uint64_t q = 0; q < num_query; ++q) {
+            const uint64_t x   = (j0 - shifts[q]) & (size - 1);
+            const uint64_t a   = x / tile;
+            const uint64_t off = x % tile;
+            if (j0 == 0 || off == 0) {
+                request(q, a);    // otherwise loaded as the previous tile's a + 1
+            }
+            if (off != 0 && num_tiles > 1) {
+                request(q, (a + 1) % num_tiles);
+            }
+        }
+        expand(queries, tiles, outputs);
+
+        const uint64_t *db = database.data() + j0;
+        for (uint64_t q = 0; q < num_query; ++q) {
+            const uint64_t x   = (j0 - shifts[q]) & (size - 1);
+            const uint64_t a   = x / tile;
+            const uint64_t off = x % tile;
+            sums[q] += select_sum(db, slot(q, a), off, tile - off);
+            if (off != 0) {
+                sums[q] += select_sum(db + tile - off, slot(q, (a + 1) % num_tiles), 0, off);
+            }
+        }
+    }
+}
+
+uint64_t RotatedDotProduct(std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           const uint64_t           *values,
+                           const uint64_t            count,
+                           const uint64_t            x_begin,
+                           const uint64_t            shift) {
+    return ForEachSegment(d, count, x_begin, shift, [&](uint64_t start, uint64_t offset, uint64_t len) {
+        return DotProductScalar(database.data() + start, values + offset, len);
+    });
+}
+
+}    // namespace proto
+}    // namespace ringoa
@@ -0,0 +1,115 @@
+#ifndef PROTOCOL_DOT_PRODUCT_H_
+#define PROTOCOL_DOT_PRODUCT_H_
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+
+namespace ringoa {
+namespace proto {
+
+// SIMD width used by the dot-product kernels.
+enum class DotProductBackend : uint8_t
+{
+    kScalar = 0,    // 64-bit scalar loop
+    kAvx2   = 1,    // 4 entries per instruction (bit -> mask via compare)
+    kAvx512 = 2,    // 8 entries per instruction (bit -> mask register)
+};
+
+std::string GetDotProductBackendString(const DotProductBackend backend);
+
+// Widest backend the CPU and OS support (see GetCpuFeatures).
+DotProductBackend DetectDotProductBackend() noexcept;
+
+// Dot products between a database of 2^d entries, read at a rotated index, and the
+// full-domain output of a DPF. Shared by RingOA, RingOA-FSC, SharedOT and DPF-PIR.
+//
+// Position x (x_begin <= x < x_begin + count) selects database[(x + shift) mod 2^d].
+// The rotated range is walked as contiguous segments split at the wrap point (two
+// for count <= 2^d), so the inner loops do no modular index arithmetic. Sums wrap
+// mod 2^64; callers apply the party sign and the final Mod2N once.
+//
+//   uint64_t dp = 0;
+//   eval.VisitFullDomain(key, [&](uint64_t i, const block &leaf) {
+//       const auto bits = leaf.get<uint64_t>();
+//       dp += RotatedSelectSum(database, d, bits.data(), 128, i * 128, pr);
+//   });
+//   dp = Mod2N(Sign(party_id) * dp, s);
+
+// Sum of the entries whose bit is set in 'bits' (bit k = bit k % 64 of bits[k / 64]).
+uint64_t RotatedSelectSum(std::span<const uint64_t> database,
+                          const uint64_t            d,
+                          const uint64_t           *bits,
+                          const uint64_t            count,
+                          const uint64_t            x_begin,
+                          const uint64_t            shift);
+
+// Same with an explicit backend (must be supported by the CPU); for benchmarks.
+uint64_t RotatedSelectSum(const DotProductBackend   backend,
+                          std::span<const uint64_t> database,
+                          const uint64_t            d,
+                          const uint64_t           *bits,
+                          const uint64_t            count,
+                          const uint64_t            x_begin,
+                          const uint64_t            shift);
+
+// Database entries per tile of RotatedSelectSumBatch (128 KiB, leaving L2 room for the
+// selection bits of every query).
+constexpr uint64_t kDotProductTileEntries = 1ULL << 14;
+
+// Full-domain RotatedSelectSum of K queries against the same database:
+// sums[q] = RotatedSelectSum(database, d, bits[q], 2^d, 0, shifts[q]).
+// The database is walked once, tile by tile, and every query consumes a tile while it is
+// still in cache, so the database is read from DRAM once per batch instead of K times.
+// Each query reads its own bits at its rotated offset (1/64 of the database traffic).
+void RotatedSelectSumBatch(std::span<const uint64_t>        database,
+                           const uint64_t                   d,
+                           std::span<const uint64_t *const> bits,
+                           std::span<const uint64_t>        shifts,
+                           std::span<uint64_t>              sums);
+
+// Same with an explicit backend (must be supported by the CPU); for benchmarks.
+void RotatedSelectSumBatch(const DotProductBackend          backend,
+                           std::span<const uint64_t>        database,
+                           const uint64_t                   d,
+                           std::span<const uint64_t *const> bits,
+                           std::span<const uint64_t>        shifts,
+                           std::span<uint64_t>              sums);
+
+// Writes the selection bits of query queries[i] for positions [tiles[i] * tile, (tiles[i] + 1) * tile)
+// to outputs[i] (tile / 64 words, 16-byte aligned), where tile = min(kDotProductTileEntries, 2^d).
+using SelectionTileFn = std::function<void(std::span<const uint64_t>  queries,
+                                           std::span<const uint64_t>  tiles,
+                                           std::span<uint64_t *const> outputs)>;
+
+// RotatedSelectSumBatch without full selection vectors: before each database tile, 'expand'
+// produces the next tile of bits of every query in one call, and the tile is consumed right
+// away. A query's positions straddle two bit tiles unless its shift is a multiple of the tile
+// size, so each query keeps a window of two tiles (2 * tile / 8 bytes instead of 2^d / 8).
+void RotatedSelectSumTiled(std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           std::span<const uint64_t> shifts,
+                           const SelectionTileFn    &expand,
+                           std::span<uint64_t>       sums);
+
+// Same with an explicit backend (must be supported by the CPU); for benchmarks.
+void RotatedSelectSumTiled(const DotProductBackend   backend,
+                           std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           std::span<const uint64_t> shifts,
+                           const SelectionTileFn    &expand,
+                           std::span<uint64_t>       sums);
+
+// Sum of database[(x + shift) mod 2^d] * values[x - x_begin].
+uint64_t RotatedDotProduct(std::span<const uint64_t> database,
+                           const uint64_t            d,
+                           const uint64_t           *values,
+                           const uint64_t            count,
+                           const uint64_t            x_begin,
+                           const uint64_t            shift);
+
+}    // namespace proto
+}    // namespace ringoa
+
+#endif    // PROTOCOL_DOT_PRODUCT_H_
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "RingOA/fss/prg.h"
+#include "RingOA/protocol/dot_product.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
@@ -192,7 +193,7 @@ uint64_t DpfPirEvaluator::EvaluateSharedIndex(osuCrypto::Channel          &chl,
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv.size() != (1UL << nu)) {
+    if (!uv.empty() && uv.size() != (1UL << nu)) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv.size()) + " != " + ToString(1UL << nu));
     }
@@ -250,7 +251,7 @@ uint64_t DpfPirEvaluator::EvaluateMaskedIndex(osuCrypto::Channel          &chl,
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv.size() != (1UL << nu)) {
+    if (!uv.empty() && uv.size() != (1UL << nu)) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv.size()) + " != " + ToString(1UL << nu));
     }
@@ -295,7 +296,7 @@ void DpfPirEvaluator::EvaluateMaskedIndex_Double(osuCrypto::Channel          &ch
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv.size() != (1UL << nu)) {
+    if (!uv.empty() && uv.size() != (1UL << nu)) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv.size()) + " != " + ToString(1UL << nu));
     }
@@ -339,7 +340,7 @@ void DpfPirEvaluator::EvaluateMaskedIndex_Triple(osuCrypto::Channel          &ch
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv.size() != (1UL << nu)) {
+    if (!uv.empty() && uv.size() != (1UL << nu)) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv.size()) + " != " + ToString(1UL << nu));
     }
@@ -371,24 +372,24 @@ uint64_t DpfPirEvaluator::EvaluateFullDomainThenDotProduct(const fss::dpf::DpfKe
 
     uint64_t party_id = key.party_id;
     uint64_t d        = params_.GetDatabaseSize();
-
-    // Evaluate the FDE
-    eval_.EvaluateFullDomain(key, outputs);
     uint64_t db_sum = 0;
 
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        const uint64_t low  = outputs[i].get<uint64_t>()[0];
-        const uint64_t high = outputs[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((low >> j) & 1ULL);
-            db_sum              = Mod2N(db_sum + Sign(party_id) * (database[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-        }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((high >> j) & 1ULL);
-            db_sum              = Mod2N(db_sum + Sign(party_id) * (database[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-        }
+    // Leaf bit x selects database[(x + masked_idx) mod 2^d]; the sums wrap mod 2^64
+    auto accumulate = [&](const uint64_t *bits, uint64_t count, uint64_t x_begin) {
+        db_sum += RotatedSelectSum(database, d, bits, count, x_begin, masked_idx);
+    };
+
+    // Evaluate the FDE (streamed straight into the dot product when no output buffer is given)
+    if (outputs.empty()) {
+        eval_.VisitFullDomain(key, [&](uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            accumulate(bits.data(), 128, i * 128);
+        });
+    } else {
+        eval_.EvaluateFullDomain(key, outputs);
+        accumulate(reinterpret_cast<const uint64_t *>(outputs.data()), outputs.size() * 128, 0);
     }
+    db_sum = Mod2N(Sign(party_id) * db_sum, d);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Dot product result: " + ToString(db_sum));
@@ -405,28 +406,26 @@ void DpfPirEvaluator::EvaluateFullDomainThenDotProduct_Double(const fss::dpf::Dp
 
     uint64_t party_id = key.party_id;
     uint64_t d        = params_.GetDatabaseSize();
-
-    // Evaluate the FDE
-    eval_.EvaluateFullDomain(key, outputs);
     uint64_t db_sum_1 = 0, db_sum_2 = 0;
 
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        const uint64_t low  = outputs[i].get<uint64_t>()[0];
-        const uint64_t high = outputs[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((low >> j) & 1ULL);
-            db_sum_1            = Mod2N(db_sum_1 + Sign(party_id) * (database_1[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-            db_sum_2            = Mod2N(db_sum_2 + Sign(party_id) * (database_2[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-        }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((high >> j) & 1ULL);
-            db_sum_1            = Mod2N(db_sum_1 + Sign(party_id) * (database_1[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-            db_sum_2            = Mod2N(db_sum_2 + Sign(party_id) * (database_2[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-        }
+    // Leaf bit x selects database[(x + masked_idx) mod 2^d]; the sums wrap mod 2^64
+    auto accumulate = [&](const uint64_t *bits, uint64_t count, uint64_t x_begin) {
+        db_sum_1 += RotatedSelectSum(database_1, d, bits, count, x_begin, masked_idx);
+        db_sum_2 += RotatedSelectSum(database_2, d, bits, count, x_begin, masked_idx);
+    };
+
+    // Evaluate the FDE (streamed straight into the dot product when no output buffer is given)
+    if (outputs.empty()) {
+        eval_.VisitFullDomain(key, [&](uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            accumulate(bits.data(), 128, i * 128);
+        });
+    } else {
+        eval_.EvaluateFullDomain(key, outputs);
+        accumulate(reinterpret_cast<const uint64_t *>(outputs.data()), outputs.size() * 128, 0);
     }
 
-    dot_product = std::array<uint64_t, 2>{db_sum_1, db_sum_2};
+    dot_product = std::array<uint64_t, 2>{Mod2N(Sign(party_id) * db_sum_1, d), Mod2N(Sign(party_id) * db_sum_2, d)};
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Dot product result: " + ToString(dot_product[0]) + ", " + ToString(dot_product[1]));
 #endif
@@ -442,30 +441,27 @@ void DpfPirEvaluator::EvaluateFullDomainThenDotProduct_Triple(const fss::dpf::Dp
 
     uint64_t party_id = key.party_id;
     uint64_t d        = params_.GetDatabaseSize();
-
-    // Evaluate the FDE
-    eval_.EvaluateFullDomain(key, outputs);
     uint64_t db_sum_1 = 0, db_sum_2 = 0, db_sum_3 = 0;
 
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        const uint64_t low  = outputs[i].get<uint64_t>()[0];
-        const uint64_t high = outputs[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((low >> j) & 1ULL);
-            db_sum_1            = Mod2N(db_sum_1 + Sign(party_id) * (database_1[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-            db_sum_2            = Mod2N(db_sum_2 + Sign(party_id) * (database_2[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-            db_sum_3            = Mod2N(db_sum_3 + Sign(party_id) * (database_3[Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-        }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask = 0ULL - ((high >> j) & 1ULL);
-            db_sum_1            = Mod2N(db_sum_1 + Sign(party_id) * (database_1[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-            db_sum_2            = Mod2N(db_sum_2 + Sign(party_id) * (database_2[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-            db_sum_3            = Mod2N(db_sum_3 + Sign(party_id) * (database_3[Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-        }
+    // Leaf bit x selects database[(x + masked_idx) mod 2^d]; the sums wrap mod 2^64
+    auto accumulate = [&](const uint64_t *bits, uint64_t count, uint64_t x_begin) {
+        db_sum_1 += RotatedSelectSum(database_1, d, bits, count, x_begin, masked_idx);
+        db_sum_2 += RotatedSelectSum(database_2, d, bits, count, x_begin, masked_idx);
+        db_sum_3 += RotatedSelectSum(database_3, d, bits, count, x_begin, masked_idx);
+    };
+
+    // Evaluate the FDE (streamed straight into the dot product when no output buffer is given)
+    if (outputs.empty()) {
+        eval_.VisitFullDomain(key, [&](uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            accumulate(bits.data(), 128, i * 128);
+        });
+    } else {
+        eval_.EvaluateFullDomain(key, outputs);
+        accumulate(reinterpret_cast<const uint64_t *>(outputs.data()), outputs.size() * 128, 0);
     }
 
-    dot_product = std::array<uint64_t, 3>{db_sum_1, db_sum_2, db_sum_3};
+    dot_product = std::array<uint64_t, 3>{Mod2N(Sign(party_id) * db_sum_1, d), Mod2N(Sign(party_id) * db_sum_2, d), Mod2N(Sign(party_id) * db_sum_3, d)};
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Dot product result: " + ToString(dot_product[0]) + ", " + ToString(dot_product[1]) + ", " + ToString(dot_product[2]));
 #endif
@@ -480,23 +476,27 @@ void DpfPirEvaluator::EvaluateFullDomainThenDotProduct_Vectorized(const fss::dpf
     uint64_t party_id = key.party_id;
     uint64_t d        = params_.GetDatabaseSize();
 
-    // Evaluate the FDE
-    eval_.EvaluateFullDomain(key, outputs);
-
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        const uint64_t low  = outputs[i].get<uint64_t>()[0];
-        const uint64_t high = outputs[i].get<uint64_t>()[1];
+    std::vector<uint64_t> db_sums(databases.size(), 0);
 
+    // Leaf bit x selects database[(x + masked_idx) mod 2^d]; the sums wrap mod 2^64
+    auto accumulate = [&](const uint64_t *bits, uint64_t count, uint64_t x_begin) {
         for (size_t db_idx = 0; db_idx < databases.size(); ++db_idx) {
-            for (int j = 0; j < 64; ++j) {
-                const uint64_t mask = 0ULL - ((low >> j) & 1ULL);
-                dot_product[db_idx] = Mod2N(dot_product[db_idx] + Sign(party_id) * (databases[db_idx][Mod2N((i * 128 + j) + masked_idx, d)] & mask), d);
-            }
-            for (int j = 0; j < 64; ++j) {
-                const uint64_t mask = 0ULL - ((high >> j) & 1ULL);
-                dot_product[db_idx] = Mod2N(dot_product[db_idx] + Sign(party_id) * (databases[db_idx][Mod2N((i * 128 + 64 + j) + masked_idx, d)] & mask), d);
-            }
+            db_sums[db_idx] += RotatedSelectSum(databases[db_idx], d, bits, count, x_begin, masked_idx);
         }
+    };
+
+    // Evaluate the FDE (streamed straight into the dot product when no output buffer is given)
+    if (outputs.empty()) {
+        eval_.VisitFullDomain(key, [&](uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            accumulate(bits.data(), 128, i * 128);
+        });
+    } else {
+        eval_.EvaluateFullDomain(key, outputs);
+        accumulate(reinterpret_cast<const uint64_t *>(outputs.data()), outputs.size() * 128, 0);
+    }
+    for (size_t db_idx = 0; db_idx < databases.size(); ++db_idx) {
+        dot_product[db_idx] = Mod2N(dot_product[db_idx] + Sign(party_id) * db_sums[db_idx], d);
     }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
@@ -552,11 +552,7 @@ uint64_t DpfPirEvaluator::EvaluateSharedIndexNaive(osuCrypto::Channel          &
 
     // Evaluate the FDE
     eval_.EvaluateFullDomain(key.dpf_key, uv);
-    uint64_t db_sum = 0;
-
-    for (size_t i = 0; i < uv.size(); ++i) {
-        db_sum = Mod2N(db_sum + (database[Mod2N(i + pr, d)]) * uv[i], d);
-    }
+    uint64_t db_sum = Mod2N(RotatedDotProduct(database, d, uv.data(), uv.size(), 0, pr), d);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, party_str + " db_sum: " + ToString(db_sum));
@@ -598,11 +594,7 @@ uint64_t DpfPirEvaluator::EvaluateMaskedIndexNaive(osuCrypto::Channel          &
 
     // Evaluate the FDE
     eval_.EvaluateFullDomain(key.dpf_key, uv);
-    uint64_t db_sum = 0;
-
-    for (size_t i = 0; i < uv.size(); ++i) {
-        db_sum = Mod2N(db_sum + (database[Mod2N(i + masked_index, d)]) * uv[i], d);
-    }
+    uint64_t db_sum = Mod2N(RotatedDotProduct(database, d, uv.data(), uv.size(), 0, masked_index), d);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, party_str + " db_sum: " + ToString(db_sum));
@@ -190,10 +190,10 @@ public:
                                       const uint64_t               masked_index) const;
 
 private:
-    DpfPirParameters                 params_;
-    fss::dpf::DpfEvaluator           eval_;
-    sharing::AdditiveSharing2P      &ss_;
-    fss::prg::PseudoRandomGenerator &G_;
+    DpfPirParameters                       params_;
+    fss::dpf::DpfEvaluator                 eval_;
+    sharing::AdditiveSharing2P            &ss_;
+    const fss::prg::PseudoRandomGenerator &G_;
 };
 
 }    // namespace proto
@@ -195,5 +195,35 @@ uint64_t EqualityEvaluator::EvaluateMaskedInput(const EqualityKey &key, const ui
     return output;
 }
 
+void EqualityEvaluator::EvaluateMaskedInput(const std::vector<EqualityKey> &keys,
+                                            const std::vector<uint64_t>    &x1,
+                                            const std::vector<uint64_t>    &x2,
+                                            std::vector<uint64_t>          &outputs) const {
+    uint64_t n = params_.GetInputBitsize();
+
+    if (keys.size() != x1.size() || keys.size() != x2.size()) {
+        throw std::invalid_argument(
+            "EqualityEvaluator::EvaluateMaskedInput: keys, x1 and x2 must have the same size (" +
+            std::to_string(keys.size()) + ", " + std::to_string(x1.size()) + ", " + std::to_string(x2.size()) + ")");
+    }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Evaluating Equality protocol with " + ToString(keys.size()) + " masked inputs");
+#endif
+
+    // Evaluate all DPF keys level by level
+    std::vector<const fss::dpf::DpfKey *> dpf_keys(keys.size());
+    std::vector<uint64_t>                 alpha(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        dpf_keys[i] = &keys[i].dpf_key;
+        alpha[i]    = Mod2N(x1[i] - x2[i], n);
+    }
+    outputs.resize(keys.size());
+    eval_.EvaluateAt(dpf_keys, alpha, outputs);
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "alpha: " + ToString(alpha) + ", outputs: " + ToString(outputs));
+#endif
+}
+
 }    // namespace proto
 }    // namespace ringoa
@@ -116,6 +116,10 @@ public:
 
     uint64_t EvaluateSharedInput(osuCrypto::Channel &chl, const EqualityKey &key, const uint64_t x1, const uint64_t x2) const;
     uint64_t EvaluateMaskedInput(const EqualityKey &key, const uint64_t x1, const uint64_t x2) const;
+    void     EvaluateMaskedInput(const std::vector<EqualityKey> &keys,
+                                 const std::vector<uint64_t>    &x1,
+                                 const std::vector<uint64_t>    &x2,
+                                 std::vector<uint64_t>          &outputs) const;
 
 private:
     EqualityParameters          params_;
@@ -0,0 +1,179 @@
+#include "fde_cache.h"
+
+#include <algorithm>
+
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/to_string.h"
+
+namespace ringoa {
+namespace proto {
+
+RingOaFdeCache::RingOaFdeCache(const RingOaParameters &params, const uint64_t memory_budget, const bool background)
+    : eval_(params.GetParameters()),
+      num_leaves_(1ULL << params.GetParameters().GetTerminateBitsize()),
+      entry_bytes_(2 * num_leaves_ * sizeof(block)),
+      slots_(memory_budget / entry_bytes_),
+      stop_(false) {
+    if (slots_.empty()) {
+        Logger::WarnLog(LOC, "FDE cache budget " + ToString(memory_budget) + " bytes is below one entry (" +
+                                 ToString(entry_bytes_) + " bytes); nothing will be cached");
+    }
+    free_slots_.reserve(slots_.size());
+    for (uint64_t i = slots_.size(); i > 0; --i) {
+        free_slots_.push_back(i - 1);
+    }
+    if (background) {
+        worker_ = std::thread([this]() { WorkerLoop(); });
+    }
+}
+
+RingOaFdeCache::~RingOaFdeCache() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+uint64_t RingOaFdeCache::GetNumEntries() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return index_.size();
+}
+
+uint64_t RingOaFdeCache::Precompute(std::span<const RingOaKey *const> keys) {
+    uint64_t num_keys = 0;
+    if (worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (const RingOaKey *key : keys) {
+                if (index_.count(key) == 0 && std::find(pending_.begin(), pending_.end(), key) == pending_.end()) {
+                    pending_.push_back(key);
+                    ++num_keys;
+                }
+            }
+        }
+        cv_.notify_all();
+        return num_keys;
+    }
+
+    for (const RingOaKey *key : keys) {
+        uint64_t slot;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (index_.count(key) != 0) {
+                continue;
+            }
+            if (!Reserve(key, slot)) {
+                break;
+            }
+        }
+        Expand(slots_[slot]);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            slots_[slot].ready = true;
+        }
+        cv_.notify_all();
+        ++num_keys;
+    }
+    return num_keys;
+}
+
+const RingOaFdeCache::Entry *RingOaFdeCache::Acquire(const RingOaKey &key) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto                         it = index_.find(&key);
+    if (it == index_.end()) {
+        // Not started yet: evaluate it directly rather than wait behind earlier keys
+        auto queued = std::find(pending_.begin(), pending_.end(), &key);
+        if (queued != pending_.end()) {
+            pending_.erase(queued);
+        }
+        return nullptr;
+    }
+    Entry &entry = slots_[it->second];
+    cv_.wait(lock, [&entry]() { return entry.ready; });
+    entry.in_use = true;
+    return &entry;
+}
+
+void RingOaFdeCache::Release(const Entry *entry) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        const uint64_t              slot = static_cast<uint64_t>(entry - slots_.data());
+        if (!slots_[slot].in_use) {
+            return;
+        }
+        // Clear() may have unlisted the key, and a later Precompute may have cached it again elsewhere
+        auto it = index_.find(slots_[slot].key);
+        if (it != index_.end() && it->second == slot) {
+            index_.erase(it);
+        }
+        slots_[slot].key    = nullptr;
+        slots_[slot].ready  = false;
+        slots_[slot].in_use = false;
+        free_slots_.push_back(slot);
+    }
+    cv_.notify_all();
+}
+
+void RingOaFdeCache::Clear() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    pending_.clear();
+    cv_.wait(lock, [this]() {
+        return std::all_of(index_.begin(), index_.end(), [this](const auto &kv) { return slots_[kv.second].ready; });
+    });
+    for (const auto &[key, slot] : index_) {
+        if (slots_[slot].in_use) {
+            continue;    // freed by Release
+        }
+        slots_[slot].key   = nullptr;
+        slots_[slot].ready = false;
+        free_slots_.push_back(slot);
+    }
+    index_.clear();
+}
+
+bool RingOaFdeCache::Reserve(const RingOaKey *key, uint64_t &slot) {
+    if (free_slots_.empty()) {
+        return false;
+    }
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[slot].key   = key;
+    slots_[slot].ready = false;
+    index_.emplace(key, slot);
+    return true;
+}
+
+void RingOaFdeCache::Expand(Entry &entry) const {
+    entry.uv_prev.resize(num_leaves_);
+    entry.uv_next.resize(num_leaves_);
+    const std::array<const fss::dpf::DpfKey *, 2> keys{&entry.key->key_from_next, &entry.key->key_from_prev};
+    const std::array<std::vector<block> *, 2>     uvs{&entry.uv_prev, &entry.uv_next};
+    eval_.EvaluateFullDomain(keys, uvs);
+}
+
+void RingOaFdeCache::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || (!pending_.empty() && !free_slots_.empty()); });
+        if (stop_) {
+            return;
+        }
+        const RingOaKey *key = pending_.front();
+        pending_.pop_front();
+        uint64_t slot;
+        Reserve(key, slot);
+
+        lock.unlock();
+        Expand(slots_[slot]);
+        lock.lock();
+        slots_[slot].ready = true;
+        cv_.notify_all();
+    }
+}
+
+}    // namespace proto
+}    // namespace ringoa
@@ -0,0 +1,114 @@
+#ifndef PROTOCOL_FDE_CACHE_H_
+#define PROTOCOL_FDE_CACHE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "RingOA/fss/dpf_eval.h"
+#include "RingOA/protocol/ringoa.h"
+
+namespace ringoa {
+namespace proto {
+
+/**
+ * RingOaFdeCache — full-domain expansions of RingOA keys, computed ahead of the online phase.
+ *
+ * Overview
+ * - The expansion of key_from_prev / key_from_next depends only on the key, not on the
+ *   secret index, so it can run before the index is known. RingOaEvaluator::Evaluate and
+ *   EvaluateBatch consult the cache set by SetFdeCache: on a hit the online work is the
+ *   masked-index reconstruction plus the rotated dot product over the stored outputs.
+ * - Memory is bounded: the budget (bytes, per party) is split into fixed slots of
+ *   GetEntryBytes() each, allocated on first use and reused. Keys beyond the free slots
+ *   are not cached (synchronous mode) or wait in a queue (background mode).
+ * - Entries are single-use: an evaluation takes the entry and frees its slot, as every
+ *   RingOA key is used once.
+ *
+ * Modes
+ * - background = false: Precompute(keys) expands on the calling thread (offline phase)
+ *   until the budget is full.
+ * - background = true: Precompute(keys) queues the keys and returns; one worker thread
+ *   expands them in order whenever a slot is free (idle time during the online phase).
+ *   An evaluation waits for an expansion in progress, and takes a key that is still
+ *   queued out of the queue and evaluates it directly, so it never waits on later keys.
+ *
+ * Usage
+ *   RingOaFdeCache cache(params, 64ULL << 20, true);    // 64 MiB, background thread
+ *   eval.SetFdeCache(&cache);
+ *   cache.Precompute(keys);                              // keys: std::span<const RingOaKey *const>
+ *   eval.Evaluate(chls, *keys[0], uv_prev, uv_next, database, index, result);    // cache hit
+ *
+ * Notes
+ * - Entries are looked up by key address; keys must stay alive (and not move) until they
+ *   are evaluated or Clear() is called.
+ * - Precompute, Acquire and Release are thread-safe.
+ */
+class RingOaFdeCache {
+public:
+    // Outputs of one key, laid out as RingOaEvaluator::EvaluateFullDomainThenDotProduct writes uv_prev / uv_next.
+    struct Entry {
+        const RingOaKey   *key    = nullptr;
+        bool               ready  = false;
+        bool               in_use = false;    // acquired and not yet released
+        std::vector<block> uv_prev;
+        std::vector<block> uv_next;
+    };
+
+    RingOaFdeCache() = delete;
+    RingOaFdeCache(const RingOaParameters &params, const uint64_t memory_budget, const bool background = false);
+    ~RingOaFdeCache();
+
+    RingOaFdeCache(const RingOaFdeCache &)            = delete;
+    RingOaFdeCache &operator=(const RingOaFdeCache &) = delete;
+
+    // Bytes held by one key (both expansions).
+    uint64_t GetEntryBytes() const {
+        return entry_bytes_;
+    }
+    uint64_t GetNumSlots() const {
+        return slots_.size();
+    }
+    // Keys cached or being expanded.
+    uint64_t GetNumEntries() const;
+
+    // Expands (synchronous mode) or queues (background mode) the keys, in order.
+    // Returns the number of keys cached (synchronous) or queued (background).
+    uint64_t Precompute(std::span<const RingOaKey *const> keys);
+
+    // Returns the entry of key, waiting while its expansion runs, or nullptr if it is not
+    // cached. A returned entry stays valid until Release(entry).
+    const Entry *Acquire(const RingOaKey &key);
+    void         Release(const Entry *entry);
+
+    // Drops queued keys and waits for the running expansion; cached entries are discarded.
+    // Acquired entries are only unlisted: they stay valid and keep their slot until Release.
+    void Clear();
+
+private:
+    fss::dpf::DpfEvaluator                          eval_;
+    uint64_t                                        num_leaves_;
+    uint64_t                                        entry_bytes_;
+    std::vector<Entry>                              slots_;
+    std::vector<uint64_t>                           free_slots_;
+    std::unordered_map<const RingOaKey *, uint64_t> index_;
+    std::deque<const RingOaKey *>                   pending_;
+    bool                                            stop_;
+    mutable std::mutex                              mtx_;
+    std::condition_variable                         cv_;
+    std::thread                                     worker_;
+
+    // Reserves a slot for key (mtx_ held); returns false if none is free.
+    bool Reserve(const RingOaKey *key, uint64_t &slot);
+    void Expand(Entry &entry) const;
+    void WorkerLoop();
+};
+
+}    // namespace proto
+}    // namespace ringoa
+
+#endif    // PROTOCOL_FDE_CACHE_H_
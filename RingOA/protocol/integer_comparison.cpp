@@ -192,6 +192,20 @@ uint64_t IntegerComparisonEvaluator::EvaluateSharedInput(osuCrypto::Channel &chl
     }
 }
 
+std::array<uint64_t, 2> IntegerComparisonEvaluator::MaskSharedInput(const IntegerComparisonKey &key, const uint64_t x, const uint64_t y) const {
+    std::array<uint64_t, 2> masked_x;
+    ss_in_.EvaluateAdd({x, y}, {key.shr1_in, key.shr2_in}, masked_x);
+    return masked_x;
+}
+
+uint64_t IntegerComparisonEvaluator::EvaluateMaskedShares(const IntegerComparisonKey    &key,
+                                                          const std::array<uint64_t, 2> &masked_0,
+                                                          const std::array<uint64_t, 2> &masked_1) const {
+    std::array<uint64_t, 2> masked_x;
+    ss_in_.ReconstLocal(masked_0, masked_1, masked_x);
+    return EvaluateMaskedInput(key, masked_x[0], masked_x[1]);
+}
+
 uint64_t IntegerComparisonEvaluator::EvaluateMaskedInput(const IntegerComparisonKey &key, const uint64_t x, const uint64_t y) const {
     uint64_t party_id = key.ddcf_key.dcf_key.party_id;
     uint64_t n        = params_.GetInputBitsize();
@@ -229,5 +243,76 @@ uint64_t IntegerComparisonEvaluator::EvaluateMaskedInput(const IntegerComparison
     return output;
 }
 
+void IntegerComparisonEvaluator::EvaluateSharedInput(osuCrypto::Channel                          &chl,
+                                                     std::span<const IntegerComparisonKey *const> keys,
+                                                     const std::vector<uint64_t>                 &x,
+                                                     const std::vector<uint64_t>                 &y,
+                                                     std::vector<uint64_t>                       &outputs) const {
+    if (keys.size() != x.size() || keys.size() != y.size()) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(keys.size()) + ", x=" + ToString(x.size()) + ", y=" + ToString(y.size()));
+        return;
+    }
+    if (keys.empty()) {
+        outputs.clear();
+        return;
+    }
+    uint64_t party_id = keys[0]->ddcf_key.dcf_key.party_id;
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Evaluating " + ToString(keys.size()) + " Comparison protocols with shared inputs");
+    Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
+#endif
+
+    // Reconstruct all masked inputs in one round: {x[0] + r1, y[0] + r2, x[1] + r1', ...}
+    std::vector<uint64_t> inputs(2 * keys.size()), masks(2 * keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        inputs[2 * i]     = x[i];
+        inputs[2 * i + 1] = y[i];
+        masks[2 * i]      = keys[i]->shr1_in;
+        masks[2 * i + 1]  = keys[i]->shr2_in;
+    }
+    std::vector<uint64_t> masked_x_0, masked_x_1, masked_x;
+    ss_in_.EvaluateAdd(inputs, masks, (party_id == 0) ? masked_x_0 : masked_x_1);
+    ss_in_.Reconst(party_id, chl, masked_x_0, masked_x_1, masked_x);
+
+    std::vector<uint64_t> masked_x1(keys.size()), masked_x2(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        masked_x1[i] = masked_x[2 * i];
+        masked_x2[i] = masked_x[2 * i + 1];
+    }
+    EvaluateMaskedInput(keys, masked_x1, masked_x2, outputs);
+}
+
+void IntegerComparisonEvaluator::EvaluateMaskedInput(std::span<const IntegerComparisonKey *const> keys,
+                                                     const std::vector<uint64_t>                 &x,
+                                                     const std::vector<uint64_t>                 &y,
+                                                     std::vector<uint64_t>                       &outputs) const {
+    uint64_t n = params_.GetInputBitsize();
+    uint64_t e = params_.GetOutputBitsize();
+
+    if (keys.size() != x.size() || keys.size() != y.size()) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(keys.size()) + ", x=" + ToString(x.size()) + ", y=" + ToString(y.size()));
+        return;
+    }
+    if (outputs.size() != keys.size()) {
+        outputs.resize(keys.size());
+    }
+
+    // Evaluate all DDCF keys together
+    std::vector<const DdcfKey *> ddcf_keys(keys.size());
+    std::vector<uint64_t>        alpha(keys.size()), msb_z(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        uint64_t z   = Mod2N(x[i] - y[i], n);
+        ddcf_keys[i] = &keys[i]->ddcf_key;
+        alpha[i]     = GetLowerNBits(z, n - 1);
+        msb_z[i]     = GetMSB(z, n);
+    }
+    eval_.EvaluateAt(std::span<const DdcfKey *const>(ddcf_keys), std::span<const uint64_t>(alpha), std::span<uint64_t>(outputs));
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        uint64_t party_id = keys[i]->ddcf_key.dcf_key.party_id;
+        outputs[i]        = Mod2N(party_id - ((party_id * msb_z[i]) + outputs[i] - (2 * msb_z[i] * outputs[i])), e);
+    }
+}
+
 }    // namespace proto
 }    // namespace ringoa
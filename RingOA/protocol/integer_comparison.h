@@ -1,6 +1,9 @@
 #ifndef PROTOCOL_INTEGER_COMPARISON_H_
 #define PROTOCOL_INTEGER_COMPARISON_H_
 
+#include <array>
+#include <span>
+
 #include "ddcf.h"
 
 namespace osuCrypto {
@@ -115,6 +118,25 @@ public:
 
     uint64_t EvaluateSharedInput(osuCrypto::Channel &chl, const IntegerComparisonKey &key, const uint64_t x1, const uint64_t x2) const;
     uint64_t EvaluateMaskedInput(const IntegerComparisonKey &key, const uint64_t x1, const uint64_t x2) const;
+    // EvaluateSharedInput split around its reconstruction round: MaskSharedInput returns this
+    // party's share of the masked inputs, which the parties exchange; EvaluateMaskedShares
+    // reconstructs them from both shares (party 0's first) and evaluates the comparison.
+    std::array<uint64_t, 2> MaskSharedInput(const IntegerComparisonKey &key, const uint64_t x1, const uint64_t x2) const;
+    uint64_t                EvaluateMaskedShares(const IntegerComparisonKey    &key,
+                                                 const std::array<uint64_t, 2> &masked_0,
+                                                 const std::array<uint64_t, 2> &masked_1) const;
+
+    // Batched comparisons: one reconstruction round for all masked inputs, then all DDCF keys
+    // are evaluated together. outputs[i] is the share of the comparison of x1[i] and x2[i].
+    void EvaluateSharedInput(osuCrypto::Channel                          &chl,
+                             std::span<const IntegerComparisonKey *const> keys,
+                             const std::vector<uint64_t>                 &x1,
+                             const std::vector<uint64_t>                 &x2,
+                             std::vector<uint64_t>                       &outputs) const;
+    void EvaluateMaskedInput(std::span<const IntegerComparisonKey *const> keys,
+                             const std::vector<uint64_t>                 &x1,
+                             const std::vector<uint64_t>                 &x2,
+                             std::vector<uint64_t>                       &outputs) const;
 
 private:
     IntegerComparisonParameters params_;
@@ -98,6 +98,10 @@ std::pair<Min3Key, Min3Key> Min3KeyGenerator::GenerateKeys() const {
 
     std::pair<IntegerComparisonKey, IntegerComparisonKey> ic_key_pair_1 = gen_.GenerateKeys();
     std::pair<IntegerComparisonKey, IntegerComparisonKey> ic_key_pair_2 = gen_.GenerateKeys();
+    key_pair.first.ic_key_1  = std::move(ic_key_pair_1.first);
+    key_pair.second.ic_key_1 = std::move(ic_key_pair_1.second);
+    key_pair.first.ic_key_2  = std::move(ic_key_pair_2.first);
+    key_pair.second.ic_key_2 = std::move(ic_key_pair_2.second);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     key_pair.first.PrintKey();
@@ -151,5 +155,41 @@ uint64_t Min3Evaluator::EvaluateSharedInput(osuCrypto::Channel &chl, const Min3K
     }
 }
 
+void Min3Evaluator::EvaluateSharedInput(osuCrypto::Channel                         &chl,
+                                        std::span<const Min3Key *const>             keys,
+                                        const std::vector<std::array<uint64_t, 3>> &inputs,
+                                        std::vector<uint64_t>                      &outputs) const {
+    if (keys.size() != inputs.size()) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(keys.size()) + ", inputs=" + ToString(inputs.size()));
+        return;
+    }
+    if (keys.empty()) {
+        outputs.clear();
+        return;
+    }
+    uint64_t party_id = keys[0]->ic_key_1.ddcf_key.dcf_key.party_id;
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Evaluating " + ToString(keys.size()) + " Min3 protocols with shared inputs");
+    Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
+#endif
+
+    std::vector<const IntegerComparisonKey *> ic_keys_1(keys.size()), ic_keys_2(keys.size());
+    std::vector<uint64_t>                     x(keys.size()), y(keys.size()), z(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ic_keys_1[i] = &keys[i]->ic_key_1;
+        ic_keys_2[i] = &keys[i]->ic_key_2;
+        x[i]         = inputs[i][0];
+        y[i]         = inputs[i][1];
+        z[i]         = inputs[i][2];
+    }
+
+    // min(x, y) for every instance, then min(min(x, y), z)
+    std::vector<uint64_t> less_xy_c, small_xy, less_xyz_c;
+    eval_.EvaluateSharedInput(chl, std::span<const IntegerComparisonKey *const>(ic_keys_1), x, y, less_xy_c);
+    ss_.EvaluateSelect(party_id, chl, x, y, less_xy_c, small_xy);
+    eval_.EvaluateSharedInput(chl, std::span<const IntegerComparisonKey *const>(ic_keys_2), small_xy, z, less_xyz_c);
+    ss_.EvaluateSelect(party_id, chl, small_xy, z, less_xyz_c, outputs);
+}
+
 }    // namespace proto
 }    // namespace ringoa
@@ -22,8 +22,9 @@ namespace proto {
 class Min3Parameters {
 public:
     Min3Parameters() = delete;
+    // Comparison bits are shared in the same n + 1 bit ring as the inputs they select between
     explicit Min3Parameters(const uint64_t n)
-        : params_(n + 1, n) {
+        : params_(n + 1, n + 1) {
     }
 
     uint64_t GetInputBitsize() const {
@@ -34,7 +35,7 @@ public:
     }
 
     void ReconfigureParameters(const uint64_t n) {
-        params_.ReconfigureParameters(n + 1, n);
+        params_.ReconfigureParameters(n + 1, n + 1);
     }
 
     std::string GetParametersInfo() const {
@@ -116,6 +117,13 @@ public:
 
     uint64_t EvaluateSharedInput(osuCrypto::Channel &chl, const Min3Key &key, const std::array<uint64_t, 3> &inputs) const;
 
+    // Minimum of many triples at once: each of the two comparison/selection steps runs for
+    // all instances together, so the round count does not grow with keys.size().
+    void EvaluateSharedInput(osuCrypto::Channel                         &chl,
+                             std::span<const Min3Key *const>             keys,
+                             const std::vector<std::array<uint64_t, 3>> &inputs,
+                             std::vector<uint64_t>                      &outputs) const;
+
 private:
     Min3Parameters              params_;
     IntegerComparisonEvaluator  eval_;
@@ -1,6 +1,8 @@
 #include "obliv_select.h"
 
+#include <bit>
 #include <cstring>
+#include <stdexcept>
 
 #include "RingOA/fss/prg.h"
 #include "RingOA/sharing/binary_2p.h"
@@ -217,7 +219,7 @@ void OblivSelectEvaluator::Evaluate(Channels                      &chls,
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -267,12 +269,28 @@ void OblivSelectEvaluator::Evaluate_Parallel(Channels                      &chls
                                              const sharing::RepShareView64 &database,
                                              const sharing::RepShareVec64  &index,
                                              sharing::RepShareVec64        &result) const {
+    const std::array<const OblivSelectKey *, 2> keys{&key1, &key2};
+    EvaluateBatch(chls, keys, uv_prev, uv_next, database, index, result);
+}
+
+void OblivSelectEvaluator::EvaluateBatch(Channels                              &chls,
+                                         std::span<const OblivSelectKey *const> keys,
+                                         std::vector<block>                    &uv_prev,
+                                         std::vector<block>                    &uv_next,
+                                         const sharing::RepShareView64         &database,
+                                         const sharing::RepShareVec64          &index,
+                                         sharing::RepShareVec64                &result) const {
 
     uint64_t party_id = chls.party_id;
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
+    uint64_t num_keys = keys.size();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (index.Size() != num_keys) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_keys) + ", index=" + ToString(index.Size()));
+        return;
+    }
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -281,40 +299,39 @@ void OblivSelectEvaluator::Evaluate_Parallel(Channels                      &chls
         Logger::ErrorLog(LOC, "Database size does not match the number of nodes: " +
                                   ToString(database.Size()) + " != " + ToString(1UL << d));
     }
+    if (result.Size() != num_keys) {
+        result = sharing::RepShareVec64(num_keys);
+    }
+    if (num_keys == 0) {
+        return;
+    }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate OblivSelect key"));
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate " + ToString(num_keys) + " OblivSelect keys"));
     Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
     std::string party_str = "[P" + ToString(party_id) + "] ";
     Logger::DebugLog(LOC, party_str + " idx: " + index.ToString());
     Logger::DebugLog(LOC, party_str + " db: " + database.ToString());
 #endif
 
-    // Reconstruct p ^ r_i
-    // pr: [pr_prev1, pr_next1, pr_prev2, pr_next2]
-    std::array<uint64_t, 4> pr = ReconstructPRBinary(chls, key1, key2, index);
+    // Reconstruct p ^ r_i for every key (one message per neighbour)
+    std::vector<uint64_t> pr_prev, pr_next;
+    ReconstructPRBinary(chls, keys, index, pr_prev, pr_next);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + " pr_prev1: " + ToString(pr[0]) + ", pr_next1: " + ToString(pr[1]) +
-                              ", pr_prev2: " + ToString(pr[2]) + ", pr_next2: " + ToString(pr[3]));
+    Logger::DebugLog(LOC, party_str + " pr_prev: " + ToString(pr_prev) + ", pr_next: " + ToString(pr_next));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block
-    auto [dp_prev1, dp_next1] = EvaluateFullDomainThenDotProduct(
-        key1.prev_key, key1.next_key, uv_prev, uv_next, database, pr[0], pr[1]);
-    auto [dp_prev2, dp_next2] = EvaluateFullDomainThenDotProduct(
-        key2.prev_key, key2.next_key, uv_prev, uv_next, database, pr[2], pr[3]);
+    // Evaluate DPF and reshare the selected values
+    sharing::RepShare64 r_sh;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        auto [dp_prev, dp_next] = EvaluateFullDomainThenDotProduct(
+            keys[k]->prev_key, keys[k]->next_key, uv_prev, uv_next, database, pr_prev[k], pr_next[k]);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + "dp_prev1: " + ToString(dp_prev1) + ", dp_next1: " + ToString(dp_next1));
-    Logger::DebugLog(LOC, party_str + "dp_prev2: " + ToString(dp_prev2) + ", dp_next2: " + ToString(dp_next2));
+        Logger::DebugLog(LOC, party_str + "dp_prev[" + ToString(k) + "]: " + ToString(dp_prev) + ", dp_next[" + ToString(k) + "]: " + ToString(dp_next));
 #endif
-
-    uint64_t            selected1_sh = dp_prev1 ^ dp_next1;
-    uint64_t            selected2_sh = dp_prev2 ^ dp_next2;
-    sharing::RepShare64 r1_sh, r2_sh;
-    brss_.Rand(r1_sh);
-    brss_.Rand(r2_sh);
-    result[0][0] = selected1_sh ^ r1_sh[0] ^ r1_sh[1];
-    result[0][1] = selected2_sh ^ r2_sh[0] ^ r2_sh[1];
+        brss_.Rand(r_sh);
+        result[0][k] = dp_prev ^ dp_next ^ r_sh[0] ^ r_sh[1];
+    }
     chls.next.send(result[0]);
     chls.prev.recv(result[1]);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
@@ -327,11 +344,34 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
                                                        const uint64_t                pr) const {
     uint64_t nu = params_.GetParameters().GetTerminateBitsize();
 
-    // Breadth-first traversal for 8 nodes
+    // The batched kernel splits the first log2(8) levels across lanes. Single-bit-mask
+    // parameters always give nu >= 3 (n >= 10); anything else would underflow nu - kLaneBits.
+    if (params_.GetParameters().GetOutputType() != fss::OutputType::kSingleBitMask || nu < 3) {
+        throw std::invalid_argument("OblivSelect on binary data needs single-bit-mask keys with nu >= 3, got nu = " + ToString(nu));
+    }
+
+    // Lane count follows the PRG backend, capped by the number of nodes at depth nu
+    block blk_sum = fss::prg::DispatchLanes(G_.GetPreferredBatchSize(), 1ULL << nu, [&]<size_t N>() {
+        return ComputeDotProductBlockBatched<N>(key, database, pr);
+    });
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Dot product result: " + Format(blk_sum));
+#endif
+    return blk_sum;
+}
+
+template <size_t N>
+block OblivSelectEvaluator::ComputeDotProductBlockBatched(const fss::dpf::DpfKey       &key,
+                                                          const std::span<const block> &database,
+                                                          const uint64_t                pr) const {
+    constexpr uint64_t kLaneBits = std::countr_zero(N);
+    uint64_t           nu        = params_.GetParameters().GetTerminateBitsize();
+
+    // Breadth-first traversal for N nodes
     std::vector<block> start_seeds{key.init_seed}, next_seeds;
     std::vector<bool>  start_control_bits{key.party_id != 0}, next_control_bits;
 
-    for (uint64_t i = 0; i < 3; ++i) {
+    for (uint64_t i = 0; i < kLaneBits; ++i) {
         std::array<block, 2> expanded_seeds;
         std::array<bool, 2>  expanded_control_bits;
         next_seeds.resize(1U << (i + 1));
@@ -350,20 +390,20 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
     // Initialize the variables
     uint64_t current_level = 0;
     uint64_t current_idx   = 0;
-    uint64_t last_depth    = std::max(static_cast<int32_t>(nu) - 3, 0);
+    uint64_t last_depth    = nu - kLaneBits;
     uint64_t last_idx      = 1U << last_depth;
 
     // Store the seeds and control bits
-    std::array<block, 8>              expanded_seeds, output_seeds;
-    std::array<block, 8>              sums = {zero_block, zero_block, zero_block, zero_block,
-                                              zero_block, zero_block, zero_block, zero_block};
-    std::array<bool, 8>               expanded_control_bits;
-    std::vector<std::array<block, 8>> prev_seeds(last_depth + 1);
-    std::vector<std::array<bool, 8>>  prev_control_bits(last_depth + 1);
-    std::vector<block>                byte_expanded_seeds(64);
+    std::array<block, N>              expanded_seeds, output_seeds;
+    std::array<block, N>              sums;
+    std::array<bool, N>               expanded_control_bits;
+    std::vector<std::array<block, N>> prev_seeds(last_depth + 1);
+    std::vector<std::array<bool, N>>  prev_control_bits(last_depth + 1);
+    std::vector<block>                byte_expanded_seeds(8 * N);
+    sums.fill(zero_block);
 
     // Evaluate the DPF key
-    for (uint64_t i = 0; i < 8; ++i) {
+    for (uint64_t i = 0; i < N; ++i) {
         prev_seeds[0][i]        = start_seeds[i];
         prev_control_bits[0][i] = start_control_bits[i];
     }
@@ -380,26 +420,17 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
             } else {
                 side = fss::prg::Side::kLeft;
             }
-            G_.Expand(prev_seeds[current_level], expanded_seeds, side);
-            for (uint64_t i = 0; i < 8; ++i) {
+            G_.Expand<N>(prev_seeds[current_level], expanded_seeds, side);
+            for (uint64_t i = 0; i < N; ++i) {
                 expanded_control_bits[i] = GetLsb(expanded_seeds[i]);
                 SetLsbZero(expanded_seeds[i]);
             }
 
             // Apply correction word if control bit is true
-            bool  cw_control_bit = current_bit ? key.cw_control_right[current_level + 3] : key.cw_control_left[current_level + 3];
-            block cw_seed        = key.cw_seed[current_level + 3];
-            expanded_seeds[0] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][0]]);
-            expanded_seeds[1] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][1]]);
-            expanded_seeds[2] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][2]]);
-            expanded_seeds[3] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][3]]);
-            expanded_seeds[4] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][4]]);
-            expanded_seeds[5] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][5]]);
-            expanded_seeds[6] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][6]]);
-            expanded_seeds[7] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][7]]);
-
-            for (uint64_t i = 0; i < 8; ++i) {
-                // expanded_seeds[i] ^= (key.cw_seed[current_level + 3] & zero_and_all_one[prev_control_bits[current_level][i]]);
+            bool  cw_control_bit = key.GetControlBit(current_level + kLaneBits, current_bit);
+            block cw_seed        = key.cw_seed[current_level + kLaneBits];
+            for (uint64_t i = 0; i < N; ++i) {
+                expanded_seeds[i] ^= (cw_seed & zero_and_all_one[prev_control_bits[current_level][i]]);
                 expanded_control_bits[i] ^= (cw_control_bit & prev_control_bits[current_level][i]);
             }
 
@@ -407,22 +438,22 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
             current_level++;
 
             // Update the previous seeds and control bits
-            for (uint64_t i = 0; i < 8; ++i) {
+            for (uint64_t i = 0; i < N; ++i) {
                 prev_seeds[current_level][i]        = expanded_seeds[i];
                 prev_control_bits[current_level][i] = expanded_control_bits[i];
             }
         }
 
         // Seed expansion for the final output
-        G_.Expand(prev_seeds[current_level], prev_seeds[current_level], fss::prg::Side::kLeft);
+        G_.Expand<N>(prev_seeds[current_level], prev_seeds[current_level], fss::prg::Side::kLeft);
 
-        for (uint64_t j = 0; j < 8; ++j) {
+        for (uint64_t j = 0; j < N; ++j) {
             output_seeds[j] = prev_seeds[current_level][j] ^ (zero_and_all_one[prev_control_bits[current_level][j]] & key.output);
         }
 
         auto dest = byte_expanded_seeds.data();
 
-        for (uint64_t i = 0; i < 8; ++i) {
+        for (uint64_t i = 0; i < N; ++i) {
             dest[0] = all_bytes_one_mask & output_seeds[i].mm_srai_epi16(0);
             dest[1] = all_bytes_one_mask & output_seeds[i].mm_srai_epi16(1);
             dest[2] = all_bytes_one_mask & output_seeds[i].mm_srai_epi16(2);
@@ -435,42 +466,13 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
             dest += 8;
         }
 
-        uint8_t *seed_byte0 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 0;
-        uint8_t *seed_byte1 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 1;
-        uint8_t *seed_byte2 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 2;
-        uint8_t *seed_byte3 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 3;
-        uint8_t *seed_byte4 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 4;
-        uint8_t *seed_byte5 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 5;
-        uint8_t *seed_byte6 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 6;
-        uint8_t *seed_byte7 = reinterpret_cast<uint8_t *>(byte_expanded_seeds.data()) + 128 * 7;
-
-        // Calculate the dot product
+        // Calculate the dot product (lane i covers leaves (i * last_idx + current_idx) * 128 + j)
+        const uint8_t *seed_bytes = reinterpret_cast<const uint8_t *>(byte_expanded_seeds.data());
         for (uint64_t j = 0; j < 128; ++j) {
-            size_t db_idx0 = (((0 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx1 = (((1 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx2 = (((2 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx3 = (((3 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx4 = (((4 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx5 = (((5 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx6 = (((6 * last_idx + current_idx) * 128) + j) ^ pr;
-            size_t db_idx7 = (((7 * last_idx + current_idx) * 128) + j) ^ pr;
-            auto   input0  = database[db_idx0] & zero_and_all_one[seed_byte0[j]];
-            auto   input1  = database[db_idx1] & zero_and_all_one[seed_byte1[j]];
-            auto   input2  = database[db_idx2] & zero_and_all_one[seed_byte2[j]];
-            auto   input3  = database[db_idx3] & zero_and_all_one[seed_byte3[j]];
-            auto   input4  = database[db_idx4] & zero_and_all_one[seed_byte4[j]];
-            auto   input5  = database[db_idx5] & zero_and_all_one[seed_byte5[j]];
-            auto   input6  = database[db_idx6] & zero_and_all_one[seed_byte6[j]];
-            auto   input7  = database[db_idx7] & zero_and_all_one[seed_byte7[j]];
-
-            sums[0] = sums[0] ^ input0;
-            sums[1] = sums[1] ^ input1;
-            sums[2] = sums[2] ^ input2;
-            sums[3] = sums[3] ^ input3;
-            sums[4] = sums[4] ^ input4;
-            sums[5] = sums[5] ^ input5;
-            sums[6] = sums[6] ^ input6;
-            sums[7] = sums[7] ^ input7;
+            for (uint64_t i = 0; i < N; ++i) {
+                size_t db_idx = (((i * last_idx + current_idx) * 128) + j) ^ pr;
+                sums[i]       = sums[i] ^ (database[db_idx] & zero_and_all_one[seed_bytes[128 * i + j]]);
+            }
         }
 
         // Update the current index
@@ -480,12 +482,9 @@ block OblivSelectEvaluator::ComputeDotProductBlockSIMD(const fss::dpf::DpfKey
     }
 
     block blk_sum = zero_block;
-    for (uint64_t i = 0; i < 8; i++) {
+    for (uint64_t i = 0; i < N; i++) {
         blk_sum = blk_sum ^ sums[i];
     }
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, "Dot product result: " + Format(blk_sum));
-#endif
     return blk_sum;
 }
 
@@ -496,28 +495,34 @@ std::pair<uint64_t, uint64_t> OblivSelectEvaluator::EvaluateFullDomainThenDotPro
                                                                                      const sharing::RepShareView64 &database,
                                                                                      const uint64_t                 pr_prev,
                                                                                      const uint64_t                 pr_next) const {
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block == __m128i)
-    eval_.EvaluateFullDomain(key_prev, uv_prev);
-    eval_.EvaluateFullDomain(key_next, uv_next);
-    uint64_t dp_prev = 0, dp_next = 0;
-
-    for (size_t i = 0; i < uv_prev.size(); ++i) {
-        const uint64_t low_prev  = uv_prev[i].get<uint64_t>()[0];
-        const uint64_t high_prev = uv_prev[i].get<uint64_t>()[1];
-        const uint64_t low_next  = uv_next[i].get<uint64_t>()[0];
-        const uint64_t high_next = uv_next[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((low_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((low_next >> j) & 1ULL);
-            dp_prev ^= (database.share0[(i * 128 + j) ^ pr_prev] & mask_prev);
-            dp_next ^= (database.share1[(i * 128 + j) ^ pr_next] & mask_next);
+    // Evaluate both DPF keys in lockstep (uv_prev and uv_next are std::vector<block>, where block == __m128i)
+    const std::array<const fss::dpf::DpfKey *, 2> keys{&key_prev, &key_next};
+    uint64_t                                      dp_prev = 0, dp_next = 0;
+
+    // Leaf i of keys[k] selects 128 database entries (k = 0: dp_prev, k = 1: dp_next)
+    auto accumulate = [&](uint64_t k, uint64_t i, const block &leaf) {
+        const auto    &share = (k == 0) ? database.share0 : database.share1;
+        const uint64_t pr    = (k == 0) ? pr_prev : pr_next;
+        uint64_t       dp    = (k == 0) ? dp_prev : dp_next;
+        for (int h = 0; h < 2; ++h) {
+            const uint64_t bits = leaf.get<uint64_t>()[h];
+            for (int j = 0; j < 64; ++j) {
+                const uint64_t mask = 0ULL - ((bits >> j) & 1ULL);
+                dp ^= (share[(i * 128 + h * 64 + j) ^ pr] & mask);
+            }
         }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((high_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((high_next >> j) & 1ULL);
-            dp_prev ^= (database.share0[(i * 128 + 64 + j) ^ pr_prev] & mask_prev);
-            dp_next ^= (database.share1[(i * 128 + 64 + j) ^ pr_next] & mask_next);
+        ((k == 0) ? dp_prev : dp_next) = dp;
+    };
+
+    if (uv_prev.empty() && uv_next.empty()) {
+        // No output buffers: consume the leaves while they are still in L1
+        eval_.VisitFullDomain(keys, accumulate);
+    } else {
+        const std::array<std::vector<block> *, 2> uvs{&uv_prev, &uv_next};
+        eval_.EvaluateFullDomain(keys, uvs);
+        for (size_t i = 0; i < uv_prev.size(); ++i) {
+            accumulate(0, i, uv_prev[i]);
+            accumulate(1, i, uv_next[i]);
         }
     }
     return std::make_pair(dp_prev, dp_next);
@@ -605,52 +610,49 @@ std::pair<uint64_t, uint64_t> OblivSelectEvaluator::ReconstructPRBinary(Channels
     return std::make_pair(pr_prev, pr_next);
 }
 
-std::array<uint64_t, 4> OblivSelectEvaluator::ReconstructPRBinary(Channels                     &chls,
-                                                                  const OblivSelectKey         &key1,
-                                                                  const OblivSelectKey         &key2,
-                                                                  const sharing::RepShareVec64 &index) const {
+void OblivSelectEvaluator::ReconstructPRBinary(Channels                              &chls,
+                                               std::span<const OblivSelectKey *const> keys,
+                                               const sharing::RepShareVec64          &index,
+                                               std::vector<uint64_t>                 &pr_prev,
+                                               std::vector<uint64_t>                 &pr_next) const {
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, "ReconstructPR for Party " + ToString(chls.party_id));
+    Logger::DebugLog(LOC, "ReconstructPR (" + ToString(keys.size()) + " keys) for Party " + ToString(chls.party_id));
 #endif
 
     // Set replicated sharing of random value
-    uint64_t               pr_prev1 = 0, pr_next1 = 0, pr_prev2 = 0, pr_next2 = 0;
-    sharing::RepShareVec64 r_0_sh(2), r_1_sh(2), r_2_sh(2);
-
-    switch (chls.party_id) {
-        case 0:
-            r_0_sh.Set(0, sharing::RepShare64(key1.r_sh_0, key1.r_sh_1));
-            r_1_sh.Set(0, sharing::RepShare64(key1.next_r_sh, 0));
-            r_2_sh.Set(0, sharing::RepShare64(0, key1.prev_r_sh));
-            r_0_sh.Set(1, sharing::RepShare64(key2.r_sh_0, key2.r_sh_1));
-            r_1_sh.Set(1, sharing::RepShare64(key2.next_r_sh, 0));
-            r_2_sh.Set(1, sharing::RepShare64(0, key2.prev_r_sh));
-            break;
-        case 1:
-            r_0_sh.Set(0, sharing::RepShare64(0, key1.prev_r_sh));
-            r_1_sh.Set(0, sharing::RepShare64(key1.r_sh_0, key1.r_sh_1));
-            r_2_sh.Set(0, sharing::RepShare64(key1.next_r_sh, 0));
-            r_0_sh.Set(1, sharing::RepShare64(0, key2.prev_r_sh));
-            r_1_sh.Set(1, sharing::RepShare64(key2.r_sh_0, key2.r_sh_1));
-            r_2_sh.Set(1, sharing::RepShare64(key2.next_r_sh, 0));
-            break;
-        case 2:
-            r_0_sh.Set(0, sharing::RepShare64(key1.next_r_sh, 0));
-            r_1_sh.Set(0, sharing::RepShare64(0, key1.prev_r_sh));
-            r_2_sh.Set(0, sharing::RepShare64(key1.r_sh_0, key1.r_sh_1));
-            r_0_sh.Set(1, sharing::RepShare64(key2.next_r_sh, 0));
-            r_1_sh.Set(1, sharing::RepShare64(0, key2.prev_r_sh));
-            r_2_sh.Set(1, sharing::RepShare64(key2.r_sh_0, key2.r_sh_1));
-            break;
-        default:
-            Logger::ErrorLog(LOC, "Invalid party_id: " + ToString(chls.party_id));
-            return std::array<uint64_t, 4>{0, 0, 0, 0};
+    uint64_t               num_keys = keys.size();
+    sharing::RepShareVec64 r_0_sh(num_keys), r_1_sh(num_keys), r_2_sh(num_keys);
+    pr_prev.assign(num_keys, 0);
+    pr_next.assign(num_keys, 0);
+
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        const OblivSelectKey &key = *keys[k];
+        switch (chls.party_id) {
+            case 0:
+                r_0_sh.Set(k, sharing::RepShare64(key.r_sh_0, key.r_sh_1));
+                r_1_sh.Set(k, sharing::RepShare64(key.next_r_sh, 0));
+                r_2_sh.Set(k, sharing::RepShare64(0, key.prev_r_sh));
+                break;
+            case 1:
+                r_0_sh.Set(k, sharing::RepShare64(0, key.prev_r_sh));
+                r_1_sh.Set(k, sharing::RepShare64(key.r_sh_0, key.r_sh_1));
+                r_2_sh.Set(k, sharing::RepShare64(key.next_r_sh, 0));
+                break;
+            case 2:
+                r_0_sh.Set(k, sharing::RepShare64(key.next_r_sh, 0));
+                r_1_sh.Set(k, sharing::RepShare64(0, key.prev_r_sh));
+                r_2_sh.Set(k, sharing::RepShare64(key.r_sh_0, key.r_sh_1));
+                break;
+            default:
+                Logger::ErrorLog(LOC, "Invalid party_id: " + ToString(chls.party_id));
+                return;
+        }
     }
 
     // Reconstruct p ^ r_i
-    sharing::RepShareVec64 pr_prev_sh(2);
-    sharing::RepShareVec64 pr_next_sh(2);
+    sharing::RepShareVec64 pr_prev_sh(num_keys);
+    sharing::RepShareVec64 pr_next_sh(num_keys);
 
     if (chls.party_id == 0) {
         // p ^ r_1 between Party 0 and Party 2
@@ -659,14 +661,14 @@ std::array<uint64_t, 4> OblivSelectEvaluator::ReconstructPRBinary(Channels
         brss_.EvaluateXor(index, r_2_sh, pr_next_sh);
         chls.prev.send(pr_prev_sh[0]);
         chls.next.send(pr_next_sh[1]);
-        std::vector<uint64_t> p_r_1_prev(2);
-        std::vector<uint64_t> p_r_2_next(2);
+        std::vector<uint64_t> p_r_1_prev(num_keys);
+        std::vector<uint64_t> p_r_2_next(num_keys);
         chls.next.recv(p_r_2_next);
         chls.prev.recv(p_r_1_prev);
-        pr_next1 = p_r_1_prev[0] ^ pr_prev_sh[0][0] ^ pr_prev_sh[1][0];
-        pr_prev1 = pr_next_sh[0][0] ^ pr_next_sh[1][0] ^ p_r_2_next[0];
-        pr_next2 = p_r_1_prev[1] ^ pr_prev_sh[0][1] ^ pr_prev_sh[1][1];
-        pr_prev2 = pr_next_sh[0][1] ^ pr_next_sh[1][1] ^ p_r_2_next[1];
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_next[k] = p_r_1_prev[k] ^ pr_prev_sh[0][k] ^ pr_prev_sh[1][k];
+            pr_prev[k] = pr_next_sh[0][k] ^ pr_next_sh[1][k] ^ p_r_2_next[k];
+        }
 
     } else if (chls.party_id == 1) {
         // p ^ r_0 between Party 1 and Party 2
@@ -675,14 +677,14 @@ std::array<uint64_t, 4> OblivSelectEvaluator::ReconstructPRBinary(Channels
         brss_.EvaluateXor(index, r_2_sh, pr_prev_sh);
         chls.next.send(pr_next_sh[1]);
         chls.prev.send(pr_prev_sh[0]);
-        std::vector<uint64_t> p_r_0_next(2);
-        std::vector<uint64_t> p_r_2_prev(2);
+        std::vector<uint64_t> p_r_0_next(num_keys);
+        std::vector<uint64_t> p_r_2_prev(num_keys);
         chls.prev.recv(p_r_2_prev);
         chls.next.recv(p_r_0_next);
-        pr_next1 = p_r_2_prev[0] ^ pr_prev_sh[0][0] ^ pr_prev_sh[1][0];
-        pr_prev1 = pr_next_sh[0][0] ^ pr_next_sh[1][0] ^ p_r_0_next[0];
-        pr_next2 = p_r_2_prev[1] ^ pr_prev_sh[0][1] ^ pr_prev_sh[1][1];
-        pr_prev2 = pr_next_sh[0][1] ^ pr_next_sh[1][1] ^ p_r_0_next[1];
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_next[k] = p_r_2_prev[k] ^ pr_prev_sh[0][k] ^ pr_prev_sh[1][k];
+            pr_prev[k] = pr_next_sh[0][k] ^ pr_next_sh[1][k] ^ p_r_0_next[k];
+        }
 
     } else {
         // p ^ r_0 between Party 1 and Party 2
@@ -691,16 +693,15 @@ std::array<uint64_t, 4> OblivSelectEvaluator::ReconstructPRBinary(Channels
         brss_.EvaluateXor(index, r_1_sh, pr_next_sh);
         chls.prev.send(pr_prev_sh[0]);
         chls.next.send(pr_next_sh[1]);
-        std::vector<uint64_t> p_r_0_prev(2);
-        std::vector<uint64_t> p_r_1_next(2);
+        std::vector<uint64_t> p_r_0_prev(num_keys);
+        std::vector<uint64_t> p_r_1_next(num_keys);
         chls.prev.recv(p_r_0_prev);
         chls.next.recv(p_r_1_next);
-        pr_next1 = p_r_0_prev[0] ^ pr_prev_sh[0][0] ^ pr_prev_sh[1][0];
-        pr_prev1 = pr_next_sh[0][0] ^ pr_next_sh[1][0] ^ p_r_1_next[0];
-        pr_next2 = p_r_0_prev[1] ^ pr_prev_sh[0][1] ^ pr_prev_sh[1][1];
-        pr_prev2 = pr_next_sh[0][1] ^ pr_next_sh[1][1] ^ p_r_1_next[1];
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_next[k] = p_r_0_prev[k] ^ pr_prev_sh[0][k] ^ pr_prev_sh[1][k];
+            pr_prev[k] = pr_next_sh[0][k] ^ pr_next_sh[1][k] ^ p_r_1_next[k];
+        }
     }
-    return std::array<uint64_t, 4>{pr_prev1, pr_next1, pr_prev2, pr_next2};
 }
 
 void OblivSelectEvaluator::EvaluateNextSeed(
@@ -719,8 +720,8 @@ void OblivSelectEvaluator::EvaluateNextSeed(
     expanded_seeds[fss::kLeft] ^= mask;
     expanded_seeds[fss::kRight] ^= mask;
 
-    const bool control_mask_left  = key.cw_control_left[current_level] & current_control_bit;
-    const bool control_mask_right = key.cw_control_right[current_level] & current_control_bit;
+    const bool control_mask_left  = key.GetControlLeft(current_level) & current_control_bit;
+    const bool control_mask_right = key.GetControlRight(current_level) & current_control_bit;
     expanded_control_bits[fss::kLeft] ^= control_mask_left;
     expanded_control_bits[fss::kRight] ^= control_mask_right;
 }
@@ -1,6 +1,8 @@
 #ifndef PROTOCOL_OBLIV_SELECT_H_
 #define PROTOCOL_OBLIV_SELECT_H_
 
+#include <span>
+
 #include "RingOA/fss/dpf_eval.h"
 #include "RingOA/fss/dpf_gen.h"
 #include "RingOA/fss/dpf_key.h"
@@ -141,6 +143,16 @@ public:
                            const sharing::RepShareVec64  &index,
                            sharing::RepShareVec64        &result) const;
 
+    // Batched selection: result[k] is the share of database[index[k]] under keys[k]. The masked
+    // indices and the reshare each take one message per neighbour for the whole batch.
+    void EvaluateBatch(Channels                              &chls,
+                       std::span<const OblivSelectKey *const> keys,
+                       std::vector<block>                    &uv_prev,
+                       std::vector<block>                    &uv_next,
+                       const sharing::RepShareView64         &database,
+                       const sharing::RepShareVec64          &index,
+                       sharing::RepShareVec64                &result) const;
+
     block ComputeDotProductBlockSIMD(const fss::dpf::DpfKey       &key,
                                      const std::span<const block> &database,
                                      const uint64_t                pr) const;
@@ -154,20 +166,26 @@ public:
                                                                    const uint64_t                 pr_next) const;
 
 private:
-    OblivSelectParameters               params_;
-    fss::dpf::DpfEvaluator              eval_;
-    sharing::BinaryReplicatedSharing3P &brss_;
-    fss::prg::PseudoRandomGenerator    &G_;
+    OblivSelectParameters                  params_;
+    fss::dpf::DpfEvaluator                 eval_;
+    sharing::BinaryReplicatedSharing3P    &brss_;
+    const fss::prg::PseudoRandomGenerator &G_;
 
     // Internal functions
+    template <size_t N>
+    block ComputeDotProductBlockBatched(const fss::dpf::DpfKey       &key,
+                                        const std::span<const block> &database,
+                                        const uint64_t                pr) const;
+
     std::pair<uint64_t, uint64_t> ReconstructPRBinary(Channels                  &chls,
                                                       const OblivSelectKey      &key,
                                                       const sharing::RepShare64 &index) const;
 
-    std::array<uint64_t, 4> ReconstructPRBinary(Channels                     &chls,
-                                                const OblivSelectKey         &key1,
-                                                const OblivSelectKey         &key2,
-                                                const sharing::RepShareVec64 &index) const;
+    void ReconstructPRBinary(Channels                              &chls,
+                             std::span<const OblivSelectKey *const> keys,
+                             const sharing::RepShareVec64          &index,
+                             std::vector<uint64_t>                 &pr_prev,
+                             std::vector<uint64_t>                 &pr_next) const;
 
     void EvaluateNextSeed(const uint64_t current_level, const block &current_seed, const bool &current_control_bit,
                           std::array<block, 2> &expanded_seeds, std::array<bool, 2> &expanded_control_bits,
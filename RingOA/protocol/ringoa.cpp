@@ -1,13 +1,19 @@
 #include "ringoa.h"
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <tuple>
 
 #include "RingOA/fss/prg.h"
+#include "RingOA/protocol/dot_product.h"
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/rng.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
@@ -91,6 +97,32 @@ void RingOaKey::Deserialize(const std::vector<uint8_t> &buffer) {
     std::memcpy(&wsh_from_next, buffer.data() + offset, sizeof(wsh_from_next));
 }
 
+size_t RingOaKey::CalculateLegacySerializedSize(const RingOaParameters &params) {
+    return sizeof(uint64_t) + 2 * fss::dpf::DpfKey::CalculateLegacySerializedSize(params.GetParameters()) +
+           4 * sizeof(uint64_t);
+}
+
+void RingOaKey::ConvertLegacy(const RingOaParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed) {
+    if (legacy.size() != CalculateLegacySerializedSize(params)) {
+        throw std::invalid_argument("Invalid legacy RingOaKey: size " + ToString(legacy.size()) + " != " + ToString(CalculateLegacySerializedSize(params)));
+    }
+    const size_t key_size = fss::dpf::DpfKey::CalculateLegacySerializedSize(params.GetParameters());
+    auto         it       = legacy.begin();
+
+    // Party ID
+    packed.insert(packed.end(), it, it + sizeof(uint64_t));
+    it += sizeof(uint64_t);
+
+    // DPF keys
+    for (int i = 0; i < 2; ++i) {
+        fss::dpf::DpfKey::ConvertLegacy(std::vector<uint8_t>(it, it + key_size), packed);
+        it += key_size;
+    }
+
+    // Random shares
+    packed.insert(packed.end(), it, legacy.end());
+}
+
 void RingOaKey::PrintKey(const bool detailed) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     if (detailed) {
@@ -120,7 +152,18 @@ RingOaKeyGenerator::RingOaKeyGenerator(
     const RingOaParameters     &params,
     sharing::AdditiveSharing2P &ass)
     : params_(params),
-      gen_(params.GetParameters()), ass_(ass) {
+      gen_(params.GetParameters()), ass_(ass),
+      num_threads_(1),
+      pool_(nullptr) {
+}
+
+void RingOaKeyGenerator::SetNumThreads(const uint64_t num_threads) {
+    num_threads_ = std::max<uint64_t>(num_threads, 1);
+    if (num_threads_ > 1) {
+        pool_ = std::make_shared<ThreadPool>(num_threads_);
+    } else {
+        pool_.reset();
+    }
 }
 
 std::array<RingOaKey, 3> RingOaKeyGenerator::GenerateKeys() const {
@@ -186,6 +229,77 @@ std::array<RingOaKey, 3> RingOaKeyGenerator::GenerateKeys() const {
     return keys;
 }
 
+std::vector<std::array<RingOaKey, 3>> RingOaKeyGenerator::GenerateKeys(const uint64_t count) const {
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Generate " + ToString(count) + " RingOa key triples"));
+#endif
+
+    // One draw from the caller's stream seeds every chunk
+    const uint64_t                                     num_chunks = (count + kKeyGenChunkSize - 1) / kKeyGenChunkSize;
+    const block                                        base_seed  = GlobalRng::Rand<block>();
+    std::vector<std::vector<std::array<RingOaKey, 3>>> chunks(num_chunks);
+
+    auto generate_chunk = [&](uint64_t c) {
+        GlobalRng::ScopedSeed seed(GlobalRng::DeriveSeed(base_seed, c));
+        GenerateKeyChunk(std::min(kKeyGenChunkSize, count - c * kKeyGenChunkSize), chunks[c]);
+    };
+    if (pool_ && num_chunks > 1) {
+        pool_->ParallelFor(num_chunks, generate_chunk);
+    } else {
+        for (uint64_t c = 0; c < num_chunks; ++c) {
+            generate_chunk(c);
+        }
+    }
+
+    std::vector<std::array<RingOaKey, 3>> keys;
+    keys.reserve(count);
+    for (auto &chunk : chunks) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(keys));
+    }
+    return keys;
+}
+
+void RingOaKeyGenerator::GenerateKeyChunk(const uint64_t count, std::vector<std::array<RingOaKey, 3>> &keys) const {
+    uint64_t d             = params_.GetDatabaseSize();
+    uint64_t remaining_bit = params_.GetParameters().GetInputBitsize() - params_.GetParameters().GetTerminateBitsize();
+    uint64_t num_dpf_keys  = 3 * count;
+
+    // Three DPF keys per triple, generated in one batch
+    std::vector<uint64_t>                      rands(num_dpf_keys);
+    std::vector<std::pair<uint64_t, uint64_t>> rand_shs(num_dpf_keys);
+    for (uint64_t j = 0; j < num_dpf_keys; ++j) {
+        rands[j]    = Mod2N(GlobalRng::Rand<uint64_t>(), d);
+        rand_shs[j] = ass_.Share(rands[j]);
+    }
+    std::vector<std::pair<fss::dpf::DpfKey, fss::dpf::DpfKey>> key_pairs;
+    std::vector<block>                                         final_seeds_0, final_seeds_1;
+    std::vector<bool>                                          final_control_bits_1;
+    gen_.GenerateKeys(rands, std::vector<uint64_t>(num_dpf_keys, 1), key_pairs, final_seeds_0, final_seeds_1, final_control_bits_1);
+
+    std::vector<std::pair<uint64_t, uint64_t>> w_shs(num_dpf_keys);
+    for (uint64_t j = 0; j < num_dpf_keys; ++j) {
+        uint64_t w = ComputeSignCorrection(final_seeds_0[j], final_seeds_1[j], final_control_bits_1[j],
+                                           GetLowerNBits(rands[j], remaining_bit));
+        w_shs[j]   = ass_.Share(w);
+    }
+
+    // Assign previous and next keys as in GenerateKeys()
+    keys.reserve(count);
+    for (uint64_t k = 0; k < count; ++k) {
+        keys.push_back({RingOaKey(0, params_), RingOaKey(1, params_), RingOaKey(2, params_)});
+        for (uint64_t i = 0; i < 3; ++i) {
+            uint64_t prev            = 3 * k + (i + 2) % 3;
+            uint64_t next            = 3 * k + (i + 1) % 3;
+            keys[k][i].key_from_prev = std::move(key_pairs[prev].first);
+            keys[k][i].rsh_from_prev = rand_shs[prev].first;
+            keys[k][i].wsh_from_prev = w_shs[prev].first;
+            keys[k][i].key_from_next = std::move(key_pairs[next].second);
+            keys[k][i].rsh_from_next = rand_shs[next].second;
+            keys[k][i].wsh_from_next = w_shs[next].second;
+        }
+    }
+}
+
 uint64_t RingOaKeyGenerator::ComputeSignCorrection(
     block   &final_seed_0,
     block   &final_seed_1,
@@ -221,7 +335,7 @@ RingOaEvaluator::RingOaEvaluator(
     sharing::ReplicatedSharing3P &rss,
     sharing::AdditiveSharing2P   &ass_prev,
     sharing::AdditiveSharing2P   &ass_next)
-    : params_(params), eval_(params.GetParameters()), rss_(rss), ass_prev_(ass_prev), ass_next_(ass_next) {
+    : params_(params), eval_(params.GetParameters()), rss_(rss), ass_prev_(ass_prev), ass_next_(ass_next), fde_cache_(nullptr) {
 }
 
 void RingOaEvaluator::OnlineSetUp(const uint64_t party_id, const std::string &file_path) const {
@@ -250,7 +364,7 @@ void RingOaEvaluator::Evaluate(Channels                      &chls,
     uint64_t s        = params_.GetShareSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -275,8 +389,7 @@ void RingOaEvaluator::Evaluate(Channels                      &chls,
 #endif
 
     // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block
-    auto [dp_prev, dp_next] = EvaluateFullDomainThenDotProduct(
-        party_id, key.key_from_prev, key.key_from_next, uv_prev, uv_next, database, pr_prev, pr_next);
+    auto [dp_prev, dp_next] = DotProduct(party_id, key, uv_prev, uv_next, database, pr_prev, pr_next);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, party_str + "dp_prev: " + ToString(dp_prev) + ", dp_next: " + ToString(dp_next));
 #endif
@@ -315,13 +428,169 @@ void RingOaEvaluator::Evaluate_Parallel(Channels                      &chls,
                                         const sharing::RepShareView64 &database,
                                         const sharing::RepShareVec64  &index,
                                         sharing::RepShareVec64        &result) const {
+    const std::array<const RingOaKey *, 2> keys{&key1, &key2};
+    EvaluateBatch(chls, keys, uv_prev, uv_next, database, index, result);
+}
+
+void RingOaEvaluator::StartEvaluate(Channels                  &chls,
+                                    const RingOaKey           &key,
+                                    const sharing::RepShare64 &index,
+                                    RingOaPendingEval         &op) const {
+    uint64_t s = params_.GetShareSize();
+    op.key     = &key;
+
+    // Same exchange as ReconstructMaskedValue, written for any party: the pair with the
+    // previous party masks with r_(i+1) (rsh_from_next) and the pair with the next party with
+    // r_(i+2) (rsh_from_prev); each neighbour contributes its third share
+    sharing::RepShare64 prev_sh, next_sh;
+    rss_.EvaluateSub(index, sharing::RepShare64(key.rsh_from_next, 0), prev_sh);
+    rss_.EvaluateSub(index, sharing::RepShare64(0, key.rsh_from_prev), next_sh);
+    op.pr_prev = Mod2N(prev_sh[0] + prev_sh[1], s);
+    op.pr_next = Mod2N(next_sh[0] + next_sh[1], s);
+    chls.prev.asyncSendCopy(&prev_sh[0], 1);
+    chls.next.asyncSendCopy(&next_sh[1], 1);
+    op.masked_prev = chls.prev.asyncRecv(&op.recv_prev, 1);
+    op.masked_next = chls.next.asyncRecv(&op.recv_next, 1);
+}
+
+void RingOaEvaluator::FinishEvaluate(Channels                      &chls,
+                                     std::vector<block>            &uv_prev,
+                                     std::vector<block>            &uv_next,
+                                     const sharing::RepShareView64 &database,
+                                     RingOaPendingEval             &op) const {
+    uint64_t         party_id = chls.party_id;
+    uint64_t         s        = params_.GetShareSize();
+    const RingOaKey &key      = *op.key;
+
+    op.masked_prev.get();
+    op.masked_next.get();
+    uint64_t pr_prev = Mod2N(op.pr_prev + op.recv_prev, s);
+    uint64_t pr_next = Mod2N(op.pr_next + op.recv_next, s);
+
+    auto [dp_prev, dp_next] = DotProduct(party_id, key, uv_prev, uv_next, database, pr_prev, pr_next);
+
+    uint64_t ext_dp_prev, ext_dp_next;
+    if (party_id == 0) {
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, key.wsh_from_next, ext_dp_prev);    // P0 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, key.wsh_from_prev, ext_dp_next);    // P0 <-> P1
+    } else if (party_id == 1) {
+        ass_next_.EvaluateMult(0, chls.next, dp_next, key.wsh_from_prev, ext_dp_next);    // P1 <-> P2
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, key.wsh_from_next, ext_dp_prev);    // P1 <-> P0
+    } else {
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, key.wsh_from_next, ext_dp_prev);    // P1 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, key.wsh_from_prev, ext_dp_next);    // P0 <-> P2
+    }
+
+    // Reshare without waiting: the next access can start computing meanwhile
+    sharing::RepShare64 r_sh;
+    rss_.Rand(r_sh);
+    op.result[0] = Mod2N(ext_dp_prev + ext_dp_next + r_sh[0] - r_sh[1], s);
+    chls.next.asyncSendCopy(&op.result[0], 1);
+    op.reshare = chls.prev.asyncRecv(&op.result[1], 1);
+}
+
+void RingOaEvaluator::WaitEvaluate(RingOaPendingEval   &op,
+                                   sharing::RepShare64 &result) const {
+    op.reshare.get();
+    result = op.result;
+}
+
+void RingOaEvaluator::EvaluatePipelined(Channels                         &chls,
+                                        std::span<const RingOaKey *const> keys,
+                                        std::vector<block>               &uv_prev,
+                                        std::vector<block>               &uv_next,
+                                        const sharing::RepShareView64    &database,
+                                        const sharing::RepShareVec64     &index,
+                                        sharing::RepShareVec64           &result,
+                                        const uint64_t                    depth) const {
+    uint64_t num_keys = keys.size();
+
+    if (index.Size() != num_keys) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_keys) + ", index=" + ToString(index.Size()));
+        return;
+    }
+    if (result.Size() != num_keys) {
+        result = sharing::RepShareVec64(num_keys);
+    }
+
+    // ops never reallocates, so the posted receives keep valid targets
+    std::vector<RingOaPendingEval> ops(num_keys);
+    const uint64_t                 window  = std::max<uint64_t>(depth, 1);
+    uint64_t                       started = 0;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        for (; started < num_keys && started < k + window; ++started) {
+            StartEvaluate(chls, *keys[started], index.At(started), ops[started]);
+        }
+        FinishEvaluate(chls, uv_prev, uv_next, database, ops[k]);
+    }
+    sharing::RepShare64 result_sh;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        WaitEvaluate(ops[k], result_sh);
+        result.Set(k, result_sh);
+    }
+}
+
+CoTask RingOaEvaluator::EvaluateCo(CoScheduler                  &sched,
+                                   Channels                     &chls,
+                                   const RingOaKey              &key,
+                                   std::vector<block>           &uv_prev,
+                                   std::vector<block>           &uv_next,
+                                   const sharing::RepShareView64 database,
+                                   const sharing::RepShare64     index,
+                                   sharing::RepShare64          &result) const {
+    uint64_t party_id = chls.party_id;
+    uint64_t s        = params_.GetShareSize();
+
+    // Round 1: masked index
+    RingOaPendingEval op;
+    StartEvaluate(chls, key, index, op);
+    co_await sched.Wait(std::move(op.masked_prev), std::move(op.masked_next));
+    uint64_t pr_prev = Mod2N(op.pr_prev + op.recv_prev, s);
+    uint64_t pr_next = Mod2N(op.pr_next + op.recv_next, s);
+
+    auto [dp_prev, dp_next] = DotProduct(party_id, key, uv_prev, uv_next, database, pr_prev, pr_next);
+
+    // Round 2: both sign-correction multiplications at once (this party is party 1 of the pair
+    // with the previous party and party 0 of the pair with the next one)
+    sharing::BeaverTriple   triple_prev, triple_next;
+    std::array<uint64_t, 2> de_prev, de_next, de_from_prev, de_from_next;
+    ass_prev_.EvaluateMultMask(dp_prev, key.wsh_from_next, triple_prev, de_prev);
+    ass_next_.EvaluateMultMask(dp_next, key.wsh_from_prev, triple_next, de_next);
+    chls.prev.asyncSendCopy(de_prev.data(), de_prev.size());
+    chls.next.asyncSendCopy(de_next.data(), de_next.size());
+    co_await sched.Wait(chls.prev.asyncRecv(de_from_prev.data(), de_from_prev.size()),
+                        chls.next.asyncRecv(de_from_next.data(), de_from_next.size()));
+    uint64_t ext_dp_prev, ext_dp_next;
+    ass_prev_.EvaluateMultCombine(1, triple_prev, de_from_prev, de_prev, ext_dp_prev);
+    ass_next_.EvaluateMultCombine(0, triple_next, de_next, de_from_next, ext_dp_next);
+
+    // Round 3: reshare
+    sharing::RepShare64 r_sh;
+    rss_.Rand(r_sh);
+    result[0] = Mod2N(ext_dp_prev + ext_dp_next + r_sh[0] - r_sh[1], s);
+    chls.next.asyncSendCopy(&result[0], 1);
+    co_await sched.Wait(chls.prev.asyncRecv(&result[1], 1));
+}
+
+void RingOaEvaluator::EvaluateBatch(Channels                         &chls,
+                                    std::span<const RingOaKey *const> keys,
+                                    std::vector<block>               &uv_prev,
+                                    std::vector<block>               &uv_next,
+                                    const sharing::RepShareView64    &database,
+                                    const sharing::RepShareVec64     &index,
+                                    sharing::RepShareVec64           &result) const {
 
     uint64_t party_id = chls.party_id;
     uint64_t d        = params_.GetDatabaseSize();
     uint64_t s        = params_.GetShareSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
+    uint64_t num_keys = keys.size();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (index.Size() != num_keys) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_keys) + ", index=" + ToString(index.Size()));
+        return;
+    }
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -330,56 +599,148 @@ void RingOaEvaluator::Evaluate_Parallel(Channels                      &chls,
         Logger::ErrorLog(LOC, "Database size does not match the number of nodes: " +
                                   ToString(database.Size()) + " != " + ToString(1UL << d));
     }
+    if (result.Size() != num_keys) {
+        result = sharing::RepShareVec64(num_keys);
+    }
+    if (num_keys == 0) {
+        return;
+    }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate RingOa key"));
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate " + ToString(num_keys) + " RingOa keys"));
     Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
     std::string party_str = "[P" + ToString(party_id) + "] ";
     Logger::DebugLog(LOC, party_str + " idx: " + index.ToString());
     Logger::DebugLog(LOC, party_str + " db: " + database.ToString());
 #endif
 
-    // Reconstruct p - r_i
-    // pr: [pr_prev1, pr_next1, pr_prev2, pr_next2]
-    std::array<uint64_t, 4> pr = ReconstructMaskedValue(chls, key1, key2, index);
+    // Reconstruct p - r_i for every key (one message per neighbour)
+    std::vector<uint64_t> pr_prev, pr_next;
+    ReconstructMaskedValue(chls, keys, index, pr_prev, pr_next);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + " pr_prev1: " + ToString(pr[0]) + ", pr_next1: " + ToString(pr[1]) +
-                              ", pr_prev2: " + ToString(pr[2]) + ", pr_next2: " + ToString(pr[3]));
+    Logger::DebugLog(LOC, party_str + " pr_prev: " + ToString(pr_prev) + ", pr_next: " + ToString(pr_next));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block
-    auto [dp_prev1, dp_next1] = EvaluateFullDomainThenDotProduct(
-        party_id, key1.key_from_prev, key1.key_from_next, uv_prev, uv_next, database, pr[0], pr[1]);
-    auto [dp_prev2, dp_next2] = EvaluateFullDomainThenDotProduct(
-        party_id, key2.key_from_prev, key2.key_from_next, uv_prev, uv_next, database, pr[2], pr[3]);
+    // Evaluate DPF (local): groups of keys share one pass over the database
+    std::vector<uint64_t> dp_prev(num_keys), dp_next(num_keys), wsh_prev(num_keys), wsh_next(num_keys);
+    if (num_keys == 1) {
+        std::tie(dp_prev[0], dp_next[0]) = DotProduct(party_id, *keys[0], uv_prev, uv_next, database, pr_prev[0], pr_next[0]);
+    } else {
+        for (uint64_t k = 0; k < num_keys; k += kDotProductBatchSize) {
+            const uint64_t n = std::min(kDotProductBatchSize, num_keys - k);
+            DotProductBatch(keys.subspan(k, n), database,
+                            std::span<const uint64_t>(pr_prev).subspan(k, n), std::span<const uint64_t>(pr_next).subspan(k, n),
+                            std::span<uint64_t>(dp_prev).subspan(k, n), std::span<uint64_t>(dp_next).subspan(k, n));
+        }
+    }
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        wsh_prev[k] = keys[k]->wsh_from_prev;
+        wsh_next[k] = keys[k]->wsh_from_next;
+    }
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + "dp_prev1: " + ToString(dp_prev1) + ", dp_next1: " + ToString(dp_next1));
-    Logger::DebugLog(LOC, party_str + "dp_prev2: " + ToString(dp_prev2) + ", dp_next2: " + ToString(dp_next2));
+    Logger::DebugLog(LOC, party_str + "dp_prev: " + ToString(dp_prev) + ", dp_next: " + ToString(dp_next));
 #endif
 
-    std::array<uint64_t, 2> ext_dp_prev, ext_dp_next;
+    std::vector<uint64_t> ext_dp_prev, ext_dp_next;
     if (party_id == 0) {
-        ass_prev_.EvaluateMult(1, chls.prev, {dp_prev1, dp_prev2}, {key1.wsh_from_next, key2.wsh_from_next}, ext_dp_prev);    // P0 <-> P2
-        ass_next_.EvaluateMult(0, chls.next, {dp_next1, dp_next2}, {key1.wsh_from_prev, key2.wsh_from_prev}, ext_dp_next);    // P0 <-> P1
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P0 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P0 <-> P1
     } else if (party_id == 1) {
-        ass_next_.EvaluateMult(0, chls.next, {dp_next1, dp_next2}, {key1.wsh_from_prev, key2.wsh_from_prev}, ext_dp_next);    // P1 <-> P2
-        ass_prev_.EvaluateMult(1, chls.prev, {dp_prev1, dp_prev2}, {key1.wsh_from_next, key2.wsh_from_next}, ext_dp_prev);    // P1 <-> P0
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P1 <-> P2
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P1 <-> P0
     } else {
-        ass_prev_.EvaluateMult(1, chls.prev, {dp_prev1, dp_prev2}, {key1.wsh_from_next, key2.wsh_from_next}, ext_dp_prev);    // P1 <-> P2
-        ass_next_.EvaluateMult(0, chls.next, {dp_next1, dp_next2}, {key1.wsh_from_prev, key2.wsh_from_prev}, ext_dp_next);    // P0 <-> P2
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P1 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P0 <-> P2
     }
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + "ext_dp_prev1: " + ToString(ext_dp_prev[0]) + ", ext_dp_prev2: " + ToString(ext_dp_prev[1]) +
-                              ", ext_dp_next1: " + ToString(ext_dp_next[0]) + ", ext_dp_next2: " + ToString(ext_dp_next[1]));
+    Logger::DebugLog(LOC, party_str + "ext_dp_prev: " + ToString(ext_dp_prev) + ", ext_dp_next: " + ToString(ext_dp_next));
 #endif
 
-    uint64_t            selected1_sh = Mod2N(ext_dp_prev[0] + ext_dp_next[0], s);
-    uint64_t            selected2_sh = Mod2N(ext_dp_prev[1] + ext_dp_next[1], s);
-    sharing::RepShare64 r1_sh, r2_sh;
-    rss_.Rand(r1_sh);
-    rss_.Rand(r2_sh);
-    result[0][0] = Mod2N(selected1_sh + r1_sh[0] - r1_sh[1], s);
-    result[0][1] = Mod2N(selected2_sh + r2_sh[0] - r2_sh[1], s);
+    sharing::RepShare64 r_sh;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        rss_.Rand(r_sh);
+        result[0][k] = Mod2N(ext_dp_prev[k] + ext_dp_next[k] + r_sh[0] - r_sh[1], s);
+    }
+    chls.next.send(result[0]);
+    chls.prev.recv(result[1]);
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, party_str + " result: " + ToString(result[0]) + ", " + ToString(result[1]));
+#endif
+}
+
+void RingOaEvaluator::EvaluateRecord(Channels                     &chls,
+                                     const RingOaKey              &key,
+                                     std::vector<block>           &uv_prev,
+                                     std::vector<block>           &uv_next,
+                                     const sharing::RepShareMat64 &database,
+                                     const sharing::RepShare64    &index,
+                                     sharing::RepShareVec64       &result) const {
+
+    uint64_t party_id  = chls.party_id;
+    uint64_t d         = params_.GetDatabaseSize();
+    uint64_t s         = params_.GetShareSize();
+    uint64_t nu        = params_.GetParameters().GetTerminateBitsize();
+    uint64_t num_words = database.rows;
+
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
+        Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
+                                  ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
+                                  " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
+    }
+    if (database.cols != (1UL << d)) {
+        Logger::ErrorLog(LOC, "Database row size does not match the number of nodes: " +
+                                  ToString(database.cols) + " != " + ToString(1UL << d));
+        return;
+    }
+    if (result.Size() != num_words) {
+        result = sharing::RepShareVec64(num_words);
+    }
+    if (num_words == 0) {
+        return;
+    }
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate RingOa key on " + ToString(num_words) + "-word records"));
+    Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
+    std::string party_str = "[P" + ToString(party_id) + "] ";
+    Logger::DebugLog(LOC, party_str + " idx: " + index.ToString());
+#endif
+
+    // Reconstruct p - r_i (once for the whole record)
+    auto [pr_prev, pr_next] = ReconstructMaskedValue(chls, key, index);
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, party_str + " pr_prev: " + ToString(pr_prev) + ", pr_next: " + ToString(pr_next));
+#endif
+
+    // Evaluate DPF once, then one dot product per word
+    std::vector<uint64_t> dp_prev, dp_next;
+    DotProductRecord(party_id, key, uv_prev, uv_next, database, pr_prev, pr_next, dp_prev, dp_next);
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, party_str + "dp_prev: " + ToString(dp_prev) + ", dp_next: " + ToString(dp_next));
+#endif
+
+    // Every word is corrected by the same sign share
+    std::vector<uint64_t> wsh_prev(num_words, key.wsh_from_prev), wsh_next(num_words, key.wsh_from_next);
+    std::vector<uint64_t> ext_dp_prev, ext_dp_next;
+    if (party_id == 0) {
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P0 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P0 <-> P1
+    } else if (party_id == 1) {
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P1 <-> P2
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P1 <-> P0
+    } else {
+        ass_prev_.EvaluateMult(1, chls.prev, dp_prev, wsh_next, ext_dp_prev);    // P1 <-> P2
+        ass_next_.EvaluateMult(0, chls.next, dp_next, wsh_prev, ext_dp_next);    // P0 <-> P2
+    }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, party_str + "ext_dp_prev: " + ToString(ext_dp_prev) + ", ext_dp_next: " + ToString(ext_dp_next));
+#endif
+
+    sharing::RepShare64 r_sh;
+    for (uint64_t w = 0; w < num_words; ++w) {
+        rss_.Rand(r_sh);
+        result[0][w] = Mod2N(ext_dp_prev[w] + ext_dp_next[w] + r_sh[0] - r_sh[1], s);
+    }
     chls.next.send(result[0]);
     chls.prev.recv(result[1]);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
@@ -405,33 +766,198 @@ std::pair<uint64_t, uint64_t> RingOaEvaluator::EvaluateFullDomainThenDotProduct(
     Logger::DebugLog(LOC, "[P" + ToString(party_id) + "] key_from_next ID: " + ToString(key_from_next.party_id));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block == __m128i)
-    eval_.EvaluateFullDomain(key_from_next, uv_prev);
-    eval_.EvaluateFullDomain(key_from_prev, uv_next);
-    uint64_t      dp_prev = 0, dp_next = 0;
-    const int64_t s_prev = Sign(key_from_prev.party_id);
-    const int64_t s_next = Sign(key_from_next.party_id);
-
-    for (size_t i = 0; i < uv_prev.size(); ++i) {
-        const uint64_t low_prev  = uv_prev[i].get<uint64_t>()[0];
-        const uint64_t high_prev = uv_prev[i].get<uint64_t>()[1];
-        const uint64_t low_next  = uv_next[i].get<uint64_t>()[0];
-        const uint64_t high_next = uv_next[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((low_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((low_next >> j) & 1ULL);
-            dp_prev                  = Mod2N(dp_prev + s_next * (database.share1[Mod2N((i * 128 + j) + pr_prev, d)] & mask_prev), s);
-            dp_next                  = Mod2N(dp_next + s_prev * (database.share0[Mod2N((i * 128 + j) + pr_next, d)] & mask_next), s);
+    // Evaluate both DPF keys in lockstep (uv_prev and uv_next are std::vector<block>, where block == __m128i)
+    const std::array<const fss::dpf::DpfKey *, 2> keys{&key_from_next, &key_from_prev};
+    uint64_t                                      dp_prev = 0, dp_next = 0;
+    const int64_t                                 s_prev = Sign(key_from_prev.party_id);
+    const int64_t                                 s_next = Sign(key_from_next.party_id);
+
+    // Leaf i of keys[k] selects 128 database entries (k = 0: dp_prev, k = 1: dp_next);
+    // the sums wrap mod 2^64 and are signed and reduced once at the end
+    if (uv_prev.empty() && uv_next.empty()) {
+        // No output buffers: consume the leaves while they are still in L1
+        eval_.VisitFullDomain(keys, [&](uint64_t k, uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            ((k == 0) ? dp_prev : dp_next) += RotatedSelectSum((k == 0) ? database.share1 : database.share0, d,
+                                                               bits.data(), 128, i * 128, (k == 0) ? pr_prev : pr_next);
+        });
+    } else {
+        const std::array<std::vector<block> *, 2> uvs{&uv_prev, &uv_next};
+        eval_.EvaluateFullDomain(keys, uvs);
+        dp_prev = RotatedSelectSum(database.share1, d, reinterpret_cast<const uint64_t *>(uv_prev.data()), uv_prev.size() * 128, 0, pr_prev);
+        dp_next = RotatedSelectSum(database.share0, d, reinterpret_cast<const uint64_t *>(uv_next.data()), uv_next.size() * 128, 0, pr_next);
+    }
+    return std::make_pair(Mod2N(s_next * dp_prev, s), Mod2N(s_prev * dp_next, s));
+}
+
+std::pair<uint64_t, uint64_t> RingOaEvaluator::DotProduct(
+    const uint64_t                 party_id,
+    const RingOaKey               &key,
+    std::vector<block>            &uv_prev,
+    std::vector<block>            &uv_next,
+    const sharing::RepShareView64 &database,
+    const uint64_t                 pr_prev,
+    const uint64_t                 pr_next) const {
+
+    const RingOaFdeCache::Entry *cached = (fde_cache_ != nullptr) ? fde_cache_->Acquire(key) : nullptr;
+    if (cached == nullptr) {
+        return EvaluateFullDomainThenDotProduct(party_id, key.key_from_prev, key.key_from_next, uv_prev, uv_next, database, pr_prev, pr_next);
+    }
+
+    // Precomputed expansion: only the rotated dot products remain (same layout and signs as
+    // EvaluateFullDomainThenDotProduct with output buffers)
+    uint64_t d       = params_.GetDatabaseSize();
+    uint64_t s       = params_.GetShareSize();
+    uint64_t dp_prev = RotatedSelectSum(database.share1, d, reinterpret_cast<const uint64_t *>(cached->uv_prev.data()),
+                                        cached->uv_prev.size() * 128, 0, pr_prev);
+    uint64_t dp_next = RotatedSelectSum(database.share0, d, reinterpret_cast<const uint64_t *>(cached->uv_next.data()),
+                                        cached->uv_next.size() * 128, 0, pr_next);
+    fde_cache_->Release(cached);
+    return std::make_pair(Mod2N(Sign(key.key_from_next.party_id) * dp_prev, s), Mod2N(Sign(key.key_from_prev.party_id) * dp_next, s));
+}
+
+void RingOaEvaluator::DotProductBatch(
+    std::span<const RingOaKey *const> keys,
+    const sharing::RepShareView64    &database,
+    std::span<const uint64_t>         pr_prev,
+    std::span<const uint64_t>         pr_next,
+    std::span<uint64_t>               dp_prev,
+    std::span<uint64_t>               dp_next) const {
+
+    uint64_t d        = params_.GetDatabaseSize();
+    uint64_t s        = params_.GetShareSize();
+    uint64_t num_keys = keys.size();
+
+    // Keys with a precomputed expansion and keys expanded here
+    std::vector<const RingOaFdeCache::Entry *> cached(num_keys, nullptr);
+    std::vector<uint64_t>                      cached_keys, fresh_keys;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        cached[k] = (fde_cache_ != nullptr) ? fde_cache_->Acquire(*keys[k]) : nullptr;
+        (cached[k] != nullptr ? cached_keys : fresh_keys).push_back(k);
+    }
+
+    // Same layout and signs as EvaluateFullDomainThenDotProduct with output buffers:
+    // side 0 pairs key_from_next with share1 (dp_prev), side 1 key_from_prev with share0 (dp_next)
+    for (int side = 0; side < 2; ++side) {
+        const auto                     &share   = (side == 0) ? database.share1 : database.share0;
+        const std::span<const uint64_t> pr      = (side == 0) ? pr_prev : pr_next;
+        const std::span<uint64_t>       dp      = (side == 0) ? dp_prev : dp_next;
+        auto                            dpf_key = [&](uint64_t k) -> const fss::dpf::DpfKey & {
+            return (side == 0) ? keys[k]->key_from_next : keys[k]->key_from_prev;
+        };
+
+        if (!cached_keys.empty()) {
+            std::vector<const uint64_t *> bits(cached_keys.size());
+            std::vector<uint64_t>         shifts(cached_keys.size()), sums(cached_keys.size());
+            for (size_t i = 0; i < cached_keys.size(); ++i) {
+                const auto &uv = (side == 0) ? cached[cached_keys[i]]->uv_prev : cached[cached_keys[i]]->uv_next;
+                bits[i]        = reinterpret_cast<const uint64_t *>(uv.data());
+                shifts[i]      = pr[cached_keys[i]];
+            }
+            RotatedSelectSumBatch(share, d, bits, shifts, sums);
+            for (size_t i = 0; i < cached_keys.size(); ++i) {
+                dp[cached_keys[i]] = sums[i];
+            }
+        }
+
+        if (!fresh_keys.empty()) {
+            // A bit tile of kDotProductTileEntries positions is a subtree of tile / 128 leaves
+            const uint64_t                        leaves = std::min<uint64_t>(kDotProductTileEntries, 1ULL << d) / 128;
+            std::vector<uint64_t>                 shifts(fresh_keys.size()), sums(fresh_keys.size()), firsts;
+            std::vector<const fss::dpf::DpfKey *> tile_keys;
+            std::vector<block *>                  tile_outputs;
+            for (size_t i = 0; i < fresh_keys.size(); ++i) {
+                shifts[i] = pr[fresh_keys[i]];
+            }
+            auto expand = [&](std::span<const uint64_t> queries, std::span<const uint64_t> tiles, std::span<uint64_t *const> outputs) {
+                tile_keys.clear();
+                firsts.clear();
+                tile_outputs.clear();
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    tile_keys.push_back(&dpf_key(fresh_keys[queries[i]]));
+                    firsts.push_back(tiles[i] * leaves);
+                    tile_outputs.push_back(reinterpret_cast<block *>(outputs[i]));
+                }
+                eval_.EvaluateSubtrees(tile_keys, firsts, leaves, tile_outputs);
+            };
+            RotatedSelectSumTiled(share, d, shifts, expand, sums);
+            for (size_t i = 0; i < fresh_keys.size(); ++i) {
+                dp[fresh_keys[i]] = sums[i];
+            }
+        }
+    }
+
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        if (cached[k] != nullptr) {
+            fde_cache_->Release(cached[k]);
+        }
+        dp_prev[k] = Mod2N(Sign(keys[k]->key_from_next.party_id) * dp_prev[k], s);
+        dp_next[k] = Mod2N(Sign(keys[k]->key_from_prev.party_id) * dp_next[k], s);
+    }
+}
+
+void RingOaEvaluator::DotProductRecord(
+    const uint64_t                party_id,
+    const RingOaKey              &key,
+    std::vector<block>           &uv_prev,
+    std::vector<block>           &uv_next,
+    const sharing::RepShareMat64 &database,
+    const uint64_t                pr_prev,
+    const uint64_t                pr_next,
+    std::vector<uint64_t>        &dp_prev,
+    std::vector<uint64_t>        &dp_next) const {
+
+    uint64_t d         = params_.GetDatabaseSize();
+    uint64_t s         = params_.GetShareSize();
+    uint64_t num_words = database.rows;
+    uint64_t row_size  = database.cols;
+    // Row w of share j starts at database[j].data() + w * row_size
+    const uint64_t *db0 = database[0].data();
+    const uint64_t *db1 = database[1].data();
+    dp_prev.assign(num_words, 0);
+    dp_next.assign(num_words, 0);
+
+    const RingOaFdeCache::Entry *cached = (fde_cache_ != nullptr) ? fde_cache_->Acquire(key) : nullptr;
+    if (cached == nullptr && uv_prev.empty() && uv_next.empty()) {
+        // No output buffers: every row consumes each leaf while it is still in L1
+        const std::array<const fss::dpf::DpfKey *, 2> keys{&key.key_from_next, &key.key_from_prev};
+        eval_.VisitFullDomain(keys, [&](uint64_t k, uint64_t i, const block &leaf) {
+            const auto      bits  = leaf.get<uint64_t>();
+            const uint64_t *db    = (k == 0) ? db1 : db0;
+            const uint64_t  shift = (k == 0) ? pr_prev : pr_next;
+            uint64_t       *dp    = (k == 0) ? dp_prev.data() : dp_next.data();
+            for (uint64_t w = 0; w < num_words; ++w) {
+                dp[w] += RotatedSelectSum({db + w * row_size, row_size}, d, bits.data(), 128, i * 128, shift);
+            }
+        });
+    } else {
+        // Expand once (or take the precomputed expansion), then walk each row over the same bits
+        const std::vector<block> *bits_prev = &uv_prev, *bits_next = &uv_next;
+        if (cached != nullptr) {
+            bits_prev = &cached->uv_prev;
+            bits_next = &cached->uv_next;
+        } else {
+            const std::array<const fss::dpf::DpfKey *, 2> keys{&key.key_from_next, &key.key_from_prev};
+            const std::array<std::vector<block> *, 2>     uvs{&uv_prev, &uv_next};
+            eval_.EvaluateFullDomain(keys, uvs);
+        }
+        for (uint64_t w = 0; w < num_words; ++w) {
+            dp_prev[w] = RotatedSelectSum({db1 + w * row_size, row_size}, d, reinterpret_cast<const uint64_t *>(bits_prev->data()),
+                                          bits_prev->size() * 128, 0, pr_prev);
+            dp_next[w] = RotatedSelectSum({db0 + w * row_size, row_size}, d, reinterpret_cast<const uint64_t *>(bits_next->data()),
+                                          bits_next->size() * 128, 0, pr_next);
         }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((high_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((high_next >> j) & 1ULL);
-            dp_prev                  = Mod2N(dp_prev + s_next * (database.share1[Mod2N((i * 128 + 64 + j) + pr_prev, d)] & mask_prev), s);
-            dp_next                  = Mod2N(dp_next + s_prev * (database.share0[Mod2N((i * 128 + 64 + j) + pr_next, d)] & mask_next), s);
+        if (cached != nullptr) {
+            fde_cache_->Release(cached);
         }
     }
-    return std::make_pair(dp_prev, dp_next);
+
+    const int64_t s_prev = Sign(key.key_from_prev.party_id);
+    const int64_t s_next = Sign(key.key_from_next.party_id);
+    for (uint64_t w = 0; w < num_words; ++w) {
+        dp_prev[w] = Mod2N(s_next * dp_prev[w], s);
+        dp_next[w] = Mod2N(s_prev * dp_next[w], s);
+    }
 }
 
 std::pair<uint64_t, uint64_t> RingOaEvaluator::ReconstructMaskedValue(Channels                  &chls,
@@ -498,28 +1024,31 @@ std::pair<uint64_t, uint64_t> RingOaEvaluator::ReconstructMaskedValue(Channels
     return std::make_pair(pr_prev, pr_next);
 }
 
-std::array<uint64_t, 4> RingOaEvaluator::ReconstructMaskedValue(Channels                     &chls,
-                                                                const RingOaKey              &key1,
-                                                                const RingOaKey              &key2,
-                                                                const sharing::RepShareVec64 &index) const {
+void RingOaEvaluator::ReconstructMaskedValue(Channels                         &chls,
+                                             std::span<const RingOaKey *const> keys,
+                                             const sharing::RepShareVec64     &index,
+                                             std::vector<uint64_t>            &pr_prev,
+                                             std::vector<uint64_t>            &pr_next) const {
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, "ReconstructPR for Party " + ToString(chls.party_id));
+    Logger::DebugLog(LOC, "ReconstructMaskedValue (" + ToString(keys.size()) + " keys) for Party " + ToString(chls.party_id));
 #endif
 
     // Set replicated sharing of random value
     uint64_t               s        = params_.GetShareSize();
-    uint64_t               pr_prev1 = 0, pr_next1 = 0, pr_prev2 = 0, pr_next2 = 0;
-    sharing::RepShareVec64 r_0_sh(2), r_1_sh(2), r_2_sh(2);
+    uint64_t               num_keys = keys.size();
+    sharing::RepShareVec64 r_0_sh(num_keys), r_1_sh(num_keys), r_2_sh(num_keys);
+    pr_prev.resize(num_keys);
+    pr_next.resize(num_keys);
 
     // Reconstruct p - r_i
     if (chls.party_id == 0) {
-        r_1_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_2_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_1_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        r_2_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        sharing::RepShareVec64 pr_20_sh(2), pr_01_sh(2);
-        std::vector<uint64_t>  pr_20(2), pr_01(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_1_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+            r_2_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+        }
+        sharing::RepShareVec64 pr_20_sh(num_keys), pr_01_sh(num_keys);
+        std::vector<uint64_t>  pr_20(num_keys), pr_01(num_keys);
         // p - r_1 between Party 0 and Party 2
         // p - r_2 between Party 0 and Party 1
         rss_.EvaluateSub(index, r_1_sh, pr_20_sh);
@@ -528,18 +1057,18 @@ std::array<uint64_t, 4> RingOaEvaluator::ReconstructMaskedValue(Channels
         chls.next.send(pr_01_sh[1]);
         chls.next.recv(pr_01);
         chls.prev.recv(pr_20);
-        pr_prev1 = Mod2N(pr_20[0] + pr_20_sh[0][0] + pr_20_sh[1][0], s);
-        pr_next1 = Mod2N(pr_01_sh[0][0] + pr_01_sh[1][0] + pr_01[0], s);
-        pr_prev2 = Mod2N(pr_20[1] + pr_20_sh[0][1] + pr_20_sh[1][1], s);
-        pr_next2 = Mod2N(pr_01_sh[0][1] + pr_01_sh[1][1] + pr_01[1], s);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_20[k] + pr_20_sh[0][k] + pr_20_sh[1][k], s);
+            pr_next[k] = Mod2N(pr_01_sh[0][k] + pr_01_sh[1][k] + pr_01[k], s);
+        }
 
     } else if (chls.party_id == 1) {
-        r_0_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_2_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_0_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        r_2_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        sharing::RepShareVec64 pr_12_sh(2), pr_01_sh(2);
-        std::vector<uint64_t>  pr_12(2), pr_01(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_0_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+            r_2_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+        }
+        sharing::RepShareVec64 pr_12_sh(num_keys), pr_01_sh(num_keys);
+        std::vector<uint64_t>  pr_12(num_keys), pr_01(num_keys);
         // p - r_0 between Party 1 and Party 2
         // p - r_2 between Party 0 and Party 1
         rss_.EvaluateSub(index, r_0_sh, pr_12_sh);
@@ -548,18 +1077,18 @@ std::array<uint64_t, 4> RingOaEvaluator::ReconstructMaskedValue(Channels
         chls.prev.send(pr_01_sh[0]);
         chls.prev.recv(pr_01);
         chls.next.recv(pr_12);
-        pr_prev1 = Mod2N(pr_01[0] + pr_01_sh[0][0] + pr_01_sh[1][0], s);
-        pr_next1 = Mod2N(pr_12_sh[0][0] + pr_12_sh[1][0] + pr_12[0], s);
-        pr_prev2 = Mod2N(pr_01[1] + pr_01_sh[0][1] + pr_01_sh[1][1], s);
-        pr_next2 = Mod2N(pr_12_sh[0][1] + pr_12_sh[1][1] + pr_12[1], s);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_01[k] + pr_01_sh[0][k] + pr_01_sh[1][k], s);
+            pr_next[k] = Mod2N(pr_12_sh[0][k] + pr_12_sh[1][k] + pr_12[k], s);
+        }
 
     } else {
-        r_0_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_1_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_0_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        r_1_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        sharing::RepShareVec64 pr_12_sh(2), pr_20_sh(2);
-        std::vector<uint64_t>  pr_12(2), pr_20(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_0_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+            r_1_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+        }
+        sharing::RepShareVec64 pr_12_sh(num_keys), pr_20_sh(num_keys);
+        std::vector<uint64_t>  pr_12(num_keys), pr_20(num_keys);
         // p - r_0 between Party 1 and Party 2
         // p - r_1 between Party 0 and Party 2
         rss_.EvaluateSub(index, r_0_sh, pr_12_sh);
@@ -568,12 +1097,11 @@ std::array<uint64_t, 4> RingOaEvaluator::ReconstructMaskedValue(Channels
         chls.next.send(pr_20_sh[1]);
         chls.prev.recv(pr_12);
         chls.next.recv(pr_20);
-        pr_prev1 = Mod2N(pr_12[0] + pr_12_sh[0][0] + pr_12_sh[1][0], s);
-        pr_next1 = Mod2N(pr_20_sh[0][0] + pr_20_sh[1][0] + pr_20[0], s);
-        pr_prev2 = Mod2N(pr_12[1] + pr_12_sh[0][1] + pr_12_sh[1][1], s);
-        pr_next2 = Mod2N(pr_20_sh[0][1] + pr_20_sh[1][1] + pr_20[1], s);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_12[k] + pr_12_sh[0][k] + pr_12_sh[1][k], s);
+            pr_next[k] = Mod2N(pr_20_sh[0][k] + pr_20_sh[1][k] + pr_20[k], s);
+        }
     }
-    return std::array<uint64_t, 4>{pr_prev1, pr_next1, pr_prev2, pr_next2};
 }
 
 }    // namespace proto
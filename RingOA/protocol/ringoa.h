@@ -1,14 +1,19 @@
 #ifndef PROTOCOL_RINGOA_H_
 #define PROTOCOL_RINGOA_H_
 
+#include <future>
+#include <span>
+
 #include "RingOA/fss/dpf_eval.h"
 #include "RingOA/fss/dpf_gen.h"
 #include "RingOA/fss/dpf_key.h"
 #include "RingOA/sharing/share_types.h"
+#include "RingOA/utils/coro.h"
 
 namespace ringoa {
 
 class Channels;
+class ThreadPool;
 
 namespace sharing {
 
@@ -19,27 +24,29 @@ class AdditiveSharing2P;
 
 namespace proto {
 
+class RingOaFdeCache;
+
 class RingOaParameters {
 public:
     RingOaParameters() = delete;
-    explicit RingOaParameters(const uint64_t d)
-        : params_(d, 1, fss::kOptimizedEvalType, fss::OutputType::kShiftedAdditive),
+    explicit RingOaParameters(const uint64_t d, const fss::EvalType type = fss::kOptimizedEvalType)
+        : params_(d, 1, type, fss::OutputType::kShiftedAdditive),
           db_bitsize_(d),
           share_bitsize_(d) {
     }
-    explicit RingOaParameters(const uint64_t d, const uint64_t s)
-        : params_(d, 1, fss::kOptimizedEvalType, fss::OutputType::kShiftedAdditive),
+    explicit RingOaParameters(const uint64_t d, const uint64_t s, const fss::EvalType type = fss::kOptimizedEvalType)
+        : params_(d, 1, type, fss::OutputType::kShiftedAdditive),
           db_bitsize_(d),
           share_bitsize_(s) {
     }
 
-    void ReconfigureParameters(const uint64_t d) {
-        params_.ReconfigureParameters(d, 1, fss::kOptimizedEvalType, fss::OutputType::kShiftedAdditive);
+    void ReconfigureParameters(const uint64_t d, const fss::EvalType type = fss::kOptimizedEvalType) {
+        params_.ReconfigureParameters(d, 1, type, fss::OutputType::kShiftedAdditive);
         db_bitsize_    = d;
         share_bitsize_ = d;
     }
-    void ReconfigureParameters(const uint64_t d, const uint64_t s) {
-        params_.ReconfigureParameters(d, 1, fss::kOptimizedEvalType, fss::OutputType::kShiftedAdditive);
+    void ReconfigureParameters(const uint64_t d, const uint64_t s, const fss::EvalType type = fss::kOptimizedEvalType) {
+        params_.ReconfigureParameters(d, 1, type, fss::OutputType::kShiftedAdditive);
         db_bitsize_    = d;
         share_bitsize_ = s;
     }
@@ -100,6 +107,11 @@ struct RingOaKey {
     void Serialize(std::vector<uint8_t> &buffer) const;
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of the legacy form (DPF keys with one byte per control bit) for 'params'.
+    static size_t CalculateLegacySerializedSize(const RingOaParameters &params);
+    // Rewrites a key serialized with legacy DPF keys into the current form (see DpfKey::ConvertLegacy).
+    static void ConvertLegacy(const RingOaParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
@@ -107,20 +119,60 @@ private:
     size_t           serialized_size_;
 };
 
+// One RingOA access evaluated in phases (RingOaEvaluator::StartEvaluate, FinishEvaluate,
+// WaitEvaluate). Receives complete into its fields in the background, so an object must stay
+// in place (not be moved or destroyed) from StartEvaluate until WaitEvaluate returns.
+struct RingOaPendingEval {
+    const RingOaKey    *key       = nullptr;
+    uint64_t            pr_prev   = 0;    // own part of p - r for the pair with the previous party
+    uint64_t            pr_next   = 0;    // own part of p - r for the pair with the next party
+    uint64_t            recv_prev = 0;
+    uint64_t            recv_next = 0;
+    std::future<void>   masked_prev;
+    std::future<void>   masked_next;
+    sharing::RepShare64 result;
+    std::future<void>   reshare;
+};
+
+/**
+ * RingOaKeyGenerator — dealer-side generation of RingOA key triples.
+ *
+ * Batched generation
+ * - GenerateKeys(count) produces 'count' triples. The work is cut into chunks of
+ *   kKeyGenChunkSize triples; each chunk generates its 3 * chunk DPF keys with the batched
+ *   DpfKeyGenerator::GenerateKeys and runs as one task on the pool set by SetNumThreads.
+ * - Chunk c reseeds GlobalRng with GlobalRng::DeriveSeed(base, c), where base is a single
+ *   draw from the caller's GlobalRng. The triples therefore depend only on the caller's seed
+ *   (deterministic under USE_FIXED_RANDOM_SEED), not on the thread count.
+ * - GenerateKeys() keeps producing one triple from the caller's GlobalRng stream.
+ */
 class RingOaKeyGenerator {
 public:
+    static constexpr uint64_t kKeyGenChunkSize = 64;
+
     RingOaKeyGenerator() = delete;
     RingOaKeyGenerator(const RingOaParameters     &params,
                        sharing::AdditiveSharing2P &ass);
 
     void OfflineSetUp(const uint64_t num_selection, const std::string &file_path) const;
 
-    std::array<RingOaKey, 3> GenerateKeys() const;
+    // Threads used by GenerateKeys(count); 1 (default) runs it on the calling thread.
+    void     SetNumThreads(const uint64_t num_threads);
+    uint64_t GetNumThreads() const {
+        return num_threads_;
+    }
+
+    std::array<RingOaKey, 3>              GenerateKeys() const;
+    std::vector<std::array<RingOaKey, 3>> GenerateKeys(const uint64_t count) const;
 
 private:
     RingOaParameters            params_;
     fss::dpf::DpfKeyGenerator   gen_;
     sharing::AdditiveSharing2P &ass_;
+    uint64_t                    num_threads_;
+    std::shared_ptr<ThreadPool> pool_;
+
+    void GenerateKeyChunk(const uint64_t count, std::vector<std::array<RingOaKey, 3>> &keys) const;
 
     uint64_t ComputeSignCorrection(
         block   &final_seed_0,
@@ -129,8 +181,31 @@ private:
         uint64_t alpha_hat) const;
 };
 
+/**
+ * RingOaEvaluator — online evaluation of RingOA keys.
+ *
+ * Overlapping rounds with computation
+ * - Evaluate runs an access as blocking rounds: the masked-index exchange, the local
+ *   expansion and dot product, the sign-correction multiplication and the reshare.
+ * - StartEvaluate / FinishEvaluate / WaitEvaluate split the same access at its rounds using
+ *   the channels' asynchronous send and receive: StartEvaluate posts the masked-index
+ *   exchange and returns; FinishEvaluate waits for it, computes, multiplies and posts the
+ *   reshare; WaitEvaluate collects the reshared result.
+ * - EvaluatePipelined keeps up to 'depth' accesses started and not yet finished, so the
+ *   masked-index round of query k + 1 is on the wire while query k expands its keys, and no
+ *   query waits for the reshare of the previous one.
+ * - All parties must issue the same sequence of Start / Finish / Wait calls (message order
+ *   on each channel follows the call order).
+ * - EvaluateCo is the coroutine form for sessions multiplexed by a CoScheduler: the three
+ *   rounds (masked index, sign-correction multiplication, reshare) are suspension points.
+ */
 class RingOaEvaluator {
 public:
+    // Keys whose dot products share one pass over the database in EvaluateBatch.
+    static constexpr uint64_t kDotProductBatchSize = 16;
+    // Accesses in flight (started, not yet finished) in EvaluatePipelined.
+    static constexpr uint64_t kPipelineDepth = 4;
+
     RingOaEvaluator() = delete;
 
     RingOaEvaluator(const RingOaParameters       &params,
@@ -140,6 +215,15 @@ public:
 
     void OnlineSetUp(const uint64_t party_id, const std::string &file_path) const;
 
+    // Full-domain expansions precomputed by 'cache' replace the online expansion of the keys it
+    // holds (see RingOaFdeCache); nullptr (default) always expands online. Not owned.
+    void SetFdeCache(RingOaFdeCache *cache) {
+        fde_cache_ = cache;
+    }
+    RingOaFdeCache *GetFdeCache() const {
+        return fde_cache_;
+    }
+
     void Evaluate(Channels                      &chls,
                   const RingOaKey               &key,
                   std::vector<block>            &uv_prev,
@@ -157,6 +241,68 @@ public:
                            const sharing::RepShareVec64  &index,
                            sharing::RepShareVec64        &result) const;
 
+    // Batched access: result[k] is the share of database[index[k]] under keys[k]. The masked
+    // indices, the sign-correction multiplications and the reshare each take one message per
+    // neighbour for the whole batch, so the round count does not depend on keys.size().
+    // Groups of kDotProductBatchSize keys read the database once; their DPFs are expanded one
+    // database tile at a time (a few KiB per key), not in full. uv_prev / uv_next serve a
+    // single key.
+    void EvaluateBatch(Channels                         &chls,
+                       std::span<const RingOaKey *const> keys,
+                       std::vector<block>               &uv_prev,
+                       std::vector<block>               &uv_next,
+                       const sharing::RepShareView64    &database,
+                       const sharing::RepShareVec64     &index,
+                       sharing::RepShareVec64           &result) const;
+
+    // Phased evaluation of one access (see the class comment); equivalent to Evaluate.
+    void StartEvaluate(Channels                  &chls,
+                       const RingOaKey           &key,
+                       const sharing::RepShare64 &index,
+                       RingOaPendingEval         &op) const;
+    void FinishEvaluate(Channels                      &chls,
+                        std::vector<block>            &uv_prev,
+                        std::vector<block>            &uv_next,
+                        const sharing::RepShareView64 &database,
+                        RingOaPendingEval             &op) const;
+    void WaitEvaluate(RingOaPendingEval   &op,
+                      sharing::RepShare64 &result) const;
+
+    // Multi-query access with up to 'depth' accesses in flight: result[k] is the share of
+    // database[index[k]] under keys[k]. Same rounds per access as Evaluate, overlapped.
+    void EvaluatePipelined(Channels                         &chls,
+                           std::span<const RingOaKey *const> keys,
+                           std::vector<block>               &uv_prev,
+                           std::vector<block>               &uv_next,
+                           const sharing::RepShareView64    &database,
+                           const sharing::RepShareVec64     &index,
+                           sharing::RepShareVec64           &result,
+                           const uint64_t                    depth = kPipelineDepth) const;
+
+    // Coroutine form of Evaluate (see CoScheduler). The view and index are taken by value; key,
+    // database storage and result must outlive the task. uv_prev / uv_next are not used across a
+    // suspension, so all sessions of a scheduler can share them.
+    CoTask EvaluateCo(CoScheduler                  &sched,
+                      Channels                     &chls,
+                      const RingOaKey              &key,
+                      std::vector<block>           &uv_prev,
+                      std::vector<block>           &uv_next,
+                      const sharing::RepShareView64 database,
+                      const sharing::RepShare64     index,
+                      sharing::RepShare64          &result) const;
+
+    // Record access: result[w] is the share of database[w][index] for the W = database.rows words
+    // of a record, each row of database being a table of 2^d entries (the RepShareMat64 layout of
+    // the wavelet-matrix tables). One key, one full-domain expansion, one masked-index
+    // reconstruction and one batched sign-correction multiplication serve all W words.
+    void EvaluateRecord(Channels                     &chls,
+                        const RingOaKey              &key,
+                        std::vector<block>           &uv_prev,
+                        std::vector<block>           &uv_next,
+                        const sharing::RepShareMat64 &database,
+                        const sharing::RepShare64    &index,
+                        sharing::RepShareVec64       &result) const;
+
     std::pair<uint64_t, uint64_t> EvaluateFullDomainThenDotProduct(
         const uint64_t                 party_id,
         const fss::dpf::DpfKey        &key_from_prev,
@@ -173,18 +319,52 @@ private:
     sharing::ReplicatedSharing3P &rss_;
     sharing::AdditiveSharing2P   &ass_prev_;
     sharing::AdditiveSharing2P   &ass_next_;
+    RingOaFdeCache               *fde_cache_;
 
     // Internal functions
+    std::pair<uint64_t, uint64_t> DotProduct(
+        const uint64_t                 party_id,
+        const RingOaKey               &key,
+        std::vector<block>            &uv_prev,
+        std::vector<block>            &uv_next,
+        const sharing::RepShareView64 &database,
+        const uint64_t                 pr_prev,
+        const uint64_t                 pr_next) const;
+
+    // DotProduct for a group of keys, reading the database once per side. Cached expansions
+    // go through RotatedSelectSumBatch; the others are expanded one database tile at a time
+    // across the group (RotatedSelectSumTiled), never in full.
+    void DotProductBatch(
+        std::span<const RingOaKey *const> keys,
+        const sharing::RepShareView64    &database,
+        std::span<const uint64_t>         pr_prev,
+        std::span<const uint64_t>         pr_next,
+        std::span<uint64_t>               dp_prev,
+        std::span<uint64_t>               dp_next) const;
+
+    // DotProduct for every row of a record database (dp_prev[w], dp_next[w] for row w).
+    void DotProductRecord(
+        const uint64_t                party_id,
+        const RingOaKey              &key,
+        std::vector<block>           &uv_prev,
+        std::vector<block>           &uv_next,
+        const sharing::RepShareMat64 &database,
+        const uint64_t                pr_prev,
+        const uint64_t                pr_next,
+        std::vector<uint64_t>        &dp_prev,
+        std::vector<uint64_t>        &dp_next) const;
+
     std::pair<uint64_t, uint64_t> ReconstructMaskedValue(
         Channels                  &chls,
         const RingOaKey           &key,
         const sharing::RepShare64 &index) const;
 
-    std::array<uint64_t, 4> ReconstructMaskedValue(
-        Channels                     &chls,
-        const RingOaKey              &key1,
-        const RingOaKey              &key2,
-        const sharing::RepShareVec64 &index) const;
+    void ReconstructMaskedValue(
+        Channels                         &chls,
+        std::span<const RingOaKey *const> keys,
+        const sharing::RepShareVec64     &index,
+        std::vector<uint64_t>            &pr_prev,
+        std::vector<uint64_t>            &pr_next) const;
 };
 
 }    // namespace proto
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "RingOA/fss/prg.h"
+#include "RingOA/protocol/dot_product.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/utils/logger.h"
@@ -322,7 +323,7 @@ void RingOaFscEvaluator::Evaluate(Channels                      &chls,
     uint64_t s        = params_.GetShareSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -400,7 +401,7 @@ void RingOaFscEvaluator::Evaluate_Parallel(Channels                      &chls,
     uint64_t s        = params_.GetShareSize();
     uint64_t nu       = params_.GetParameters().GetTerminateBitsize();
 
-    if (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu)) {
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << nu) || uv_next.size() != (1UL << nu))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << nu) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << nu));
@@ -496,33 +497,28 @@ std::pair<uint64_t, uint64_t> RingOaFscEvaluator::EvaluateFullDomainThenDotProdu
     Logger::DebugLog(LOC, "[P" + ToString(party_id) + "] key_from_next ID: " + ToString(key_from_next.party_id));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block == __m128i)
-    eval_.EvaluateFullDomain(key_from_next, uv_prev);
-    eval_.EvaluateFullDomain(key_from_prev, uv_next);
-    uint64_t      dp_prev = 0, dp_next = 0;
-    const int64_t s_prev = Sign(key_from_prev.party_id);
-    const int64_t s_next = Sign(key_from_next.party_id);
-
-    for (size_t i = 0; i < uv_prev.size(); ++i) {
-        const uint64_t low_prev  = uv_prev[i].get<uint64_t>()[0];
-        const uint64_t high_prev = uv_prev[i].get<uint64_t>()[1];
-        const uint64_t low_next  = uv_next[i].get<uint64_t>()[0];
-        const uint64_t high_next = uv_next[i].get<uint64_t>()[1];
-
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((low_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((low_next >> j) & 1ULL);
-            dp_prev                  = Mod2N(dp_prev + s_next * (database.share1[Mod2N((i * 128 + j) + pr_prev, d)] & mask_prev), s);
-            dp_next                  = Mod2N(dp_next + s_prev * (database.share0[Mod2N((i * 128 + j) + pr_next, d)] & mask_next), s);
-        }
-        for (int j = 0; j < 64; ++j) {
-            const uint64_t mask_prev = 0ULL - ((high_prev >> j) & 1ULL);
-            const uint64_t mask_next = 0ULL - ((high_next >> j) & 1ULL);
-            dp_prev                  = Mod2N(dp_prev + s_next * (database.share1[Mod2N((i * 128 + 64 + j) + pr_prev, d)] & mask_prev), s);
-            dp_next                  = Mod2N(dp_next + s_prev * (database.share0[Mod2N((i * 128 + 64 + j) + pr_next, d)] & mask_next), s);
-        }
+    // Evaluate both DPF keys in lockstep (uv_prev and uv_next are std::vector<block>, where block == __m128i)
+    const std::array<const fss::dpf::DpfKey *, 2> keys{&key_from_next, &key_from_prev};
+    uint64_t                                      dp_prev = 0, dp_next = 0;
+    const int64_t                                 s_prev = Sign(key_from_prev.party_id);
+    const int64_t                                 s_next = Sign(key_from_next.party_id);
+
+    // Leaf i of keys[k] selects 128 database entries (k = 0: dp_prev, k = 1: dp_next);
+    // the sums wrap mod 2^64 and are signed and reduced once at the end
+    if (uv_prev.empty() && uv_next.empty()) {
+        // No output buffers: consume the leaves while they are still in L1
+        eval_.VisitFullDomain(keys, [&](uint64_t k, uint64_t i, const block &leaf) {
+            const auto bits = leaf.get<uint64_t>();
+            ((k == 0) ? dp_prev : dp_next) += RotatedSelectSum((k == 0) ? database.share1 : database.share0, d,
+                                                               bits.data(), 128, i * 128, (k == 0) ? pr_prev : pr_next);
+        });
+    } else {
+        const std::array<std::vector<block> *, 2> uvs{&uv_prev, &uv_next};
+        eval_.EvaluateFullDomain(keys, uvs);
+        dp_prev = RotatedSelectSum(database.share1, d, reinterpret_cast<const uint64_t *>(uv_prev.data()), uv_prev.size() * 128, 0, pr_prev);
+        dp_next = RotatedSelectSum(database.share0, d, reinterpret_cast<const uint64_t *>(uv_next.data()), uv_next.size() * 128, 0, pr_next);
     }
-    return std::make_pair(dp_prev, dp_next);
+    return std::make_pair(Mod2N(s_next * dp_prev, s), Mod2N(s_prev * dp_next, s));
 }
 
 std::pair<uint64_t, uint64_t> RingOaFscEvaluator::ReconstructMaskedValue(Channels                  &chls,
@@ -3,6 +3,7 @@
 #include <cstring>
 
 #include "RingOA/fss/prg.h"
+#include "RingOA/protocol/dot_product.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/utils/logger.h"
@@ -165,7 +166,7 @@ void SharedOtEvaluator::Evaluate(Channels                      &chls,
     uint64_t party_id = chls.party_id;
     uint64_t d        = params_.GetDatabaseSize();
 
-    if (uv_prev.size() != (1UL << d) || uv_next.size() != (1UL << d)) {
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << d) || uv_next.size() != (1UL << d))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << d) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << d));
@@ -215,11 +216,27 @@ void SharedOtEvaluator::Evaluate_Parallel(Channels                      &chls,
                                           const sharing::RepShareView64 &database,
                                           const sharing::RepShareVec64  &index,
                                           sharing::RepShareVec64        &result) const {
+    const std::array<const SharedOtKey *, 2> keys{&key1, &key2};
+    EvaluateBatch(chls, keys, uv_prev, uv_next, database, index, result);
+}
+
+void SharedOtEvaluator::EvaluateBatch(Channels                           &chls,
+                                      std::span<const SharedOtKey *const> keys,
+                                      std::vector<uint64_t>              &uv_prev,
+                                      std::vector<uint64_t>              &uv_next,
+                                      const sharing::RepShareView64      &database,
+                                      const sharing::RepShareVec64       &index,
+                                      sharing::RepShareVec64             &result) const {
 
     uint64_t party_id = chls.party_id;
     uint64_t d        = params_.GetDatabaseSize();
+    uint64_t num_keys = keys.size();
 
-    if (uv_prev.size() != (1UL << d) || uv_next.size() != (1UL << d)) {
+    if (index.Size() != num_keys) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_keys) + ", index=" + ToString(index.Size()));
+        return;
+    }
+    if (!(uv_prev.empty() && uv_next.empty()) && (uv_prev.size() != (1UL << d) || uv_next.size() != (1UL << d))) {
         Logger::ErrorLog(LOC, "Output vector size does not match the number of nodes: " +
                                   ToString(uv_prev.size()) + " != " + ToString(1UL << d) +
                                   " or " + ToString(uv_next.size()) + " != " + ToString(1UL << d));
@@ -228,40 +245,39 @@ void SharedOtEvaluator::Evaluate_Parallel(Channels                      &chls,
         Logger::ErrorLog(LOC, "Database size does not match the number of nodes: " +
                                   ToString(database.Size()) + " != " + ToString(1UL << d));
     }
+    if (result.Size() != num_keys) {
+        result = sharing::RepShareVec64(num_keys);
+    }
+    if (num_keys == 0) {
+        return;
+    }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate SharedOt key"));
+    Logger::DebugLog(LOC, Logger::StrWithSep("Evaluate " + ToString(num_keys) + " SharedOt keys"));
     Logger::DebugLog(LOC, "Party ID: " + ToString(party_id));
     std::string party_str = "[P" + ToString(party_id) + "] ";
     Logger::DebugLog(LOC, party_str + " idx: " + index.ToString());
     Logger::DebugLog(LOC, party_str + " db: " + database.ToString());
 #endif
 
-    // Reconstruct p - r_i
-    // pr: [pr_prev1, pr_next1, pr_prev2, pr_next2]
-    std::array<uint64_t, 4> pr = ReconstructMaskedValue(chls, key1, key2, index);
+    // Reconstruct p - r_i for every key (one message per neighbour)
+    std::vector<uint64_t> pr_prev, pr_next;
+    ReconstructMaskedValue(chls, keys, index, pr_prev, pr_next);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + " pr_prev1: " + ToString(pr[0]) + ", pr_next1: " + ToString(pr[1]) +
-                              ", pr_prev2: " + ToString(pr[2]) + ", pr_next2: " + ToString(pr[3]));
+    Logger::DebugLog(LOC, party_str + " pr_prev: " + ToString(pr_prev) + ", pr_next: " + ToString(pr_next));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<block>, where block
-    auto [dp_prev1, dp_next1] = EvaluateFullDomainThenDotProduct(
-        party_id, key1.key_from_prev, key1.key_from_next, uv_prev, uv_next, database, pr[0], pr[1]);
-    auto [dp_prev2, dp_next2] = EvaluateFullDomainThenDotProduct(
-        party_id, key2.key_from_prev, key2.key_from_next, uv_prev, uv_next, database, pr[2], pr[3]);
+    // Evaluate DPF and reshare the selected values
+    sharing::RepShare64 r_sh;
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        auto [dp_prev, dp_next] = EvaluateFullDomainThenDotProduct(
+            party_id, keys[k]->key_from_prev, keys[k]->key_from_next, uv_prev, uv_next, database, pr_prev[k], pr_next[k]);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, party_str + "dp_prev1: " + ToString(dp_prev1) + ", dp_next1: " + ToString(dp_next1));
-    Logger::DebugLog(LOC, party_str + "dp_prev2: " + ToString(dp_prev2) + ", dp_next2: " + ToString(dp_next2));
+        Logger::DebugLog(LOC, party_str + "dp_prev[" + ToString(k) + "]: " + ToString(dp_prev) + ", dp_next[" + ToString(k) + "]: " + ToString(dp_next));
 #endif
-
-    uint64_t            selected1_sh = Mod2N(dp_prev1 + dp_next1, d);
-    uint64_t            selected2_sh = Mod2N(dp_prev2 + dp_next2, d);
-    sharing::RepShare64 r1_sh, r2_sh;
-    rss_.Rand(r1_sh);
-    rss_.Rand(r2_sh);
-    result[0][0] = Mod2N(selected1_sh + r1_sh[0] - r1_sh[1], d);
-    result[0][1] = Mod2N(selected2_sh + r2_sh[0] - r2_sh[1], d);
+        rss_.Rand(r_sh);
+        result[0][k] = Mod2N(dp_prev + dp_next + r_sh[0] - r_sh[1], d);
+    }
     chls.next.send(result[0]);
     chls.prev.recv(result[1]);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
@@ -286,16 +302,37 @@ std::pair<uint64_t, uint64_t> SharedOtEvaluator::EvaluateFullDomainThenDotProduc
     Logger::DebugLog(LOC, "[P" + ToString(party_id) + "] key_from_next ID: " + ToString(key_from_next.party_id));
 #endif
 
-    // Evaluate DPF (uv_prev and uv_next are std::vector<uint64_t>, where uint64_t is the value of the node)
-    eval_.EvaluateFullDomain(key_from_next, uv_prev);
-    eval_.EvaluateFullDomain(key_from_prev, uv_next);
-    uint64_t dp_prev = 0, dp_next = 0;
+    // Evaluate both DPF keys in lockstep (uv_prev and uv_next are std::vector<uint64_t>, where uint64_t is the value of the node)
+    const std::array<const fss::dpf::DpfKey *, 2> keys{&key_from_next, &key_from_prev};
+    uint64_t                                      dp_prev = 0, dp_next = 0;
+    fss::EvalType                                 fde_type = params_.GetParameters().GetEvalType();
+
+    if (uv_prev.empty() && uv_next.empty() &&
+        (fde_type == fss::EvalType::kHybridBatched || fde_type == fss::EvalType::kRecursive || fde_type == fss::EvalType::kHalfTree)) {
+        // No output buffers: split each leaf block into its 2^(d - nu) values as it is produced
+        uint64_t chunk_exp = d - params_.GetParameters().GetTerminateBitsize();
+        uint64_t num_elems = 1ULL << chunk_exp;
+        eval_.VisitFullDomain(keys, [&](uint64_t k, uint64_t i, const block &leaf) {
+            std::array<uint64_t, 128> values;
+            for (uint64_t j = 0; j < num_elems; ++j) {
+                values[j] = fss::GetSplitBlockValue(leaf, chunk_exp, j, fss::OutputType::kShiftedAdditive);
+            }
+            ((k == 0) ? dp_prev : dp_next) += RotatedDotProduct((k == 0) ? database.share1 : database.share0, d,
+                                                                values.data(), num_elems, i * num_elems, (k == 0) ? pr_prev : pr_next);
+        });
+        return std::make_pair(Mod2N(dp_prev, d), Mod2N(dp_next, d));
+    }
 
-    for (size_t i = 0; i < uv_prev.size(); ++i) {
-        dp_prev = Mod2N(dp_prev + database.share1[Mod2N(i + pr_prev, d)] * uv_prev[i], d);
-        dp_next = Mod2N(dp_next + database.share0[Mod2N(i + pr_next, d)] * uv_next[i], d);
+    // The iterative and brute-force evaluations only produce integer outputs
+    if (uv_prev.empty() && uv_next.empty()) {
+        uv_prev.resize(1UL << d);
+        uv_next.resize(1UL << d);
     }
-    return std::make_pair(dp_prev, dp_next);
+    const std::array<std::vector<uint64_t> *, 2> uvs{&uv_prev, &uv_next};
+    eval_.EvaluateFullDomain(keys, uvs);
+    dp_prev = RotatedDotProduct(database.share1, d, uv_prev.data(), uv_prev.size(), 0, pr_prev);
+    dp_next = RotatedDotProduct(database.share0, d, uv_next.data(), uv_next.size(), 0, pr_next);
+    return std::make_pair(Mod2N(dp_prev, d), Mod2N(dp_next, d));
 }
 
 std::pair<uint64_t, uint64_t> SharedOtEvaluator::ReconstructMaskedValue(Channels                  &chls,
@@ -362,28 +399,31 @@ std::pair<uint64_t, uint64_t> SharedOtEvaluator::ReconstructMaskedValue(Channels
     return std::make_pair(pr_prev, pr_next);
 }
 
-std::array<uint64_t, 4> SharedOtEvaluator::ReconstructMaskedValue(Channels                     &chls,
-                                                                  const SharedOtKey            &key1,
-                                                                  const SharedOtKey            &key2,
-                                                                  const sharing::RepShareVec64 &index) const {
+void SharedOtEvaluator::ReconstructMaskedValue(Channels                           &chls,
+                                               std::span<const SharedOtKey *const> keys,
+                                               const sharing::RepShareVec64       &index,
+                                               std::vector<uint64_t>              &pr_prev,
+                                               std::vector<uint64_t>              &pr_next) const {
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, "ReconstructPR for Party " + ToString(chls.party_id));
+    Logger::DebugLog(LOC, "ReconstructPR (" + ToString(keys.size()) + " keys) for Party " + ToString(chls.party_id));
 #endif
 
     // Set replicated sharing of random value
     uint64_t               d        = params_.GetDatabaseSize();
-    uint64_t               pr_prev1 = 0, pr_next1 = 0, pr_prev2 = 0, pr_next2 = 0;
-    sharing::RepShareVec64 r_0_sh(2), r_1_sh(2), r_2_sh(2);
+    uint64_t               num_keys = keys.size();
+    sharing::RepShareVec64 r_0_sh(num_keys), r_1_sh(num_keys), r_2_sh(num_keys);
+    pr_prev.resize(num_keys);
+    pr_next.resize(num_keys);
 
     // Reconstruct p - r_i
     if (chls.party_id == 0) {
-        r_1_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_2_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_1_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        r_2_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        sharing::RepShareVec64 pr_20_sh(2), pr_01_sh(2);
-        std::vector<uint64_t>  pr_20(2), pr_01(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_1_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+            r_2_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+        }
+        sharing::RepShareVec64 pr_20_sh(num_keys), pr_01_sh(num_keys);
+        std::vector<uint64_t>  pr_20(num_keys), pr_01(num_keys);
         // p - r_1 between Party 0 and Party 2
         // p - r_2 between Party 0 and Party 1
         rss_.EvaluateSub(index, r_1_sh, pr_20_sh);
@@ -392,18 +432,18 @@ std::array<uint64_t, 4> SharedOtEvaluator::ReconstructMaskedValue(Channels
         chls.next.send(pr_01_sh[1]);
         chls.next.recv(pr_01);
         chls.prev.recv(pr_20);
-        pr_prev1 = Mod2N(pr_20[0] + pr_20_sh[0][0] + pr_20_sh[1][0], d);
-        pr_next1 = Mod2N(pr_01_sh[0][0] + pr_01_sh[1][0] + pr_01[0], d);
-        pr_prev2 = Mod2N(pr_20[1] + pr_20_sh[0][1] + pr_20_sh[1][1], d);
-        pr_next2 = Mod2N(pr_01_sh[0][1] + pr_01_sh[1][1] + pr_01[1], d);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_20[k] + pr_20_sh[0][k] + pr_20_sh[1][k], d);
+            pr_next[k] = Mod2N(pr_01_sh[0][k] + pr_01_sh[1][k] + pr_01[k], d);
+        }
 
     } else if (chls.party_id == 1) {
-        r_0_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_2_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_0_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        r_2_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        sharing::RepShareVec64 pr_12_sh(2), pr_01_sh(2);
-        std::vector<uint64_t>  pr_12(2), pr_01(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_0_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+            r_2_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+        }
+        sharing::RepShareVec64 pr_12_sh(num_keys), pr_01_sh(num_keys);
+        std::vector<uint64_t>  pr_12(num_keys), pr_01(num_keys);
         // p - r_0 between Party 1 and Party 2
         // p - r_2 between Party 0 and Party 1
         rss_.EvaluateSub(index, r_0_sh, pr_12_sh);
@@ -412,18 +452,18 @@ std::array<uint64_t, 4> SharedOtEvaluator::ReconstructMaskedValue(Channels
         chls.prev.send(pr_01_sh[0]);
         chls.prev.recv(pr_01);
         chls.next.recv(pr_12);
-        pr_prev1 = Mod2N(pr_01[0] + pr_01_sh[0][0] + pr_01_sh[1][0], d);
-        pr_next1 = Mod2N(pr_12_sh[0][0] + pr_12_sh[1][0] + pr_12[0], d);
-        pr_prev2 = Mod2N(pr_01[1] + pr_01_sh[0][1] + pr_01_sh[1][1], d);
-        pr_next2 = Mod2N(pr_12_sh[0][1] + pr_12_sh[1][1] + pr_12[1], d);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_01[k] + pr_01_sh[0][k] + pr_01_sh[1][k], d);
+            pr_next[k] = Mod2N(pr_12_sh[0][k] + pr_12_sh[1][k] + pr_12[k], d);
+        }
 
     } else {
-        r_0_sh.Set(0, sharing::RepShare64(key1.rsh_from_next, 0));
-        r_1_sh.Set(0, sharing::RepShare64(0, key1.rsh_from_prev));
-        r_0_sh.Set(1, sharing::RepShare64(key2.rsh_from_next, 0));
-        r_1_sh.Set(1, sharing::RepShare64(0, key2.rsh_from_prev));
-        sharing::RepShareVec64 pr_12_sh(2), pr_20_sh(2);
-        std::vector<uint64_t>  pr_12(2), pr_20(2);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            r_0_sh.Set(k, sharing::RepShare64(keys[k]->rsh_from_next, 0));
+            r_1_sh.Set(k, sharing::RepShare64(0, keys[k]->rsh_from_prev));
+        }
+        sharing::RepShareVec64 pr_12_sh(num_keys), pr_20_sh(num_keys);
+        std::vector<uint64_t>  pr_12(num_keys), pr_20(num_keys);
         // p - r_0 between Party 1 and Party 2
         // p - r_1 between Party 0 and Party 2
         rss_.EvaluateSub(index, r_0_sh, pr_12_sh);
@@ -432,12 +472,11 @@ std::array<uint64_t, 4> SharedOtEvaluator::ReconstructMaskedValue(Channels
         chls.next.send(pr_20_sh[1]);
         chls.prev.recv(pr_12);
         chls.next.recv(pr_20);
-        pr_prev1 = Mod2N(pr_12[0] + pr_12_sh[0][0] + pr_12_sh[1][0], d);
-        pr_next1 = Mod2N(pr_20_sh[0][0] + pr_20_sh[1][0] + pr_20[0], d);
-        pr_prev2 = Mod2N(pr_12[1] + pr_12_sh[0][1] + pr_12_sh[1][1], d);
-        pr_next2 = Mod2N(pr_20_sh[0][1] + pr_20_sh[1][1] + pr_20[1], d);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            pr_prev[k] = Mod2N(pr_12[k] + pr_12_sh[0][k] + pr_12_sh[1][k], d);
+            pr_next[k] = Mod2N(pr_20_sh[0][k] + pr_20_sh[1][k] + pr_20[k], d);
+        }
     }
-    return std::array<uint64_t, 4>{pr_prev1, pr_next1, pr_prev2, pr_next2};
 }
 
 }    // namespace proto
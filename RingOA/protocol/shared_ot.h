@@ -1,6 +1,8 @@
 #ifndef PROTOCOL_SHARED_OT_H_
 #define PROTOCOL_SHARED_OT_H_
 
+#include <span>
+
 #include "RingOA/fss/dpf_eval.h"
 #include "RingOA/fss/dpf_gen.h"
 #include "RingOA/fss/dpf_key.h"
@@ -130,6 +132,16 @@ public:
                            const sharing::RepShareVec64  &index,
                            sharing::RepShareVec64        &result) const;
 
+    // Batched access: result[k] is the share of database[index[k]] under keys[k]. The masked
+    // indices and the reshare each take one message per neighbour for the whole batch.
+    void EvaluateBatch(Channels                           &chls,
+                       std::span<const SharedOtKey *const> keys,
+                       std::vector<uint64_t>              &uv_prev,
+                       std::vector<uint64_t>              &uv_next,
+                       const sharing::RepShareView64      &database,
+                       const sharing::RepShareVec64       &index,
+                       sharing::RepShareVec64             &result) const;
+
     std::pair<uint64_t, uint64_t> EvaluateFullDomainThenDotProduct(
         const uint64_t                 party_id,
         const fss::dpf::DpfKey        &key_from_prev,
@@ -141,10 +153,10 @@ public:
         const uint64_t                 pr_next) const;
 
 private:
-    SharedOtParameters               params_;
-    fss::dpf::DpfEvaluator           eval_;
-    sharing::ReplicatedSharing3P    &rss_;
-    fss::prg::PseudoRandomGenerator &G_;
+    SharedOtParameters                     params_;
+    fss::dpf::DpfEvaluator                 eval_;
+    sharing::ReplicatedSharing3P          &rss_;
+    const fss::prg::PseudoRandomGenerator &G_;
 
     // Internal functions
     std::pair<uint64_t, uint64_t> ReconstructMaskedValue(
@@ -152,11 +164,12 @@ private:
         const SharedOtKey         &key,
         const sharing::RepShare64 &index) const;
 
-    std::array<uint64_t, 4> ReconstructMaskedValue(
-        Channels                     &chls,
-        const SharedOtKey            &key1,
-        const SharedOtKey            &key2,
-        const sharing::RepShareVec64 &index) const;
+    void ReconstructMaskedValue(
+        Channels                           &chls,
+        std::span<const SharedOtKey *const> keys,
+        const sharing::RepShareVec64       &index,
+        std::vector<uint64_t>              &pr_prev,
+        std::vector<uint64_t>              &pr_next) const;
 };
 
 }    // namespace proto
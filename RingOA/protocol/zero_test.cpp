@@ -63,6 +63,21 @@ void ZeroTestKey::Deserialize(const std::vector<uint8_t> &buffer) {
     std::memcpy(&shr_in, buffer.data() + offset, sizeof(shr_in));
 }
 
+size_t ZeroTestKey::CalculateLegacySerializedSize(const ZeroTestParameters &params) {
+    return fss::dpf::DpfKey::CalculateLegacySerializedSize(params.GetParameters()) + sizeof(uint64_t);
+}
+
+void ZeroTestKey::ConvertLegacy(const ZeroTestParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed) {
+    if (legacy.size() != CalculateLegacySerializedSize(params)) {
+        throw std::invalid_argument("Invalid legacy ZeroTestKey: size " + ToString(legacy.size()) + " != " + ToString(CalculateLegacySerializedSize(params)));
+    }
+    const size_t key_size = fss::dpf::DpfKey::CalculateLegacySerializedSize(params.GetParameters());
+
+    // DPF key, then the shared random value
+    fss::dpf::DpfKey::ConvertLegacy(std::vector<uint8_t>(legacy.begin(), legacy.begin() + key_size), packed);
+    packed.insert(packed.end(), legacy.begin() + key_size, legacy.end());
+}
+
 void ZeroTestKey::PrintKey(const bool detailed) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     if (detailed) {
@@ -177,5 +192,28 @@ uint64_t ZeroTestEvaluator::EvaluateMaskedInput(const ZeroTestKey &key, const ui
     return output;
 }
 
+void ZeroTestEvaluator::EvaluateMaskedInput(const std::vector<ZeroTestKey> &keys, const std::vector<uint64_t> &x, std::vector<uint64_t> &outputs) const {
+    if (keys.size() != x.size()) {
+        throw std::invalid_argument(
+            "ZeroTestEvaluator::EvaluateMaskedInput: keys.size() != x.size() (" +
+            std::to_string(keys.size()) + " vs " + std::to_string(x.size()) + ")");
+    }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Evaluating ZeroTest protocol with " + ToString(keys.size()) + " masked inputs");
+#endif
+
+    // Evaluate all DPF keys level by level
+    std::vector<const fss::dpf::DpfKey *> dpf_keys(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        dpf_keys[i] = &keys[i].dpf_key;
+    }
+    outputs.resize(x.size());
+    eval_.EvaluateAt(dpf_keys, x, outputs);
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "outputs: " + ToString(outputs));
+#endif
+}
+
 }    // namespace proto
 }    // namespace ringoa
@@ -80,6 +80,11 @@ struct ZeroTestKey {
     void Serialize(std::vector<uint8_t> &buffer) const;
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of the legacy form (DPF keys with one byte per control bit) for 'params'.
+    static size_t CalculateLegacySerializedSize(const ZeroTestParameters &params);
+    // Rewrites a key serialized with legacy DPF keys into the current form (see DpfKey::ConvertLegacy).
+    static void ConvertLegacy(const ZeroTestParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
@@ -114,6 +119,7 @@ public:
 
     uint64_t EvaluateSharedInput(osuCrypto::Channel &chl, const ZeroTestKey &key, const uint64_t x) const;
     uint64_t EvaluateMaskedInput(const ZeroTestKey &key, const uint64_t x) const;
+    void     EvaluateMaskedInput(const std::vector<ZeroTestKey> &keys, const std::vector<uint64_t> &x, std::vector<uint64_t> &outputs) const;
 
 private:
     ZeroTestParameters          params_;
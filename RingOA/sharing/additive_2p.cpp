@@ -330,6 +330,26 @@ void AdditiveSharing2P::EvaluateMult(const uint64_t party_id, osuCrypto::Channel
     }
 }
 
+void AdditiveSharing2P::EvaluateMultMask(const uint64_t &x, const uint64_t &y, BeaverTriple &triple, std::array<uint64_t, 2> &de_sh) {
+    if (triple_index_ >= triples_.num_triples) {
+        Logger::ErrorLog(LOC, "No more Beaver triples available.");
+        return;
+    }
+    triple = triples_.triples[triple_index_];
+    ++triple_index_;
+
+    de_sh[0] = Mod2N(x - triple.a, bitsize_);    // d
+    de_sh[1] = Mod2N(y - triple.b, bitsize_);    // e
+}
+
+void AdditiveSharing2P::EvaluateMultCombine(const uint64_t party_id, const BeaverTriple &triple, const std::array<uint64_t, 2> &de_0, const std::array<uint64_t, 2> &de_1, uint64_t &z) const {
+    uint64_t d = Mod2N(de_0[0] + de_1[0], bitsize_);
+    uint64_t e = Mod2N(de_0[1] + de_1[1], bitsize_);
+
+    // Beaver formula: z = a*e + b*d + c (+ d*e for party 0)
+    z = Mod2N(e * triple.a + d * triple.b + triple.c + (party_id == 0 ? d * e : 0), bitsize_);
+}
+
 void AdditiveSharing2P::EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::array<uint64_t, 2> &x, const std::array<uint64_t, 2> &y, std::array<uint64_t, 2> &z) {
     // Use two different Beaver triples for each element of array x, y
     if (triple_index_ + 1 >= triples_.num_triples) {
@@ -486,6 +506,41 @@ void AdditiveSharing2P::EvaluateMult(const uint64_t party_id, osuCrypto::Channel
     }
 }
 
+void AdditiveSharing2P::EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, std::vector<uint64_t> &z) {
+    if (x.size() != y.size()) {
+        Logger::ErrorLog(LOC, "Size mismatch: x.size() != y.size() in EvaluateMult.");
+        return;
+    }
+    // One Beaver triple per element, all (d, e) pairs reconstructed in a single round
+    if (triple_index_ + x.size() > triples_.num_triples) {
+        Logger::ErrorLog(LOC, "No more Beaver triples available.");
+        return;
+    }
+
+    // de_local = { d0, e0, d1, e1, ... } with d = x - a, e = y - b
+    std::vector<uint64_t>  de_0, de_1, de;
+    std::vector<uint64_t> &de_local = (party_id == 0) ? de_0 : de_1;
+    de_local.resize(2 * x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        const auto &triple  = triples_.triples[triple_index_ + i];
+        de_local[2 * i]     = Mod2N(x[i] - triple.a, bitsize_);
+        de_local[2 * i + 1] = Mod2N(y[i] - triple.b, bitsize_);
+    }
+    Reconst(party_id, chl, de_0, de_1, de);
+
+    // Beaver formula: z = a*e + b*d + c (+ d*e for party 0)
+    if (z.size() != x.size()) {
+        z.resize(x.size());
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        const auto &triple = triples_.triples[triple_index_ + i];
+        uint64_t    d      = de[2 * i];
+        uint64_t    e      = de[2 * i + 1];
+        z[i]               = Mod2N((e * triple.a) + (d * triple.b) + triple.c + (party_id == 0 ? d * e : 0), bitsize_);
+    }
+    triple_index_ += x.size();
+}
+
 void AdditiveSharing2P::EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const uint64_t &x, const uint64_t &y, const uint64_t &c, uint64_t &z) {
     // ----------------------------------------------------
     // 1) Compute y_sub_x = (y - x) mod bitsize
@@ -514,6 +569,14 @@ void AdditiveSharing2P::EvaluateSelect(const uint64_t party_id, osuCrypto::Chann
     EvaluateAdd(x, c_mul_y_sub_x, z);
 }
 
+void AdditiveSharing2P::EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, const std::vector<uint64_t> &c, std::vector<uint64_t> &z) {
+    std::vector<uint64_t> y_sub_x;
+    EvaluateSub(y, x, y_sub_x);
+    std::vector<uint64_t> c_mul_y_sub_x;
+    EvaluateMult(party_id, chl, c, y_sub_x, c_mul_y_sub_x);
+    EvaluateAdd(x, c_mul_y_sub_x, z);
+}
+
 uint64_t AdditiveSharing2P::GenerateRandomValue() const {
     return Mod2N(GlobalRng::Rand<uint64_t>(), bitsize_);
 }
@@ -57,11 +57,16 @@ public:
     void EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const uint64_t &x, const uint64_t &y, uint64_t &z);
     void EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::array<uint64_t, 2> &x, const std::array<uint64_t, 2> &y, std::array<uint64_t, 2> &z);
     void EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::array<uint64_t, 3> &x, const std::array<uint64_t, 3> &y, std::array<uint64_t, 3> &z);
-    // void EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, std::vector<uint64_t> &z);
+    void EvaluateMult(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, std::vector<uint64_t> &z);
+    // EvaluateMult (one triple) split around its round: EvaluateMultMask takes the next triple and
+    // returns this party's share of (x - a, y - b), which the parties exchange; EvaluateMultCombine
+    // computes z from both shares and the same triple.
+    void EvaluateMultMask(const uint64_t &x, const uint64_t &y, BeaverTriple &triple, std::array<uint64_t, 2> &de_sh);
+    void EvaluateMultCombine(const uint64_t party_id, const BeaverTriple &triple, const std::array<uint64_t, 2> &de_0, const std::array<uint64_t, 2> &de_1, uint64_t &z) const;
 
     void EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const uint64_t &x, const uint64_t &y, const uint64_t &c, uint64_t &z);
     void EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const std::array<uint64_t, 2> &x, const std::array<uint64_t, 2> &y, const std::array<uint64_t, 2> &c, std::array<uint64_t, 2> &z);
-    // void EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, const std::vector<uint64_t> &c, std::vector<uint64_t> &z);
+    void EvaluateSelect(const uint64_t party_id, osuCrypto::Channel &chl, const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, const std::vector<uint64_t> &c, std::vector<uint64_t> &z);
 
     uint64_t GenerateRandomValue() const;
     void     PrintTriples(const size_t limit = 0) const;
@@ -228,13 +228,17 @@ void ReplicatedSharing3P::EvaluateSub(const RepShareVec64 &x_vec_sh, const RepSh
 }
 
 void ReplicatedSharing3P::EvaluateMult(Channels &chls, const RepShare64 &x_sh, const RepShare64 &y_sh, RepShare64 &z_sh) {
+    z_sh.data[0] = EvaluateMultLocal(x_sh, y_sh);
+    chls.next.send(z_sh.data[0]);
+    chls.prev.recv(z_sh.data[1]);
+}
+
+uint64_t ReplicatedSharing3P::EvaluateMultLocal(const RepShare64 &x_sh, const RepShare64 &y_sh) {
     // (t_0, t_1, t_2) forms a (3, 3)-sharing of t = x * y
     uint64_t   t_sh = Mod2N(x_sh.data[0] * y_sh.data[0] + x_sh.data[1] * y_sh.data[0] + x_sh.data[0] * y_sh.data[1], bitsize_);
     RepShare64 r_sh;
     Rand(r_sh);
-    z_sh.data[0] = Mod2N(t_sh + r_sh.data[0] - r_sh.data[1], bitsize_);
-    chls.next.send(z_sh.data[0]);
-    chls.prev.recv(z_sh.data[1]);
+    return Mod2N(t_sh + r_sh.data[0] - r_sh.data[1], bitsize_);
 }
 
 void ReplicatedSharing3P::EvaluateMult(Channels &chls, const RepShareVec64 &x_vec_sh, const RepShareVec64 &y_vec_sh, RepShareVec64 &z_vec_sh) {
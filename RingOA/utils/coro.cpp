@@ -0,0 +1,114 @@
+#include "coro.h"
+
+#include <algorithm>
+
+namespace ringoa {
+
+CoTask::~CoTask() {
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+CoTask::CoTask(CoTask &&other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr)) {
+}
+
+CoTask &CoTask::operator=(CoTask &&other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+void CoTask::await_resume() const {
+    if (handle_ && handle_.promise().exception) {
+        std::rethrow_exception(handle_.promise().exception);
+    }
+}
+
+void CoScheduler::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    sched_.queue_.push_back(Entry{handle, std::move(pending_), sched_.current_});
+}
+
+CoScheduler::Awaiter CoScheduler::Wait(std::future<void> &&f) {
+    std::vector<std::future<void>> pending;
+    pending.push_back(std::move(f));
+    return Awaiter(*this, std::move(pending));
+}
+
+CoScheduler::Awaiter CoScheduler::Wait(std::future<void> &&f0, std::future<void> &&f1) {
+    std::vector<std::future<void>> pending;
+    pending.push_back(std::move(f0));
+    pending.push_back(std::move(f1));
+    return Awaiter(*this, std::move(pending));
+}
+
+CoScheduler::Awaiter CoScheduler::Wait(std::vector<std::future<void>> &&pending) {
+    return Awaiter(*this, std::move(pending));
+}
+
+CoScheduler::Awaiter CoScheduler::Yield() {
+    return Awaiter(*this, {});
+}
+
+void CoScheduler::Run(const uint64_t num_sessions, const uint64_t max_in_flight, const std::function<CoTask(uint64_t)> &make_session) {
+    max_in_flight_    = std::max<uint64_t>(max_in_flight, 1);
+    uint64_t admitted = 0;
+    auto     admit    = [&]() {
+        while (admitted < num_sessions && sessions_.size() < max_in_flight_) {
+            CoTask task = make_session(admitted);
+            queue_.push_back(Entry{task.handle_, {}, admitted});
+            sessions_.emplace(admitted, std::move(task));
+            ++admitted;
+        }
+    };
+
+    try {
+        admit();
+        while (!queue_.empty()) {
+            Entry entry = std::move(queue_.front());
+            queue_.pop_front();
+            // Let every receive of the entry land before one failure unwinds its frame
+            for (auto &f : entry.pending) {
+                f.wait();
+            }
+            for (auto &f : entry.pending) {
+                f.get();
+            }
+
+            current_ = entry.session;
+            entry.handle.resume();
+
+            auto it = sessions_.find(entry.session);
+            if (it->second.Done()) {
+                std::exception_ptr error = it->second.handle_.promise().exception;
+                sessions_.erase(it);
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                admit();
+            }
+        }
+    } catch (...) {
+        // A failed session, receive or make_session: the other sessions cannot stay in step with
+        // the other parties, so drop them and leave the scheduler empty for the next Run.
+        // Receives still in flight write into the suspended frames; wait for them (their own
+        // errors no longer matter) before the frames are destroyed.
+        for (auto &entry : queue_) {
+            for (auto &f : entry.pending) {
+                if (f.valid()) {
+                    f.wait();
+                }
+            }
+        }
+        queue_.clear();
+        sessions_.clear();
+        throw;
+    }
+}
+
+}    // namespace ringoa
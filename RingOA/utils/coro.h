@@ -0,0 +1,170 @@
+#ifndef UTILS_CORO_H_
+#define UTILS_CORO_H_
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ringoa {
+
+/**
+ * CoTask — coroutine type of the protocol sessions run by CoScheduler.
+ *
+ * - Lazily started: the body runs when the task is awaited (co_await task) or spawned on a
+ *   scheduler, and an awaiting coroutine resumes when the task completes (symmetric transfer).
+ * - An exception thrown in the body is rethrown at the co_await, or by CoScheduler::Run for a
+ *   session.
+ * - Arguments taken by reference must outlive the task; awaiting the task in the same
+ *   full-expression that creates it (co_await eval.EvaluateCo(...)) guarantees that.
+ */
+class CoTask {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr      exception;
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {
+            }
+        };
+
+        CoTask get_return_object() {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+        FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+        void return_void() const noexcept {
+        }
+        void unhandled_exception() {
+            exception = std::current_exception();
+        }
+    };
+
+    CoTask() = default;
+    ~CoTask();
+
+    CoTask(const CoTask &)            = delete;
+    CoTask &operator=(const CoTask &) = delete;
+    CoTask(CoTask &&other) noexcept;
+    CoTask &operator=(CoTask &&other) noexcept;
+
+    bool Done() const {
+        return !handle_ || handle_.done();
+    }
+
+    bool await_ready() const noexcept {
+        return Done();
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    void await_resume() const;
+
+private:
+    friend class CoScheduler;
+
+    explicit CoTask(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * CoScheduler — per-party executor multiplexing many protocol sessions over one Channels.
+ *
+ * Overview
+ * - A session is a CoTask. It runs until it awaits Wait(...) (the receives of one round) or
+ *   Yield(), then the next session runs. Sessions resume in FIFO order, one round each, so a
+ *   party keeps as many rounds in flight as it has sessions, on one thread.
+ * - Run(num_sessions, max_in_flight, make_session) admits sessions 0, 1, ... in order, keeping
+ *   at most max_in_flight alive, and returns when all have completed.
+ *
+ * Determinism
+ * - Messages on a channel, the replicated PRF streams and the Beaver triples are consumed in
+ *   call order, so the three parties must interleave the sessions identically. The schedule
+ *   depends only on the sequence of suspensions, never on arrival times, hence it is the same on
+ *   every party as long as each session suspends at the same points on all of them.
+ * - Protocol code keeps that rule: in each round a session sends, posts its receives and awaits
+ *   them; a party with nothing to receive in a round awaits Yield() instead.
+ *
+ * Notes
+ * - Send with asyncSend/asyncSendCopy: a blocking send of one session would stall the others.
+ * - Scratch buffers (e.g., the uv buffers of RingOA) can be shared by all sessions if they are
+ *   not kept across a suspension.
+ */
+class CoScheduler {
+public:
+    class Awaiter {
+    public:
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {
+        }
+
+    private:
+        friend class CoScheduler;
+
+        Awaiter(CoScheduler &sched, std::vector<std::future<void>> &&pending)
+            : sched_(sched), pending_(std::move(pending)) {
+        }
+
+        CoScheduler                   &sched_;
+        std::vector<std::future<void>> pending_;
+    };
+
+    CoScheduler()                               = default;
+    CoScheduler(const CoScheduler &)            = delete;
+    CoScheduler &operator=(const CoScheduler &) = delete;
+
+    // Suspends the calling session until the given receives have completed.
+    Awaiter Wait(std::future<void> &&f);
+    Awaiter Wait(std::future<void> &&f0, std::future<void> &&f1);
+    Awaiter Wait(std::vector<std::future<void>> &&pending);
+    // Suspends the calling session for one round without waiting on the network.
+    Awaiter Yield();
+
+    // Rethrows the first exception of a session, a receive or make_session, after dropping the
+    // remaining sessions.
+    void Run(const uint64_t num_sessions, const uint64_t max_in_flight, const std::function<CoTask(uint64_t)> &make_session);
+
+    uint64_t GetMaxInFlight() const {
+        return max_in_flight_;
+    }
+
+private:
+    struct Entry {
+        std::coroutine_handle<>        handle;
+        std::vector<std::future<void>> pending;
+        uint64_t                       session;
+    };
+
+    std::deque<Entry>                    queue_;
+    std::unordered_map<uint64_t, CoTask> sessions_;
+    uint64_t                             current_       = 0;
+    uint64_t                             max_in_flight_ = 0;
+};
+
+}    // namespace ringoa
+
+#endif    // UTILS_CORO_H_
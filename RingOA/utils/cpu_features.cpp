@@ -0,0 +1,25 @@
+#include "cpu_features.h"
+
+namespace ringoa {
+
+namespace {
+
+CpuFeatures ProbeCpuFeatures() noexcept {
+    CpuFeatures features;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    features.avx2    = __builtin_cpu_supports("avx2");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+    features.vaes    = __builtin_cpu_supports("vaes");
+#endif
+    return features;
+}
+
+}    // namespace
+
+const CpuFeatures &GetCpuFeatures() noexcept {
+    static const CpuFeatures features = ProbeCpuFeatures();
+    return features;
+}
+
+}    // namespace ringoa
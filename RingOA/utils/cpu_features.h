@@ -0,0 +1,19 @@
+#ifndef UTILS_CPU_FEATURES_H_
+#define UTILS_CPU_FEATURES_H_
+
+namespace ringoa {
+
+// x86 SIMD extensions usable on the running CPU and OS, probed once on first use.
+// The probe also checks that the OS saves the AVX/AVX-512 register state (XGETBV).
+// All flags are false on other architectures and compilers.
+struct CpuFeatures {
+    bool avx2    = false;
+    bool avx512f = false;
+    bool vaes    = false;
+};
+
+const CpuFeatures &GetCpuFeatures() noexcept;
+
+}    // namespace ringoa
+
+#endif    // UTILS_CPU_FEATURES_H_
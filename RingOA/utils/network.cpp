@@ -83,6 +83,23 @@ ThreePartyNetworkManager::ThreePartyNetworkManager(const std::string &ip_address
 }
 
 void ThreePartyNetworkManager::Start(const uint32_t party_id, std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> task) {
+    Launch(party_id, 1, [task](std::vector<osuCrypto::Channel> &chls_next, std::vector<osuCrypto::Channel> &chls_prev) {
+        task(chls_next[0], chls_prev[0]);
+    });
+}
+
+void ThreePartyNetworkManager::StartWorkers(const uint32_t party_id, const uint64_t num_channels, WorkerTask task) {
+    Launch(party_id, num_channels, [party_id, task](std::vector<osuCrypto::Channel> &chls_next, std::vector<osuCrypto::Channel> &chls_prev) {
+        std::vector<Channels> chls;
+        chls.reserve(chls_next.size());
+        for (size_t w = 0; w < chls_next.size(); ++w) {
+            chls.emplace_back(party_id, chls_prev[w], chls_next[w]);
+        }
+        task(chls);
+    });
+}
+
+void ThreePartyNetworkManager::Launch(const uint32_t party_id, const uint64_t num_channels, ChannelTask task) {
     // Start the thread for the specified party
     std::thread *party_thread = nullptr;
     switch (party_id) {
@@ -100,7 +117,7 @@ void ThreePartyNetworkManager::Start(const uint32_t party_id, std::function<void
             exit(EXIT_FAILURE);
     }
 
-    *party_thread = std::thread([&, party_id, task]() {
+    *party_thread = std::thread([&, party_id, num_channels, task]() {
         // Set up the network configuration
         uint32_t               id_next           = (party_id + 1) % 3;
         uint32_t               id_prev           = (party_id + 2) % 3;
@@ -131,6 +148,14 @@ void ThreePartyNetworkManager::Start(const uint32_t party_id, std::function<void
         auto               chl_next = session_next.addChannel();
         auto               chl_prev = session_prev.addChannel();
 
+        // Worker channels share the two sessions; both ends open them in the same order
+        std::vector<osuCrypto::Channel> chls_next{chl_next}, chls_prev{chl_prev};
+        for (uint64_t w = 1; w < num_channels; ++w) {
+            const std::string name = "w" + std::to_string(w);
+            chls_next.push_back(session_next.addChannel(name, name));
+            chls_prev.push_back(session_prev.addChannel(name, name));
+        }
+
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         Logger::DebugLog(LOC, "=============================");
         Logger::DebugLog(LOC, "[Party " + std::to_string(party_id) + "] Information");
@@ -151,6 +176,10 @@ void ThreePartyNetworkManager::Start(const uint32_t party_id, std::function<void
         chl_next.waitForConnection();
 
         chl_prev.waitForConnection();
+        for (uint64_t w = 1; w < num_channels; ++w) {
+            chls_next[w].waitForConnection();
+            chls_prev[w].waitForConnection();
+        }
 
         // Exchange IDs with next and previous parties
         chl_next.send(party_id);
@@ -170,8 +199,8 @@ void ThreePartyNetworkManager::Start(const uint32_t party_id, std::function<void
             exit(EXIT_FAILURE);
         }
 
-        // Execute the task with the two channels
-        task(chl_next, chl_prev);
+        // Execute the task with the channels
+        task(chls_next, chls_prev);
     });
 }
 
@@ -180,18 +209,31 @@ void ThreePartyNetworkManager::AutoConfigure(
     std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> party0_task,
     std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> party1_task,
     std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> party2_task) {
+    // A single channel pair per party, i.e. the pair that Start uses
+    auto single = [](std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> task) -> WorkerTask {
+        return [task](std::vector<Channels> &chls) { task(chls[0].next, chls[0].prev); };
+    };
+    AutoConfigureWorkers(party_id, 1, single(party0_task), single(party1_task), single(party2_task));
+}
+
+void ThreePartyNetworkManager::AutoConfigureWorkers(
+    int            party_id,
+    const uint64_t num_channels,
+    WorkerTask     party0_task,
+    WorkerTask     party1_task,
+    WorkerTask     party2_task) {
     if (party_id == 0) {
-        Start(0, party0_task);
+        StartWorkers(0, num_channels, party0_task);
     } else if (party_id == 1) {
-        Start(1, party1_task);
+        StartWorkers(1, num_channels, party1_task);
     } else if (party_id == 2) {
-        Start(2, party2_task);
+        StartWorkers(2, num_channels, party2_task);
     } else {
-        Start(0, party0_task);
+        StartWorkers(0, num_channels, party0_task);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));    // Ensure party 0 starts first
-        Start(1, party1_task);
+        StartWorkers(1, num_channels, party1_task);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));    // Ensure party 1 starts second
-        Start(2, party2_task);
+        StartWorkers(2, num_channels, party2_task);
     }
 }
 
@@ -3,12 +3,15 @@
 
 #include <functional>
 #include <thread>
+#include <vector>
 
 #include <cryptoTools/Network/Channel.h>
 #include <cryptoTools/Network/IOService.h>
 
 namespace ringoa {
 
+struct Channels;
+
 /**
  * TwoPartyNetworkManager
  *
@@ -67,6 +70,8 @@ private:
  *
  * Notes:
  *   - Each party connects to prev/next neighbors: ids (i-1) mod 3, (i+1) mod 3.
+ *   - StartWorkers / AutoConfigureWorkers open several channel pairs on the same two sessions
+ *     (one per worker thread, see WorkerDispatcher); pair 0 is the pair that Start uses.
  *   - Destructor joins threads and stops IO service if still running.
  */
 class ThreePartyNetworkManager {
@@ -90,9 +95,26 @@ public:
                        std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> party1_task,
                        std::function<void(osuCrypto::Channel &, osuCrypto::Channel &)> party2_task);
 
+    // task(chls) with chls[w] the w-th of 'num_channels' channel pairs to the neighbours.
+    using WorkerTask = std::function<void(std::vector<Channels> &)>;
+
+    void StartWorkers(const uint32_t party_id, const uint64_t num_channels, WorkerTask task);
+
+    void AutoConfigureWorkers(int            party_id,
+                              const uint64_t num_channels,
+                              WorkerTask     party0_task,
+                              WorkerTask     party1_task,
+                              WorkerTask     party2_task);
+
     void WaitForCompletion();
 
 private:
+    using ChannelTask = std::function<void(std::vector<osuCrypto::Channel> &, std::vector<osuCrypto::Channel> &)>;
+
+    // Connects to both neighbours, opens num_channels channels per session and runs
+    // task(chls_next, chls_prev) on the thread of party_id.
+    void Launch(const uint32_t party_id, const uint64_t num_channels, ChannelTask task);
+
     std::string          ip_address_;
     uint16_t             port_;
     osuCrypto::IOService ios_;
@@ -1,7 +1,9 @@
 #ifndef UTILS_RNG_H_
 #define UTILS_RNG_H_
 
+#include <cryptoTools/Crypto/AES.h>
 #include <cryptoTools/Crypto/PRNG.h>
+#include <utility>
 
 #include "block.h"
 
@@ -31,6 +33,34 @@ public:
         return prng().getBit() != 0;
     }
 
+    // Seed of the index-th stream derived from 'base': AES keyed with 'base' encrypting 'index',
+    // so distinct indices give independent-looking seeds with no linear relation between them.
+    // Parallel loops draw 'base' once on the calling thread and reseed every task with
+    // DeriveSeed(base, task), so the output depends on the caller's seed and the task split
+    // only, not on which thread runs which task.
+    static block DeriveSeed(const block base, const uint64_t index) {
+        return osuCrypto::AES(base).ecbEncBlock(osuCrypto::toBlock(index));
+    }
+
+    // Reseeds the calling thread's generator for the lifetime of this object and restores the
+    // previous generator afterwards (worker threads have no seed of their own).
+    class ScopedSeed {
+    public:
+        explicit ScopedSeed(const block seed)
+            : saved_(seed) {
+            std::swap(prng(), saved_);
+        }
+        ~ScopedSeed() {
+            std::swap(prng(), saved_);
+        }
+
+        ScopedSeed(const ScopedSeed &)            = delete;
+        ScopedSeed &operator=(const ScopedSeed &) = delete;
+
+    private:
+        osuCrypto::PRNG saved_;
+    };
+
 private:
     // Thread-local AES-NI PRNG instance.
     static inline osuCrypto::PRNG &prng() {
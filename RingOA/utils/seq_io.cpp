@@ -1,26 +1,166 @@
 #include "seq_io.h"
 
-#include <cctype>
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <immintrin.h>
 #include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-namespace ringoa {
+#include "thread_pool.h"
+
+namespace {
+
+// Read-only mapping of a whole file (an empty file maps nothing)
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char *>(p);
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data_ != nullptr)
+            ::munmap(const_cast<char *>(data_), size_);
+    }
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const {
+        return data_;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// dst[j] = uppercase(src[j]) (ASCII letters only, as std::toupper in the "C" locale)
+void CopyUpperScalar(char *dst, const char *src, const std::size_t len) noexcept {
+    for (std::size_t j = 0; j < len; ++j) {
+        const char c = src[j];
+        dst[j]       = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 0x20) : c;
+    }
+}
+
+__attribute__((target("avx2"))) void CopyUpperAvx2(char *dst, const char *src, const std::size_t len) noexcept {
+    const __m256i below_a = _mm256_set1_epi8('a' - 1);
+    const __m256i above_z = _mm256_set1_epi8('z' + 1);
+    const __m256i case_ch = _mm256_set1_epi8(0x20);
+    std::size_t   j       = 0;
+    for (; j + 32 <= len; j += 32) {
+        // Signed compares: bytes >= 0x80 are negative and never count as lowercase
+        const __m256i v     = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + j));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, below_a), _mm256_cmpgt_epi8(above_z, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), _mm256_sub_epi8(v, _mm256_and_si256(lower, case_ch)));
+    }
+    CopyUpperScalar(dst + j, src + j, len - j);
+}
+
+using CopyUpperFn = void (*)(char *, const char *, std::size_t) noexcept;
 
-std::string ReadFastaSequence(const std::string &fasta_path) {
-    std::ifstream fin(fasta_path, std::ios::binary);
-    if (!fin) {
-        throw std::runtime_error("Failed to open file: " + fasta_path);
+CopyUpperFn DetectCopyUpper() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CopyUpperAvx2;
+    }
+#endif
+    return CopyUpperScalar;
+}
+
+// Calls run(p, len) for the sequence part of every line starting in [begin, end):
+// header ('>') and empty lines are skipped, a trailing '\r' (CRLF) is dropped.
+// Lines are found with memchr, which glibc vectorises.
+template <typename Run>
+void ForEachSequenceRun(const char *begin, const char *end, Run &&run) {
+    const char *p = begin;
+    while (p < end) {
+        const char *nl       = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *line_end = nl != nullptr ? nl : end;
+        const char *seq_end  = line_end;
+        if (seq_end > p && seq_end[-1] == '\r')
+            --seq_end;
+        if (seq_end > p && *p != '>')
+            run(p, static_cast<std::size_t>(seq_end - p));
+        p = nl != nullptr ? nl + 1 : end;
+    }
+}
+
+// Appends the sequence of a FASTA file to out. The file is split into num_threads line-aligned
+// chunks; a first pass sizes each chunk's output, a second copies it (uppercased) in place.
+void AppendFastaSequence(const std::string &fasta_path, std::string &out, const uint64_t num_threads) {
+    static const CopyUpperFn copy_upper = DetectCopyUpper();
+
+    MappedFile        file(fasta_path);
+    const char       *data       = file.data();
+    const std::size_t size       = file.size();
+    const uint64_t    num_chunks = std::max<uint64_t>(num_threads, 1);
+
+    std::vector<const char *> bounds(num_chunks + 1, data + size);
+    bounds[0] = data;
+    for (uint64_t c = 1; c < num_chunks; ++c) {
+        // Move each split point to the start of the next line
+        const std::size_t b = std::max<std::size_t>(c * size / num_chunks, bounds[c - 1] - data);
+        if (b == 0 || b >= size || data[b - 1] == '\n') {
+            bounds[c] = data + b;
+        } else {
+            const char *nl = static_cast<const char *>(std::memchr(data + b, '\n', size - b));
+            bounds[c]      = nl != nullptr ? nl + 1 : data + size;
+        }
     }
 
-    std::string seq, line;
-    while (std::getline(fin, line)) {
-        if (!line.empty() && line.back() == '\r')
-            line.pop_back();    // handle CRLF
-        if (line.empty() || line[0] == '>')
-            continue;
-        for (unsigned char ch : line)
-            seq.push_back(static_cast<char>(std::toupper(ch)));
+    ringoa::ThreadPool       pool(num_chunks);
+    std::vector<std::size_t> offsets(num_chunks + 1, 0);
+    pool.ParallelFor(num_chunks, [&](uint64_t c) {
+        std::size_t len = 0;
+        ForEachSequenceRun(bounds[c], bounds[c + 1], [&](const char *, std::size_t n) { len += n; });
+        offsets[c + 1] = len;
+    });
+    offsets[0] = out.size();
+    for (uint64_t c = 0; c < num_chunks; ++c) {
+        offsets[c + 1] += offsets[c];
     }
+
+    out.resize(offsets[num_chunks]);
+    pool.ParallelFor(num_chunks, [&](uint64_t c) {
+        char *dst = out.data() + offsets[c];
+        ForEachSequenceRun(bounds[c], bounds[c + 1], [&](const char *p, std::size_t n) {
+            copy_upper(dst, p, n);
+            dst += n;
+        });
+    });
+}
+
+}    // namespace
+
+namespace ringoa {
+
+std::string ReadFastaSequence(const std::string &fasta_path, const uint64_t num_threads) {
+    std::string seq;
+    AppendFastaSequence(fasta_path, seq, num_threads);
     return seq;
 }
 
@@ -31,20 +171,24 @@ std::string CutPrefix(const std::string &full_seq, std::size_t length) {
     return full_seq.substr(0, length);
 }
 
-ChromosomeLoader::ChromosomeLoader(std::vector<std::string> fasta_paths)
-    : fasta_paths_(std::move(fasta_paths)) {
+ChromosomeLoader::ChromosomeLoader(std::vector<std::string> fasta_paths, const uint64_t num_threads)
+    : fasta_paths_(std::move(fasta_paths)), num_threads_(num_threads) {
 }
 
 std::string ChromosomeLoader::EnsurePrefix(std::size_t length) {
+    return std::string(EnsurePrefixView(length));
+}
+
+std::string_view ChromosomeLoader::EnsurePrefixView(std::size_t length) {
     while (current_.size() < length && next_idx_ < fasta_paths_.size()) {
-        current_ += ReadFastaSequence(fasta_paths_[next_idx_++]);
+        AppendFastaSequence(fasta_paths_[next_idx_++], current_, num_threads_);
     }
     if (current_.size() < length) {
         throw std::runtime_error(
             "Insufficient total sequence length. Needed " + std::to_string(length) +
             ", available " + std::to_string(current_.size()) + ".");
     }
-    return current_.substr(0, length);
+    return std::string_view(current_).substr(0, length);
 }
 
 void ChromosomeLoader::Reset() {
@@ -1,13 +1,16 @@
 #ifndef RINGOA_SEQ_IO_H_
 #define RINGOA_SEQ_IO_H_
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ringoa {
 
-// Read a single FASTA file (skip '>' header lines, uppercase sequence)
-std::string ReadFastaSequence(const std::string &fasta_path);
+// Read a single FASTA file (skip '>' header lines, uppercase sequence).
+// The file is memory-mapped and split across num_threads threads at line boundaries.
+std::string ReadFastaSequence(const std::string &fasta_path, const uint64_t num_threads = 1);
 
 // Return prefix [0, length). Throws if length > full_seq.size().
 std::string CutPrefix(const std::string &full_seq, std::size_t length);
@@ -15,11 +18,13 @@ std::string CutPrefix(const std::string &full_seq, std::size_t length);
 // Stateful chromosome loader that preserves `current_` and `next_idx_` across calls.
 class ChromosomeLoader {
 public:
-    explicit ChromosomeLoader(std::vector<std::string> fasta_paths);
+    explicit ChromosomeLoader(std::vector<std::string> fasta_paths, const uint64_t num_threads = 1);
 
     // Ensure the internal buffer has at least `length` bases; append as needed.
     // Returns a copy of prefix [0, length).
     std::string EnsurePrefix(std::size_t length);
+    // Same, without the copy (valid until the next call that appends or Reset()).
+    std::string_view EnsurePrefixView(std::size_t length);
 
     // Accessors
     std::size_t loaded_count() const {
@@ -40,6 +45,7 @@ public:
 
 private:
     std::vector<std::string> fasta_paths_;
+    uint64_t                 num_threads_;
     std::size_t              next_idx_ = 0;
     std::string              current_;
 };
@@ -0,0 +1,147 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace {
+
+// Whether the current thread is running a task of any pool's loop
+thread_local bool tls_in_pool_task = false;
+
+// Marks the current thread as running a pool task until the end of the scope
+class PoolTaskScope {
+public:
+    PoolTaskScope()
+        : prev_(tls_in_pool_task) {
+        tls_in_pool_task = true;
+    }
+    ~PoolTaskScope() {
+        tls_in_pool_task = prev_;
+    }
+
+private:
+    bool prev_;
+};
+
+}    // namespace
+
+namespace ringoa {
+
+ThreadPool::ThreadPool(const uint64_t num_threads)
+    : num_threads_(num_threads == 0 ? 1 : num_threads),
+      stop_(false) {
+    workers_.reserve(num_threads_ - 1);
+    for (uint64_t i = 1; i < num_threads_; ++i) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(const uint64_t num_tasks, const std::function<void(uint64_t)> &task) {
+    if (num_tasks == 0) {
+        return;
+    }
+    // A task of any pool calling ParallelFor runs the nested loop inline: queuing helpers and
+    // waiting for them could deadlock once every worker (of this pool or one waiting on it)
+    // is blocked the same way.
+    if (workers_.empty() || num_tasks == 1 || tls_in_pool_task) {
+        for (uint64_t i = 0; i < num_tasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // Shared state of this loop; outlives the helpers through shared ownership.
+    struct LoopState {
+        std::atomic<uint64_t>   next{0};
+        uint64_t                active = 0;
+        std::exception_ptr      error;
+        std::mutex              mtx;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<LoopState>();
+
+    auto run = [state, num_tasks, &task]() {
+        for (uint64_t i = state->next.fetch_add(1); i < num_tasks; i = state->next.fetch_add(1)) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mtx);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+                state->next.store(num_tasks);
+            }
+        }
+    };
+
+    uint64_t num_helpers = std::min<uint64_t>(workers_.size(), num_tasks - 1);
+    state->active        = num_helpers;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (uint64_t i = 0; i < num_helpers; ++i) {
+            queue_.emplace_back([this, state, run]() {
+                {
+                    PoolTaskScope scope;
+                    run();
+                }
+                std::lock_guard<std::mutex> lock(state->mtx);
+                if (--state->active == 0) {
+                    state->done.notify_one();
+                }
+            });
+        }
+    }
+    cv_.notify_all();
+
+    // The caller works on the loop as well, then waits for the helpers to drain.
+    {
+        PoolTaskScope scope;
+        run();
+    }
+    {
+        std::unique_lock<std::mutex> lock(state->mtx);
+        state->done.wait(lock, [&state]() { return state->active == 0; });
+    }
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+uint64_t ThreadPool::GetDefaultNumThreads() {
+    uint64_t hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : hw;
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (stop_ && queue_.empty()) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+}    // namespace ringoa
@@ -0,0 +1,63 @@
+#ifndef UTILS_THREAD_POOL_H_
+#define UTILS_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ringoa {
+
+/**
+ * ThreadPool — fixed-size pool of worker threads for data-parallel loops.
+ *
+ * Overview
+ * - ParallelFor(num_tasks, task) runs task(0..num_tasks-1) and blocks until all are done.
+ * - The calling thread takes part in the loop, so a pool of N threads spawns N-1 workers.
+ * - Tasks are handed out one index at a time through an atomic counter (dynamic scheduling).
+ *
+ * Usage
+ *   ringoa::ThreadPool pool(8);
+ *   pool.ParallelFor(num_chunks, [&](uint64_t i) { Process(i); });
+ *
+ * Notes
+ * - ParallelFor may be called from several threads at once; calls share the workers.
+ * - A task that calls ParallelFor on any pool (its own or another) runs that nested loop
+ *   inline on its thread.
+ * - The first exception thrown by a task is rethrown in the caller after the loop drains.
+ * - GetDefaultNumThreads() returns std::thread::hardware_concurrency() (at least 1).
+ */
+class ThreadPool {
+public:
+    ThreadPool() = delete;
+    explicit ThreadPool(const uint64_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    uint64_t GetNumThreads() const {
+        return num_threads_;
+    }
+
+    void ParallelFor(const uint64_t num_tasks, const std::function<void(uint64_t)> &task);
+
+    static uint64_t GetDefaultNumThreads();
+
+private:
+    uint64_t                          num_threads_;
+    std::vector<std::thread>          workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex                        mtx_;
+    std::condition_variable           cv_;
+    bool                              stop_;
+
+    void WorkerLoop();
+};
+
+}    // namespace ringoa
+
+#endif    // UTILS_THREAD_POOL_H_
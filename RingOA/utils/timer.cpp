@@ -171,6 +171,18 @@ void TimerManager::PrintAllResults(const std::string &msg,
     current_timer_id_ = prev;
 }
 
+double TimerManager::GetCurrentAverage(const TimeUnit unit) const {
+    const auto it = timers_.find(current_timer_id_);
+    if (it == timers_.end() || it->second.elapsed_times.empty()) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (const double elapsed : it->second.elapsed_times) {
+        total += elapsed;
+    }
+    return ConvertElapsedTime(total / static_cast<double>(it->second.elapsed_times.size()), NANOSECONDS, unit);
+}
+
 // Base unit: nanoseconds
 double TimerManager::GetElapsedTime(const TimePoint &start, const TimePoint &end) const {
     using namespace std::chrono;
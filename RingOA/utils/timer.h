@@ -76,6 +76,11 @@ public:
     void PrintAllResults(const std::string &msg          = "",
                          TimeUnit           unit         = MILLISECONDS,
                          bool               show_details = false);
+    /**
+     * GetCurrentAverage(): average of the recorded entries of the selected timer (0 if none).
+     * Useful for deriving throughput figures (e.g. blocks/s) in benchmarks.
+     */
+    double GetCurrentAverage(TimeUnit unit = MILLISECONDS) const;
 
 private:
     struct Timer {
@@ -0,0 +1,116 @@
+#include "worker_dispatcher.h"
+
+#include <algorithm>
+
+namespace ringoa {
+
+WorkerDispatcher::WorkerDispatcher(std::vector<Channels> &chls)
+    : chls_(chls),
+      task_(nullptr),
+      generation_(0),
+      pending_(0),
+      stop_(false) {
+    threads_.reserve(chls_.size() > 0 ? chls_.size() - 1 : 0);
+    for (uint64_t w = 1; w < chls_.size(); ++w) {
+        threads_.emplace_back([this, w]() { WorkerLoop(w); });
+    }
+}
+
+WorkerDispatcher::~WorkerDispatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &t : threads_) {
+        t.join();
+    }
+}
+
+void WorkerDispatcher::RunOnWorkers(const WorkerTask &task) {
+    if (chls_.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        task_    = &task;
+        error_   = nullptr;
+        pending_ = threads_.size();
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    // The calling thread serves worker 0
+    RunWorker(0, task);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_cv_.wait(lock, [this]() { return pending_ == 0; });
+        task_ = nullptr;
+        error = std::exchange(error_, nullptr);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerDispatcher::RunWorker(const uint64_t worker, const WorkerTask &task) {
+    try {
+        task(worker, chls_[worker]);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+}
+
+void WorkerDispatcher::WorkerLoop(const uint64_t worker) {
+    uint64_t seen = 0;
+    while (true) {
+        const WorkerTask *task;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            start_cv_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+        }
+        RunWorker(worker, *task);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (--pending_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerDispatcher::Dispatch(const uint64_t num_queries, const ShardTask &task) {
+    uint64_t num_workers = chls_.size();
+    RunOnWorkers([&](uint64_t w, Channels &chls) {
+        auto [begin, end] = GetShard(num_queries, num_workers, w);
+        task(w, chls, begin, end);
+    });
+}
+
+std::pair<uint64_t, uint64_t> WorkerDispatcher::GetShard(const uint64_t num_queries, const uint64_t num_workers, const uint64_t worker) {
+    if (num_workers == 0) {
+        return {0, 0};
+    }
+    // The first (num_queries % num_workers) workers take one extra query
+    uint64_t base  = num_queries / num_workers;
+    uint64_t extra = num_queries % num_workers;
+    uint64_t begin = worker * base + std::min(worker, extra);
+    uint64_t end   = begin + base + (worker < extra ? 1 : 0);
+    return {begin, end};
+}
+
+std::string WorkerDispatcher::GetWorkerPath(const std::string &file_path, const uint64_t worker) {
+    return file_path + "w" + std::to_string(worker) + "_";
+}
+
+}    // namespace ringoa
@@ -0,0 +1,89 @@
+#ifndef UTILS_WORKER_DISPATCHER_H_
+#define UTILS_WORKER_DISPATCHER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "network.h"
+
+namespace ringoa {
+
+/**
+ * WorkerDispatcher — per-party pool of protocol workers, one per channel pair.
+ *
+ * Overview
+ * - Worker w owns chls[w] (from ThreePartyNetworkManager::StartWorkers) and runs on its own
+ *   thread, so the workers of a party evaluate queries in parallel without sharing a channel.
+ * - Workers 1..n-1 are threads created once by the constructor and parked between dispatches;
+ *   the calling thread serves worker 0. A dispatch only wakes them, so protocol rounds do not
+ *   pay for thread creation.
+ * - Dispatch(num_queries, task) splits [0, num_queries) into one contiguous shard per worker and
+ *   runs task(w, chls[w], begin, end) on all workers at once. The split depends only on
+ *   num_queries and the number of workers, so worker w of every party gets the same shard;
+ *   a task that writes the result of query q at position q gathers the results in order.
+ * - RunOnWorkers(task) runs task(w, chls[w]) on every worker (e.g. per-worker setup).
+ *
+ * Usage
+ *   net_mgr.AutoConfigureWorkers(party_id, num_workers, task0, task1, task2), where each task:
+ *     ringoa::WorkerDispatcher dispatcher(chls);
+ *     dispatcher.Dispatch(num_queries, [&](uint64_t w, Channels &chl, uint64_t begin, uint64_t end) {
+ *         for (uint64_t q = begin; q < end; ++q) evals[w]->Evaluate(chl, ..., result[q]);
+ *     });
+ *
+ * Notes
+ * - Workers must not share evaluator state: each needs its own sharing objects, PRF keys and
+ *   Beaver triples (e.g. loaded from GetWorkerPath(file_path, w)), or the parties' streams
+ *   would interleave differently.
+ * - The first exception thrown by a worker is rethrown after all workers have returned.
+ * - RunOnWorkers and Dispatch must not be called concurrently on the same dispatcher.
+ */
+class WorkerDispatcher {
+public:
+    using ShardTask  = std::function<void(uint64_t worker, Channels &chls, uint64_t begin, uint64_t end)>;
+    using WorkerTask = std::function<void(uint64_t worker, Channels &chls)>;
+
+    WorkerDispatcher() = delete;
+    explicit WorkerDispatcher(std::vector<Channels> &chls);
+    ~WorkerDispatcher();
+
+    WorkerDispatcher(const WorkerDispatcher &)            = delete;
+    WorkerDispatcher &operator=(const WorkerDispatcher &) = delete;
+
+    uint64_t GetNumWorkers() const {
+        return chls_.size();
+    }
+
+    void RunOnWorkers(const WorkerTask &task);
+    void Dispatch(const uint64_t num_queries, const ShardTask &task);
+
+    // [begin, end) of the queries handled by 'worker' (balanced contiguous split).
+    static std::pair<uint64_t, uint64_t> GetShard(const uint64_t num_queries, const uint64_t num_workers, const uint64_t worker);
+    // Prefix for the offline material (keys, triples, PRF keys) of 'worker'.
+    static std::string GetWorkerPath(const std::string &file_path, const uint64_t worker);
+
+private:
+    std::vector<Channels>   &chls_;
+    std::vector<std::thread> threads_;     /**< Threads of workers 1..n-1, alive until destruction. */
+    std::mutex               mtx_;
+    std::condition_variable  start_cv_;    /**< Wakes the workers for a new dispatch. */
+    std::condition_variable  done_cv_;     /**< Wakes the caller when the last worker returns. */
+    const WorkerTask        *task_;        /**< Task of the current dispatch. */
+    uint64_t                 generation_;  /**< Number of dispatches started so far. */
+    uint64_t                 pending_;     /**< Workers 1..n-1 still running the current task. */
+    std::exception_ptr       error_;
+    bool                     stop_;
+
+    void RunWorker(const uint64_t worker, const WorkerTask &task);
+    void WorkerLoop(const uint64_t worker);
+};
+
+}    // namespace ringoa
+
+#endif    // UTILS_WORKER_DISPATCHER_H_
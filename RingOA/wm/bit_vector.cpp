@@ -0,0 +1,120 @@
+#include "bit_vector.h"
+
+#include <bit>
+#include <stdexcept>
+
+namespace ringoa {
+namespace wm {
+
+BitVector::BitVector(const size_t n)
+    : n_(n), bits_(n / kWordBits + 1, 0) {    // one spare word so that Rank1(n) reads in bounds
+}
+
+void BitVector::Set(const size_t i) {
+    bits_[i / kWordBits] |= 1ULL << (i % kWordBits);
+}
+
+void BitVector::Build() {
+    // One extra superblock when n is a multiple of 512, so that Rank1(n) has an entry
+    const size_t num_super = n_ / kSuperBlockBits + 1;
+    directory_.assign(2 * num_super, 0);
+
+    size_t ones = 0;
+    for (size_t sb = 0; sb < num_super; ++sb) {
+        directory_[2 * sb] = ones;
+        uint64_t rel       = 0;
+        uint64_t packed    = 0;
+        for (size_t blk = 0; blk < kBlocksPerSuper; ++blk) {
+            if (blk > 0) {
+                packed |= rel << (9 * (blk - 1));
+            }
+            const size_t w = sb * kBlocksPerSuper + blk;
+            if (w < bits_.size()) {
+                rel += std::popcount(bits_[w]);
+            }
+        }
+        directory_[2 * sb + 1] = packed;
+        ones += rel;
+    }
+    num_ones_ = ones;
+}
+
+size_t BitVector::GetMemoryBytes() const {
+    return (bits_.size() + directory_.size()) * sizeof(uint64_t);
+}
+
+bool BitVector::Access(const size_t i) const {
+    if (i >= n_)
+        throw std::out_of_range("BitVector::Access index out of range");
+    return (bits_[i / kWordBits] >> (i % kWordBits)) & 1ULL;
+}
+
+size_t BitVector::Rank1(const size_t i) const {
+    // Branch-free: the mask is empty when i is word aligned
+    return OnesBeforeBlock(i / kSuperBlockBits, (i / kWordBits) % kBlocksPerSuper) +
+           std::popcount(bits_[i / kWordBits] & ((1ULL << (i % kWordBits)) - 1));
+}
+
+size_t BitVector::Select1(const size_t k) const {
+    if (k >= num_ones_)
+        throw std::out_of_range("BitVector::Select1 rank out of range");
+
+    // Last superblock with fewer than k + 1 ones before it
+    size_t lo = 0, hi = directory_.size() / 2;
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (directory_[2 * mid] <= k) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t blk = 1;
+    while (blk < kBlocksPerSuper && OnesBeforeBlock(lo, blk) <= k) {
+        ++blk;
+    }
+    --blk;
+    const size_t w = lo * kBlocksPerSuper + blk;
+    return w * kWordBits + SelectInWord(bits_[w], k - OnesBeforeBlock(lo, blk));
+}
+
+size_t BitVector::Select0(const size_t k) const {
+    if (k >= GetNumZeros())
+        throw std::out_of_range("BitVector::Select0 rank out of range");
+
+    // Same search on zeros = bits before - ones before (padding lies past every valid answer)
+    size_t lo = 0, hi = directory_.size() / 2;
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (mid * kSuperBlockBits - directory_[2 * mid] <= k) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    auto zeros_before = [&](size_t blk) {
+        return (lo * kBlocksPerSuper + blk) * kWordBits - OnesBeforeBlock(lo, blk);
+    };
+    size_t blk = 1;
+    while (blk < kBlocksPerSuper && zeros_before(blk) <= k) {
+        ++blk;
+    }
+    --blk;
+    const size_t w = lo * kBlocksPerSuper + blk;
+    return w * kWordBits + SelectInWord(~bits_[w], k - zeros_before(blk));
+}
+
+size_t BitVector::OnesBeforeBlock(const size_t sb, const size_t blk) const {
+    // Block 0 maps to shift 63, whose field is always zero (the 7 counts use bits 0..62)
+    return directory_[2 * sb] + ((directory_[2 * sb + 1] >> (9 * ((blk - 1) & 7))) & 0x1FF);
+}
+
+size_t BitVector::SelectInWord(uint64_t word, size_t k) {
+    for (; k > 0; --k) {
+        word &= word - 1;    // clear the lowest set bit
+    }
+    return std::countr_zero(word);
+}
+
+}    // namespace wm
+}    // namespace ringoa
@@ -0,0 +1,71 @@
+#ifndef WM_BIT_VECTOR_H_
+#define WM_BIT_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ringoa {
+namespace wm {
+
+/**
+ * @brief Packed bitvector with constant-time rank and logarithmic-time select.
+ *
+ * Bits are packed 64 per word. The rank directory keeps two words per 512-bit superblock
+ * (rank9 layout): the number of ones before the superblock, and the 9-bit counts of ones
+ * before each of its blocks 1..7 relative to the superblock. Rank reads one directory entry
+ * and one popcount; select binary-searches the superblocks, then scans at most 8 blocks.
+ * The directory adds 25% to the n bits of payload.
+ *
+ * Usage: BitVector bv(n); bv.Set(i) for each one; bv.Build(); then query.
+ */
+class BitVector {
+public:
+    BitVector() = default;
+    explicit BitVector(const size_t n);
+
+    // --- Construction (call Build() after the last Set) ---
+    void Set(const size_t i);
+    void Build();
+
+    // --- Basic info ---
+    size_t Size() const {
+        return n_;
+    }
+    size_t GetNumOnes() const {
+        return num_ones_;
+    }
+    size_t GetNumZeros() const {
+        return n_ - num_ones_;
+    }
+    size_t GetMemoryBytes() const;
+
+    // --- Queries ---
+    bool   Access(const size_t i) const;    ///< B[i]
+    size_t Rank1(const size_t i) const;     ///< ones in [0,i), i <= Size()
+    size_t Rank0(const size_t i) const {    ///< zeros in [0,i), i <= Size()
+        return i - Rank1(i);
+    }
+    size_t Select1(const size_t k) const;    ///< position of the k-th one (0-based), k < GetNumOnes()
+    size_t Select0(const size_t k) const;    ///< position of the k-th zero (0-based), k < GetNumZeros()
+
+private:
+    static constexpr size_t kWordBits       = 64;
+    static constexpr size_t kSuperBlockBits = 512;
+    static constexpr size_t kBlocksPerSuper = kSuperBlockBits / kWordBits;
+
+    size_t                n_        = 0;
+    size_t                num_ones_ = 0;
+    std::vector<uint64_t> bits_;
+    std::vector<uint64_t> directory_;    // per superblock: {ones before it, 7 x 9-bit block counts}
+
+    // Ones before block 'blk' of superblock 'sb' (both relative to the start of the vector)
+    size_t OnesBeforeBlock(const size_t sb, const size_t blk) const;
+    // Position of the k-th set bit of 'word'
+    static size_t SelectInWord(uint64_t word, size_t k);
+};
+
+}    // namespace wm
+}    // namespace ringoa
+
+#endif    // WM_BIT_VECTOR_H_
@@ -0,0 +1,187 @@
+#include "bwt_builder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/thread_pool.h"
+#include "RingOA/utils/to_string.h"
+
+namespace ringoa {
+namespace wm {
+
+BwtBuilder::BwtBuilder(const BwtBuildOptions &options)
+    : options_(options) {
+    options_.num_threads = std::max<uint64_t>(options_.num_threads, 1);
+}
+
+std::string BwtBuilder::Build(const std::string &text) {
+    std::string bwt;
+    bwt.reserve(text.size() + 1);
+    Run(text, [&bwt](const std::string &chunk) { bwt += chunk; });
+    return bwt;
+}
+
+void BwtBuilder::BuildToFile(const std::string &text, const std::string &file_path) {
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("BwtBuilder: cannot open " + file_path);
+    Run(text, [&out](const std::string &chunk) { out.write(chunk.data(), chunk.size()); });
+    if (!out)
+        throw std::runtime_error("BwtBuilder: write failed for " + file_path);
+}
+
+std::string BwtBuilder::LoadBwt(const std::string &file_path) {
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("BwtBuilder: cannot open " + file_path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void BwtBuilder::Run(const std::string &text, const std::function<void(const std::string &)> &emit) {
+    const uint64_t n   = text.size();
+    num_passes_        = 0;
+    peak_suffix_bytes_ = 0;
+
+    // The '$' suffix sorts first; its BWT character is the last text character
+    emit(std::string(1, n > 0 ? text[n - 1] : '$'));
+    if (n == 0)
+        return;
+
+    // Character codes 1..s in byte order; 0 stands for "past the end" so shorter suffixes sort first
+    std::array<uint64_t, 256> code{};
+    for (unsigned char c : text) {
+        code[c] = 1;
+    }
+    uint64_t sigma = 0;
+    for (auto &c : code) {
+        c = c ? ++sigma : 0;
+    }
+    const uint64_t base = sigma + 1;
+    uint64_t       k = 1, num_buckets = base;
+    while (num_buckets * base <= kMaxBuckets && k < n) {
+        num_buckets *= base;
+        ++k;
+    }
+    auto bucket_of = [&](uint64_t i) {
+        uint64_t key = 0;
+        for (uint64_t j = 0; j < k; ++j) {
+            key = key * base + (i + j < n ? code[static_cast<unsigned char>(text[i + j])] : 0);
+        }
+        return key;
+    };
+
+    // Bucket sizes per text chunk, so that each chunk later writes to its own slots
+    ThreadPool     pool(options_.num_threads);
+    const uint64_t num_chunks = options_.num_threads;
+    const uint64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+    auto           chunk_range = [&](uint64_t c) {
+        return std::make_pair(std::min(c * chunk_size, n), std::min((c + 1) * chunk_size, n));
+    };
+    std::vector<std::vector<uint64_t>> chunk_counts(num_chunks, std::vector<uint64_t>(num_buckets, 0));
+    pool.ParallelFor(num_chunks, [&](uint64_t c) {
+        auto [begin, end] = chunk_range(c);
+        for (uint64_t i = begin; i < end; ++i) {
+            ++chunk_counts[c][bucket_of(i)];
+        }
+    });
+    std::vector<uint64_t> bucket_sizes(num_buckets, 0);
+    for (const auto &counts : chunk_counts) {
+        for (uint64_t b = 0; b < num_buckets; ++b) {
+            bucket_sizes[b] += counts[b];
+        }
+    }
+
+    // One pass per run of consecutive buckets that fits in memory_limit
+    const uint64_t max_suffixes = options_.memory_limit ? std::max<uint64_t>(options_.memory_limit / sizeof(uint64_t), 1) : n;
+    for (uint64_t b0 = 0; b0 < num_buckets;) {
+        uint64_t b1 = b0, total = 0;
+        while (b1 < num_buckets && (b1 == b0 || total + bucket_sizes[b1] <= max_suffixes)) {
+            total += bucket_sizes[b1++];
+        }
+        if (total == 0) {
+            b0 = b1;
+            continue;
+        }
+        ++num_passes_;
+        peak_suffix_bytes_ = std::max(peak_suffix_bytes_, total * sizeof(uint64_t));
+
+        // Slot of the first suffix of bucket b from chunk c: bucket start + earlier chunks' share
+        const uint64_t                     run = b1 - b0;
+        std::vector<uint64_t>              offsets(run + 1, 0);
+        std::vector<std::vector<uint64_t>> cursors(num_chunks, std::vector<uint64_t>(run));
+        for (uint64_t j = 0; j < run; ++j) {
+            offsets[j + 1] = offsets[j] + bucket_sizes[b0 + j];
+            uint64_t slot  = offsets[j];
+            for (uint64_t c = 0; c < num_chunks; ++c) {
+                cursors[c][j] = slot;
+                slot += chunk_counts[c][b0 + j];
+            }
+        }
+
+        std::vector<uint64_t> suffixes(total);
+        pool.ParallelFor(num_chunks, [&](uint64_t c) {
+            auto [begin, end] = chunk_range(c);
+            for (uint64_t i = begin; i < end; ++i) {
+                const uint64_t b = bucket_of(i);
+                if (b0 <= b && b < b1) {
+                    suffixes[cursors[c][b - b0]++] = i;
+                }
+            }
+        });
+        pool.ParallelFor(run, [&](uint64_t j) {
+            SortBucket(text, k, suffixes.data() + offsets[j], suffixes.data() + offsets[j + 1]);
+        });
+
+        std::string chunk(total, '\0');
+        for (uint64_t t = 0; t < total; ++t) {
+            chunk[t] = suffixes[t] == 0 ? '$' : text[suffixes[t] - 1];
+        }
+        emit(chunk);
+        b0 = b1;
+    }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "BwtBuilder: n=" + ToString(n) + " k=" + ToString(k) + " buckets=" + ToString(num_buckets) +
+                              " passes=" + ToString(num_passes_) + " peak_suffix_bytes=" + ToString(peak_suffix_bytes_));
+#endif
+}
+
+void BwtBuilder::SortBucket(const std::string &text, const uint64_t k, uint64_t *first, uint64_t *last) const {
+    const uint64_t n = text.size();
+    const char    *s = text.data();
+
+    // Sorts [first, last), whose suffixes share their first 'depth' characters, by the next 'width'.
+    // Runs still tied (long repeats) are sorted again in place by a window twice as wide further
+    // along, so no memory beyond the bucket is needed; the recursion is at most log2(n) deep.
+    auto sort_run = [n, s](auto &self, uint64_t *run_first, uint64_t *run_last, const uint64_t depth, const uint64_t width) -> void {
+        auto less = [n, s, depth, width](uint64_t a, uint64_t b) {
+            const uint64_t sa = std::min(a + depth, n), sb = std::min(b + depth, n);
+            const uint64_t la = std::min(n - sa, width), lb = std::min(n - sb, width);
+            const int      cmp = std::memcmp(s + sa, s + sb, std::min(la, lb));
+            return cmp != 0 ? cmp < 0 : la < lb;
+        };
+        std::sort(run_first, run_last, less);
+
+        // Tied suffixes both reach past the window (a suffix ending inside it would be shorter)
+        for (uint64_t *run = run_first; run != run_last;) {
+            uint64_t *end = run + 1;
+            while (end != run_last && !less(*run, *end)) {
+                ++end;
+            }
+            if (end - run > 1) {
+                self(self, run, end, depth + width, 2 * width);
+            }
+            run = end;
+        }
+    };
+    if (last - first >= 2) {
+        sort_run(sort_run, first, last, k, kMaxSortDepth);
+    }
+}
+
+}    // namespace wm
+}    // namespace ringoa
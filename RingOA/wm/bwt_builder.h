@@ -0,0 +1,78 @@
+#ifndef WM_BWT_BUILDER_H_
+#define WM_BWT_BUILDER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ringoa {
+
+class ThreadPool;
+
+namespace wm {
+
+/**
+ * @brief Options of BwtBuilder (and of FMIndex construction).
+ */
+struct BwtBuildOptions {
+    uint64_t num_threads  = 1;    ///< threads for bucket collection/sorting and the wavelet matrix levels
+    uint64_t memory_limit = 0;    ///< bytes of suffix positions held at once (0: whole suffix array)
+};
+
+/**
+ * @brief Bucketed suffix sorter that streams the BWT of text + '$'.
+ *
+ * Overview
+ * - Suffixes are bucketed by their first k characters (k chosen so that there are at most
+ *   2^18 buckets). Bucket order is suffix order, so the BWT is produced bucket by bucket.
+ * - A pass collects the suffixes of a run of consecutive buckets, sorts each bucket
+ *   (comparing the text after the shared k-prefix) and emits their BWT characters.
+ *   Collection and sorting run on options.num_threads threads.
+ * - With memory_limit set, a pass holds at most memory_limit bytes of suffix positions
+ *   (8 bytes each) instead of the full 8n-byte suffix array; every pass rescans the text.
+ *   BuildToFile streams the BWT to disk, so peak memory is about n + memory_limit bytes.
+ *
+ * Notes
+ * - Output matches sdsl::construct_im on the same text: BWT[0] = text[n-1] (the '$' suffix
+ *   sorts first) and the row of the whole text holds '$'. The text must not contain '\0'.
+ * - A single bucket larger than memory_limit is still processed in one pass.
+ * - Bucket sorts first compare kMaxSortDepth characters past the bucket prefix. Suffixes still
+ *   tied (long repeats) are re-sorted in place by windows that double in width further along,
+ *   so repeats cost time (about the repeat length per comparison) but no memory beyond the
+ *   suffix positions of the pass.
+ */
+class BwtBuilder {
+public:
+    explicit BwtBuilder(const BwtBuildOptions &options = BwtBuildOptions());
+
+    std::string Build(const std::string &text);
+    void        BuildToFile(const std::string &text, const std::string &file_path);
+
+    static std::string LoadBwt(const std::string &file_path);
+
+    // Statistics of the last build
+    uint64_t GetNumPasses() const {
+        return num_passes_;
+    }
+    uint64_t GetPeakSuffixBytes() const {
+        return peak_suffix_bytes_;
+    }
+
+private:
+    static constexpr uint64_t kMaxBuckets   = 1ULL << 18;
+    static constexpr uint64_t kMaxSortDepth = 256;
+
+    BwtBuildOptions options_;
+    uint64_t        num_passes_        = 0;
+    uint64_t        peak_suffix_bytes_ = 0;
+
+    // Calls emit(chunk) with consecutive pieces of the BWT, in order
+    void Run(const std::string &text, const std::function<void(const std::string &)> &emit);
+    void SortBucket(const std::string &text, const uint64_t k, uint64_t *first, uint64_t *last) const;
+};
+
+}    // namespace wm
+}    // namespace ringoa
+
+#endif    // WM_BWT_BUILDER_H_
@@ -0,0 +1,134 @@
+#include "occ_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <immintrin.h>
+#include <stdexcept>
+#include <utility>
+
+#include "RingOA/utils/thread_pool.h"
+
+namespace {
+
+// Occurrences of c in p[0, len)
+uint64_t CountByteScalar(const char *p, const uint64_t len, const char c) noexcept {
+    return static_cast<uint64_t>(std::count(p, p + len, c));
+}
+
+__attribute__((target("avx2,popcnt"))) uint64_t CountByteAvx2(const char *p, const uint64_t len, const char c) noexcept {
+    const __m256i needle = _mm256_set1_epi8(c);
+    uint64_t      count  = 0;
+    uint64_t      j      = 0;
+    for (; j + 32 <= len; j += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + j));
+        count += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle))));
+    }
+    return count + CountByteScalar(p + j, len - j, c);
+}
+
+using CountByteFn = uint64_t (*)(const char *, uint64_t, char) noexcept;
+
+CountByteFn DetectCountByte() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CountByteAvx2;
+    }
+#endif
+    return CountByteScalar;
+}
+
+}    // namespace
+
+namespace ringoa {
+namespace wm {
+
+OccTable::OccTable(std::string bwt, const uint64_t sample_rate)
+    : bwt_(std::move(bwt)), sample_rate_(sample_rate) {
+    if (sample_rate_ == 0)
+        throw std::invalid_argument("OccTable: sample_rate must be positive");
+
+    // Symbols in byte order, and C[c] over all 256 byte values
+    std::array<uint64_t, 256> freq{};
+    for (unsigned char c : bwt_) {
+        freq[c]++;
+    }
+    code_.fill(kAbsent);
+    uint64_t smaller = 0;
+    for (size_t c = 0; c < 256; ++c) {
+        if (freq[c] > 0) {
+            code_[c] = static_cast<int16_t>(sigma_++);
+        }
+        c_array_[c] = smaller;
+        smaller += freq[c];
+    }
+
+    // Checkpoint j holds Occ(., j * sample_rate)
+    const uint64_t        n = bwt_.size();
+    std::vector<uint64_t> running(sigma_, 0);
+    checkpoints_.resize((n / sample_rate_ + 1) * sigma_);
+    for (uint64_t i = 0; i < n; ++i) {
+        if (i % sample_rate_ == 0) {
+            std::copy(running.begin(), running.end(), checkpoints_.begin() + (i / sample_rate_) * sigma_);
+        }
+        running[code_[static_cast<unsigned char>(bwt_[i])]]++;
+    }
+    if (n % sample_rate_ == 0) {
+        std::copy(running.begin(), running.end(), checkpoints_.begin() + (n / sample_rate_) * sigma_);
+    }
+}
+
+uint64_t OccTable::GetMemoryBytes() const {
+    return checkpoints_.size() * sizeof(uint64_t) + sizeof(code_) + sizeof(c_array_);
+}
+
+uint64_t OccTable::Occ(const char c, const uint64_t i) const {
+    static const CountByteFn count_byte = DetectCountByte();
+
+    const int16_t code = code_[static_cast<unsigned char>(c)];
+    if (code == kAbsent)
+        return 0;
+    const uint64_t cp    = i / sample_rate_;
+    const uint64_t start = cp * sample_rate_;
+    return checkpoints_[cp * sigma_ + code] + count_byte(bwt_.data() + start, i - start, c);
+}
+
+uint64_t OccTable::ComputeLPM(const std::string &query) const {
+    uint64_t left    = 0;
+    uint64_t right   = bwt_.size();
+    uint64_t lpm_len = 0;
+    for (char c : query) {
+        left  = LF(c, left);
+        right = LF(c, right);
+        // An empty interval stays empty, so the remaining characters cannot extend the match
+        if (left >= right)
+            break;
+        lpm_len++;
+    }
+    return lpm_len;
+}
+
+std::vector<uint64_t> OccTable::ComputeLPMBatch(const std::vector<std::string> &queries) const {
+    std::vector<uint64_t> lpm_lens(queries.size());
+    for (size_t q = 0; q < queries.size(); ++q) {
+        lpm_lens[q] = ComputeLPM(queries[q]);
+    }
+    return lpm_lens;
+}
+
+std::vector<uint64_t> OccTable::ComputeLPMBatch(const std::vector<std::string> &queries, ThreadPool &pool) const {
+    const uint64_t num_queries = queries.size();
+    const uint64_t num_chunks  = (num_queries + kQueriesPerChunk - 1) / kQueriesPerChunk;
+
+    std::vector<uint64_t> lpm_lens(num_queries);
+    pool.ParallelFor(num_chunks, [&](uint64_t chunk) {
+        const uint64_t end = std::min(num_queries, (chunk + 1) * kQueriesPerChunk);
+        for (uint64_t q = chunk * kQueriesPerChunk; q < end; ++q) {
+            lpm_lens[q] = ComputeLPM(queries[q]);
+        }
+    });
+    return lpm_lens;
+}
+
+}    // namespace wm
+}    // namespace ringoa
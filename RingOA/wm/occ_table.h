@@ -0,0 +1,81 @@
+#ifndef WM_OCC_TABLE_H_
+#define WM_OCC_TABLE_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ringoa {
+
+class ThreadPool;
+
+namespace wm {
+
+/**
+ * @brief Sampled occurrence table over a BWT, for plaintext backward search.
+ *
+ * Overview
+ * - Every sample_rate positions, a checkpoint stores Occ(c, i) for each symbol c of the BWT
+ *   (the symbols of one checkpoint are adjacent, so a lookup touches one cache line).
+ * - Occ(c, i) = checkpoint below i + the occurrences of c between it and i, counted with
+ *   byte compares (AVX2 when available) over at most sample_rate - 1 bytes.
+ * - C[c] = number of BWT characters smaller than c, so LF(c, i) = C[c] + Occ(c, i).
+ * - A backward-search step costs O(sample_rate / 32), independent of the BWT length.
+ *
+ * Notes
+ * - The table owns the BWT; checkpoints add 8 * sigma / sample_rate bytes per character.
+ * - Characters that do not occur in the BWT have Occ = 0 (the search interval becomes empty).
+ * - ComputeLPM follows FMIndex::ComputeLPMfromWM: the query is consumed front to back over
+ *   the BWT of the reversed text.
+ */
+class OccTable {
+public:
+    static constexpr uint64_t kDefaultSampleRate = 128;
+
+    OccTable() = default;
+    explicit OccTable(std::string bwt, const uint64_t sample_rate = kDefaultSampleRate);
+
+    const std::string &GetBwt() const {
+        return bwt_;
+    }
+    uint64_t GetSampleRate() const {
+        return sample_rate_;
+    }
+    uint64_t GetSigma() const {
+        return sigma_;
+    }
+    uint64_t GetMemoryBytes() const;    ///< checkpoints only (the BWT itself excluded)
+
+    // Occurrences of c in BWT[0, i), i <= BWT length
+    uint64_t Occ(const char c, const uint64_t i) const;
+    // C[c]: BWT characters smaller than c
+    uint64_t GetC(const char c) const {
+        return c_array_[static_cast<unsigned char>(c)];
+    }
+    uint64_t LF(const char c, const uint64_t i) const {
+        return GetC(c) + Occ(c, i);
+    }
+
+    // Longest prefix of query whose backward search interval stays non-empty
+    uint64_t              ComputeLPM(const std::string &query) const;
+    std::vector<uint64_t> ComputeLPMBatch(const std::vector<std::string> &queries) const;
+    // Same, with chunks of queries spread over pool (inline on the caller for a 1-thread pool)
+    std::vector<uint64_t> ComputeLPMBatch(const std::vector<std::string> &queries, ThreadPool &pool) const;
+
+private:
+    static constexpr int16_t  kAbsent          = -1;
+    static constexpr uint64_t kQueriesPerChunk = 256;    // batch scheduling granularity
+
+    std::string               bwt_;
+    uint64_t                  sample_rate_ = kDefaultSampleRate;
+    uint64_t                  sigma_       = 0;
+    std::array<int16_t, 256>  code_{};          // byte -> symbol index (kAbsent if not in the BWT)
+    std::array<uint64_t, 256> c_array_{};       // byte -> C[c]
+    std::vector<uint64_t>     checkpoints_;    // [checkpoint][symbol]
+};
+
+}    // namespace wm
+}    // namespace ringoa
+
+#endif    // WM_OCC_TABLE_H_
@@ -77,6 +77,13 @@ void OQuantileKey::Deserialize(const std::vector<uint8_t> &buffer) {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Deserializing OQuantileKey");
 #endif
+    // The DCF keys of a legacy key cannot be rewritten (see DcfKey), so it is not converted
+    if (buffer.size() != serialized_size_) {
+        if (buffer.size() == CalculateLegacySerializedSize(params_)) {
+            throw std::invalid_argument("Invalid OQuantileKey: written before early-terminated DCF keys, regenerate the key");
+        }
+        throw std::invalid_argument("Invalid OQuantileKey: size " + ToString(buffer.size()) + " != " + ToString(serialized_size_));
+    }
     size_t offset = 0;
 
     // Deserialize the number of OA keys
@@ -99,6 +106,14 @@ void OQuantileKey::Deserialize(const std::vector<uint8_t> &buffer) {
     }
 }
 
+size_t OQuantileKey::CalculateLegacySerializedSize(const OQuantileParameters &params) {
+    // IC key: a DDCF key (DCF key and mask) and two input shares
+    const size_t ic_key_size = fss::dcf::DcfKey::CalculateLegacySerializedSize(params.GetIcParameters().GetParameters().GetParameters()) + 3 * sizeof(uint64_t);
+    return 2 * sizeof(uint64_t) +
+           2 * params.GetSigma() * proto::RingOaKey::CalculateLegacySerializedSize(params.GetOaParameters()) +
+           params.GetSigma() * ic_key_size;
+}
+
 void OQuantileKey::PrintKey(const bool detailed) const {
     Logger::DebugLog(LOC, Logger::StrWithSep("OQuantile Key"));
     Logger::DebugLog(LOC, "Number of RingOa Keys: " + ToString(num_oa_keys));
@@ -121,8 +136,8 @@ OQuantileKeyGenerator::OQuantileKeyGenerator(
       rss_(rss) {
 }
 
-void OQuantileKeyGenerator::OfflineSetUp(const std::string &file_path) {
-    oa_gen_.OfflineSetUp(params_.GetSigma() * 2, file_path);
+void OQuantileKeyGenerator::OfflineSetUp(const std::string &file_path, const uint64_t num_queries) {
+    oa_gen_.OfflineSetUp(params_.GetSigma() * 2 * num_queries, file_path);
 }
 
 std::array<sharing::RepShareMat64, 3> OQuantileKeyGenerator::GenerateDatabaseU64Share(const WaveletMatrix &wm) const {
@@ -134,41 +149,51 @@ std::array<sharing::RepShareMat64, 3> OQuantileKeyGenerator::GenerateDatabaseU64
 }
 
 std::array<OQuantileKey, 3> OQuantileKeyGenerator::GenerateKeys() const {
-    // Initialize the keys
-    std::array<OQuantileKey, 3> keys = {
-        OQuantileKey(0, params_),
-        OQuantileKey(1, params_),
-        OQuantileKey(2, params_),
-    };
+    return std::move(GenerateKeys(1)[0]);
+}
 
+std::vector<std::array<OQuantileKey, 3>> OQuantileKeyGenerator::GenerateKeys(const uint64_t count) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, Logger::StrWithSep("Generate OQuantile keys"));
 #endif
 
-    for (uint64_t i = 0; i < keys[0].num_oa_keys; ++i) {
-        // Generate the RingOa keys
-        std::array<proto::RingOaKey, 3> oa_key = oa_gen_.GenerateKeys();
+    // Initialize the keys
+    std::vector<std::array<OQuantileKey, 3>> keys;
+    keys.reserve(count);
+    for (uint64_t k = 0; k < count; ++k) {
+        keys.push_back({OQuantileKey(0, params_), OQuantileKey(1, params_), OQuantileKey(2, params_)});
+    }
+
+    // Generate the RingOa keys of all OQuantile keys in one batch
+    const uint64_t                               num_oa_keys = 2 * params_.GetSigma();
+    const uint64_t                               num_ic_keys = params_.GetSigma();
+    std::vector<std::array<proto::RingOaKey, 3>> oa_keys     = oa_gen_.GenerateKeys(count * num_oa_keys);
 
+    for (uint64_t k = 0; k < count; ++k) {
         // Set the RingOa keys
-        keys[0].oa_keys[i] = std::move(oa_key[0]);
-        keys[1].oa_keys[i] = std::move(oa_key[1]);
-        keys[2].oa_keys[i] = std::move(oa_key[2]);
-    }
+        for (uint64_t i = 0; i < num_oa_keys; ++i) {
+            keys[k][0].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][0]);
+            keys[k][1].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][1]);
+            keys[k][2].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][2]);
+        }
 
-    for (uint64_t i = 0; i < keys[0].num_ic_keys; ++i) {
-        // Generate the IntegerComparison keys
-        std::pair<proto::IntegerComparisonKey, proto::IntegerComparisonKey> ic_key = ic_gen_.GenerateKeys();
+        for (uint64_t i = 0; i < num_ic_keys; ++i) {
+            // Generate the IntegerComparison keys
+            std::pair<proto::IntegerComparisonKey, proto::IntegerComparisonKey> ic_key = ic_gen_.GenerateKeys();
 
-        // Set the IntegerComparison keys
-        keys[1].ic_keys[i] = std::move(ic_key.first);
-        keys[2].ic_keys[i] = std::move(ic_key.second);
+            // Set the IntegerComparison keys
+            keys[k][1].ic_keys[i] = std::move(ic_key.first);
+            keys[k][2].ic_keys[i] = std::move(ic_key.second);
+        }
     }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "OQuantile keys generated");
-    keys[0].PrintKey();
-    keys[1].PrintKey();
-    keys[2].PrintKey();
+    for (const auto &key : keys) {
+        key[0].PrintKey();
+        key[1].PrintKey();
+        key[2].PrintKey();
+    }
 #endif
 
     // Return the keys
@@ -435,5 +460,94 @@ void OQuantileEvaluator::EvaluateQuantile_Parallel(Channels
     }
 }
 
+CoTask OQuantileEvaluator::EvaluateQuantile_Co(CoScheduler                  &sched,
+                                               Channels                     &chls,
+                                               const OQuantileKey           &key,
+                                               std::vector<block>           &uv_prev,
+                                               std::vector<block>           &uv_next,
+                                               const sharing::RepShareMat64 &wm_tables,
+                                               sharing::RepShare64           left_sh,
+                                               sharing::RepShare64           right_sh,
+                                               sharing::RepShare64           k_sh,
+                                               sharing::RepShare64          &result) const {
+    uint64_t s        = params_.GetShareSize();
+    uint64_t sigma    = params_.GetSigma();
+    uint64_t party_id = chls.party_id;
+
+    result = sharing::RepShare64(0, 0);
+    sharing::RepShare64 zeroleft_sh(0, 0), zeroright_sh(0, 0);
+    sharing::RepShare64 zerocount_sh(0, 0);
+    sharing::RepShare64 comp_sh(0, 0);
+
+    size_t oa_key_idx = 0;
+    for (uint64_t i = sigma; i > 0; --i) {
+        const size_t bit = i - 1;
+        co_await oa_eval_.EvaluateCo(sched, chls, key.oa_keys[oa_key_idx], uv_prev, uv_next, wm_tables.RowView(bit), left_sh, zeroleft_sh);
+        co_await oa_eval_.EvaluateCo(sched, chls, key.oa_keys[oa_key_idx + 1], uv_prev, uv_next, wm_tables.RowView(bit), right_sh, zeroright_sh);
+        oa_key_idx += 2;
+
+        sharing::RepShare64 total_zeros = wm_tables.RowView(bit).At(wm_tables.RowView(bit).Size() - 1);
+        rss_.EvaluateSub(zeroright_sh, zeroleft_sh, zerocount_sh);
+
+        // Round 1: comparison between P1 and P2 on (2, 2)-shares; P0 keeps in step
+        uint64_t                ic = 0;
+        std::array<uint64_t, 2> masked_own{}, masked_peer{};
+        sharing::RepShare64     r1_sh, r2_sh;
+        rss_.Rand(r1_sh);
+        rss_.Rand(r2_sh);
+        if (party_id == 1) {
+            uint64_t k_0         = Mod2N(k_sh.data[0] + k_sh.data[1] + r1_sh.data[1], s);
+            uint64_t zerocount_0 = Mod2N(zerocount_sh.data[0] + zerocount_sh.data[1] + r2_sh.data[1], s);
+            masked_own           = ic_eval_.MaskSharedInput(key.ic_keys[bit], k_0, zerocount_0);
+            chls.next.asyncSendCopy(masked_own.data(), masked_own.size());
+            co_await sched.Wait(chls.next.asyncRecv(masked_peer.data(), masked_peer.size()));
+            ic = ic_eval_.EvaluateMaskedShares(key.ic_keys[bit], masked_own, masked_peer);
+        } else if (party_id == 2) {
+            uint64_t k_1         = Mod2N(k_sh.data[0] - r1_sh.data[0], s);
+            uint64_t zerocount_1 = Mod2N(zerocount_sh.data[0] - r2_sh.data[0], s);
+            masked_own           = ic_eval_.MaskSharedInput(key.ic_keys[bit], k_1, zerocount_1);
+            chls.prev.asyncSendCopy(masked_own.data(), masked_own.size());
+            co_await sched.Wait(chls.prev.asyncRecv(masked_peer.data(), masked_peer.size()));
+            ic = ic_eval_.EvaluateMaskedShares(key.ic_keys[bit], masked_peer, masked_own);
+        } else {
+            co_await sched.Yield();
+        }
+
+        // Round 2: convert the (2, 2)-sharing to RSS
+        rss_.Rand(r1_sh);
+        comp_sh[0] = Mod2N(ic + r1_sh[1] - r1_sh[0], s);
+        chls.next.asyncSendCopy(&comp_sh[0], 1);
+        co_await sched.Wait(chls.prev.asyncRecv(&comp_sh[1], 1));
+
+        // Round 3: the selects of k, left and right, z = x + comp * (y - x)
+        sharing::RepShare64 update_sh, oneleft_sh, oneright_sh;
+        rss_.EvaluateSub(k_sh, zerocount_sh, update_sh);
+        rss_.EvaluateAdd(total_zeros, left_sh, oneleft_sh);
+        rss_.EvaluateSub(oneleft_sh, zeroleft_sh, oneleft_sh);
+        rss_.EvaluateAdd(total_zeros, right_sh, oneright_sh);
+        rss_.EvaluateSub(oneright_sh, zeroright_sh, oneright_sh);
+
+        std::array<sharing::RepShare64, 3> x_sh = {k_sh, zeroleft_sh, zeroright_sh};
+        std::array<sharing::RepShare64, 3> y_sh = {update_sh, oneleft_sh, oneright_sh};
+        std::array<uint64_t, 3>            prod_0, prod_1;
+        for (size_t j = 0; j < x_sh.size(); ++j) {
+            sharing::RepShare64 y_sub_x;
+            rss_.EvaluateSub(y_sh[j], x_sh[j], y_sub_x);
+            prod_0[j] = rss_.EvaluateMultLocal(comp_sh, y_sub_x);
+        }
+        chls.next.asyncSendCopy(prod_0.data(), prod_0.size());
+        co_await sched.Wait(chls.prev.asyncRecv(prod_1.data(), prod_1.size()));
+        rss_.EvaluateAdd(x_sh[0], sharing::RepShare64(prod_0[0], prod_1[0]), k_sh);
+        rss_.EvaluateAdd(x_sh[1], sharing::RepShare64(prod_0[1], prod_1[1]), left_sh);
+        rss_.EvaluateAdd(x_sh[2], sharing::RepShare64(prod_0[2], prod_1[2]), right_sh);
+
+        // Update result
+        sharing::RepShare64 cond_sh(0, 0);
+        cond_sh[0] = Mod2N(comp_sh[0] * (1UL << bit), s);
+        cond_sh[1] = Mod2N(comp_sh[1] * (1UL << bit), s);
+        rss_.EvaluateAdd(result, cond_sh, result);
+    }
+}
+
 }    // namespace wm
 }    // namespace ringoa
@@ -113,6 +113,11 @@ OQuantileKey {
     void Serialize(std::vector<uint8_t> &buffer) const;
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of a key written before this format (legacy DPF and DCF keys) for 'params'.
+    // Such a key holds DCF keys without early termination and cannot be converted: Deserialize
+    // rejects it with std::invalid_argument.
+    static size_t CalculateLegacySerializedSize(const OQuantileParameters &params);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
@@ -128,7 +133,9 @@ public:
         sharing::AdditiveSharing2P   &ass,
         sharing::ReplicatedSharing3P &rss);
 
-    void OfflineSetUp(const std::string &file_path);
+    // Beaver triples for 'num_queries' quantile evaluations (e.g., concurrent EvaluateQuantile_Co
+    // sessions).
+    void OfflineSetUp(const std::string &file_path, const uint64_t num_queries = 1);
 
     const proto::RingOaKeyGenerator &GetRingOaKeyGenerator() const {
         return oa_gen_;
@@ -136,7 +143,13 @@ public:
 
     std::array<sharing::RepShareMat64, 3> GenerateDatabaseU64Share(const WaveletMatrix &wm) const;
 
-    std::array<OQuantileKey, 3> GenerateKeys() const;
+    // Threads used for the RingOA keys (see RingOaKeyGenerator::GenerateKeys(count)).
+    void SetNumThreads(const uint64_t num_threads) {
+        oa_gen_.SetNumThreads(num_threads);
+    }
+
+    std::array<OQuantileKey, 3>              GenerateKeys() const;
+    std::vector<std::array<OQuantileKey, 3>> GenerateKeys(const uint64_t count) const;
 
 private:
     OQuantileParameters                  params_;
@@ -175,6 +188,21 @@ public:
                                    sharing::RepShare64          &k_sh,
                                    sharing::RepShare64          &result) const;
 
+    // Coroutine form of EvaluateQuantile for sessions run by a CoScheduler (see
+    // RingOaEvaluator::EvaluateCo). Per level: the two RingOA accesses, the comparison round
+    // between P1 and P2, its reshare, and the three selects in one round. key, wm_tables and
+    // result must outlive the task.
+    CoTask EvaluateQuantile_Co(CoScheduler                  &sched,
+                               Channels                     &chls,
+                               const OQuantileKey           &key,
+                               std::vector<block>           &uv_prev,
+                               std::vector<block>           &uv_next,
+                               const sharing::RepShareMat64 &wm_tables,
+                               sharing::RepShare64           left_sh,
+                               sharing::RepShare64           right_sh,
+                               sharing::RepShare64           k_sh,
+                               sharing::RepShare64          &result) const;
+
 private:
     OQuantileParameters               params_;
     proto::RingOaEvaluator            oa_eval_;
@@ -2,6 +2,7 @@
 
 #include <cstring>
 
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/utils/logger.h"
@@ -76,6 +77,28 @@ void OWMKey::Deserialize(const std::vector<uint8_t> &buffer) {
     }
 }
 
+size_t OWMKey::CalculateLegacySerializedSize(const OWMParameters &params) {
+    return sizeof(uint64_t) + params.GetSigma() * proto::RingOaKey::CalculateLegacySerializedSize(params.GetOaParameters());
+}
+
+void OWMKey::ConvertLegacy(const OWMParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed) {
+    if (legacy.size() != CalculateLegacySerializedSize(params)) {
+        throw std::invalid_argument("Invalid legacy OWMKey: size " + ToString(legacy.size()) + " != " + ToString(CalculateLegacySerializedSize(params)));
+    }
+    const size_t key_size = proto::RingOaKey::CalculateLegacySerializedSize(params.GetOaParameters());
+    auto         it       = legacy.begin();
+
+    // Number of OA keys
+    packed.insert(packed.end(), it, it + sizeof(uint64_t));
+    it += sizeof(uint64_t);
+
+    // OA keys
+    for (uint64_t i = 0; i < params.GetSigma(); ++i) {
+        proto::RingOaKey::ConvertLegacy(params.GetOaParameters(), std::vector<uint8_t>(it, it + key_size), packed);
+        it += key_size;
+    }
+}
+
 void OWMKey::PrintKey(const bool detailed) const {
     Logger::DebugLog(LOC, Logger::StrWithSep("OWM Key"));
     Logger::DebugLog(LOC, "Number of RingOa Keys: " + ToString(num_oa_keys));
@@ -102,32 +125,41 @@ std::array<sharing::RepShareMat64, 3> OWMKeyGenerator::GenerateDatabaseU64Share(
 }
 
 std::array<OWMKey, 3> OWMKeyGenerator::GenerateKeys() const {
-    // Initialize the keys
-    std::array<OWMKey, 3> keys = {
-        OWMKey(0, params_),
-        OWMKey(1, params_),
-        OWMKey(2, params_),
-    };
+    return std::move(GenerateKeys(1)[0]);
+}
 
+std::vector<std::array<OWMKey, 3>> OWMKeyGenerator::GenerateKeys(const uint64_t count) const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, Logger::StrWithSep("Generate OWM keys"));
 #endif
 
-    for (uint64_t i = 0; i < keys[0].num_oa_keys; ++i) {
-        // Generate the RingOa keys
-        std::array<proto::RingOaKey, 3> oa_key = oa_gen_.GenerateKeys();
+    // Initialize the keys
+    std::vector<std::array<OWMKey, 3>> keys;
+    keys.reserve(count);
+    for (uint64_t k = 0; k < count; ++k) {
+        keys.push_back({OWMKey(0, params_), OWMKey(1, params_), OWMKey(2, params_)});
+    }
 
-        // Set the RingOa keys
-        keys[0].oa_keys[i] = std::move(oa_key[0]);
-        keys[1].oa_keys[i] = std::move(oa_key[1]);
-        keys[2].oa_keys[i] = std::move(oa_key[2]);
+    // Generate the RingOa keys of all OWM keys in one batch
+    const uint64_t                               num_oa_keys = params_.GetSigma();
+    std::vector<std::array<proto::RingOaKey, 3>> oa_keys     = oa_gen_.GenerateKeys(count * num_oa_keys);
+
+    // Set the RingOa keys
+    for (uint64_t k = 0; k < count; ++k) {
+        for (uint64_t i = 0; i < num_oa_keys; ++i) {
+            keys[k][0].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][0]);
+            keys[k][1].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][1]);
+            keys[k][2].oa_keys[i] = std::move(oa_keys[k * num_oa_keys + i][2]);
+        }
     }
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "OWM keys generated");
-    keys[0].PrintKey();
-    keys[1].PrintKey();
-    keys[2].PrintKey();
+    for (const auto &key : keys) {
+        key[0].PrintKey();
+        key[1].PrintKey();
+        key[2].PrintKey();
+    }
 #endif
 
     // Return the keys
@@ -144,6 +176,19 @@ OWMEvaluator::OWMEvaluator(
       rss_(rss) {
 }
 
+uint64_t OWMEvaluator::PrecomputeFde(const OWMKey &key) const {
+    proto::RingOaFdeCache *cache = oa_eval_.GetFdeCache();
+    if (cache == nullptr) {
+        return 0;
+    }
+    std::vector<const proto::RingOaKey *> oa_keys;
+    oa_keys.reserve(key.oa_keys.size());
+    for (const auto &oa_key : key.oa_keys) {
+        oa_keys.push_back(&oa_key);
+    }
+    return cache->Precompute(oa_keys);
+}
+
 void OWMEvaluator::EvaluateRankCF(Channels                      &chls,
                                   const OWMKey                  &key,
                                   std::vector<block>            &uv_prev,
@@ -243,5 +288,115 @@ void OWMEvaluator::EvaluateRankCF_Parallel(Channels                      &chls,
     result = position_sh;
 }
 
+void OWMEvaluator::EvaluateRankCF_Pipelined(Channels                                &chls,
+                                            std::span<const OWMKey *const>           keys,
+                                            std::vector<block>                      &uv_prev,
+                                            std::vector<block>                      &uv_next,
+                                            const sharing::RepShareMat64            &wm_tables,
+                                            std::span<const sharing::RepShareView64> char_sh,
+                                            sharing::RepShareVec64                  &position_sh,
+                                            sharing::RepShareVec64                  &result,
+                                            const uint64_t                           depth) const {
+    uint64_t sigma     = params_.GetSigma();
+    uint64_t num_query = keys.size();
+
+    if (char_sh.size() != num_query || position_sh.Size() != num_query) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_query) + ", char_sh=" + ToString(char_sh.size()) +
+                                  ", position_sh=" + ToString(position_sh.Size()));
+        return;
+    }
+
+    std::vector<const proto::RingOaKey *> oa_keys(num_query);
+    sharing::RepShareVec64                rank0_sh(num_query), c_sh(num_query);
+    for (uint64_t i = 0; i < sigma; ++i) {
+        for (uint64_t k = 0; k < num_query; ++k) {
+            oa_keys[k] = &keys[k]->oa_keys[i];
+            c_sh.Set(k, char_sh[k].At(i));
+        }
+        oa_eval_.EvaluatePipelined(chls, oa_keys, uv_prev, uv_next, wm_tables.RowView(i), position_sh, rank0_sh, depth);
+        SelectNextPosition(chls, wm_tables.RowView(i), c_sh, rank0_sh, position_sh);
+    }
+    result = position_sh;
+}
+
+void OWMEvaluator::EvaluateRankCF_Batch(Channels                                &chls,
+                                        std::span<const OWMKey *const>           keys,
+                                        std::vector<block>                      &uv_prev,
+                                        std::vector<block>                      &uv_next,
+                                        const sharing::RepShareMat64            &wm_tables,
+                                        std::span<const sharing::RepShareView64> char_sh,
+                                        sharing::RepShareVec64                  &position_sh,
+                                        sharing::RepShareVec64                  &result) const {
+    uint64_t sigma     = params_.GetSigma();
+    uint64_t num_query = keys.size();
+
+    if (char_sh.size() != num_query || position_sh.Size() != num_query) {
+        Logger::ErrorLog(LOC, "Size mismatch: keys=" + ToString(num_query) + ", char_sh=" + ToString(char_sh.size()) +
+                                  ", position_sh=" + ToString(position_sh.Size()));
+        return;
+    }
+
+    std::vector<const proto::RingOaKey *> oa_keys(num_query);
+    sharing::RepShareVec64                rank0_sh(num_query), c_sh(num_query);
+    for (uint64_t i = 0; i < sigma; ++i) {
+        for (uint64_t k = 0; k < num_query; ++k) {
+            oa_keys[k] = &keys[k]->oa_keys[i];
+            c_sh.Set(k, char_sh[k].At(i));
+        }
+        oa_eval_.EvaluateBatch(chls, oa_keys, uv_prev, uv_next, wm_tables.RowView(i), position_sh, rank0_sh);
+        SelectNextPosition(chls, wm_tables.RowView(i), c_sh, rank0_sh, position_sh);
+    }
+    result = position_sh;
+}
+
+void OWMEvaluator::SelectNextPosition(Channels                      &chls,
+                                      const sharing::RepShareView64 &table,
+                                      const sharing::RepShareVec64  &c_sh,
+                                      const sharing::RepShareVec64  &rank0_sh,
+                                      sharing::RepShareVec64        &position_sh) const {
+    uint64_t               num_query = rank0_sh.Size();
+    sharing::RepShareVec64 rank1_sh(num_query), rank_diff_sh(num_query), prod_sh(num_query);
+
+    // rank1 = position - rank0 + total_zeros; position = rank0 + c * (rank1 - rank0)
+    sharing::RepShare64 total_zeros = table.At(table.Size() - 1);
+    for (uint64_t k = 0; k < num_query; ++k) {
+        sharing::RepShare64 p_sub_rank0_sh, rank1_k_sh;
+        rss_.EvaluateSub(position_sh.At(k), rank0_sh.At(k), p_sub_rank0_sh);
+        rss_.EvaluateAdd(p_sub_rank0_sh, total_zeros, rank1_k_sh);
+        rank1_sh.Set(k, rank1_k_sh);
+    }
+    rss_.EvaluateSub(rank1_sh, rank0_sh, rank_diff_sh);
+    rss_.EvaluateMult(chls, c_sh, rank_diff_sh, prod_sh);
+    rss_.EvaluateAdd(rank0_sh, prod_sh, position_sh);
+}
+
+CoTask OWMEvaluator::EvaluateRankCF_Co(CoScheduler                  &sched,
+                                       Channels                     &chls,
+                                       const OWMKey                 &key,
+                                       std::vector<block>           &uv_prev,
+                                       std::vector<block>           &uv_next,
+                                       const sharing::RepShareMat64 &wm_tables,
+                                       const sharing::RepShareView64 char_sh,
+                                       sharing::RepShare64           position_sh,
+                                       sharing::RepShare64          &result) const {
+    uint64_t sigma = params_.GetSigma();
+
+    sharing::RepShare64 rank0_sh, rank1_sh, p_sub_rank0_sh, diff_sh, prod_sh;
+    for (uint64_t i = 0; i < sigma; ++i) {
+        co_await oa_eval_.EvaluateCo(sched, chls, key.oa_keys[i], uv_prev, uv_next, wm_tables.RowView(i), position_sh, rank0_sh);
+
+        // position = rank0 + c * (rank1 - rank0), the multiplication of EvaluateSelect
+        sharing::RepShare64 total_zeros = wm_tables.RowView(i).At(wm_tables.RowView(i).Size() - 1);
+        rss_.EvaluateSub(position_sh, rank0_sh, p_sub_rank0_sh);
+        rss_.EvaluateAdd(p_sub_rank0_sh, total_zeros, rank1_sh);
+        rss_.EvaluateSub(rank1_sh, rank0_sh, diff_sh);
+        prod_sh[0] = rss_.EvaluateMultLocal(char_sh.At(i), diff_sh);
+        chls.next.asyncSendCopy(&prod_sh[0], 1);
+        co_await sched.Wait(chls.prev.asyncRecv(&prod_sh[1], 1));
+        rss_.EvaluateAdd(rank0_sh, prod_sh, position_sh);
+    }
+    result = position_sh;
+}
+
 }    // namespace wm
 }    // namespace ringoa
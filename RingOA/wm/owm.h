@@ -89,6 +89,11 @@ struct OWMKey {
     void Serialize(std::vector<uint8_t> &buffer) const;
     void Deserialize(const std::vector<uint8_t> &buffer);
 
+    // Serialized size of the legacy form (DPF keys with one byte per control bit) for 'params'.
+    static size_t CalculateLegacySerializedSize(const OWMParameters &params);
+    // Rewrites a key serialized with legacy DPF keys into the current form (see DpfKey::ConvertLegacy).
+    static void ConvertLegacy(const OWMParameters &params, const std::vector<uint8_t> &legacy, std::vector<uint8_t> &packed);
+
     void PrintKey(const bool detailed = false) const;
 
 private:
@@ -110,7 +115,13 @@ public:
 
     std::array<sharing::RepShareMat64, 3> GenerateDatabaseU64Share(const FMIndex &fm) const;
 
-    std::array<OWMKey, 3> GenerateKeys() const;
+    // Threads used for the RingOA keys (see RingOaKeyGenerator::GenerateKeys(count)).
+    void SetNumThreads(const uint64_t num_threads) {
+        oa_gen_.SetNumThreads(num_threads);
+    }
+
+    std::array<OWMKey, 3>              GenerateKeys() const;
+    std::vector<std::array<OWMKey, 3>> GenerateKeys(const uint64_t count) const;
 
 private:
     OWMParameters                 params_;
@@ -130,6 +141,14 @@ public:
         return oa_eval_;
     }
 
+    // FDE cache used by the RingOA evaluations (see RingOaEvaluator::SetFdeCache).
+    void SetFdeCache(proto::RingOaFdeCache *cache) {
+        oa_eval_.SetFdeCache(cache);
+    }
+    // Precomputes (or queues) the RingOA keys of 'key' on that cache in evaluation order;
+    // returns the number of keys cached or queued (0 without a cache).
+    uint64_t PrecomputeFde(const OWMKey &key) const;
+
     void EvaluateRankCF(Channels                      &chls,
                         const OWMKey                  &key,
                         std::vector<block>            &uv_prev,
@@ -149,7 +168,53 @@ public:
                                  sharing::RepShareVec64        &position_sh,
                                  sharing::RepShareVec64        &result) const;
 
+    // Rank CF for K independent queries (keys[k], char_sh[k], position_sh[k]): each level runs
+    // the K RingOA accesses through RingOaEvaluator::EvaluatePipelined with 'depth' in flight,
+    // then one vectorised select for all queries.
+    void EvaluateRankCF_Pipelined(Channels                                &chls,
+                                  std::span<const OWMKey *const>           keys,
+                                  std::vector<block>                      &uv_prev,
+                                  std::vector<block>                      &uv_next,
+                                  const sharing::RepShareMat64            &wm_tables,
+                                  std::span<const sharing::RepShareView64> char_sh,
+                                  sharing::RepShareVec64                  &position_sh,
+                                  sharing::RepShareVec64                  &result,
+                                  const uint64_t                           depth = proto::RingOaEvaluator::kPipelineDepth) const;
+
+    // Rank CF for K independent queries in lockstep: each level runs the K RingOA accesses as
+    // one RingOaEvaluator::EvaluateBatch and then one vectorised select, so the number of rounds
+    // does not depend on K.
+    void EvaluateRankCF_Batch(Channels                                &chls,
+                              std::span<const OWMKey *const>           keys,
+                              std::vector<block>                      &uv_prev,
+                              std::vector<block>                      &uv_next,
+                              const sharing::RepShareMat64            &wm_tables,
+                              std::span<const sharing::RepShareView64> char_sh,
+                              sharing::RepShareVec64                  &position_sh,
+                              sharing::RepShareVec64                  &result) const;
+
+    // Coroutine form of EvaluateRankCF (see CoScheduler and RingOaEvaluator::EvaluateCo): the
+    // RingOA access and one select round per level. key, wm_tables and result must outlive the
+    // task.
+    CoTask EvaluateRankCF_Co(CoScheduler                  &sched,
+                             Channels                     &chls,
+                             const OWMKey                 &key,
+                             std::vector<block>           &uv_prev,
+                             std::vector<block>           &uv_next,
+                             const sharing::RepShareMat64 &wm_tables,
+                             const sharing::RepShareView64 char_sh,
+                             sharing::RepShare64           position_sh,
+                             sharing::RepShare64          &result) const;
+
 private:
+    // position[k] = rank0[k] + c[k] * (rank1[k] - rank0[k]) with rank1 = position - rank0 +
+    // total_zeros of 'table', for all k in one multiplication round.
+    void SelectNextPosition(Channels                      &chls,
+                            const sharing::RepShareView64 &table,
+                            const sharing::RepShareVec64  &c_sh,
+                            const sharing::RepShareVec64  &rank0_sh,
+                            sharing::RepShareVec64        &position_sh) const;
+
     OWMParameters                 params_;
     proto::RingOaEvaluator        oa_eval_;
     sharing::ReplicatedSharing3P &rss_;
@@ -0,0 +1,211 @@
+#include "packed_symbols.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <immintrin.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "RingOA/utils/thread_pool.h"
+
+namespace {
+
+using ringoa::wm::kInvalidSymbol;
+using ringoa::wm::SymbolTable;
+
+// Symbols translated (and packed) at a time per thread
+constexpr size_t kBlockSymbols = 1 << 12;
+
+// dst[j] = table[src[j]] for j < len; returns the first j whose byte is outside the table (len if none)
+size_t TranslateScalar(const uint8_t *src, const size_t len, uint8_t *dst, const SymbolTable &table) noexcept {
+    size_t bad = len;
+    for (size_t j = 0; j < len; ++j) {
+        dst[j] = table[src[j]];
+        if (dst[j] == kInvalidSymbol && bad == len)
+            bad = j;
+    }
+    return bad;
+}
+
+// The table is split into 16 rows by the high nibble; a row is a pshufb lookup on the low
+// nibble. Rows without any valid byte are skipped (ASCII alphabets use 3 or 4 rows).
+__attribute__((target("avx2"))) size_t TranslateAvx2(const uint8_t *src, const size_t len, uint8_t *dst, const SymbolTable &table) noexcept {
+    __m256i  rows[16], his[16];
+    uint64_t num_rows = 0;
+    for (uint64_t h = 0; h < 16; ++h) {
+        const uint8_t *row = table.data() + 16 * h;
+        if (std::all_of(row, row + 16, [](uint8_t s) { return s == kInvalidSymbol; }))
+            continue;
+        rows[num_rows] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row)));
+        his[num_rows]  = _mm256_set1_epi8(static_cast<char>(h));
+        ++num_rows;
+    }
+
+    const __m256i nibble  = _mm256_set1_epi8(0x0F);
+    const __m256i invalid = _mm256_set1_epi8(static_cast<char>(kInvalidSymbol));
+    size_t        j       = 0;
+    for (; j + 32 <= len; j += 32) {
+        const __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + j));
+        const __m256i lo  = _mm256_and_si256(v, nibble);
+        const __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        __m256i       res = invalid;
+        for (uint64_t r = 0; r < num_rows; ++r) {
+            res = _mm256_blendv_epi8(res, _mm256_shuffle_epi8(rows[r], lo), _mm256_cmpeq_epi8(hi, his[r]));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), res);
+        const uint32_t bad = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(res, invalid)));
+        if (bad != 0)
+            return j + std::countr_zero(bad);
+    }
+    const size_t bad = TranslateScalar(src + j, len - j, dst + j, table);
+    return j + bad;
+}
+
+using TranslateFn = size_t (*)(const uint8_t *, size_t, uint8_t *, const SymbolTable &) noexcept;
+
+TranslateFn DetectTranslate() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return TranslateAvx2;
+    }
+#endif
+    return TranslateScalar;
+}
+
+}    // namespace
+
+namespace ringoa {
+namespace wm {
+
+PackedSymbols::PackedSymbols(const size_t n, const uint64_t bits)
+    : n_(n), bits_(bits) {
+    if (bits == 0 || bits > 64)
+        throw std::invalid_argument("PackedSymbols: bits must be in [1, 64]");
+    per_word_ = 64 / bits;
+    mask_     = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    words_.assign((n + per_word_ - 1) / per_word_, 0);
+}
+
+void PackedSymbols::Set(const size_t i, const uint64_t v) {
+    const uint64_t shift = (i % per_word_) * bits_;
+    uint64_t      &word  = words_[i / per_word_];
+    word                 = (word & ~(mask_ << shift)) | ((v & mask_) << shift);
+}
+
+void PackedSymbols::Clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+PackedSymbols::Reader::Reader(const PackedSymbols &symbols, const size_t i)
+    : word_(symbols.words_.data() + i / symbols.per_word_),
+      bits_(symbols.bits_), mask_(symbols.mask_), per_word_(symbols.per_word_),
+      slot_(i % symbols.per_word_), cur_(0) {
+    if (i < symbols.n_) {
+        cur_ = *word_ >> (slot_ * bits_);
+    }
+}
+
+uint64_t PackedSymbols::Reader::Next() {
+    if (slot_ == per_word_) {
+        cur_  = *++word_;
+        slot_ = 0;
+    }
+    const uint64_t v = cur_ & mask_;
+    cur_             = (cur_ >> (bits_ - 1)) >> 1;    // no undefined shift for bits_ == 64
+    ++slot_;
+    return v;
+}
+
+PackedSymbols::Writer::Writer(PackedSymbols &symbols, const size_t i)
+    : word_(symbols.words_.data() + i / symbols.per_word_),
+      bits_(symbols.bits_), mask_(symbols.mask_), per_word_(symbols.per_word_),
+      slot_(i % symbols.per_word_), shared_(slot_ != 0) {
+}
+
+void PackedSymbols::Writer::Push(const uint64_t v) {
+    acc_ |= (v & mask_) << (slot_ * bits_);
+    if (++slot_ == per_word_) {
+        Flush();
+        ++word_;
+        slot_   = 0;
+        acc_    = 0;
+        shared_ = false;
+    }
+}
+
+void PackedSymbols::Writer::Finish() {
+    if (slot_ > 0) {
+        Flush();
+    }
+}
+
+void PackedSymbols::Writer::Flush() {
+    // A word this range covers entirely has no other writer
+    if (shared_ || slot_ != per_word_) {
+        std::atomic_ref<uint64_t>(*word_).fetch_or(acc_, std::memory_order_relaxed);
+    } else {
+        *word_ = acc_;
+    }
+}
+
+SymbolTable MakeSymbolTable(std::string_view alphabet) {
+    if (alphabet.size() >= kInvalidSymbol)
+        throw std::invalid_argument("MakeSymbolTable: alphabet too large");
+    SymbolTable table;
+    table.fill(kInvalidSymbol);
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        table[static_cast<uint8_t>(alphabet[i])] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+PackedSymbols EncodeSymbols(std::string_view text, const SymbolTable &table, const uint64_t bits, const uint64_t num_threads) {
+    static const TranslateFn translate = DetectTranslate();
+
+    PackedSymbols packed(text.size(), bits);
+    for (uint8_t s : table) {
+        if (s != kInvalidSymbol && bits < 8 && (s >> bits) != 0)
+            throw std::invalid_argument("EncodeSymbols: symbol " + std::to_string(s) + " does not fit in " + std::to_string(bits) + " bits");
+    }
+
+    // Each chunk covers whole words, so chunks never write the same word
+    const uint64_t per_word   = packed.GetSymbolsPerWord();
+    const size_t   num_words  = packed.GetWords().size();
+    const uint64_t num_chunks = std::max<uint64_t>(num_threads, 1);
+    const size_t   chunk_size = (num_words + num_chunks - 1) / num_chunks * per_word;
+    const size_t   block_size = std::max<size_t>(kBlockSymbols / per_word, 1) * per_word;
+    const auto    *src        = reinterpret_cast<const uint8_t *>(text.data());
+
+    std::vector<size_t> first_bad(num_chunks, std::numeric_limits<size_t>::max());
+    ThreadPool          pool(num_chunks);
+    pool.ParallelFor(num_chunks, [&](uint64_t c) {
+        const size_t          begin = std::min(c * chunk_size, text.size());
+        const size_t          end   = std::min(begin + chunk_size, text.size());
+        std::vector<uint8_t>  ids(block_size);
+        PackedSymbols::Writer writer(packed, begin);
+        for (size_t b = begin; b < end; b += block_size) {
+            const size_t len = std::min(block_size, end - b);
+            const size_t bad = translate(src + b, len, ids.data(), table);
+            if (bad < len) {
+                first_bad[c] = b + bad;
+                return;
+            }
+            for (size_t j = 0; j < len; ++j) {
+                writer.Push(ids[j]);
+            }
+        }
+        writer.Finish();
+    });
+
+    const size_t bad = *std::min_element(first_bad.begin(), first_bad.end());
+    if (bad != std::numeric_limits<size_t>::max())
+        throw std::invalid_argument("EncodeSymbols: character '" + std::string(1, text[bad]) + "' at position " + std::to_string(bad) +
+                                    " is not in the alphabet");
+    return packed;
+}
+
+}    // namespace wm
+}    // namespace ringoa
@@ -0,0 +1,97 @@
+#ifndef WM_PACKED_SYMBOLS_H_
+#define WM_PACKED_SYMBOLS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ringoa {
+namespace wm {
+
+/**
+ * @brief Fixed-width symbol array with floor(64 / bits) symbols per 64-bit word.
+ *
+ * Symbols never straddle words, so a symbol is one shift and mask away and threads that
+ * write disjoint word ranges never share a word. Bare ACGT takes 2 bits (32 per word),
+ * DNA over {$,A,C,G,T,N} 3 bits (21 per word) and proteins 5 bits (12 per word).
+ *
+ * Reader and Writer walk the array sequentially from any position without a division per
+ * symbol. Writers OR into the array (it must be zero there); the words at both ends of a
+ * writer's range are updated atomically, so writers of adjacent ranges may run in parallel.
+ */
+class PackedSymbols {
+public:
+    PackedSymbols() = default;
+    PackedSymbols(const size_t n, const uint64_t bits);
+
+    size_t Size() const {
+        return n_;
+    }
+    uint64_t GetBitsPerSymbol() const {
+        return bits_;
+    }
+    uint64_t GetSymbolsPerWord() const {
+        return per_word_;
+    }
+    size_t GetMemoryBytes() const {
+        return words_.size() * sizeof(uint64_t);
+    }
+    const std::vector<uint64_t> &GetWords() const {
+        return words_;
+    }
+
+    uint64_t Get(const size_t i) const {
+        return (words_[i / per_word_] >> ((i % per_word_) * bits_)) & mask_;
+    }
+    void Set(const size_t i, const uint64_t v);
+    void Clear();    ///< all symbols to zero
+
+    class Reader {
+    public:
+        Reader(const PackedSymbols &symbols, const size_t i);
+        uint64_t Next();
+
+    private:
+        const uint64_t *word_;
+        uint64_t        bits_, mask_, per_word_, slot_, cur_;
+    };
+
+    class Writer {
+    public:
+        Writer(PackedSymbols &symbols, const size_t i);
+        void Push(const uint64_t v);
+        void Finish();    ///< flushes the last partial word
+
+    private:
+        uint64_t *word_;
+        uint64_t  bits_, mask_, per_word_, slot_, acc_ = 0;
+        bool      shared_;    // the current word may also be written by the previous range
+
+        void Flush();
+    };
+
+private:
+    size_t                n_        = 0;
+    uint64_t              bits_     = 0;
+    uint64_t              per_word_ = 0;
+    uint64_t              mask_     = 0;
+    std::vector<uint64_t> words_;
+};
+
+// Byte -> symbol table; bytes outside the alphabet map to kInvalidSymbol
+using SymbolTable                = std::array<uint8_t, 256>;
+constexpr uint8_t kInvalidSymbol = 0xFF;
+
+// alphabet[i] -> i (e.g. "ACGT" for 2-bit DNA)
+SymbolTable MakeSymbolTable(std::string_view alphabet);
+
+// Translates text through table (AVX2 when available) and packs it at 'bits' bits per symbol,
+// on num_threads threads. Throws std::invalid_argument on a byte outside the table.
+PackedSymbols EncodeSymbols(std::string_view text, const SymbolTable &table, const uint64_t bits, const uint64_t num_threads = 1);
+
+}    // namespace wm
+}    // namespace ringoa
+
+#endif    // WM_PACKED_SYMBOLS_H_
@@ -4,6 +4,7 @@
 #include <sdsl/csa_wt.hpp>
 
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
 
@@ -70,8 +71,10 @@ void CharMapper::Initialize(CharType type) {
     }
 
     id2char_.resize(char2id_.size());
+    table_.fill(kInvalidSymbol);
     for (const auto &[ch, id] : char2id_) {
-        id2char_[id] = ch;
+        id2char_[id]                           = ch;
+        table_[static_cast<unsigned char>(ch)] = static_cast<uint8_t>(id);
     }
 }
 
@@ -84,7 +87,7 @@ CharType CharMapper::GetType() const {
 }
 
 bool CharMapper::IsValidChar(char c) const {
-    return char2id_.find(c) != char2id_.end();
+    return table_[static_cast<unsigned char>(c)] != kInvalidSymbol;
 }
 
 std::vector<uint64_t> CharMapper::ToIds(const std::string &s) const {
@@ -97,11 +100,16 @@ std::vector<uint64_t> CharMapper::ToIds(const std::string &s) const {
 }
 
 uint64_t CharMapper::ToId(char c) const {
-    auto it = char2id_.find(c);
-    if (it == char2id_.end()) {
+    const uint8_t id = table_[static_cast<unsigned char>(c)];
+    if (id == kInvalidSymbol) {
         Logger::ErrorLog(LOC, "Character '" + std::string(1, c) + "' not found in alphabet");
+        return 0;
     }
-    return it->second;
+    return id;
+}
+
+PackedSymbols CharMapper::ToPacked(std::string_view s, const uint64_t num_threads) const {
+    return EncodeSymbols(s, table_, sigma_, num_threads);
 }
 
 std::string CharMapper::ToString(const std::vector<uint64_t> &v) const {
@@ -117,6 +125,10 @@ const std::unordered_map<char, uint64_t> &CharMapper::GetMap() const {
     return char2id_;
 }
 
+const SymbolTable &CharMapper::GetSymbolTable() const {
+    return table_;
+}
+
 std::string CharMapper::MapToString() const {
     std::string result;
     for (const auto &[ch, id] : char2id_) {
@@ -128,30 +140,47 @@ std::string CharMapper::MapToString() const {
     return result;
 }
 
-WaveletMatrix::WaveletMatrix(const std::string &data, const CharType type, const BuildOrder order)
+WaveletMatrix::WaveletMatrix(const std::string &data, const CharType type, const BuildOrder order, const uint64_t num_threads)
+    : WaveletMatrix(CharMapper(type).ToPacked(data, num_threads), type, order, num_threads) {
+}
+
+WaveletMatrix::WaveletMatrix(const std::vector<uint64_t> &data, const size_t sigma, const BuildOrder order, const uint64_t num_threads)
+    : length_(0), sigma_(sigma), order_(order) {
+    PackedSymbols         packed(data.size(), std::max<size_t>(sigma_, 1));
+    PackedSymbols::Writer writer(packed, 0);
+    for (uint64_t v : data) {
+        writer.Push(v);
+    }
+    writer.Finish();
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    Logger::DebugLog(LOC, "Sigma: " + ToString(sigma_));
+    Logger::DebugLog(LOC, "Order: " + GetBuildOrderString(order_));
+    Logger::DebugLog(LOC, "Data: " + ToString(data));
+    Logger::DebugLog(LOC, "Length: " + ToString(data.size()));
+#endif
+    Build(std::move(packed), num_threads);
+}
+
+WaveletMatrix::WaveletMatrix(PackedSymbols data, const CharType type, const BuildOrder order, const uint64_t num_threads)
     : length_(0), sigma_(0), order_(order), mapper_(type) {
-    data_  = mapper_.ToIds(data);
     sigma_ = mapper_.GetSigma();
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Sigma: " + ToString(sigma_));
     Logger::DebugLog(LOC, "Mapping: " + mapper_.MapToString());
     Logger::DebugLog(LOC, "Order: " + GetBuildOrderString(order_));
-    Logger::DebugLog(LOC, "Data: " + ToString(data_));
-    Logger::DebugLog(LOC, "Length: " + ToString(data.size()));
+    Logger::DebugLog(LOC, "Length: " + ToString(data.Size()));
 #endif
-    Build(data_);
+    Build(std::move(data), num_threads);
 }
 
-WaveletMatrix::WaveletMatrix(const std::vector<uint64_t> &data, const size_t sigma, const BuildOrder order)
+WaveletMatrix::WaveletMatrix(PackedSymbols data, const size_t sigma, const BuildOrder order, const uint64_t num_threads)
     : length_(0), sigma_(sigma), order_(order) {
-    data_ = data;
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "Sigma: " + ToString(sigma_));
     Logger::DebugLog(LOC, "Order: " + GetBuildOrderString(order_));
-    Logger::DebugLog(LOC, "Data: " + ToString(data_));
-    Logger::DebugLog(LOC, "Length: " + ToString(data.size()));
+    Logger::DebugLog(LOC, "Length: " + ToString(data.Size()));
 #endif
-    Build(data_);
+    Build(std::move(data), num_threads);
 }
 
 size_t WaveletMatrix::GetLength() const {
@@ -170,12 +199,50 @@ std::string WaveletMatrix::GetMapString() const {
     return mapper_.MapToString();
 }
 
-const std::vector<uint64_t> &WaveletMatrix::GetData() const {
-    return data_;
+std::vector<uint64_t> WaveletMatrix::GetData() const {
+    // Follows each position through the levels in build order (Access assumes MSB->LSB)
+    std::vector<uint64_t> data(length_);
+    for (size_t i = 0; i < length_; ++i) {
+        size_t pos = i;
+        for (size_t step = 0; step < sigma_; ++step) {
+            const size_t     bit   = order_ == BuildOrder::MSBFirst ? sigma_ - 1 - step : step;
+            const BitVector &level = levels_[bit];
+            if (level.Access(pos)) {
+                data[i] |= 1ULL << bit;
+                pos = level.GetNumZeros() + level.Rank1(pos);
+            } else {
+                pos = level.Rank0(pos);
+            }
+        }
+    }
+    return data;
+}
+
+const BitVector &WaveletMatrix::GetLevel(size_t bit) const {
+    return levels_.at(bit);
 }
 
-const std::vector<uint64_t> &WaveletMatrix::GetRank0Tables() const {
-    return rank0_tables_;
+size_t WaveletMatrix::GetMemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto &level : levels_) {
+        bytes += level.GetMemoryBytes();
+    }
+    return bytes;
+}
+
+std::vector<uint64_t> WaveletMatrix::GetRank0Tables() const {
+    if (length_ == 0)
+        return {};
+    const size_t          stride = length_ + 1;
+    std::vector<uint64_t> rank0_tables(sigma_ * stride, 0);
+    for (size_t bit = 0; bit < sigma_; ++bit) {
+        const BitVector &level = levels_[bit];
+        const size_t     off   = bit * stride;
+        for (size_t i = 0; i < length_; ++i) {
+            rank0_tables[off + i + 1] = rank0_tables[off + i] + !level.Access(i);
+        }
+    }
+    return rank0_tables;
 }
 
 BuildOrder WaveletMatrix::GetBuildOrder() const {
@@ -184,10 +251,11 @@ BuildOrder WaveletMatrix::GetBuildOrder() const {
 
 void WaveletMatrix::PrintRank0Tables() const {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    const size_t stride = length_ + 1;
+    const size_t                stride       = length_ + 1;
+    const std::vector<uint64_t> rank0_tables = GetRank0Tables();
     for (size_t bit = 0; bit < sigma_; ++bit) {
         size_t                    off = bit * stride;
-        std::span<const uint64_t> tbl(&rank0_tables_[off], stride);
+        std::span<const uint64_t> tbl(&rank0_tables[off], stride);
         Logger::DebugLog(
             LOC,
             "Rank0 Table[" + ToString(bit) + "]: " +
@@ -199,17 +267,15 @@ void WaveletMatrix::PrintRank0Tables() const {
 uint64_t WaveletMatrix::Access(size_t i) const {
     if (i >= length_)
         throw std::out_of_range("Access index out of range");
-    const size_t stride = length_ + 1;
-    uint64_t     result = 0;
+    uint64_t result = 0;
 
     // Traverse from MSB to LSB
     for (size_t lvl = sigma_; lvl > 0; --lvl) {
-        const size_t bit = lvl - 1;
-        const size_t off = bit * stride;
+        const size_t     bit   = lvl - 1;
+        const BitVector &level = levels_[bit];
 
-        const size_t z_before = rank0_tables_[off + i];
-        const size_t z_after  = rank0_tables_[off + i + 1];    // safe: i < length_
-        const bool   is_zero  = (z_after - z_before) == 1;
+        const size_t z_before = level.Rank0(i);
+        const bool   is_zero  = !level.Access(i);    // safe: i < length_
 
         if (is_zero) {
             // current bit is 0
@@ -217,7 +283,7 @@ uint64_t WaveletMatrix::Access(size_t i) const {
             // result bit stays 0
         } else {
             // current bit is 1
-            const size_t total_zeros = rank0_tables_[off + length_];
+            const size_t total_zeros = level.GetNumZeros();
             const size_t ones_before = i - z_before;                 // #ones in [0,i)
             i                        = total_zeros + ones_before;    // map into 1-bucket
             result |= (1ULL << bit);
@@ -232,17 +298,16 @@ uint64_t WaveletMatrix::Quantile(size_t l, size_t r, size_t k) const {
     if (k >= r - l)
         throw std::out_of_range("Quantile: k out of range");
 
-    const size_t stride = length_ + 1;
-    uint64_t     result = 0;
-    size_t       left = l, right = r;
+    uint64_t result = 0;
+    size_t   left = l, right = r;
 
     // Traverse from MSB to LSB
     for (size_t lvl = sigma_; lvl > 0; --lvl) {
-        const size_t bit = lvl - 1;
-        const size_t off = bit * stride;
+        const size_t     bit   = lvl - 1;
+        const BitVector &level = levels_[bit];
 
-        size_t z_left     = rank0_tables_[off + left];
-        size_t z_right    = rank0_tables_[off + right];
+        size_t z_left     = level.Rank0(left);
+        size_t z_right    = level.Rank0(right);
         size_t zero_count = z_right - z_left;
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         Logger::DebugLog(LOC, "Bit " + ToString(bit) + ", k = " + ToString(k));
@@ -262,7 +327,7 @@ uint64_t WaveletMatrix::Quantile(size_t l, size_t r, size_t k) const {
         } else {
             // k-th lies in the 1-bucket
             k -= zero_count;
-            size_t total_zeros = rank0_tables_[off + length_];
+            size_t total_zeros = level.GetNumZeros();
             size_t o_left      = left - z_left;
             size_t o_right     = right - z_right;
             left               = total_zeros + o_left;
@@ -301,8 +366,7 @@ uint64_t WaveletMatrix::RangeFreq(size_t l, size_t r,
     };
     std::stack<Node> st;
     st.push({l, r, sigma_, 0});
-    uint64_t     count  = 0;
-    const size_t stride = length_ + 1;
+    uint64_t count = 0;
 
     Logger::DebugLog(LOC, "RangeFreq begin");
     Logger::DebugLog(LOC, "Query: l=" + ToString(l) + ", r=" + ToString(r) +
@@ -333,14 +397,14 @@ uint64_t WaveletMatrix::RangeFreq(size_t l, size_t r,
             continue;
         }
 
-        size_t bit = lvl - 1;
-        size_t off = bit * stride;
+        size_t           bit   = lvl - 1;
+        const BitVector &level = levels_[bit];
 
-        size_t z_left  = rank0_tables_[off + left];
-        size_t z_right = rank0_tables_[off + right];
+        size_t z_left  = level.Rank0(left);
+        size_t z_right = level.Rank0(right);
         size_t nl0 = z_left, nr0 = z_right;
 
-        size_t total_zeros = rank0_tables_[off + length_];
+        size_t total_zeros = level.GetNumZeros();
         size_t o_left      = left - z_left;
         size_t o_right     = right - z_right;
         size_t nl1         = total_zeros + o_left;
@@ -405,7 +469,6 @@ void WaveletMatrix::RangeList(size_t l, size_t r,
     };
     std::stack<Node> st;
     st.push({l, r, sigma_, 0});
-    const size_t stride = length_ + 1;
 
     while (!st.empty()) {
         auto [left, right, lvl, prefix] = st.top();
@@ -420,14 +483,14 @@ void WaveletMatrix::RangeList(size_t l, size_t r,
             continue;
         }
 
-        size_t bit = lvl - 1;
-        size_t off = bit * stride;
+        size_t           bit   = lvl - 1;
+        const BitVector &level = levels_[bit];
 
-        size_t z_left  = rank0_tables_[off + left];
-        size_t z_right = rank0_tables_[off + right];
+        size_t z_left  = level.Rank0(left);
+        size_t z_right = level.Rank0(right);
         size_t nl0 = z_left, nr0 = z_right;
 
-        size_t total_zeros = rank0_tables_[off + length_];
+        size_t total_zeros = level.GetNumZeros();
         size_t o_left      = left - z_left;
         size_t o_right     = right - z_right;
         size_t nl1         = total_zeros + o_left;
@@ -475,22 +538,20 @@ uint64_t WaveletMatrix::RankCF(uint64_t c, size_t position) const {
     if (length_ == 0)
         return 0;
 
-    const size_t stride = length_ + 1;
-
     // Traverse from LSB to MSB
     for (size_t bit = 0; bit < sigma_; ++bit) {
-        const size_t off = bit * stride;
-        const bool   b   = (c >> bit) & 1ULL;
+        const BitVector &level = levels_[bit];
+        const bool       b     = (c >> bit) & 1ULL;
 
         // zeros prefix in [0, position)
-        const size_t zpos = rank0_tables_[off + position];
+        const size_t zpos = level.Rank0(position);
 
         if (!b) {
             // 0-bit: jump to 0-bucket
             position = zpos;
         } else {
             // 1-bit: jump to 1-bucket = totalZeros + ones_prefix
-            const size_t total_zeros = rank0_tables_[off + length_];
+            const size_t total_zeros = level.GetNumZeros();
             const size_t ones_prefix = position - zpos;
             position                 = total_zeros + ones_prefix;
         }
@@ -505,106 +566,101 @@ uint64_t WaveletMatrix::RankCF(uint64_t c, size_t position) const {
     return position;    // == C[c] + rank(c, position) under LSB->MSB build
 }
 
-void WaveletMatrix::Build(const std::vector<uint64_t> &data) {
+void WaveletMatrix::Build(PackedSymbols current, const uint64_t num_threads) {
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, "WaveletMatrix Build...");
 #endif
-    length_ = data.size();
+    length_ = current.Size();
     if (length_ == 0) {
-        rank0_tables_.clear();
+        levels_.clear();
         return;
     }
-
-    const size_t stride = length_ + 1;
-    rank0_tables_.assign(sigma_ * stride, 0);
-
-    std::vector<uint64_t> current = data;
-    if (order_ == BuildOrder::MSBFirst) {
-        BuildMsbFirst(std::move(current));
-    } else {
-        BuildLsbFirst(std::move(current));
+    if (current.GetBitsPerSymbol() > sigma_) {
+        // Drop the bits above sigma so that the levels only see sigma-bit symbols
+        PackedSymbols         narrowed(length_, std::max<size_t>(sigma_, 1));
+        PackedSymbols::Reader reader(current, 0);
+        PackedSymbols::Writer writer(narrowed, 0);
+        for (size_t i = 0; i < length_; ++i) {
+            writer.Push(reader.Next());
+        }
+        writer.Finish();
+        current = std::move(narrowed);
     }
 
+    levels_.assign(sigma_, BitVector(length_));
+    ThreadPool pool(std::max<uint64_t>(num_threads, 1));
+    BuildLevels(std::move(current), pool);
+
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     PrintRank0Tables();
     Logger::DebugLog(LOC, "WaveletMatrix Build - Done");
 #endif
 }
 
-void WaveletMatrix::BuildMsbFirst(std::vector<uint64_t> current) {
-    const size_t          stride = length_ + 1;
-    std::vector<uint64_t> zero_bucket(length_), one_bucket(length_);
-
-    for (size_t lvl = sigma_; lvl > 0; --lvl) {
-        const size_t bit   = lvl - 1;
-        const size_t off   = bit * stride;
-        size_t       zeros = 0, ones = 0;
-
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-        std::string bit_str;
-        bit_str.reserve(length_);
-#endif
-
-        for (size_t i = 0; i < length_; ++i) {
-            const bool is_one = (current[i] >> bit) & 1U;
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-            bit_str.push_back(is_one ? '1' : '0');
-#endif
-            if (is_one) {
-                one_bucket[ones++] = current[i];
-            } else {
-                zero_bucket[zeros++] = current[i];
-                ++rank0_tables_[off + i + 1];
+void WaveletMatrix::BuildLevels(PackedSymbols current, ThreadPool &pool) {
+    // Chunks cover whole 64-bit words, so no two chunks Set bits of the same word
+    const uint64_t      num_chunks = pool.GetNumThreads();
+    const size_t        chunk_size = ((length_ + num_chunks - 1) / num_chunks + 63) / 64 * 64;
+    PackedSymbols       next(length_, current.GetBitsPerSymbol());
+    std::vector<size_t> chunk_zeros(num_chunks), zero_pos(num_chunks), one_pos(num_chunks);
+
+    for (size_t step = 0; step < sigma_; ++step) {
+        const size_t bit   = order_ == BuildOrder::MSBFirst ? sigma_ - 1 - step : step;
+        BitVector   &level = levels_[bit];
+
+        pool.ParallelFor(num_chunks, [&](uint64_t c) {
+            const size_t          begin = std::min(c * chunk_size, length_);
+            const size_t          end   = std::min(begin + chunk_size, length_);
+            size_t                zeros = 0;
+            PackedSymbols::Reader reader(current, begin);
+            for (size_t i = begin; i < end; ++i) {
+                if ((reader.Next() >> bit) & 1U) {
+                    level.Set(i);
+                } else {
+                    ++zeros;
+                }
             }
-            rank0_tables_[off + i + 1] += rank0_tables_[off + i];
-        }
-
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-        Logger::DebugLog(LOC, "Bit Vector [" + ToString(bit) + "]: " + bit_str +
-                                  " (0: " + ToString(zeros) +
-                                  ", 1: " + ToString(ones) + ")");
-#endif
-
-        std::copy(zero_bucket.begin(), zero_bucket.begin() + zeros, current.begin());
-        std::copy(one_bucket.begin(), one_bucket.begin() + ones, current.begin() + zeros);
-    }
-}
-
-void WaveletMatrix::BuildLsbFirst(std::vector<uint64_t> current) {
-    const size_t          stride = length_ + 1;
-    std::vector<uint64_t> zero_bucket(length_), one_bucket(length_);
-
-    for (size_t bit = 0; bit < sigma_; ++bit) {
-        const size_t off   = bit * stride;
-        size_t       zeros = 0, ones = 0;
+            chunk_zeros[c] = zeros;
+        });
+        level.Build();
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
         std::string bit_str;
         bit_str.reserve(length_);
-#endif
-
         for (size_t i = 0; i < length_; ++i) {
-            const bool is_one = (current[i] >> bit) & 1U;
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-            bit_str.push_back(is_one ? '1' : '0');
-#endif
-            if (is_one) {
-                one_bucket[ones++] = current[i];
-            } else {
-                zero_bucket[zeros++] = current[i];
-                ++rank0_tables_[off + i + 1];
-            }
-            rank0_tables_[off + i + 1] += rank0_tables_[off + i];
+            bit_str.push_back(level.Access(i) ? '1' : '0');
         }
-
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
         Logger::DebugLog(LOC, "Bit Vector [" + ToString(bit) + "]: " + bit_str +
-                                  " (0: " + ToString(zeros) +
-                                  ", 1: " + ToString(ones) + ")");
+                                  " (0: " + ToString(level.GetNumZeros()) +
+                                  ", 1: " + ToString(level.GetNumOnes()) + ")");
 #endif
 
-        std::copy(zero_bucket.begin(), zero_bucket.begin() + zeros, current.begin());
-        std::copy(one_bucket.begin(), one_bucket.begin() + ones, current.begin() + zeros);
+        // Stable partition: chunk c writes after the zeros (ones) of chunks 0..c-1
+        size_t zeros_before = 0;
+        for (uint64_t c = 0; c < num_chunks; ++c) {
+            const size_t begin = std::min(c * chunk_size, length_);
+            zero_pos[c]        = zeros_before;
+            one_pos[c]         = level.GetNumZeros() + (begin - zeros_before);
+            zeros_before += chunk_zeros[c];
+        }
+        next.Clear();
+        pool.ParallelFor(num_chunks, [&](uint64_t c) {
+            const size_t          begin = std::min(c * chunk_size, length_);
+            const size_t          end   = std::min(begin + chunk_size, length_);
+            PackedSymbols::Reader reader(current, begin);
+            PackedSymbols::Writer zero_writer(next, zero_pos[c]), one_writer(next, one_pos[c]);
+            for (size_t i = begin; i < end; ++i) {
+                const uint64_t v = reader.Next();
+                if ((v >> bit) & 1U) {
+                    one_writer.Push(v);
+                } else {
+                    zero_writer.Push(v);
+                }
+            }
+            zero_writer.Finish();
+            one_writer.Finish();
+        });
+        std::swap(current, next);
     }
 }
 
@@ -613,29 +669,51 @@ FMIndex::FMIndex(const std::string &text, const CharType type) {
     text_ = text;
     std::reverse(text_.begin(), text_.end());
 
-    // 2) Build BWT from text
-    BuildBwt();
+    // 2) Build BWT from text (with its occurrence table)
+    occ_ = OccTable(BuildBwt());
 
-    // 3) Convert bwt_str_ to integers
-    wm_ = WaveletMatrix(bwt_str_, type, BuildOrder::LSBFirst);
+    // 3) Convert BWT to integers
+    wm_ = WaveletMatrix(occ_.GetBwt(), type, BuildOrder::LSBFirst);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
     Logger::DebugLog(LOC, kDash);
     Logger::DebugLog(LOC, "Alphabet size   : " + ToString(wm_.GetSigma()));
     Logger::DebugLog(LOC, "Mapping         : " + wm_.GetMapString());
     Logger::DebugLog(LOC, "Text            : " + text_);
-    Logger::DebugLog(LOC, "BWT             : " + bwt_str_);
+    Logger::DebugLog(LOC, "BWT             : " + occ_.GetBwt());
     Logger::DebugLog(LOC, "BWT as integers : " + ToString(wm_.GetData()));
     wm_.PrintRank0Tables();
     Logger::DebugLog(LOC, kDash);
 #endif
 }
 
+FMIndex::FMIndex(const std::string &text, const CharType type, const BwtBuildOptions &options) {
+    text_ = text;
+    std::reverse(text_.begin(), text_.end());
+    occ_ = OccTable(BwtBuilder(options).Build(text_));
+    wm_  = WaveletMatrix(occ_.GetBwt(), type, BuildOrder::LSBFirst, options.num_threads);
+}
+
+FMIndex FMIndex::FromBwt(std::string bwt, const CharType type, const uint64_t num_threads) {
+    FMIndex fm;
+    fm.occ_ = OccTable(std::move(bwt));
+    fm.wm_  = WaveletMatrix(fm.occ_.GetBwt(), type, BuildOrder::LSBFirst, num_threads);
+    return fm;
+}
+
 const WaveletMatrix &FMIndex::GetWaveletMatrix() const {
     return wm_;
 }
 
-const std::vector<uint64_t> &FMIndex::GetRank0Tables() const {
+const std::string &FMIndex::GetBwt() const {
+    return occ_.GetBwt();
+}
+
+const OccTable &FMIndex::GetOccTable() const {
+    return occ_;
+}
+
+std::vector<uint64_t> FMIndex::GetRank0Tables() const {
     return wm_.GetRank0Tables();
 }
 
@@ -665,18 +743,21 @@ std::vector<uint64_t> FMIndex::ConvertToBitMatrix(const std::string &query) cons
     return bits;
 }
 
-void FMIndex::BuildBwt() {
+std::string FMIndex::BuildBwt() const {
     // Construct the suffix array using the SDSL library
     sdsl::csa_wt<> csa;
     sdsl::construct_im(csa, text_, 1);
     // Convert the BWT to a string
+    std::string bwt;
+    bwt.reserve(text_.size() + 1);
     for (size_t i = 0; i < text_.size() + 1; ++i) {
         if (csa.bwt[i]) {
-            bwt_str_ += csa.bwt[i];
+            bwt += csa.bwt[i];
         } else {
-            bwt_str_ += '$';
+            bwt += '$';
         }
     }
+    return bwt;
 }
 
 void FMIndex::BackwardSearch(char c, uint64_t &left, uint64_t &right) const {
@@ -695,7 +776,7 @@ uint64_t FMIndex::ComputeLPMfromWM(const std::string &query) const {
 
     // Backward search for last character
     uint64_t              left  = 0;
-    uint64_t              right = static_cast<uint64_t>(bwt_str_.size());
+    uint64_t              right = static_cast<uint64_t>(occ_.GetBwt().size());
     std::vector<uint64_t> intervals;
     // Traverse query from end to front
     for (size_t i = 0; i < query.size(); ++i) {
@@ -721,72 +802,20 @@ uint64_t FMIndex::ComputeLPMfromWM(const std::string &query) const {
 }
 
 uint64_t FMIndex::ComputeLPMfromBWT(const std::string &query) const {
-    const std::string &bwt = bwt_str_;
-    const size_t       n   = bwt.size();
-
-    // Step 1: count character frequency
-    std::unordered_map<char, int> char_count;
-    for (char c : bwt) {
-        char_count[c]++;
-    }
-
-    // Step 2: build F[c] = offset (no need for range)
-    std::map<char, int> F;
-    int                 offset = 0;
-    for (const auto &[c, count] : std::map<char, int>(char_count.begin(), char_count.end())) {
-        F[c] = offset;
-        offset += count;
-    }
-    // #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    //     Logger::DebugLog(LOC, "F[c] = offset:");
-    //     for (const auto &[c, offset] : F) {
-    //         Logger::DebugLog(LOC, "  '" + std::string(1, c) + "' : " + ToString(offset));
-    //     }
-    // #endif
-
-    // Step 3: backward search with rank() + offset
-    int                   f       = 0;
-    int                   g       = static_cast<int>(n);
-    uint64_t              lpm_len = 0;
-    std::vector<uint64_t> intervals;
-
-    for (size_t qi = 0; qi < query.size(); ++qi) {
-        char        c     = query[qi];
-        std::string bwt_f = bwt.substr(0, f);
-        std::string bwt_g = bwt.substr(0, g);
-
-        int rank_f = static_cast<int>(std::count(bwt_f.begin(), bwt_f.end(), c));
-        int rank_g = static_cast<int>(std::count(bwt_g.begin(), bwt_g.end(), c));
-        int offset = F[c];
-
+    uint64_t lpm_len = occ_.ComputeLPM(query);
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
-        Logger::DebugLog(LOC, "(char: " + std::string(1, c) + ") (l, r) == (" +
-                                  ToString(f) + ", " + ToString(g) + ")");
-        Logger::DebugLog(LOC, "(char: " + std::string(1, c) + ") l = offset(" + ToString(offset) +
-                                  ") + rank(" + std::string(1, c) + ", " + ToString(f) + ")(" +
-                                  ToString(rank_f) + ")");
-        Logger::DebugLog(LOC, "(char: " + std::string(1, c) + ") r = offset(" + ToString(offset) +
-                                  ") + rank(" + std::string(1, c) + ", " + ToString(g) + ")(" +
-                                  ToString(rank_g) + ")");
-#endif
-
-        f = offset + rank_f;
-        g = offset + rank_g;
-
-        if (f < g) {
-            lpm_len++;
-        }
-        intervals.push_back(g - f);
-    }
-
-#if LOG_LEVEL >= LOG_LEVEL_DEBUG
-    Logger::DebugLog(LOC, "(l, r) == (" + ToString(f) + ", " + ToString(g) + ")");
-    Logger::DebugLog(LOC, "Intervals: " + ToString(intervals));
     Logger::DebugLog(LOC, "LPM length (without WM): " + ToString(lpm_len));
 #endif
-
     return lpm_len;
 }
 
+std::vector<uint64_t> FMIndex::ComputeLPMfromBWTBatch(const std::vector<std::string> &queries) const {
+    return occ_.ComputeLPMBatch(queries);
+}
+
+std::vector<uint64_t> FMIndex::ComputeLPMfromBWTBatch(const std::vector<std::string> &queries, ThreadPool &pool) const {
+    return occ_.ComputeLPMBatch(queries, pool);
+}
+
 }    // namespace wm
 }    // namespace ringoa
@@ -3,10 +3,19 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "bit_vector.h"
+#include "bwt_builder.h"
+#include "occ_table.h"
+#include "packed_symbols.h"
+
 namespace ringoa {
+
+class ThreadPool;
+
 namespace wm {
 
 /**
@@ -40,6 +49,7 @@ public:
     void Initialize(CharType type);
 
     const std::unordered_map<char, uint64_t> &GetMap() const;
+    const SymbolTable                        &GetSymbolTable() const;
     size_t                                    GetSigma() const;
     CharType                                  GetType() const;
     bool                                      IsValidChar(char c) const;
@@ -49,8 +59,12 @@ public:
     std::string           ToString(const std::vector<uint64_t> &v) const;
     std::string           MapToString() const;
 
+    // IDs packed at sigma bits each (throws std::invalid_argument on a character outside the alphabet)
+    PackedSymbols ToPacked(std::string_view s, const uint64_t num_threads = 1) const;
+
 private:
     std::unordered_map<char, uint64_t> char2id_;
+    SymbolTable                        table_;    ///< byte -> ID (kInvalidSymbol outside the alphabet)
     std::vector<char>                  id2char_;
     size_t                             sigma_;
     CharType                           type_;
@@ -58,22 +72,40 @@ private:
 
 /**
  * @brief WaveletMatrix class for plain computation.
+ *
+ * Each bit level is a BitVector (packed bits plus a rank/select directory), about
+ * 1.25 bits per symbol and level. GetRank0Tables() expands the levels into the
+ * sigma x (n + 1) prefix-zero-count tables used to share the database.
+ * Construction partitions PackedSymbols (sigma bits per symbol) level by level; with
+ * num_threads > 1 each level is a parallel stable partition over text chunks. Strings and
+ * ID vectors are packed first, or an encoded PackedSymbols can be passed in directly.
  */
 class WaveletMatrix {
 public:
     WaveletMatrix() = default;
 
-    explicit WaveletMatrix(const std::string &data, const CharType type = CharType::DNA, const BuildOrder order = BuildOrder::MSBFirst);
-    explicit WaveletMatrix(const std::vector<uint64_t> &data, const size_t sigma, const BuildOrder order = BuildOrder::MSBFirst);
+    explicit WaveletMatrix(const std::string &data, const CharType type = CharType::DNA, const BuildOrder order = BuildOrder::MSBFirst,
+                           const uint64_t num_threads = 1);
+    explicit WaveletMatrix(const std::vector<uint64_t> &data, const size_t sigma, const BuildOrder order = BuildOrder::MSBFirst,
+                           const uint64_t num_threads = 1);
+    // Symbols already encoded (e.g. CharMapper::ToPacked or EncodeSymbols); values must be < 2^sigma
+    explicit WaveletMatrix(PackedSymbols data, const CharType type, const BuildOrder order = BuildOrder::MSBFirst,
+                           const uint64_t num_threads = 1);
+    explicit WaveletMatrix(PackedSymbols data, const size_t sigma, const BuildOrder order = BuildOrder::MSBFirst,
+                           const uint64_t num_threads = 1);
 
     // --- Basic info ---
-    size_t                       GetLength() const;
-    size_t                       GetSigma() const;
-    BuildOrder                   GetBuildOrder() const;
-    const CharMapper            &GetMapper() const;
-    std::string                  GetMapString() const;
-    const std::vector<uint64_t> &GetData() const;
-    const std::vector<uint64_t> &GetRank0Tables() const;
+    size_t                GetLength() const;
+    size_t                GetSigma() const;
+    BuildOrder            GetBuildOrder() const;
+    const CharMapper     &GetMapper() const;
+    std::string           GetMapString() const;
+    std::vector<uint64_t> GetData() const;    ///< symbols decoded from the levels (debugging)
+    const BitVector      &GetLevel(size_t bit) const;
+    size_t                GetMemoryBytes() const;    ///< bytes of the bit levels and directories
+
+    // --- Export ---
+    std::vector<uint64_t> GetRank0Tables() const;    ///< rank0 of every level at 0..n, level-major
 
     // --- Debugging ---
     void PrintRank0Tables() const;
@@ -93,43 +125,52 @@ public:
     uint64_t RankCF(uint64_t c, size_t position) const;
 
 private:
-    size_t                length_;
-    size_t                sigma_;
-    BuildOrder            order_;
-    CharMapper            mapper_;
-    std::vector<uint64_t> data_;
-    std::vector<uint64_t> rank0_tables_;
+    size_t                 length_;
+    size_t                 sigma_;
+    BuildOrder             order_;
+    CharMapper             mapper_;
+    std::vector<BitVector> levels_;    ///< levels_[bit]: bit 'bit' of every symbol in that level's order
 
     // --- Build routines ---
-    void Build(const std::vector<uint64_t> &data);
-    void BuildMsbFirst(std::vector<uint64_t> current);
-    void BuildLsbFirst(std::vector<uint64_t> current);
+    void Build(PackedSymbols current, const uint64_t num_threads);
+    void BuildLevels(PackedSymbols current, ThreadPool &pool);
 };
 
 class FMIndex {
 public:
     FMIndex(const std::string &text, const CharType type = CharType::DNA);
+    // Builds the BWT with BwtBuilder (parallel, optionally memory-capped) instead of sdsl
+    FMIndex(const std::string &text, const CharType type, const BwtBuildOptions &options);
+    // Index over a BWT built earlier (e.g. BwtBuilder::LoadBwt of a BuildToFile output)
+    static FMIndex FromBwt(std::string bwt, const CharType type = CharType::DNA, const uint64_t num_threads = 1);
     FMIndex(const FMIndex &)                = default;
     FMIndex(FMIndex &&) noexcept            = default;
     FMIndex &operator=(const FMIndex &)     = default;
     FMIndex &operator=(FMIndex &&) noexcept = default;
 
-    const WaveletMatrix         &GetWaveletMatrix() const;
-    const std::vector<uint64_t> &GetRank0Tables() const;
+    const WaveletMatrix  &GetWaveletMatrix() const;
+    const std::string    &GetBwt() const;
+    const OccTable       &GetOccTable() const;
+    std::vector<uint64_t> GetRank0Tables() const;
 
     std::vector<uint64_t> ConvertToBitMatrix(const std::string &query) const;
 
     // Search query in text, returns the Longest Prefix Match Length
     uint64_t ComputeLPMfromWM(const std::string &query) const;
-    uint64_t ComputeLPMfromBWT(const std::string &query) const;
+    // Backward search over the sampled occurrence table of the BWT (no wavelet matrix)
+    uint64_t              ComputeLPMfromBWT(const std::string &query) const;
+    std::vector<uint64_t> ComputeLPMfromBWTBatch(const std::vector<std::string> &queries) const;
+    std::vector<uint64_t> ComputeLPMfromBWTBatch(const std::vector<std::string> &queries, ThreadPool &pool) const;
 
 private:
+    FMIndex() = default;
+
     std::string   text_;    /**< original text + sentinel */
-    std::string   bwt_str_; /**< BWT of text */
-    WaveletMatrix wm_;      /**< Wavelet matrix built over bwt_str (as integer array) */
+    OccTable      occ_;     /**< BWT of text with sampled occurrence counts */
+    WaveletMatrix wm_;      /**< Wavelet matrix built over the BWT (as integer array) */
 
     // Build BWT from suffix array
-    void BuildBwt();
+    std::string BuildBwt() const;
 
     // Backward search [top, bottom) range
     void BackwardSearch(char c, uint64_t &left, uint64_t &right) const;
@@ -1,9 +1,15 @@
 #ifndef BENCH_BENCH_COMMON_H_
 #define BENCH_BENCH_COMMON_H_
 
+#include <algorithm>
+#include <fstream>
+#include <string>
+
 #include <cryptoTools/Common/CLP.h>
 
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/network.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/utils.h"
 
 namespace bench_ringoa {
@@ -39,6 +45,66 @@ inline std::vector<uint64_t> SelectQueryBitsize(const osuCrypto::CLP &cmd) {
     }
 }
 
+// Thread counts 1, 2, 4, ..., "threads" (default: hardware concurrency).
+inline std::vector<uint64_t> SelectThreadCounts(const osuCrypto::CLP &cmd) {
+    uint64_t              max_threads = cmd.getOr("threads", ringoa::ThreadPool::GetDefaultNumThreads());
+    std::vector<uint64_t> thread_counts;
+    for (uint64_t t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+    return thread_counts;
+}
+
+// Worker counts 1, 2, 4, ..., "workers" (default: hardware concurrency).
+inline std::vector<uint64_t> SelectWorkerCounts(const osuCrypto::CLP &cmd) {
+    uint64_t              max_workers = cmd.getOr("workers", ringoa::ThreadPool::GetDefaultNumThreads());
+    std::vector<uint64_t> worker_counts;
+    for (uint64_t w = 1; w < max_workers; w *= 2) {
+        worker_counts.push_back(w);
+    }
+    worker_counts.push_back(max_workers);
+    return worker_counts;
+}
+
+// Coroutine sessions in flight 1, 4, 16, ..., "in_flight" (default: num_sessions).
+inline std::vector<uint64_t> SelectInFlightCounts(const osuCrypto::CLP &cmd, const uint64_t num_sessions) {
+    uint64_t              max_in_flight = std::min(cmd.getOr("in_flight", num_sessions), num_sessions);
+    std::vector<uint64_t> in_flight_counts;
+    for (uint64_t n = 1; n < max_in_flight; n *= 4) {
+        in_flight_counts.push_back(n);
+    }
+    in_flight_counts.push_back(max_in_flight);
+    return in_flight_counts;
+}
+
+// Returns once both neighbours have reached the same point, so that a timer started next
+// does not include their local work (e.g. offline precomputation before a warm-cache run).
+inline void SyncNeighbours(ringoa::Channels &chls) {
+    uint64_t token = chls.party_id, from_prev = 0, from_next = 0;
+    chls.next.send(token);
+    chls.prev.send(token);
+    chls.prev.recv(from_prev);
+    chls.next.recv(from_next);
+}
+
+// Peak resident set size of this process in bytes (VmHWM; 0 if /proc is unavailable).
+inline uint64_t GetPeakRssBytes() {
+    std::ifstream status("/proc/self/status");
+    std::string   line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6)) << 10;    // reported in kB
+        }
+    }
+    return 0;
+}
+
+// Restarts the VmHWM high-water mark from the current RSS (Linux >= 4.0).
+inline void ResetPeakRss() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
 constexpr uint64_t kRepeatDefault = 10;
 
 inline const std::string kCurrentPath = ringoa::GetCurrentDirectory();
@@ -4,21 +4,31 @@
 
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/rng.h"
+#include "RingOA_Bench/dot_product_bench.h"
 #include "RingOA_Bench/dpf_bench.h"
 #include "RingOA_Bench/dpf_pir_bench.h"
 #include "RingOA_Bench/obliv_select_bench.h"
 #include "RingOA_Bench/ofmi_bench.h"
 #include "RingOA_Bench/oquantile_bench.h"
+#include "RingOA_Bench/prg_bench.h"
 #include "RingOA_Bench/ringoa_bench.h"
 #include "RingOA_Bench/shared_ot_bench.h"
 #include "RingOA_Bench/sotfmi_bench.h"
+#include "RingOA_Bench/wm_bench.h"
 
 namespace bench_ringoa {
 
 osuCrypto::TestCollection Tests([](osuCrypto::TestCollection &t) {
+    t.add("Prg_Expand_Bench", Prg_Expand_Bench);
+    t.add("Dpf_EvalAt_Batch_Bench", Dpf_EvalAt_Batch_Bench);
     t.add("Dpf_Fde_Bench", Dpf_Fde_Bench);
+    t.add("Dpf_Fde_Parallel_Bench", Dpf_Fde_Parallel_Bench);
+    t.add("Dpf_Fde_MultiKey_Bench", Dpf_Fde_MultiKey_Bench);
     t.add("Dpf_Fde_Convert_Bench", Dpf_Fde_Convert_Bench);
     t.add("Dpf_Fde_One_Bench", Dpf_Fde_One_Bench);
+    t.add("Dpf_HalfTree_Bench", Dpf_HalfTree_Bench);
+    t.add("DotProduct_Kernel_Bench", DotProduct_Kernel_Bench);
+    t.add("DotProduct_Batch_Bench", DotProduct_Batch_Bench);
     t.add("DpfPir_Offline_Bench", DpfPir_Offline_Bench);
     t.add("DpfPir_Online_Bench", DpfPir_Online_Bench);
 
@@ -29,11 +39,18 @@ osuCrypto::TestCollection Tests([](osuCrypto::TestCollection &t) {
 
     t.add("OFMI_Offline_Bench", OFMI_Offline_Bench);
     t.add("OFMI_Online_Bench", OFMI_Online_Bench);
+    t.add("OFMI_Workers_Online_Bench", OFMI_Workers_Online_Bench);
     t.add("OFMI_Fsc_Offline_Bench", OFMI_Fsc_Offline_Bench);
     t.add("OFMI_Fsc_Online_Bench", OFMI_Fsc_Online_Bench);
 
+    t.add("WaveletMatrix_Bench", WaveletMatrix_Bench);
+    t.add("FMIndex_Build_Bench", FMIndex_Build_Bench);
+    t.add("FMIndex_LPM_Bench", FMIndex_LPM_Bench);
+    t.add("Fasta_Ingest_Bench", Fasta_Ingest_Bench);
+
     t.add("OQuantile_Offline_Bench", OQuantile_Offline_Bench);
     t.add("OQuantile_Online_Bench", OQuantile_Online_Bench);
+    t.add("OQuantile_Workers_Online_Bench", OQuantile_Workers_Online_Bench);
     t.add("OQuantile_VAF_Offline_Bench", OQuantile_VAF_Offline_Bench);
     t.add("OQuantile_VAF_Online_Bench", OQuantile_VAF_Online_Bench);
     t.add("OQuantile_Fsc_VAF_Offline_Bench", OQuantile_Fsc_VAF_Offline_Bench);
@@ -0,0 +1,152 @@
+#include "dot_product_bench.h"
+
+#include <cryptoTools/Common/TestCollection.h>
+
+#include "RingOA/protocol/dot_product.h"
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/rng.h"
+#include "RingOA/utils/timer.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+#include "bench_common.h"
+
+namespace {
+
+using ringoa::Mod2N;
+
+// The per-element loop the protocols used before the shared kernel: one mask, one
+// modular index and one modular accumulation per database entry.
+uint64_t ReferenceSelectSum(const std::vector<uint64_t> &database, const uint64_t d, const std::vector<uint64_t> &bits, const uint64_t shift) {
+    uint64_t dp = 0;
+    for (uint64_t i = 0; i < database.size(); ++i) {
+        const uint64_t mask = 0ULL - ((bits[i / 64] >> (i % 64)) & 1ULL);
+        dp                  = Mod2N(dp + (database[Mod2N(i + shift, d)] & mask), d);
+    }
+    return dp;
+}
+
+}    // namespace
+
+namespace bench_ringoa {
+
+using ringoa::GlobalRng;
+using ringoa::Logger;
+using ringoa::TimerManager;
+using ringoa::ToString;
+using ringoa::proto::DetectDotProductBackend;
+using ringoa::proto::DotProductBackend;
+using ringoa::proto::GetDotProductBackendString;
+using ringoa::proto::RotatedSelectSum;
+using ringoa::proto::RotatedSelectSumBatch;
+
+void DotProduct_Kernel_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t          repeat   = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t          d        = cmd.getOr("d", 24);
+    uint64_t          size     = 1ULL << d;
+    DotProductBackend detected = DetectDotProductBackend();
+
+    Logger::InfoLog(LOC, "Dot product kernel Benchmark started (repeat=" + ToString(repeat) + ", d=" + ToString(d) +
+                             ", detected=" + GetDotProductBackendString(detected) + ")");
+
+    std::vector<uint64_t> database(size), bits(size / 64);
+    for (auto &x : database)
+        x = GlobalRng::Rand<uint64_t>();
+    for (auto &x : bits)
+        x = GlobalRng::Rand<uint64_t>();
+    const uint64_t shift = Mod2N(GlobalRng::Rand<uint64_t>(), d);
+
+    // Reference first, then every supported backend; all must agree on the reduced sum
+    const uint64_t expected = ReferenceSelectSum(database, d, bits, shift);
+    for (int variant = -1; variant <= static_cast<int>(detected); ++variant) {
+        const DotProductBackend backend = static_cast<DotProductBackend>(variant < 0 ? 0 : variant);
+        const std::string       name    = variant < 0 ? "Reference" : GetDotProductBackendString(backend);
+
+        TimerManager timer_mgr;
+        int32_t      timer_id = timer_mgr.CreateNewTimer("DotProduct " + name);
+        timer_mgr.SelectTimer(timer_id);
+
+        uint64_t result = 0;
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            result = variant < 0 ? ReferenceSelectSum(database, d, bits, shift)
+                                 : Mod2N(RotatedSelectSum(backend, database, d, bits.data(), size, 0, shift), d);
+            timer_mgr.Stop("kernel=" + name + " d=" + ToString(d) + " iter=" + ToString(i));
+        }
+        if (result != expected) {
+            Logger::ErrorLog(LOC, "kernel=" + name + " result mismatch: " + ToString(result) + " != " + ToString(expected));
+        }
+
+        const std::string summary_msg = "kernel=" + name + " d=" + ToString(d);
+        timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+        double seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+        Logger::InfoLog(LOC, summary_msg + " throughput=" + ToString(static_cast<uint64_t>(size / seconds)) + " entries/s");
+    }
+    Logger::InfoLog(LOC, "Dot product kernel Benchmark completed");
+    Logger::ExportLogListAndClear(kLogRingOaPath + "dot_product_kernel_bench", /*use_timestamp=*/true);
+}
+
+void DotProduct_Batch_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              max_queries = cmd.getOr<uint64_t>("queries", 16);
+    std::vector<uint64_t> db_bitsizes = cmd.isSet("size") ? SelectBitsizes(cmd) : std::vector<uint64_t>{20, 22, 24, 26};
+
+    Logger::InfoLog(LOC, "Dot product batch Benchmark started (repeat=" + ToString(repeat) + ", queries<=" + ToString(max_queries) +
+                             ", backend=" + GetDotProductBackendString(DetectDotProductBackend()) + ")");
+
+    for (auto d : db_bitsizes) {
+        const uint64_t        size = 1ULL << d;
+        std::vector<uint64_t> database(size);
+        for (auto &x : database)
+            x = GlobalRng::Rand<uint64_t>();
+
+        std::vector<std::vector<uint64_t>> bits(max_queries, std::vector<uint64_t>(size / 64));
+        std::vector<const uint64_t *>      bits_ptr(max_queries);
+        std::vector<uint64_t>              shifts(max_queries);
+        for (uint64_t q = 0; q < max_queries; ++q) {
+            for (auto &x : bits[q])
+                x = GlobalRng::Rand<uint64_t>();
+            bits_ptr[q] = bits[q].data();
+            shifts[q]   = Mod2N(GlobalRng::Rand<uint64_t>(), d);
+        }
+
+        // K queries one after another (K database passes) vs. blocked (one pass)
+        for (uint64_t num_queries = 1; num_queries <= max_queries; num_queries *= 2) {
+            std::vector<uint64_t> separate(num_queries), blocked(num_queries);
+            const std::string     summary_msg = "d=" + ToString(d) + " K=" + ToString(num_queries);
+
+            for (bool use_batch : {false, true}) {
+                const std::string kernel = use_batch ? "Blocked" : "Separate";
+                TimerManager      timer_mgr;
+                int32_t      timer_id = timer_mgr.CreateNewTimer("DotProduct Batch " + kernel);
+                timer_mgr.SelectTimer(timer_id);
+
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    timer_mgr.Start();
+                    if (use_batch) {
+                        RotatedSelectSumBatch(database, d, std::span(bits_ptr).first(num_queries), std::span(shifts).first(num_queries), blocked);
+                    } else {
+                        for (uint64_t q = 0; q < num_queries; ++q) {
+                            separate[q] = RotatedSelectSum(database, d, bits_ptr[q], size, 0, shifts[q]);
+                        }
+                    }
+                    timer_mgr.Stop("kernel=" + kernel + " " + summary_msg + " iter=" + ToString(i));
+                }
+                timer_mgr.PrintCurrentResults("kernel=" + kernel + " " + summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/false);
+
+                // Database entries consumed per second over all queries
+                double seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+                Logger::InfoLog(LOC, "kernel=" + kernel + " " + summary_msg +
+                                         " throughput=" + ToString(static_cast<uint64_t>(num_queries * size / seconds)) + " entries/s" +
+                                         " (" + ToString(static_cast<uint64_t>(num_queries * size * sizeof(uint64_t) / seconds / 1e6)) + " MB/s)");
+            }
+            if (separate != blocked) {
+                Logger::ErrorLog(LOC, summary_msg + " blocked sums differ from the separate ones");
+            }
+        }
+    }
+    Logger::InfoLog(LOC, "Dot product batch Benchmark completed");
+    Logger::ExportLogListAndClear(kLogRingOaPath + "dot_product_batch_bench", /*use_timestamp=*/true);
+}
+
+}    // namespace bench_ringoa
@@ -0,0 +1,13 @@
+#ifndef BENCH_DOT_PRODUCT_BENCH_H_
+#define BENCH_DOT_PRODUCT_BENCH_H_
+
+#include <cryptoTools/Common/CLP.h>
+
+namespace bench_ringoa {
+
+void DotProduct_Kernel_Bench(const osuCrypto::CLP &cmd);
+void DotProduct_Batch_Bench(const osuCrypto::CLP &cmd);
+
+}    // namespace bench_ringoa
+
+#endif    // BENCH_DOT_PRODUCT_BENCH_H_
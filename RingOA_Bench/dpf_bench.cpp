@@ -27,6 +27,67 @@ using ringoa::fss::dpf::DpfKey;
 using ringoa::fss::dpf::DpfKeyGenerator;
 using ringoa::fss::dpf::DpfParameters;
 
+void Dpf_EvalAt_Batch_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat   = cmd.getOr("repeat", kRepeatDefault);
+    std::vector<uint64_t> sizes    = SelectBitsizes(cmd);
+    uint64_t              num_keys = cmd.getOr<uint64_t>("keys", 1024);
+
+    Logger::InfoLog(LOC, "EvalAt Batch Benchmark started (repeat=" + ToString(repeat) + ", keys=" + ToString(num_keys) + ")");
+
+    for (auto size : sizes) {
+        DpfParameters   params(size, size, EvalType::kHybridBatched);
+        uint64_t        n = params.GetInputBitsize();
+        uint64_t        e = params.GetOutputBitsize();
+        DpfKeyGenerator gen(params);
+        DpfEvaluator    eval(params);
+
+        std::vector<DpfKey>   keys;
+        std::vector<uint64_t> x(num_keys), outputs(num_keys);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            std::pair<DpfKey, DpfKey> pair = gen.GenerateKeys(Mod2N(GlobalRng::Rand<uint64_t>(), n), Mod2N(GlobalRng::Rand<uint64_t>(), e));
+            keys.push_back(std::move(pair.first));
+            x[k] = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        }
+
+        TimerManager timer_mgr;
+        int32_t      timer_scalar = timer_mgr.CreateNewTimer("DPF EvalAt Scalar Loop");
+        int32_t      timer_batch  = timer_mgr.CreateNewTimer("DPF EvalAt Batched");
+
+        const std::string summary_msg =
+            "n=" + ToString(n) +
+            " e=" + ToString(e) +
+            " keys=" + ToString(num_keys);
+
+        // One scalar EvaluateAt per key
+        timer_mgr.SelectTimer(timer_scalar);
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                outputs[k] = eval.EvaluateAt(keys[k], x[k]);
+            }
+            timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+        double scalar_seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+
+        // All keys advanced level by level
+        timer_mgr.SelectTimer(timer_batch);
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            eval.EvaluateAt(keys, x, outputs);
+            timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+        double batch_seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+
+        Logger::InfoLog(LOC, summary_msg +
+                                 " scalar=" + ToString(static_cast<uint64_t>(num_keys / scalar_seconds)) + " keys/s" +
+                                 " batched=" + ToString(static_cast<uint64_t>(num_keys / batch_seconds)) + " keys/s");
+    }
+    Logger::InfoLog(LOC, "EvalAt Batch Benchmark completed");
+    Logger::ExportLogListAndClear(kLogDpfPath + "dpf_evalat_batch_bench", /*use_timestamp=*/true);
+}
+
 void Dpf_Fde_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat     = cmd.getOr("repeat", kRepeatDefault);
     std::vector<uint64_t> sizes      = SelectBitsizes(cmd);
@@ -86,6 +147,117 @@ void Dpf_Fde_Bench(const osuCrypto::CLP &cmd) {
     Logger::ExportLogListAndClear(kLogDpfPath + "dpf_fde_bench", /*use_timestamp=*/true);
 }
 
+void Dpf_Fde_Parallel_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    std::vector<uint64_t> sizes         = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+    uint64_t              split_depth   = cmd.getOr<uint64_t>("split", 0);
+
+    Logger::InfoLog(LOC, "FDE Parallel Benchmark started (repeat=" + ToString(repeat) + ", max_threads=" + ToString(thread_counts.back()) + ")");
+
+    for (auto size : sizes) {
+        DpfParameters   params(size, size, EvalType::kHybridBatched);
+        uint64_t        n  = params.GetInputBitsize();
+        uint64_t        e  = params.GetOutputBitsize();
+        uint64_t        nu = params.GetTerminateBitsize();
+        DpfKeyGenerator gen(params);
+
+        uint64_t alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        uint64_t beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+
+        std::vector<block>        outputs(1ULL << nu);
+        std::pair<DpfKey, DpfKey> keys = gen.GenerateKeys(alpha, beta);
+
+        for (auto num_threads : thread_counts) {
+            DpfEvaluator eval(params);
+            eval.SetNumThreads(num_threads);
+            eval.SetSplitDepth(split_depth);
+
+            TimerManager timer_mgr;
+            int32_t      timer_id = timer_mgr.CreateNewTimer("DPF-FDE Parallel Eval (P0)");
+            timer_mgr.SelectTimer(timer_id);
+
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                eval.EvaluateFullDomain(keys.first, outputs);
+                timer_mgr.Stop(
+                    "n=" + ToString(n) +
+                    " e=" + ToString(e) +
+                    " threads=" + ToString(num_threads) +
+                    " iter=" + ToString(i));
+            }
+
+            const std::string summary_msg =
+                "n=" + ToString(n) +
+                " e=" + ToString(e) +
+                " threads=" + ToString(num_threads) +
+                " split=" + ToString(split_depth);
+
+            timer_mgr.PrintCurrentResults(
+                summary_msg,
+                ringoa::TimeUnit::MICROSECONDS,
+                /*show_details=*/true);
+        }
+    }
+    Logger::InfoLog(LOC, "FDE Parallel Benchmark completed");
+    Logger::ExportLogListAndClear(kLogDpfPath + "dpf_fde_parallel_bench", /*use_timestamp=*/true);
+}
+
+void Dpf_Fde_MultiKey_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat   = cmd.getOr("repeat", kRepeatDefault);
+    std::vector<uint64_t> sizes    = SelectBitsizes(cmd);
+    uint64_t              num_keys = cmd.getOr<uint64_t>("keys", 2);
+
+    Logger::InfoLog(LOC, "FDE Multi-Key Benchmark started (repeat=" + ToString(repeat) + ", keys=" + ToString(num_keys) + ")");
+
+    for (auto size : sizes) {
+        DpfParameters   params(size, size, EvalType::kHybridBatched);
+        uint64_t        n  = params.GetInputBitsize();
+        uint64_t        e  = params.GetOutputBitsize();
+        uint64_t        nu = params.GetTerminateBitsize();
+        DpfKeyGenerator gen(params);
+        DpfEvaluator    eval(params);
+
+        std::vector<DpfKey> keys;
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            std::pair<DpfKey, DpfKey> pair = gen.GenerateKeys(Mod2N(GlobalRng::Rand<uint64_t>(), n), Mod2N(GlobalRng::Rand<uint64_t>(), e));
+            keys.push_back(std::move(pair.first));
+        }
+        std::vector<std::vector<block>> outputs(num_keys, std::vector<block>(1ULL << nu));
+
+        TimerManager timer_mgr;
+        int32_t      timer_sequential = timer_mgr.CreateNewTimer("DPF-FDE Sequential Eval");
+        int32_t      timer_lockstep   = timer_mgr.CreateNewTimer("DPF-FDE Lockstep Eval");
+
+        const std::string summary_msg =
+            "n=" + ToString(n) +
+            " e=" + ToString(e) +
+            " keys=" + ToString(num_keys);
+
+        // One EvaluateFullDomain call per key
+        timer_mgr.SelectTimer(timer_sequential);
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                eval.EvaluateFullDomain(keys[k], outputs[k]);
+            }
+            timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+        // All keys walked in lockstep
+        timer_mgr.SelectTimer(timer_lockstep);
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            eval.EvaluateFullDomain(keys, outputs);
+            timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+    }
+    Logger::InfoLog(LOC, "FDE Multi-Key Benchmark completed");
+    Logger::ExportLogListAndClear(kLogDpfPath + "dpf_fde_multikey_bench", /*use_timestamp=*/true);
+}
+
 void Dpf_Fde_Convert_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat     = cmd.getOr("repeat", kRepeatDefault);
     std::vector<uint64_t> sizes      = SelectBitsizes(cmd);
@@ -204,4 +376,60 @@ void Dpf_Fde_One_Bench(const osuCrypto::CLP &cmd) {
     Logger::ExportLogListAndClear(kLogDpfPath + "dpf_fde_one_bench", /*use_timestamp=*/true);
 }
 
+void Dpf_HalfTree_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat     = cmd.getOr("repeat", kRepeatDefault);
+    std::vector<uint64_t> sizes      = SelectBitsizes(cmd);
+    uint64_t              bitsize    = cmd.getOr<uint64_t>("e", 1);
+    std::vector<EvalType> eval_types = {
+        EvalType::kHybridBatched,
+        EvalType::kHalfTree,
+    };
+
+    Logger::InfoLog(LOC, "Half-Tree Benchmark started (repeat=" + ToString(repeat) + ", e=" + ToString(bitsize) + ")");
+
+    for (auto size : sizes) {
+        for (auto eval_type : eval_types) {
+            DpfParameters   params(size, bitsize, eval_type);
+            uint64_t        n  = params.GetInputBitsize();
+            uint64_t        e  = params.GetOutputBitsize();
+            uint64_t        nu = params.GetTerminateBitsize();
+            DpfKeyGenerator gen(params);
+            DpfEvaluator    eval(params);
+
+            uint64_t alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            uint64_t beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+
+            std::vector<block> outputs(1ULL << nu);
+
+            TimerManager timer_mgr;
+            int32_t      timer_gen  = timer_mgr.CreateNewTimer("DPF KeyGen");
+            int32_t      timer_eval = timer_mgr.CreateNewTimer("DPF-FDE Eval P0");
+
+            const std::string summary_msg =
+                "n=" + ToString(n) +
+                " e=" + ToString(e) +
+                " eval=" + GetEvalTypeString(params.GetEvalType());
+
+            timer_mgr.SelectTimer(timer_gen);
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                std::pair<DpfKey, DpfKey> keys = gen.GenerateKeys(alpha, beta);
+                timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+            }
+            timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+            std::pair<DpfKey, DpfKey> keys = gen.GenerateKeys(alpha, beta);
+            timer_mgr.SelectTimer(timer_eval);
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                eval.EvaluateFullDomain(keys.first, outputs);
+                timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+            }
+            timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+        }
+    }
+    Logger::InfoLog(LOC, "Half-Tree Benchmark completed");
+    Logger::ExportLogListAndClear(kLogDpfPath + "dpf_halftree_bench", /*use_timestamp=*/true);
+}
+
 }    // namespace bench_ringoa
@@ -5,9 +5,13 @@
 
 namespace bench_ringoa {
 
+void Dpf_EvalAt_Batch_Bench(const osuCrypto::CLP &cmd);
 void Dpf_Fde_Bench(const osuCrypto::CLP &cmd);
+void Dpf_Fde_Parallel_Bench(const osuCrypto::CLP &cmd);
+void Dpf_Fde_MultiKey_Bench(const osuCrypto::CLP &cmd);
 void Dpf_Fde_Convert_Bench(const osuCrypto::CLP &cmd);
 void Dpf_Fde_One_Bench(const osuCrypto::CLP &cmd);
+void Dpf_HalfTree_Bench(const osuCrypto::CLP &cmd);
 
 }    // namespace bench_ringoa
 
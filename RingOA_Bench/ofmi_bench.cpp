@@ -6,15 +6,18 @@
 
 #include "RingOA/fm_index/ofmi.h"
 #include "RingOA/fm_index/ofmi_fsc.h"
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/protocol/key_io.h"
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/sharing/share_io.h"
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/seq_io.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA/utils/worker_dispatcher.h"
 #include "RingOA/wm/plain_wm.h"
 #include "bench_common.h"
 
@@ -39,12 +42,14 @@ std::string GenerateRandomString(size_t length, const std::string &charset = "AT
 namespace bench_ringoa {
 
 using ringoa::Channels;
+using ringoa::CoScheduler;
 using ringoa::CreateSequence;
 using ringoa::FileIo;
 using ringoa::Logger;
 using ringoa::ThreePartyNetworkManager;
 using ringoa::TimerManager;
 using ringoa::ToString;
+using ringoa::WorkerDispatcher;
 using ringoa::fm_index::OFMIEvaluator;
 using ringoa::fm_index::OFMIFscEvaluator;
 using ringoa::fm_index::OFMIFscKey;
@@ -54,6 +59,8 @@ using ringoa::fm_index::OFMIKey;
 using ringoa::fm_index::OFMIKeyGenerator;
 using ringoa::fm_index::OFMIParameters;
 using ringoa::proto::KeyIo;
+using ringoa::proto::RingOaEvaluator;
+using ringoa::proto::RingOaFdeCache;
 using ringoa::sharing::AdditiveSharing2P;
 using ringoa::sharing::ReplicatedSharing3P;
 using ringoa::sharing::RepShare64;
@@ -65,9 +72,13 @@ using ringoa::wm::FMIndex;
 
 void OFMI_Offline_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              batch         = cmd.getOr<uint64_t>("batch", 4);
+    uint64_t              lpm_queries   = cmd.getOr<uint64_t>("lpm_queries", 4);
     bool                  use_chr       = cmd.isSet("chr");
     std::vector<uint64_t> text_bitsizes = SelectBitsizes(cmd);
     std::vector<uint64_t> query_sizes   = SelectQueryBitsize(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+    std::vector<uint64_t> worker_counts = SelectWorkerCounts(cmd);
 
     std::unique_ptr<ringoa::ChromosomeLoader> chr_loader;
     if (use_chr) {
@@ -118,17 +129,42 @@ void OFMI_Offline_Bench(const osuCrypto::CLP &cmd) {
                 timer_mgr.PrintCurrentResults("d=" + ToString(d) + " qs=" + ToString(qs), ringoa::MICROSECONDS, true);
             }
 
+            for (auto num_threads : thread_counts) {    // Batched KeyGen throughput
+                const std::string timer_name = "OFMI KeyGen Batch";
+                int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
+                timer_mgr.SelectTimer(timer_id);
+                gen.SetNumThreads(num_threads);
+
+                const std::string summary_msg = "d=" + ToString(d) + " qs=" + ToString(qs) + " batch=" + ToString(batch) + " threads=" + ToString(num_threads);
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    timer_mgr.Start();
+                    std::vector<std::array<OFMIKey, 3>> keys = gen.GenerateKeys(batch);
+                    timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+                }
+                timer_mgr.PrintCurrentResults(summary_msg, ringoa::MILLISECONDS, true);
+                double seconds = timer_mgr.GetCurrentAverage(ringoa::SECONDS);
+                Logger::InfoLog(LOC, summary_msg + " " + ToString(static_cast<uint64_t>(batch / seconds)) + " keys/s");
+            }
+            gen.SetNumThreads(1);
+
             {    // OfflineSetUp
                 const std::string timer_name = "OFMI OfflineSetUp";
                 int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
                 timer_mgr.SelectTimer(timer_id);
                 timer_mgr.Start();
                 rss.OfflineSetUp(kBenchOfmiPath + "prf");
-                gen.OfflineSetUp(kBenchOfmiPath);
+                gen.OfflineSetUp(kBenchOfmiPath, lpm_queries);
                 timer_mgr.Stop("d=" + ToString(d) + " qs=" + ToString(qs) + " iter=0");
                 timer_mgr.PrintCurrentResults("d=" + ToString(d) + " qs=" + ToString(qs), ringoa::MICROSECONDS, true);
             }
 
+            // Triples and PRF keys of each worker of OFMI_Workers_Online_Bench (worker 0 may serve every query)
+            for (uint64_t w = 0; w < worker_counts.back(); ++w) {
+                const std::string worker_path = WorkerDispatcher::GetWorkerPath(kBenchOfmiPath, w);
+                rss.OfflineSetUp(worker_path + "prf");
+                gen.OfflineSetUp(worker_path, lpm_queries);
+            }
+
             {    // DataGen
                 const std::string timer_name = "OFMI DataGen";
                 int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
@@ -186,13 +222,18 @@ void OFMI_Offline_Bench(const osuCrypto::CLP &cmd) {
 
 void OFMI_Online_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              fde_budget    = cmd.getOr<uint64_t>("fde_cache_mb", 256) << 20;
+    uint64_t              lpm_queries   = cmd.getOr<uint64_t>("lpm_queries", 4);
+    uint64_t              depth         = cmd.getOr<uint64_t>("depth", RingOaEvaluator::kPipelineDepth);
     int                   party_id      = cmd.isSet("party") ? cmd.get<int>("party") : -1;
     std::string           network       = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
     bool                  use_chr       = cmd.isSet("chr");
     std::vector<uint64_t> text_bitsizes = SelectBitsizes(cmd);
     std::vector<uint64_t> query_sizes   = SelectQueryBitsize(cmd);
+    std::vector<uint64_t> in_flights    = SelectInFlightCounts(cmd, lpm_queries);
 
-    Logger::InfoLog(LOC, "OFMI Online Benchmark started (repeat=" + ToString(repeat) + ", party=" + ToString(party_id) + ")");
+    Logger::InfoLog(LOC, "OFMI Online Benchmark started (repeat=" + ToString(repeat) + ", party=" + ToString(party_id) +
+                             ", fde_cache=" + ToString(fde_budget >> 20) + " MiB)");
 
     auto MakeTask = [&](int p) {
         const std::string ptag = "(P" + ToString(p) + ")";
@@ -213,6 +254,9 @@ void OFMI_Online_Bench(const osuCrypto::CLP &cmd) {
                     TimerManager timer_mgr;
                     int32_t      id_setup = timer_mgr.CreateNewTimer("OFMI OnlineSetUp " + ptag);
                     int32_t      id_eval  = timer_mgr.CreateNewTimer("OFMI Eval " + ptag);
+                    int32_t      id_warm  = timer_mgr.CreateNewTimer("OFMI Eval FDE cache warm " + ptag);
+                    int32_t      id_pipe  = timer_mgr.CreateNewTimer("OFMI EvalPipelined " + ptag);
+                    int32_t      id_batch = timer_mgr.CreateNewTimer("OFMI EvalBatch " + ptag);
 
                     timer_mgr.SelectTimer(id_setup);
                     timer_mgr.Start();
@@ -247,6 +291,88 @@ void OFMI_Online_Bench(const osuCrypto::CLP &cmd) {
                         ass_next.ResetTripleIndex();
                     }
                     timer_mgr.PrintCurrentResults("d=" + ToString(d) + " qs=" + ToString(qs), ringoa::MILLISECONDS, true);
+                    Logger::InfoLog(LOC, "d=" + ToString(d) + " qs=" + ToString(qs) + " reads/s=" + ToString(1000.0 / timer_mgr.GetCurrentAverage(ringoa::MILLISECONDS)));
+
+                    // Same evaluation with every RingOA expansion precomputed (the timer above is the cold case)
+                    timer_mgr.SelectTimer(id_warm);
+                    RingOaFdeCache cache(params.GetOWMParameters().GetOaParameters(), fde_budget);
+                    eval.SetFdeCache(&cache);
+                    for (uint64_t i = 0; i < repeat; ++i) {
+                        uint64_t num_cached = eval.PrecomputeFde(key);
+                        SyncNeighbours(chls);
+                        timer_mgr.Start();
+                        RepShareVec64 result_sh(qs);
+                        eval.EvaluateLPM_Parallel(chls, key, uv_prev, uv_next, db_sh, query_sh, result_sh);
+                        timer_mgr.Stop("d=" + ToString(d) + " qs=" + ToString(qs) + " cached=" + ToString(num_cached) + " iter=" + ToString(i));
+                        chls.ResetStats();
+                        ass_prev.ResetTripleIndex();
+                        ass_next.ResetTripleIndex();
+                    }
+                    eval.SetFdeCache(nullptr);
+                    timer_mgr.PrintCurrentResults("d=" + ToString(d) + " qs=" + ToString(qs), ringoa::MILLISECONDS, true);
+
+                    // lpm_queries copies of the query with 'depth' RingOA accesses in flight;
+                    // compare against lpm_queries times the "OFMI Eval" average
+                    timer_mgr.SelectTimer(id_pipe);
+                    std::vector<const OFMIKey *>       pipe_keys(lpm_queries, &key);
+                    std::vector<const RepShareMat64 *> pipe_queries(lpm_queries, &query_sh);
+                    RepShareMat64                      pipe_result_sh(lpm_queries, qs);
+                    const std::string                  pipe_msg = "d=" + ToString(d) + " qs=" + ToString(qs) +
+                                                                  " lpm_queries=" + ToString(lpm_queries) +
+                                                                  " depth=" + ToString(depth);
+                    SyncNeighbours(chls);
+                    for (uint64_t i = 0; i < repeat; ++i) {
+                        timer_mgr.Start();
+                        eval.EvaluateLPM_Pipelined(chls, pipe_keys, uv_prev, uv_next, db_sh, pipe_queries, pipe_result_sh, depth);
+                        timer_mgr.Stop(pipe_msg + " iter=" + ToString(i));
+                        if (i < 2)
+                            Logger::InfoLog(LOC, pipe_msg + " total_data_sent=" + ToString(chls.GetStats()) + " bytes");
+                        chls.ResetStats();
+                        ass_prev.ResetTripleIndex();
+                        ass_next.ResetTripleIndex();
+                    }
+                    timer_mgr.PrintCurrentResults(pipe_msg, ringoa::MILLISECONDS, true);
+
+                    // lpm_queries reads in lockstep (same rounds as one "OFMI Eval")
+                    timer_mgr.SelectTimer(id_batch);
+                    const std::string batch_msg = "d=" + ToString(d) + " qs=" + ToString(qs) +
+                                                  " lpm_queries=" + ToString(lpm_queries);
+                    SyncNeighbours(chls);
+                    for (uint64_t i = 0; i < repeat; ++i) {
+                        timer_mgr.Start();
+                        eval.EvaluateLPMBatch(chls, pipe_keys, uv_prev, uv_next, db_sh, pipe_queries, pipe_result_sh);
+                        timer_mgr.Stop(batch_msg + " iter=" + ToString(i));
+                        if (i < 2)
+                            Logger::InfoLog(LOC, batch_msg + " total_data_sent=" + ToString(chls.GetStats()) + " bytes");
+                        chls.ResetStats();
+                        ass_prev.ResetTripleIndex();
+                        ass_next.ResetTripleIndex();
+                    }
+                    timer_mgr.PrintCurrentResults(batch_msg, ringoa::MILLISECONDS, true);
+                    Logger::InfoLog(LOC, batch_msg + " reads/s=" + ToString(lpm_queries * 1000.0 / timer_mgr.GetCurrentAverage(ringoa::MILLISECONDS)));
+
+                    // lpm_queries queries as coroutine sessions; throughput versus sessions in flight
+                    std::vector<RepShareVec64> co_result_sh(lpm_queries);
+                    for (uint64_t in_flight : in_flights) {
+                        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("OFMI EvalCo " + ptag));
+                        const std::string co_msg = "d=" + ToString(d) + " qs=" + ToString(qs) +
+                                                   " lpm_queries=" + ToString(lpm_queries) +
+                                                   " in_flight=" + ToString(in_flight);
+                        SyncNeighbours(chls);
+                        for (uint64_t i = 0; i < repeat; ++i) {
+                            CoScheduler sched;
+                            timer_mgr.Start();
+                            sched.Run(lpm_queries, in_flight, [&](uint64_t k) {
+                                return eval.EvaluateLPM_Co(sched, chls, key, uv_prev, uv_next, db_sh, query_sh, co_result_sh[k]);
+                            });
+                            timer_mgr.Stop(co_msg + " iter=" + ToString(i));
+                            chls.ResetStats();
+                            ass_prev.ResetTripleIndex();
+                            ass_next.ResetTripleIndex();
+                        }
+                        timer_mgr.PrintCurrentResults(co_msg, ringoa::MILLISECONDS, true);
+                        Logger::InfoLog(LOC, co_msg + " queries/s=" + ToString(lpm_queries * 1000.0 / timer_mgr.GetCurrentAverage(ringoa::MILLISECONDS)));
+                    }
                 }
             }
         };
@@ -264,6 +390,115 @@ void OFMI_Online_Bench(const osuCrypto::CLP &cmd) {
     }
 }
 
+void OFMI_Workers_Online_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              lpm_queries   = cmd.getOr<uint64_t>("lpm_queries", 4);
+    int                   party_id      = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+    std::string           network       = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
+    std::vector<uint64_t> text_bitsizes = SelectBitsizes(cmd);
+    std::vector<uint64_t> query_sizes   = SelectQueryBitsize(cmd);
+    std::vector<uint64_t> worker_counts = SelectWorkerCounts(cmd);
+    uint64_t              max_workers   = worker_counts.back();
+
+    Logger::InfoLog(LOC, "OFMI Workers Online Benchmark started (repeat=" + ToString(repeat) + ", party=" + ToString(party_id) +
+                             ", workers=" + ToString(max_workers) + ")");
+
+    // Evaluator state owned by one worker (loaded from its own triples and PRF keys)
+    struct Worker {
+        ReplicatedSharing3P        rss;
+        AdditiveSharing2P          ass_prev, ass_next;
+        OFMIEvaluator              eval;
+        std::vector<ringoa::block> uv_prev, uv_next;
+
+        Worker(const OFMIParameters &params, const uint64_t d, const uint64_t nu)
+            : rss(d), ass_prev(d), ass_next(d), eval(params, rss, ass_prev, ass_next),
+              uv_prev(1ULL << nu), uv_next(1ULL << nu) {
+        }
+    };
+
+    auto MakeTask = [&](int p) {
+        const std::string ptag = "(P" + ToString(p) + ")";
+        return [=](std::vector<Channels> &worker_chls) {
+            for (auto text_bitsize : text_bitsizes) {
+                for (auto query_size : query_sizes) {
+                    OFMIParameters params(text_bitsize, query_size);
+                    params.PrintParameters();
+
+                    uint64_t d  = params.GetDatabaseBitSize();
+                    uint64_t qs = params.GetQuerySize();
+                    uint64_t nu = params.GetOWMParameters().GetOaParameters().GetParameters().GetTerminateBitsize();
+
+                    std::string key_path   = kBenchOfmiPath + "ofmikey_d" + ToString(d) + "_qs" + ToString(qs);
+                    std::string db_path    = kBenchOfmiPath + "db_d" + ToString(d) + "_qs" + ToString(qs);
+                    std::string query_path = kBenchOfmiPath + "query_d" + ToString(d) + "_qs" + ToString(qs);
+
+                    TimerManager timer_mgr;
+                    int32_t      id_setup = timer_mgr.CreateNewTimer("OFMI Workers OnlineSetUp " + ptag);
+
+                    timer_mgr.SelectTimer(id_setup);
+                    timer_mgr.Start();
+                    OFMIKey key(p, params);
+                    KeyIo   key_io;
+                    key_io.LoadKey(key_path + "_" + ToString(p), key);
+                    RepShareMat64 db_sh;
+                    RepShareMat64 query_sh;
+                    ShareIo       sh_io;
+                    sh_io.LoadShare(db_path + "_" + ToString(p), db_sh);
+                    sh_io.LoadShare(query_path + "_" + ToString(p), query_sh);
+                    std::vector<std::unique_ptr<Worker>> workers;
+                    for (uint64_t w = 0; w < max_workers; ++w) {
+                        const std::string worker_path = WorkerDispatcher::GetWorkerPath(kBenchOfmiPath, w);
+                        workers.push_back(std::make_unique<Worker>(params, d, nu));
+                        workers[w]->eval.OnlineSetUp(p, worker_path);
+                        workers[w]->rss.OnlineSetUp(p, worker_path + "prf");
+                    }
+                    timer_mgr.Stop("d=" + ToString(d) + " qs=" + ToString(qs) + " iter=0");
+                    timer_mgr.PrintCurrentResults("d=" + ToString(d) + " qs=" + ToString(qs), ringoa::MILLISECONDS, true);
+
+                    // lpm_queries reads sharded over 1..max_workers workers; result q lands in result_sh[q]
+                    std::vector<RepShareVec64> result_sh(lpm_queries);
+                    for (auto &r : result_sh) {
+                        r = RepShareVec64(qs);
+                    }
+                    for (uint64_t num_workers : worker_counts) {
+                        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("OFMI EvalWorkers " + ptag));
+                        const std::string workers_msg = "d=" + ToString(d) + " qs=" + ToString(qs) +
+                                                        " lpm_queries=" + ToString(lpm_queries) +
+                                                        " workers=" + ToString(num_workers);
+                        std::vector<Channels> chls(worker_chls.begin(), worker_chls.begin() + num_workers);
+                        WorkerDispatcher      dispatcher(chls);
+                        SyncNeighbours(chls[0]);
+                        for (uint64_t i = 0; i < repeat; ++i) {
+                            timer_mgr.Start();
+                            dispatcher.Dispatch(lpm_queries, [&](uint64_t w, Channels &chl, uint64_t begin, uint64_t end) {
+                                Worker &worker = *workers[w];
+                                for (uint64_t q = begin; q < end; ++q) {
+                                    worker.eval.EvaluateLPM_Parallel(chl, key, worker.uv_prev, worker.uv_next, db_sh, query_sh, result_sh[q]);
+                                }
+                            });
+                            timer_mgr.Stop(workers_msg + " iter=" + ToString(i));
+                            for (uint64_t w = 0; w < num_workers; ++w) {
+                                chls[w].ResetStats();
+                                workers[w]->ass_prev.ResetTripleIndex();
+                                workers[w]->ass_next.ResetTripleIndex();
+                            }
+                        }
+                        timer_mgr.PrintCurrentResults(workers_msg, ringoa::MILLISECONDS, true);
+                        Logger::InfoLog(LOC, workers_msg + " queries/s=" + ToString(lpm_queries * 1000.0 / timer_mgr.GetCurrentAverage(ringoa::MILLISECONDS)));
+                    }
+                }
+            }
+        };
+    };
+
+    ThreePartyNetworkManager net_mgr;
+    net_mgr.AutoConfigureWorkers(party_id, max_workers, MakeTask(0), MakeTask(1), MakeTask(2));
+    net_mgr.WaitForCompletion();
+
+    Logger::InfoLog(LOC, "OFMI Workers Online Benchmark completed");
+    Logger::ExportLogListAndClear(kLogOfmiPath + "ofmi_workers_online_p" + ToString(party_id) + "_" + network, true);
+}
+
 void OFMI_Fsc_Offline_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
     bool                  use_chr       = cmd.isSet("chr");
@@ -7,6 +7,7 @@ namespace bench_ringoa {
 
 void OFMI_Offline_Bench(const osuCrypto::CLP &cmd);
 void OFMI_Online_Bench(const osuCrypto::CLP &cmd);
+void OFMI_Workers_Online_Bench(const osuCrypto::CLP &cmd);
 void OFMI_Fsc_Offline_Bench(const osuCrypto::CLP &cmd);
 void OFMI_Fsc_Online_Bench(const osuCrypto::CLP &cmd);
 
@@ -1,6 +1,7 @@
 #include "oquantile_bench.h"
 
 #include <charconv>
+#include <memory>
 #include <cryptoTools/Common/TestCollection.h>
 #include <random>
 
@@ -8,10 +9,12 @@
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/sharing/share_io.h"
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA/utils/worker_dispatcher.h"
 #include "RingOA/wm/oquantile.h"
 #include "RingOA/wm/oquantile_fsc.h"
 #include "RingOA/wm/plain_wm.h"
@@ -70,12 +73,14 @@ namespace bench_ringoa {
 
 using ringoa::block;
 using ringoa::Channels;
+using ringoa::CoScheduler;
 using ringoa::FileIo;
 using ringoa::Logger;
 using ringoa::Mod2N;
 using ringoa::ThreePartyNetworkManager;
 using ringoa::TimerManager;
 using ringoa::ToString, ringoa::Format;
+using ringoa::WorkerDispatcher;
 using ringoa::proto::KeyIo;
 using ringoa::sharing::AdditiveSharing2P;
 using ringoa::sharing::ReplicatedSharing3P;
@@ -93,8 +98,12 @@ using ringoa::wm::OQuantileParameters;
 using ringoa::wm::WaveletMatrix;
 
 void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd) {
-    uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
-    std::vector<uint64_t> db_bitsizes = SelectBitsizes(cmd);
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              batch         = cmd.getOr<uint64_t>("batch", 16);
+    uint64_t              queries       = cmd.getOr<uint64_t>("queries", 64);
+    std::vector<uint64_t> db_bitsizes   = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+    std::vector<uint64_t> worker_counts = SelectWorkerCounts(cmd);
 
     Logger::InfoLog(LOC, "OQuantile Offline Benchmark started (repeat=" + ToString(repeat) + ")");
 
@@ -140,14 +149,33 @@ void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd) {
                 /*show_details=*/true);
         }
 
-        // 2) OfflineSetUp (measured once per d)
+        // 2) Batched KeyGen throughput per thread count
+        for (auto num_threads : thread_counts) {
+            const std::string timer_name = "OQuantile KeyGen Batch";
+            const int32_t     timer_id   = timer_mgr.CreateNewTimer(timer_name);
+            timer_mgr.SelectTimer(timer_id);
+            gen.SetNumThreads(num_threads);
+
+            const std::string summary_msg = "d=" + ToString(d) + " batch=" + ToString(batch) + " threads=" + ToString(num_threads);
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                std::vector<std::array<OQuantileKey, 3>> keys = gen.GenerateKeys(batch);
+                timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+            }
+            timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+            const double seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+            Logger::InfoLog(LOC, summary_msg + " " + ToString(static_cast<uint64_t>(batch / seconds)) + " keys/s");
+        }
+        gen.SetNumThreads(1);
+
+        // 3) OfflineSetUp (measured once per d)
         {
             const std::string timer_name = "OQuantile OfflineSetUp";
             const int32_t     timer_id   = timer_mgr.CreateNewTimer(timer_name);
             timer_mgr.SelectTimer(timer_id);
 
             timer_mgr.Start();
-            gen.OfflineSetUp(kBenchWmPath);
+            gen.OfflineSetUp(kBenchWmPath, queries);
             rss.OfflineSetUp(kBenchWmPath + "prf");
             timer_mgr.Stop("d=" + ToString(d) + " iter=0");
 
@@ -157,7 +185,14 @@ void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd) {
                 /*show_details=*/true);
         }
 
-        // 3) Data generation + secret sharing (once per d)
+        // Triples and PRF keys of each worker of OQuantile_Workers_Online_Bench (worker 0 may serve every query)
+        for (uint64_t w = 0; w < worker_counts.back(); ++w) {
+            const std::string worker_path = WorkerDispatcher::GetWorkerPath(kBenchWmPath, w);
+            gen.OfflineSetUp(worker_path, queries);
+            rss.OfflineSetUp(worker_path + "prf");
+        }
+
+        // 4) Data generation + secret sharing (once per d)
         {
             const std::string timer_name = "OQuantile DataGen";
             const int32_t     timer_id   = timer_mgr.CreateNewTimer(timer_name);
@@ -165,8 +200,8 @@ void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd) {
 
             timer_mgr.Start();
 
-            // Build random database of size ds over [0, sigma)
-            std::vector<uint64_t> database = GenerateRandomVector(ds, params.GetSigma());
+            // Build random database of ds - 1 values over [0, sigma) (each shared rank row has ds entries)
+            std::vector<uint64_t> database = GenerateRandomVector(ds - 1, params.GetSigma());
 
             // Example query (left, right, k). Replace with your actual generator as needed.
             std::vector<uint64_t> query = {/* left = */ 123, /* right = */ 456, /* k = */ 100};
@@ -201,9 +236,11 @@ void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd) {
 
 void OQuantile_Online_Bench(const osuCrypto::CLP &cmd) {
     uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              queries     = cmd.getOr<uint64_t>("queries", 64);
     int                   party_id    = cmd.isSet("party") ? cmd.get<int>("party") : -1;
     std::string           network     = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
     std::vector<uint64_t> db_bitsizes = SelectBitsizes(cmd);
+    std::vector<uint64_t> in_flights  = SelectInFlightCounts(cmd, queries);
 
     Logger::InfoLog(LOC, "OQuantile Online Benchmark started (repeat=" + ToString(repeat) +
                              ", party=" + ToString(party_id) + ")");
@@ -299,6 +336,31 @@ void OQuantile_Online_Bench(const osuCrypto::CLP &cmd) {
                     "d=" + ToString(d),
                     ringoa::TimeUnit::MICROSECONDS,
                     /*show_details=*/true);
+
+                // ================================
+                // Coroutine sessions: throughput versus sessions in flight
+                // ================================
+                std::vector<RepShare64> co_result_sh(queries);
+                for (uint64_t in_flight : in_flights) {
+                    timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("OQuantile EvalCo " + ptag));
+                    const std::string co_msg = "d=" + ToString(d) + " queries=" + ToString(queries) +
+                                               " in_flight=" + ToString(in_flight);
+                    SyncNeighbours(chls);
+                    for (uint64_t i = 0; i < repeat; ++i) {
+                        CoScheduler sched;
+                        timer_mgr.Start();
+                        sched.Run(queries, in_flight, [&](uint64_t q) {
+                            return eval.EvaluateQuantile_Co(sched, chls, key, uv_prev, uv_next,
+                                                            db_sh, left_sh, right_sh, k_sh, co_result_sh[q]);
+                        });
+                        timer_mgr.Stop(co_msg + " iter=" + ToString(i));
+                        chls.ResetStats();
+                        ass_prev.ResetTripleIndex();
+                        ass_next.ResetTripleIndex();
+                    }
+                    timer_mgr.PrintCurrentResults(co_msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+                    Logger::InfoLog(LOC, co_msg + " queries/s=" + ToString(queries * 1000.0 / timer_mgr.GetCurrentAverage(ringoa::TimeUnit::MILLISECONDS)));
+                }
             }
         };
     };
@@ -318,6 +380,131 @@ void OQuantile_Online_Bench(const osuCrypto::CLP &cmd) {
                                   /*use_timestamp=*/true);
 }
 
+void OQuantile_Workers_Online_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              queries       = cmd.getOr<uint64_t>("queries", 64);
+    int                   party_id      = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+    std::string           network       = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
+    std::vector<uint64_t> db_bitsizes   = SelectBitsizes(cmd);
+    std::vector<uint64_t> worker_counts = SelectWorkerCounts(cmd);
+    const uint64_t        max_workers   = worker_counts.back();
+
+    Logger::InfoLog(LOC, "OQuantile Workers Online Benchmark started (repeat=" + ToString(repeat) +
+                             ", party=" + ToString(party_id) + ", workers=" + ToString(max_workers) + ")");
+
+    // Evaluator state owned by one worker (loaded from its own triples and PRF keys)
+    struct Worker {
+        ReplicatedSharing3P rss;
+        AdditiveSharing2P   ass_prev, ass_next;
+        OQuantileEvaluator  eval;
+        std::vector<block>  uv_prev, uv_next;
+
+        Worker(const OQuantileParameters &params, const uint64_t s, const uint64_t nu)
+            : rss(s), ass_prev(s), ass_next(s), eval(params, rss, ass_prev, ass_next),
+              uv_prev(1ULL << nu), uv_next(1ULL << nu) {
+        }
+    };
+
+    // Helper that returns a task lambda for a given party p
+    auto MakeTask = [&](int p) {
+        const std::string ptag = "(P" + ToString(p) + ")";
+
+        return [=](std::vector<Channels> &worker_chls) {
+            for (auto db_bitsize : db_bitsizes) {
+                // ----- Parameters -----
+                OQuantileParameters params(db_bitsize);
+                params.PrintParameters();
+
+                const uint64_t d  = params.GetDatabaseBitSize();
+                const uint64_t s  = params.GetShareSize();
+                const uint64_t nu = params.GetOaParameters().GetParameters().GetTerminateBitsize();
+
+                std::string key_path   = kBenchWmPath + std::string("oquantilekey_d") + ToString(d);
+                std::string db_path    = kBenchWmPath + std::string("db_d") + ToString(d);
+                std::string query_path = kBenchWmPath + std::string("query_d") + ToString(d);
+
+                // ----- Timers -----
+                TimerManager  timer_mgr;
+                const int32_t timer_setup = timer_mgr.CreateNewTimer("OQuantile Workers OnlineSetUp " + ptag);
+
+                // ================================
+                // OnlineSetUp timing (key and shares are shared read-only by all workers)
+                // ================================
+                timer_mgr.SelectTimer(timer_setup);
+                timer_mgr.Start();
+
+                OQuantileKey key(p, params);
+                KeyIo        key_io;
+                key_io.LoadKey(key_path + "_" + ToString(p), key);
+
+                RepShareMat64 db_sh;
+                RepShareVec64 query_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(p), db_sh);
+                sh_io.LoadShare(query_path + "_" + ToString(p), query_sh);
+
+                std::vector<std::unique_ptr<Worker>> workers;
+                for (uint64_t w = 0; w < max_workers; ++w) {
+                    const std::string worker_path = WorkerDispatcher::GetWorkerPath(kBenchWmPath, w);
+                    workers.push_back(std::make_unique<Worker>(params, s, nu));
+                    workers[w]->eval.OnlineSetUp(p, worker_path);
+                    workers[w]->rss.OnlineSetUp(p, worker_path + "prf");
+                }
+
+                timer_mgr.Stop("d=" + ToString(d) + " iter=0");
+                timer_mgr.PrintCurrentResults(
+                    "d=" + ToString(d),
+                    ringoa::TimeUnit::MICROSECONDS,
+                    /*show_details=*/true);
+
+                // ================================
+                // Queries sharded over 1..max_workers workers; result q lands in result_sh[q]
+                // ================================
+                std::vector<RepShare64> result_sh(queries);
+                for (uint64_t num_workers : worker_counts) {
+                    timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("OQuantile EvalWorkers " + ptag));
+                    const std::string workers_msg = "d=" + ToString(d) + " queries=" + ToString(queries) +
+                                                    " workers=" + ToString(num_workers);
+                    std::vector<Channels> chls(worker_chls.begin(), worker_chls.begin() + num_workers);
+                    WorkerDispatcher      dispatcher(chls);
+                    SyncNeighbours(chls[0]);
+                    for (uint64_t i = 0; i < repeat; ++i) {
+                        timer_mgr.Start();
+                        dispatcher.Dispatch(queries, [&](uint64_t w, Channels &chl, uint64_t begin, uint64_t end) {
+                            Worker    &worker   = *workers[w];
+                            RepShare64 left_sh  = query_sh.At(0);
+                            RepShare64 right_sh = query_sh.At(1);
+                            RepShare64 k_sh     = query_sh.At(2);
+                            for (uint64_t q = begin; q < end; ++q) {
+                                worker.eval.EvaluateQuantile_Parallel(
+                                    chl, key, worker.uv_prev, worker.uv_next,
+                                    db_sh, left_sh, right_sh, k_sh, result_sh[q]);
+                            }
+                        });
+                        timer_mgr.Stop(workers_msg + " iter=" + ToString(i));
+                        for (uint64_t w = 0; w < num_workers; ++w) {
+                            chls[w].ResetStats();
+                            workers[w]->ass_prev.ResetTripleIndex();
+                            workers[w]->ass_next.ResetTripleIndex();
+                        }
+                    }
+                    timer_mgr.PrintCurrentResults(workers_msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+                    Logger::InfoLog(LOC, workers_msg + " queries/s=" + ToString(queries * 1000.0 / timer_mgr.GetCurrentAverage(ringoa::TimeUnit::MILLISECONDS)));
+                }
+            }
+        };
+    };
+
+    // Configure max_workers channel pairs per neighbour and run
+    ThreePartyNetworkManager net_mgr;
+    net_mgr.AutoConfigureWorkers(party_id, max_workers, MakeTask(0), MakeTask(1), MakeTask(2));
+    net_mgr.WaitForCompletion();
+
+    Logger::InfoLog(LOC, "OQuantile Workers Online Benchmark completed");
+    Logger::ExportLogListAndClear(kLogWmPath + "oquantile_workers_online_p" + ToString(party_id) + "_" + network,
+                                  /*use_timestamp=*/true);
+}
+
 void OQuantile_VAF_Offline_Bench(const osuCrypto::CLP &cmd) {
     uint64_t    repeat   = cmd.getOr("repeat", kRepeatDefault);
     std::string vaf_file = cmd.getOr("vaf_file", kVafDataPath + "vaf_values.txt");
@@ -7,6 +7,7 @@ namespace bench_ringoa {
 
 void OQuantile_Offline_Bench(const osuCrypto::CLP &cmd);
 void OQuantile_Online_Bench(const osuCrypto::CLP &cmd);
+void OQuantile_Workers_Online_Bench(const osuCrypto::CLP &cmd);
 void OQuantile_VAF_Offline_Bench(const osuCrypto::CLP &cmd);
 void OQuantile_VAF_Online_Bench(const osuCrypto::CLP &cmd);
 void OQuantile_Fsc_VAF_Offline_Bench(const osuCrypto::CLP &cmd);
@@ -0,0 +1,100 @@
+#include "prg_bench.h"
+
+#include <cryptoTools/Common/TestCollection.h>
+
+#include "RingOA/fss/prg.h"
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/rng.h"
+#include "RingOA/utils/timer.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+#include "bench_common.h"
+
+namespace {
+
+using ringoa::block;
+using ringoa::fss::prg::PseudoRandomGenerator;
+using ringoa::fss::prg::Side;
+
+// Expand 'num_blocks' blocks in batches of N; the output is fed back as the next input
+// so the compiler cannot drop the work.
+template <size_t N>
+block ExpandLoop(const PseudoRandomGenerator &prg, const uint64_t num_blocks) {
+    std::array<block, N> seeds;
+    for (size_t i = 0; i < N; ++i) {
+        seeds[i] = ringoa::GlobalRng::Rand<block>();
+    }
+    for (uint64_t i = 0; i < num_blocks; i += N) {
+        prg.Expand<N>(seeds, seeds, (i / N) & 1 ? Side::kRight : Side::kLeft);
+    }
+    block acc = ringoa::zero_block;
+    for (size_t i = 0; i < N; ++i) {
+        acc ^= seeds[i];
+    }
+    return acc;
+}
+
+}    // namespace
+
+namespace bench_ringoa {
+
+using ringoa::Logger;
+using ringoa::TimerManager;
+using ringoa::ToString;
+using ringoa::fss::prg::Backend;
+using ringoa::fss::prg::GetBackendString;
+
+void Prg_Expand_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t repeat     = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t log_blocks = cmd.getOr("blocks", 24);
+    uint64_t num_blocks = 1ULL << log_blocks;
+    Backend  detected   = PseudoRandomGenerator::DetectBackend();
+
+    Logger::InfoLog(LOC, "PRG Expand Benchmark started (repeat=" + ToString(repeat) + ", blocks=2^" + ToString(log_blocks) +
+                             ", detected=" + GetBackendString(detected) + ")");
+
+    const block seed_l = ringoa::MakeBlock(0x00, 0x00), seed_r = ringoa::MakeBlock(0x00, 0x01);
+    const block value_l = ringoa::MakeBlock(0x01, 0x01), value_r = ringoa::MakeBlock(0x01, 0x00);
+
+    for (Backend backend : {Backend::kAesNi, Backend::kVaes256, Backend::kVaes512}) {
+        if (static_cast<uint8_t>(backend) > static_cast<uint8_t>(detected)) {
+            Logger::InfoLog(LOC, "Skip unsupported backend: " + GetBackendString(backend));
+            continue;
+        }
+        PseudoRandomGenerator prg(seed_l, seed_r, value_l, value_r, backend);
+
+        for (uint64_t batch : {8, 16, 32}) {
+            TimerManager timer_mgr;
+            int32_t      timer_id = timer_mgr.CreateNewTimer("PRG Expand<" + ToString(batch) + "> " + GetBackendString(backend));
+            timer_mgr.SelectTimer(timer_id);
+
+            block sink = ringoa::zero_block;
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                switch (batch) {
+                    case 8:
+                        sink ^= ExpandLoop<8>(prg, num_blocks);
+                        break;
+                    case 16:
+                        sink ^= ExpandLoop<16>(prg, num_blocks);
+                        break;
+                    default:
+                        sink ^= ExpandLoop<32>(prg, num_blocks);
+                        break;
+                }
+                timer_mgr.Stop("backend=" + GetBackendString(backend) + " batch=" + ToString(batch) + " iter=" + ToString(i));
+            }
+
+            const std::string summary_msg = "backend=" + GetBackendString(backend) + " batch=" + ToString(batch);
+            timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+            double seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+            Logger::InfoLog(LOC, summary_msg + " throughput=" + ToString(static_cast<uint64_t>(num_blocks / seconds)) +
+                                     " blocks/s (sink=" + ToString(sink.get<uint64_t>()[0] & 1) + ")");
+        }
+    }
+    Logger::InfoLog(LOC, "PRG Expand Benchmark completed");
+    Logger::ExportLogListAndClear(kLogDpfPath + "prg_expand_bench", /*use_timestamp=*/true);
+}
+
+}    // namespace bench_ringoa
@@ -0,0 +1,12 @@
+#ifndef BENCH_PRG_BENCH_H_
+#define BENCH_PRG_BENCH_H_
+
+#include <cryptoTools/Common/CLP.h>
+
+namespace bench_ringoa {
+
+void Prg_Expand_Bench(const osuCrypto::CLP &cmd);
+
+}    // namespace bench_ringoa
+
+#endif    // BENCH_PRG_BENCH_H_
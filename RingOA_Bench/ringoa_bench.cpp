@@ -2,6 +2,7 @@
 
 #include <cryptoTools/Common/TestCollection.h>
 
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/protocol/key_io.h"
 #include "RingOA/protocol/ringoa.h"
 #include "RingOA/protocol/ringoa_fsc.h"
@@ -26,6 +27,7 @@ using ringoa::TimerManager;
 using ringoa::ToString, ringoa::Format;
 using ringoa::proto::KeyIo;
 using ringoa::proto::RingOaEvaluator;
+using ringoa::proto::RingOaFdeCache;
 using ringoa::proto::RingOaFscEvaluator;
 using ringoa::proto::RingOaFscKey;
 using ringoa::proto::RingOaFscKeyGenerator;
@@ -36,13 +38,18 @@ using ringoa::proto::RingOaParameters;
 using ringoa::sharing::AdditiveSharing2P;
 using ringoa::sharing::ReplicatedSharing3P;
 using ringoa::sharing::RepShare64;
+using ringoa::sharing::RepShareMat64;
 using ringoa::sharing::RepShareVec64;
 using ringoa::sharing::RepShareView64;
 using ringoa::sharing::ShareIo;
 
 void RingOa_Offline_Bench(const osuCrypto::CLP &cmd) {
-    uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
-    std::vector<uint64_t> db_bitsizes = SelectBitsizes(cmd);
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              batch         = cmd.getOr<uint64_t>("batch", 1024);
+    uint64_t              eval_batch    = cmd.getOr<uint64_t>("eval_batch", 16);
+    uint64_t              record_words  = cmd.getOr<uint64_t>("record_words", 4);
+    std::vector<uint64_t> db_bitsizes   = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
 
     Logger::InfoLog(LOC, "RingOA Offline Benchmark started (repeat=" + ToString(repeat) + ")");
 
@@ -85,14 +92,35 @@ void RingOa_Offline_Bench(const osuCrypto::CLP &cmd) {
                 /*show_details=*/true);
         }
 
-        // 2) OfflineSetUp timing (measured once per d)
+        // 2) Batched KeyGen throughput per thread count
+        for (auto num_threads : thread_counts) {
+            const std::string timer_name = "RingOA KeyGen Batch";
+            int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
+            timer_mgr.SelectTimer(timer_id);
+            gen.SetNumThreads(num_threads);
+
+            const std::string summary_msg = "d=" + ToString(d) + " batch=" + ToString(batch) + " threads=" + ToString(num_threads);
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                std::vector<std::array<RingOaKey, 3>> keys = gen.GenerateKeys(batch);
+                timer_mgr.Stop(summary_msg + " iter=" + ToString(i));
+            }
+            timer_mgr.PrintCurrentResults(summary_msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+            double seconds = timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS);
+            Logger::InfoLog(LOC, summary_msg + " " + ToString(static_cast<uint64_t>(batch / seconds)) + " keys/s");
+        }
+        gen.SetNumThreads(1);
+
+        // 3) OfflineSetUp timing (measured once per d)
         {
             const std::string timer_name = "RingOA OfflineSetUp";
             int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
             timer_mgr.SelectTimer(timer_id);
 
             timer_mgr.Start();
-            gen.OfflineSetUp(repeat, kBenchRingOAPath);
+            // Per iteration of the online bench: one triple for each of the cold and warm Evaluate,
+            // eval_batch for EvaluateBatch and EvaluatePipelined, record_words for EvaluateRecord
+            gen.OfflineSetUp(repeat * (2 + 2 * eval_batch + record_words), kBenchRingOAPath);
             rss.OfflineSetUp(kBenchRingOAPath + "prf");
             timer_mgr.Stop("d=" + ToString(d) + " iter=0");
             timer_mgr.PrintCurrentResults(
@@ -101,7 +129,7 @@ void RingOa_Offline_Bench(const osuCrypto::CLP &cmd) {
                 /*show_details=*/true);
         }
 
-        // 3) Data generation + secret sharing timing (measured once per d)
+        // 4) Data generation + secret sharing timing (measured once per d)
         {
             const std::string timer_name = "RingOA DataGen";
             int32_t           timer_id   = timer_mgr.CreateNewTimer(timer_name);
@@ -142,13 +170,17 @@ void RingOa_Offline_Bench(const osuCrypto::CLP &cmd) {
 }
 
 void RingOa_Online_Bench(const osuCrypto::CLP &cmd) {
-    uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
-    int                   party_id    = cmd.isSet("party") ? cmd.get<int>("party") : -1;
-    std::string           network     = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
-    std::vector<uint64_t> db_bitsizes = SelectBitsizes(cmd);
+    uint64_t              repeat       = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              eval_batch   = cmd.getOr<uint64_t>("eval_batch", 16);
+    uint64_t              record_words = cmd.getOr<uint64_t>("record_words", 4);
+    uint64_t              depth        = cmd.getOr<uint64_t>("depth", RingOaEvaluator::kPipelineDepth);
+    uint64_t              fde_budget   = cmd.getOr<uint64_t>("fde_cache_mb", 256) << 20;
+    int                   party_id     = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+    std::string           network      = cmd.isSet("network") ? cmd.get<std::string>("network") : "";
+    std::vector<uint64_t> db_bitsizes  = SelectBitsizes(cmd);
 
     Logger::InfoLog(LOC, "RingOA Online Benchmark started (repeat=" + ToString(repeat) +
-                             ", party=" + ToString(party_id) + ")");
+                             ", party=" + ToString(party_id) + ", fde_cache=" + ToString(fde_budget >> 20) + " MiB)");
 
     auto MakeTask = [&](int p) {
         const std::string ptag = "(P" + ToString(p) + ")";
@@ -169,8 +201,16 @@ void RingOa_Online_Bench(const osuCrypto::CLP &cmd) {
                 TimerManager      timer_mgr;
                 const std::string timer_setup_name = "RingOA OnlineSetUp " + ptag;
                 const std::string timer_eval_name  = "RingOA Eval " + ptag;
+                const std::string timer_batch_name = "RingOA EvalBatch " + ptag;
+                const std::string timer_pipe_name  = "RingOA EvalPipelined " + ptag;
+                const std::string timer_warm_name  = "RingOA Eval FDE cache warm " + ptag;
+                const std::string timer_rec_name   = "RingOA EvalRecord " + ptag;
                 int32_t           timer_setup      = timer_mgr.CreateNewTimer(timer_setup_name);
                 int32_t           timer_eval       = timer_mgr.CreateNewTimer(timer_eval_name);
+                int32_t           timer_batch      = timer_mgr.CreateNewTimer(timer_batch_name);
+                int32_t           timer_pipe       = timer_mgr.CreateNewTimer(timer_pipe_name);
+                int32_t           timer_warm       = timer_mgr.CreateNewTimer(timer_warm_name);
+                int32_t           timer_rec        = timer_mgr.CreateNewTimer(timer_rec_name);
 
                 // --- OnlineSetUp timing ---
                 timer_mgr.SelectTimer(timer_setup);
@@ -230,6 +270,96 @@ void RingOa_Online_Bench(const osuCrypto::CLP &cmd) {
                     "d=" + ToString(d),
                     ringoa::TimeUnit::MICROSECONDS,
                     /*show_details=*/true);
+
+                // --- Batched eval timing (eval_batch accesses, constant rounds) ---
+                timer_mgr.SelectTimer(timer_batch);
+                std::vector<const RingOaKey *> batch_keys(eval_batch, &key);
+                RepShareVec64                  batch_index_sh(eval_batch), batch_result_sh(eval_batch);
+                for (uint64_t k = 0; k < eval_batch; ++k) {
+                    batch_index_sh.Set(k, index_sh);
+                }
+                const std::string batch_msg = "d=" + ToString(d) + " eval_batch=" + ToString(eval_batch);
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    timer_mgr.Start();
+                    eval.EvaluateBatch(chls, batch_keys,
+                                       uv_prev, uv_next,
+                                       RepShareView64(database_sh), batch_index_sh, batch_result_sh);
+                    timer_mgr.Stop(batch_msg + " iter=" + ToString(i));
+
+                    if (i < 2) {
+                        Logger::InfoLog(LOC, batch_msg + " total_data_sent=" + ToString(chls.GetStats()) + " bytes");
+                    }
+                    chls.ResetStats();
+                }
+                timer_mgr.PrintCurrentResults(batch_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+                // --- Pipelined eval timing (eval_batch accesses, depth in flight) ---
+                // Same rounds per access as Eval; compare against eval_batch times its average.
+                timer_mgr.SelectTimer(timer_pipe);
+                const std::string pipe_msg = "d=" + ToString(d) + " eval_batch=" + ToString(eval_batch) +
+                                             " depth=" + ToString(depth);
+                SyncNeighbours(chls);
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    timer_mgr.Start();
+                    eval.EvaluatePipelined(chls, batch_keys,
+                                           uv_prev, uv_next,
+                                           RepShareView64(database_sh), batch_index_sh, batch_result_sh, depth);
+                    timer_mgr.Stop(pipe_msg + " iter=" + ToString(i));
+
+                    if (i < 2) {
+                        Logger::InfoLog(LOC, pipe_msg + " total_data_sent=" + ToString(chls.GetStats()) + " bytes");
+                    }
+                    chls.ResetStats();
+                }
+                timer_mgr.PrintCurrentResults(pipe_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
+
+                // --- Eval timing with the expansion precomputed (FDE cache warm) ---
+                // The "RingOA Eval" timer above is the cold case.
+                timer_mgr.SelectTimer(timer_warm);
+                RingOaFdeCache   cache(params, fde_budget);
+                const RingOaKey *cache_keys[] = {&key};
+                eval.SetFdeCache(&cache);
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    cache.Precompute(cache_keys);
+                    SyncNeighbours(chls);
+                    timer_mgr.Start();
+                    eval.Evaluate(chls, key,
+                                  uv_prev, uv_next,
+                                  RepShareView64(database_sh), index_sh, result_sh);
+                    timer_mgr.Stop("d=" + ToString(d) + " iter=" + ToString(i));
+                    chls.ResetStats();
+                }
+                eval.SetFdeCache(nullptr);
+                timer_mgr.PrintCurrentResults(
+                    "d=" + ToString(d),
+                    ringoa::TimeUnit::MICROSECONDS,
+                    /*show_details=*/true);
+
+                // --- Record eval timing (record_words words per access, one key) ---
+                // The database rows are copies of the single-word database; compare against
+                // record_words times the "RingOA Eval" average.
+                timer_mgr.SelectTimer(timer_rec);
+                RepShareMat64 record_sh(record_words, 1ULL << d);
+                for (uint64_t w = 0; w < record_words; ++w) {
+                    std::copy(database_sh[0].begin(), database_sh[0].end(), record_sh[0].begin() + (w << d));
+                    std::copy(database_sh[1].begin(), database_sh[1].end(), record_sh[1].begin() + (w << d));
+                }
+                RepShareVec64     record_result_sh(record_words);
+                const std::string rec_msg = "d=" + ToString(d) + " record_words=" + ToString(record_words);
+                SyncNeighbours(chls);
+                for (uint64_t i = 0; i < repeat; ++i) {
+                    timer_mgr.Start();
+                    eval.EvaluateRecord(chls, key,
+                                        uv_prev, uv_next,
+                                        record_sh, index_sh, record_result_sh);
+                    timer_mgr.Stop(rec_msg + " iter=" + ToString(i));
+
+                    if (i < 2) {
+                        Logger::InfoLog(LOC, rec_msg + " total_data_sent=" + ToString(chls.GetStats()) + " bytes");
+                    }
+                    chls.ResetStats();
+                }
+                timer_mgr.PrintCurrentResults(rec_msg, ringoa::TimeUnit::MICROSECONDS, /*show_details=*/true);
             }
         };
     };
@@ -0,0 +1,374 @@
+#include "wm_bench.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+
+#include <cryptoTools/Common/TestCollection.h>
+
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/seq_io.h"
+#include "RingOA/utils/thread_pool.h"
+#include "RingOA/utils/timer.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+#include "RingOA/wm/bwt_builder.h"
+#include "RingOA/wm/plain_wm.h"
+#include "bench_common.h"
+
+namespace {
+
+const uint64_t kFixedSeed = 6;
+
+// WaveletMatrix::RankCF over the expanded sigma x (n + 1) rank0 tables (the former layout)
+uint64_t RankCFFromTables(const std::vector<uint64_t> &rank0_tables, const size_t length, const size_t sigma,
+                          const uint64_t c, size_t position) {
+    const size_t stride = length + 1;
+    for (size_t bit = 0; bit < sigma; ++bit) {
+        const size_t off  = bit * stride;
+        const size_t zpos = rank0_tables[off + position];
+        position          = ((c >> bit) & 1ULL) ? rank0_tables[off + length] + (position - zpos) : zpos;
+    }
+    return position;
+}
+
+}    // namespace
+
+namespace bench_ringoa {
+
+using ringoa::Logger;
+using ringoa::ThreadPool;
+using ringoa::TimerManager;
+using ringoa::ToString;
+using ringoa::wm::BuildOrder;
+using ringoa::wm::BwtBuilder;
+using ringoa::wm::BwtBuildOptions;
+using ringoa::wm::CharType;
+using ringoa::wm::FMIndex;
+using ringoa::wm::OccTable;
+using ringoa::wm::PackedSymbols;
+using ringoa::wm::WaveletMatrix;
+
+void WaveletMatrix_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat      = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              sigma       = cmd.getOr<uint64_t>("sigma", 3);
+    uint64_t              num_ranks   = cmd.getOr<uint64_t>("ranks", 1ULL << 20);
+    uint64_t              table_limit = cmd.getOr<uint64_t>("table_mb", 4096) << 20;
+    std::vector<uint64_t> bitsizes    = SelectBitsizes(cmd);
+
+    Logger::InfoLog(LOC, "WaveletMatrix Benchmark started (repeat=" + ToString(repeat) + ", sigma=" + ToString(sigma) +
+                             ", ranks=" + ToString(num_ranks) + ")");
+
+    std::mt19937_64 rng(kFixedSeed);
+    for (uint64_t d : bitsizes) {
+        const uint64_t        n = 1ULL << d;
+        std::vector<uint64_t> data(n);
+        for (auto &v : data) {
+            v = rng() & ((1ULL << sigma) - 1);
+        }
+        std::vector<std::pair<uint64_t, size_t>> queries(num_ranks);
+        for (auto &[c, position] : queries) {
+            c        = rng() & ((1ULL << sigma) - 1);
+            position = rng() % (n + 1);
+        }
+        const std::string msg = "d=" + ToString(d);
+
+        TimerManager  timer_mgr;
+        WaveletMatrix wm;
+
+        // Build time and memory of the succinct levels
+        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("WM Build"));
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            wm = WaveletMatrix(data, sigma, BuildOrder::LSBFirst);
+            timer_mgr.Stop(msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+        Logger::InfoLog(LOC, msg + " succinct_bytes=" + ToString(wm.GetMemoryBytes()));
+
+        uint64_t sink = 0;
+        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("WM RankCF"));
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            for (const auto &[c, position] : queries) {
+                sink += wm.RankCF(c, position);
+            }
+            timer_mgr.Stop(msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+        Logger::InfoLog(LOC, msg + " succinct RankCF ns/op=" + ToString(timer_mgr.GetCurrentAverage(ringoa::TimeUnit::NANOSECONDS) / num_ranks));
+
+        // Same numbers for the expanded rank0 tables (now only produced as the sharing export)
+        const uint64_t table_bytes = sigma * (n + 1) * sizeof(uint64_t);
+        Logger::InfoLog(LOC, msg + " table_bytes=" + ToString(table_bytes));
+        if (table_bytes > table_limit) {
+            Logger::InfoLog(LOC, msg + " skip expanded tables (table_mb=" + ToString(table_limit >> 20) + ")");
+            continue;
+        }
+        std::vector<uint64_t> rank0_tables;
+        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("WM Rank0Tables export"));
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            rank0_tables = wm.GetRank0Tables();
+            timer_mgr.Stop(msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+
+        timer_mgr.SelectTimer(timer_mgr.CreateNewTimer("WM RankCF tables"));
+        for (uint64_t i = 0; i < repeat; ++i) {
+            timer_mgr.Start();
+            for (const auto &[c, position] : queries) {
+                sink -= RankCFFromTables(rank0_tables, n, sigma, c, position);
+            }
+            timer_mgr.Stop(msg + " iter=" + ToString(i));
+        }
+        timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+        Logger::InfoLog(LOC, msg + " tables RankCF ns/op=" + ToString(timer_mgr.GetCurrentAverage(ringoa::TimeUnit::NANOSECONDS) / num_ranks) +
+                                 " (sink=" + ToString(sink) + ")");
+    }
+
+    Logger::InfoLog(LOC, "WaveletMatrix Benchmark completed");
+    Logger::ExportLogListAndClear(kLogWmPath + "wm_bench", /*use_timestamp=*/true);
+}
+
+void FMIndex_Build_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              memory_limit  = cmd.getOr<uint64_t>("memory_mb", 256) << 20;
+    bool                  use_chr       = cmd.isSet("chr");
+    std::vector<uint64_t> bitsizes      = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+
+    std::unique_ptr<ringoa::ChromosomeLoader> chr_loader;
+    if (use_chr) {
+        std::vector<std::string> fasta_paths;
+        for (int i = 1; i <= 6; ++i) {
+            std::string path = kChromosomePath + "chr" + std::to_string(i) + "_clean.fa";
+            if (std::filesystem::exists(path))
+                fasta_paths.push_back(path);
+        }
+        if (fasta_paths.empty())
+            throw std::runtime_error("No FASTA files found in " + kChromosomePath);
+        chr_loader = std::make_unique<ringoa::ChromosomeLoader>(std::move(fasta_paths));
+    }
+
+    Logger::InfoLog(LOC, "FMIndex Build Benchmark started (repeat=" + ToString(repeat) +
+                             ", memory_mb=" + ToString(memory_limit >> 20) + ")");
+
+    std::mt19937_64 rng(kFixedSeed);
+    for (uint64_t d : bitsizes) {
+        const uint64_t n = 1ULL << d;
+        std::string    text;
+        if (use_chr) {
+            text = chr_loader->EnsurePrefix(n);
+        } else {
+            text.resize(n);
+            for (auto &c : text) {
+                c = "ACGT"[rng() & 3];
+            }
+        }
+        const double text_mb = text.size() / 1e6;
+
+        // Runs build() 'repeat' times; logs throughput in MB of text per second and the peak RSS
+        TimerManager timer_mgr;
+        auto         Measure = [&](const std::string &timer_name, const std::string &msg, const std::function<void()> &build) {
+            timer_mgr.SelectTimer(timer_mgr.CreateNewTimer(timer_name));
+            uint64_t peak_rss = 0;
+            for (uint64_t i = 0; i < repeat; ++i) {
+                ResetPeakRss();
+                timer_mgr.Start();
+                build();
+                timer_mgr.Stop(msg + " iter=" + ToString(i));
+                peak_rss = std::max(peak_rss, GetPeakRssBytes());
+            }
+            timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+            Logger::InfoLog(LOC, msg + " MB/s=" + ToString(text_mb / timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS)) +
+                                     " peak_rss_mb=" + ToString(peak_rss >> 20));
+        };
+
+        const std::string msg = "d=" + ToString(d);
+        Measure("FMIndex Build sdsl", msg, [&]() { FMIndex fm(text, CharType::DNA); });
+        for (uint64_t num_threads : thread_counts) {
+            BwtBuildOptions options;
+            options.num_threads = num_threads;
+            Measure("FMIndex Build", msg + " threads=" + ToString(num_threads), [&]() { FMIndex fm(text, CharType::DNA, options); });
+        }
+
+        // BWT streamed to disk with at most memory_mb of suffix positions per pass
+        BwtBuildOptions options;
+        options.num_threads  = thread_counts.back();
+        options.memory_limit = memory_limit;
+        BwtBuilder        builder(options);
+        const std::string bwt_path = kBenchWmPath + "bwt_d" + ToString(d);
+        const std::string disk_msg = msg + " threads=" + ToString(options.num_threads) + " memory_mb=" + ToString(memory_limit >> 20);
+        Measure("BWT BuildToFile", disk_msg, [&]() { builder.BuildToFile(text, bwt_path); });
+        Logger::InfoLog(LOC, disk_msg + " passes=" + ToString(builder.GetNumPasses()) +
+                                 " peak_suffix_mb=" + ToString(builder.GetPeakSuffixBytes() >> 20));
+
+        // Wavelet matrix levels alone (serial versus parallel stable partition)
+        const std::string bwt = BwtBuilder::LoadBwt(bwt_path);
+        for (uint64_t num_threads : thread_counts) {
+            Measure("WM Build levels", msg + " threads=" + ToString(num_threads),
+                    [&]() { WaveletMatrix wm(bwt, CharType::DNA, BuildOrder::LSBFirst, num_threads); });
+        }
+    }
+
+    Logger::InfoLog(LOC, "FMIndex Build Benchmark completed");
+    Logger::ExportLogListAndClear(kLogWmPath + "fmindex_build_bench", /*use_timestamp=*/true);
+}
+
+void FMIndex_LPM_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    uint64_t              num_reads     = cmd.getOr<uint64_t>("reads", 1ULL << 20);
+    uint64_t              read_len      = cmd.getOr<uint64_t>("read_len", 100);
+    uint64_t              sample_rate   = cmd.getOr<uint64_t>("sample_rate", OccTable::kDefaultSampleRate);
+    std::vector<uint64_t> bitsizes      = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+
+    Logger::InfoLog(LOC, "FMIndex LPM Benchmark started (repeat=" + ToString(repeat) + ", reads=" + ToString(num_reads) +
+                             ", read_len=" + ToString(read_len) + ", sample_rate=" + ToString(sample_rate) + ")");
+
+    std::mt19937_64 rng(kFixedSeed);
+    for (uint64_t d : bitsizes) {
+        const uint64_t n = 1ULL << d;
+        std::string    text(n, 'A');
+        for (auto &c : text) {
+            c = "ACGT"[rng() & 3];
+        }
+        BwtBuildOptions options;
+        options.num_threads = thread_counts.back();
+        FMIndex  fm(text, CharType::DNA, options);
+        OccTable occ(fm.GetBwt(), sample_rate);
+
+        // Reads taken from the text (as the index expects them, reversed) with one substitution
+        // every other read, so that matches end at varying depths
+        std::vector<std::string> reads(num_reads);
+        for (uint64_t r = 0; r < num_reads; ++r) {
+            reads[r] = text.substr(rng() % (n - std::min(n, read_len) + 1), read_len);
+            std::reverse(reads[r].begin(), reads[r].end());
+            if (r & 1) {
+                char &c = reads[r][rng() % reads[r].size()];
+                c       = (c == 'A') ? 'C' : 'A';
+            }
+        }
+        const std::string msg = "d=" + ToString(d);
+        Logger::InfoLog(LOC, msg + " occ_bytes=" + ToString(occ.GetMemoryBytes()) + " wm_bytes=" + ToString(fm.GetWaveletMatrix().GetMemoryBytes()));
+
+        TimerManager timer_mgr;
+        auto         Measure = [&](const std::string &timer_name, const std::string &msg, const std::function<uint64_t()> &run) {
+            timer_mgr.SelectTimer(timer_mgr.CreateNewTimer(timer_name));
+            uint64_t sink = 0;
+            for (uint64_t i = 0; i < repeat; ++i) {
+                timer_mgr.Start();
+                sink += run();
+                timer_mgr.Stop(msg + " iter=" + ToString(i));
+            }
+            timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+            Logger::InfoLog(LOC, msg + " reads/s=" + ToString(num_reads / timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS)) +
+                                     " (sink=" + ToString(sink) + ")");
+        };
+
+        Measure("LPM WM", msg, [&]() {
+            uint64_t sum = 0;
+            for (const auto &read : reads) {
+                sum += fm.ComputeLPMfromWM(read);
+            }
+            return sum;
+        });
+        Measure("LPM Occ", msg, [&]() {
+            uint64_t sum = 0;
+            for (const auto &read : reads) {
+                sum += occ.ComputeLPM(read);
+            }
+            return sum;
+        });
+        for (uint64_t num_threads : thread_counts) {
+            ThreadPool pool(num_threads);
+            Measure("LPM Occ batch", msg + " threads=" + ToString(num_threads), [&]() {
+                std::vector<uint64_t> lpm_lens = occ.ComputeLPMBatch(reads, pool);
+                return std::accumulate(lpm_lens.begin(), lpm_lens.end(), uint64_t(0));
+            });
+        }
+    }
+
+    Logger::InfoLog(LOC, "FMIndex LPM Benchmark completed");
+    Logger::ExportLogListAndClear(kLogWmPath + "fmindex_lpm_bench", /*use_timestamp=*/true);
+}
+
+void Fasta_Ingest_Bench(const osuCrypto::CLP &cmd) {
+    uint64_t              repeat        = cmd.getOr("repeat", kRepeatDefault);
+    std::vector<uint64_t> bitsizes      = SelectBitsizes(cmd);
+    std::vector<uint64_t> thread_counts = SelectThreadCounts(cmd);
+
+    Logger::InfoLog(LOC, "FASTA Ingest Benchmark started (repeat=" + ToString(repeat) + ")");
+
+    std::mt19937_64 rng(kFixedSeed);
+    for (uint64_t d : bitsizes) {
+        // Synthetic chromosome: 60-column lines with soft-masked (lowercase) runs
+        const uint64_t    n          = 1ULL << d;
+        const std::string fasta_path = kBenchWmPath + "ingest_d" + ToString(d) + ".fa";
+        {
+            std::ofstream out(fasta_path, std::ios::binary | std::ios::trunc);
+            std::string   line;
+            out << ">synthetic d=" << d << "\n";
+            for (uint64_t i = 0; i < n; i += 60) {
+                const bool masked = (i / 6000) % 4 == 3;
+                line.clear();
+                for (uint64_t j = i; j < std::min(n, i + 60); ++j) {
+                    line += (masked ? "acgt" : "ACGT")[rng() & 3];
+                }
+                out << line << "\n";
+            }
+        }
+        const double mb  = n / 1e6;
+        std::string  msg = "d=" + ToString(d);
+
+        TimerManager timer_mgr;
+        auto         Measure = [&](const std::string &timer_name, const std::string &msg, const std::function<void()> &run) {
+            timer_mgr.SelectTimer(timer_mgr.CreateNewTimer(timer_name));
+            uint64_t peak_rss = 0;
+            for (uint64_t i = 0; i < repeat; ++i) {
+                ResetPeakRss();
+                timer_mgr.Start();
+                run();
+                timer_mgr.Stop(msg + " iter=" + ToString(i));
+                peak_rss = std::max(peak_rss, GetPeakRssBytes());
+            }
+            timer_mgr.PrintCurrentResults(msg, ringoa::TimeUnit::MILLISECONDS, /*show_details=*/true);
+            Logger::InfoLog(LOC, msg + " MB/s=" + ToString(mb / timer_mgr.GetCurrentAverage(ringoa::TimeUnit::SECONDS)) +
+                                     " peak_rss_mb=" + ToString(peak_rss >> 20));
+        };
+
+        std::string text;
+        for (uint64_t num_threads : thread_counts) {
+            Measure("FASTA read", msg + " threads=" + ToString(num_threads), [&]() { text = ringoa::ReadFastaSequence(fasta_path, num_threads); });
+        }
+
+        const ringoa::wm::CharMapper  mapper(CharType::DNA);
+        const ringoa::wm::SymbolTable acgt = ringoa::wm::MakeSymbolTable("ACGT");
+        PackedSymbols                 packed;
+        for (uint64_t num_threads : thread_counts) {
+            Measure("Encode 3-bit", msg + " threads=" + ToString(num_threads), [&]() { packed = mapper.ToPacked(text, num_threads); });
+            Measure("Encode 2-bit", msg + " threads=" + ToString(num_threads), [&]() { ringoa::wm::EncodeSymbols(text, acgt, 2, num_threads); });
+        }
+        Measure("ToIds", msg, [&]() { mapper.ToIds(text); });
+        Logger::InfoLog(LOC, msg + " packed_bytes=" + ToString(packed.GetMemoryBytes()) + " ids_bytes=" + ToString(n * sizeof(uint64_t)));
+
+        // Wavelet matrix from an ID vector (the former path) versus straight from packed symbols
+        Measure("WM Build ids", msg, [&]() { WaveletMatrix wm(mapper.ToIds(text), mapper.GetSigma(), BuildOrder::LSBFirst); });
+        for (uint64_t num_threads : thread_counts) {
+            Measure("WM Build packed", msg + " threads=" + ToString(num_threads), [&]() {
+                WaveletMatrix wm(mapper.ToPacked(text, num_threads), CharType::DNA, BuildOrder::LSBFirst, num_threads);
+            });
+        }
+        std::filesystem::remove(fasta_path);
+    }
+
+    Logger::InfoLog(LOC, "FASTA Ingest Benchmark completed");
+    Logger::ExportLogListAndClear(kLogWmPath + "fasta_ingest_bench", /*use_timestamp=*/true);
+}
+
+}    // namespace bench_ringoa
@@ -0,0 +1,15 @@
+#ifndef BENCH_WM_BENCH_H_
+#define BENCH_WM_BENCH_H_
+
+#include <cryptoTools/Common/CLP.h>
+
+namespace bench_ringoa {
+
+void WaveletMatrix_Bench(const osuCrypto::CLP &cmd);
+void FMIndex_Build_Bench(const osuCrypto::CLP &cmd);
+void FMIndex_LPM_Bench(const osuCrypto::CLP &cmd);
+void Fasta_Ingest_Bench(const osuCrypto::CLP &cmd);
+
+}    // namespace bench_ringoa
+
+#endif    // BENCH_WM_BENCH_H_
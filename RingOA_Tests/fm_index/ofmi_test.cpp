@@ -1,5 +1,6 @@
 #include "ofmi_test.h"
 
+#include <algorithm>
 #include <random>
 
 #include <cryptoTools/Common/TestCollection.h>
@@ -13,18 +14,21 @@
 #include "RingOA/sharing/binary_2p.h"
 #include "RingOA/sharing/binary_3p.h"
 #include "RingOA/sharing/share_io.h"
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
 #include "RingOA/wm/plain_wm.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath  = ringoa::GetCurrentDirectory();
 const std::string kTestOFMIPath = kCurrentPath + "/data/test/fmi/";
 const uint64_t    kFixedSeed    = 6;
+const uint64_t    kLpmQueries   = 2;
 
 std::string GenerateRandomString(size_t length, const std::string &charset = "ATGC") {
     if (charset.empty() || length == 0)
@@ -38,11 +42,61 @@ std::string GenerateRandomString(size_t length, const std::string &charset = "AT
     return result;
 }
 
+template <typename T>
+void AppendBytes(const T &value, std::vector<uint8_t> &buffer) {
+    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&value), reinterpret_cast<const uint8_t *>(&value) + sizeof(T));
+}
+
+// Legacy DPF key form (one byte per control bit), as written before DpfKey was packed
+void AppendLegacyDpfKey(const ringoa::fss::dpf::DpfKey &key, std::vector<uint8_t> &buffer) {
+    AppendBytes(key.party_id, buffer);
+    AppendBytes(key.init_seed, buffer);
+    AppendBytes(key.cw_length, buffer);
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        AppendBytes(key.cw_seed[i], buffer);
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        buffer.push_back(key.GetControlLeft(i));
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        buffer.push_back(key.GetControlRight(i));
+    AppendBytes(key.output, buffer);
+}
+
+void AppendLegacyRingOaKey(const ringoa::proto::RingOaKey &key, std::vector<uint8_t> &buffer) {
+    AppendBytes(key.party_id, buffer);
+    AppendLegacyDpfKey(key.key_from_prev, buffer);
+    AppendLegacyDpfKey(key.key_from_next, buffer);
+    AppendBytes(key.rsh_from_prev, buffer);
+    AppendBytes(key.rsh_from_next, buffer);
+    AppendBytes(key.wsh_from_prev, buffer);
+    AppendBytes(key.wsh_from_next, buffer);
+}
+
+void AppendLegacyOWMKey(const ringoa::wm::OWMKey &key, std::vector<uint8_t> &buffer) {
+    AppendBytes(key.num_oa_keys, buffer);
+    for (const auto &oa_key : key.oa_keys)
+        AppendLegacyRingOaKey(oa_key, buffer);
+}
+
+// This party's kLpmQueries batch keys and query shares, saved by OFMI_Offline_Test (one key per query).
+// query_sh must already hold kLpmQueries shares (RepShareMat is not movable).
+void LoadBatch(const ringoa::fm_index::OFMIParameters      &params,
+               const uint64_t                               party_id,
+               std::vector<ringoa::fm_index::OFMIKey>      &keys,
+               std::vector<ringoa::sharing::RepShareMat64> &query_sh) {
+    const std::string        d = ringoa::ToString(params.GetDatabaseBitSize());
+    ringoa::sharing::ShareIo sh_io;
+    keys = test_ringoa::LoadBatchKeys<ringoa::fm_index::OFMIKey>(params, kTestOFMIPath + "ofmibatchkey_d" + d, party_id, kLpmQueries);
+    for (uint64_t k = 0; k < kLpmQueries; ++k) {
+        sh_io.LoadShare(kTestOFMIPath + "batchquery_d" + d + "_" + ringoa::ToString(k) + "_" + ringoa::ToString(party_id), query_sh[k]);
+    }
+}
+
 }    // namespace
 
 namespace test_ringoa {
 
 using ringoa::Channels;
+using ringoa::CoScheduler;
 using ringoa::CreateSequence;
 using ringoa::FileIo;
 using ringoa::Logger;
@@ -283,8 +337,22 @@ void OFMI_Offline_Test() {
             sh_io.SaveShare(query_path + "_" + ToString(p), query_sh[p]);
         }
 
-        // Offline setup
-        gen.OfflineSetUp(kTestOFMIPath);
+        // Batch keys and queries: a query per batched LPM
+        SaveBatchKeys(gen, kTestOFMIPath + "ofmibatchkey_d" + ToString(d), kLpmQueries);
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            std::string batch_query = GenerateRandomString(qs);
+            Logger::DebugLog(LOC, "Batch query " + ToString(k) + ": " + batch_query);
+
+            std::array<RepShareMat64, 3> batch_query_sh = gen.GenerateQueryU64Share(fm, batch_query);
+            std::string                  bquery_path    = kTestOFMIPath + "batchquery_d" + ToString(d) + "_" + ToString(k);
+            file_io.WriteBinary(bquery_path, batch_query);
+            for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+                sh_io.SaveShare(bquery_path + "_" + ToString(p), batch_query_sh[p]);
+            }
+        }
+
+        // Offline setup (EvaluateLPM_Pipelined evaluates kLpmQueries queries)
+        gen.OfflineSetUp(kTestOFMIPath, kLpmQueries);
         rss.OfflineSetUp(kTestOFMIPath + "prf");
     }
     Logger::DebugLog(LOC, "OFMI_Offline_Test - Passed");
@@ -387,6 +455,334 @@ void OFMI_Online_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "OFMI_Online_Test - Passed");
 }
 
+void OFMI_Pipelined_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "OFMI_Pipelined_Online_Test...");
+    std::vector<OFMIParameters> params_list = {
+        OFMIParameters(10, 10),
+        // OFMIParameters(10),
+        // OFMIParameters(15),
+        // OFMIParameters(20),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetDatabaseBitSize();
+        uint64_t qs = params.GetQuerySize();
+        uint64_t nu = params.GetOWMParameters().GetOaParameters().GetParameters().GetTerminateBitsize();
+
+        FileIo file_io;
+
+        std::vector<uint64_t> result;    // kLpmQueries rows of qs entries
+        std::string           db_path = kTestOFMIPath + "db_d" + ToString(d);
+
+        std::string              database;
+        std::vector<std::string> batch_queries(kLpmQueries);
+        file_io.ReadBinary(db_path, database);
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            file_io.ReadBinary(kTestOFMIPath + "batchquery_d" + ToString(d) + "_" + ToString(k), batch_queries[k]);
+        }
+
+        // Factory to create a per-party task
+        auto MakeTask = [&](int party_id) {
+            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                // Set up replicated sharing and evaluator
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d), ass_next(d);
+                OFMIEvaluator       eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load this party's batch keys and query shares
+                std::vector<OFMIKey>       keys;
+                std::vector<RepShareMat64> query_sh(kLpmQueries);
+                LoadBatch(params, party_id, keys, query_sh);
+
+                // Load this party's share of the database
+                RepShareMat64 db_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), db_sh);
+
+                // Perform the PRF setup step
+                eval.OnlineSetUp(party_id, kTestOFMIPath);
+                rss.OnlineSetUp(party_id, kTestOFMIPath + "prf");
+
+                // Evaluate kLpmQueries queries with the pipelined driver
+                std::vector<const OFMIKey *>       key_ptrs(kLpmQueries);
+                std::vector<const RepShareMat64 *> queries(kLpmQueries);
+                RepShareMat64                      result_sh(kLpmQueries, qs);
+                std::vector<ringoa::block>         uv_prev(1U << nu), uv_next(1U << nu);
+                for (uint64_t k = 0; k < kLpmQueries; ++k) {
+                    key_ptrs[k] = &keys[k];
+                    queries[k]  = &query_sh[k];
+                }
+                eval.EvaluateLPM_Pipelined(chls, key_ptrs, uv_prev, uv_next, db_sh, queries, result_sh);
+
+                // Open the resulting share matrix to recover the final plaintext vectors
+                rss.Open(chls, result_sh.shares, result);
+            };
+        };
+
+        // Instantiate tasks for parties 0, 1, and 2
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Result: " + ToString(result));
+
+        // Compute expected longest-prefix-match lengths using FM-index
+        FMIndex fmi(database);
+
+        // Count the zero entries of each query's row: each zero indicates a matched prefix position
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            uint64_t expected_result = fmi.ComputeLPMfromWM(batch_queries[k]);
+            uint64_t match_len       = std::count(result.begin() + k * qs, result.begin() + (k + 1) * qs, 0ULL);
+            if (match_len != expected_result) {
+                throw osuCrypto::UnitTestFail(
+                    "OFMI_Pipelined_Online_Test failed: query " + ToString(k) + " result = " + ToString(match_len) +
+                    ", expected = " + ToString(expected_result));
+            }
+        }
+    }
+
+    Logger::DebugLog(LOC, "OFMI_Pipelined_Online_Test - Passed");
+}
+
+void OFMI_Batch_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "OFMI_Batch_Online_Test...");
+    std::vector<OFMIParameters> params_list = {
+        OFMIParameters(10, 10),
+        // OFMIParameters(10),
+        // OFMIParameters(15),
+        // OFMIParameters(20),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetDatabaseBitSize();
+        uint64_t qs = params.GetQuerySize();
+        uint64_t nu = params.GetOWMParameters().GetOaParameters().GetParameters().GetTerminateBitsize();
+
+        FileIo file_io;
+
+        std::vector<uint64_t> result;    // kLpmQueries rows of qs entries
+        std::string           db_path = kTestOFMIPath + "db_d" + ToString(d);
+
+        std::string              database;
+        std::vector<std::string> batch_queries(kLpmQueries);
+        file_io.ReadBinary(db_path, database);
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            file_io.ReadBinary(kTestOFMIPath + "batchquery_d" + ToString(d) + "_" + ToString(k), batch_queries[k]);
+        }
+
+        // Factory to create a per-party task
+        auto MakeTask = [&](int party_id) {
+            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                // Set up replicated sharing and evaluator
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d), ass_next(d);
+                OFMIEvaluator       eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load this party's batch keys and query shares
+                std::vector<OFMIKey>       keys;
+                std::vector<RepShareMat64> query_sh(kLpmQueries);
+                LoadBatch(params, party_id, keys, query_sh);
+
+                // Load this party's share of the database
+                RepShareMat64 db_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), db_sh);
+
+                // Perform the PRF setup step
+                eval.OnlineSetUp(party_id, kTestOFMIPath);
+                rss.OnlineSetUp(party_id, kTestOFMIPath + "prf");
+
+                // Evaluate kLpmQueries queries in lockstep
+                std::vector<const OFMIKey *>       key_ptrs(kLpmQueries);
+                std::vector<const RepShareMat64 *> queries(kLpmQueries);
+                RepShareMat64                      result_sh(kLpmQueries, qs);
+                std::vector<ringoa::block>         uv_prev(1U << nu), uv_next(1U << nu);
+                for (uint64_t k = 0; k < kLpmQueries; ++k) {
+                    key_ptrs[k] = &keys[k];
+                    queries[k]  = &query_sh[k];
+                }
+                eval.EvaluateLPMBatch(chls, key_ptrs, uv_prev, uv_next, db_sh, queries, result_sh);
+
+                // Open the resulting share matrix to recover the final plaintext vectors
+                rss.Open(chls, result_sh.shares, result);
+            };
+        };
+
+        // Instantiate tasks for parties 0, 1, and 2
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Result: " + ToString(result));
+
+        // Compute expected longest-prefix-match lengths using FM-index
+        FMIndex fmi(database);
+
+        // Count the zero entries of each query's row: each zero indicates a matched prefix position
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            uint64_t expected_result = fmi.ComputeLPMfromWM(batch_queries[k]);
+            uint64_t match_len       = std::count(result.begin() + k * qs, result.begin() + (k + 1) * qs, 0ULL);
+            if (match_len != expected_result) {
+                throw osuCrypto::UnitTestFail(
+                    "OFMI_Batch_Online_Test failed: query " + ToString(k) + " result = " + ToString(match_len) +
+                    ", expected = " + ToString(expected_result));
+            }
+        }
+    }
+
+    Logger::DebugLog(LOC, "OFMI_Batch_Online_Test - Passed");
+}
+
+void OFMI_Co_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "OFMI_Co_Online_Test...");
+    std::vector<OFMIParameters> params_list = {
+        OFMIParameters(10, 10),
+        // OFMIParameters(10),
+        // OFMIParameters(15),
+        // OFMIParameters(20),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetDatabaseBitSize();
+        uint64_t qs = params.GetQuerySize();
+        uint64_t nu = params.GetOWMParameters().GetOaParameters().GetParameters().GetTerminateBitsize();
+
+        FileIo file_io;
+
+        std::vector<uint64_t> result(kLpmQueries * qs);    // kLpmQueries rows of qs entries
+        std::string           db_path = kTestOFMIPath + "db_d" + ToString(d);
+
+        std::string              database;
+        std::vector<std::string> batch_queries(kLpmQueries);
+        file_io.ReadBinary(db_path, database);
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            file_io.ReadBinary(kTestOFMIPath + "batchquery_d" + ToString(d) + "_" + ToString(k), batch_queries[k]);
+        }
+
+        // Factory to create a per-party task
+        auto MakeTask = [&](int party_id) {
+            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                // Set up replicated sharing and evaluator
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d), ass_next(d);
+                OFMIEvaluator       eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load this party's batch keys and query shares
+                std::vector<OFMIKey>       keys;
+                std::vector<RepShareMat64> query_sh(kLpmQueries);
+                LoadBatch(params, party_id, keys, query_sh);
+
+                // Load this party's share of the database
+                RepShareMat64 db_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), db_sh);
+
+                // Perform the PRF setup step
+                eval.OnlineSetUp(party_id, kTestOFMIPath);
+                rss.OnlineSetUp(party_id, kTestOFMIPath + "prf");
+
+                // Run kLpmQueries queries as interleaved sessions
+                std::vector<RepShareVec64> result_sh(kLpmQueries);
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+                CoScheduler                sched;
+                sched.Run(kLpmQueries, kLpmQueries, [&](uint64_t k) {
+                    return eval.EvaluateLPM_Co(sched, chls, keys[k], uv_prev, uv_next, db_sh, query_sh[k], result_sh[k]);
+                });
+
+                // Open the resulting shares into row k (every party writes the same values in place)
+                for (uint64_t k = 0; k < kLpmQueries; ++k) {
+                    std::vector<uint64_t> res_k;
+                    rss.Open(chls, result_sh[k], res_k);
+                    std::copy(res_k.begin(), res_k.end(), result.begin() + k * qs);
+                }
+            };
+        };
+
+        // Instantiate tasks for parties 0, 1, and 2
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Result: " + ToString(result));
+
+        // Compute expected longest-prefix-match lengths using FM-index
+        FMIndex fmi(database);
+
+        // Count the zero entries of each query's row: each zero indicates a matched prefix position
+        for (uint64_t k = 0; k < kLpmQueries; ++k) {
+            uint64_t expected_result = fmi.ComputeLPMfromWM(batch_queries[k]);
+            uint64_t match_len       = std::count(result.begin() + k * qs, result.begin() + (k + 1) * qs, 0ULL);
+            if (match_len != expected_result) {
+                throw osuCrypto::UnitTestFail(
+                    "OFMI_Co_Online_Test failed: query " + ToString(k) + " result = " + ToString(match_len) +
+                    ", expected = " + ToString(expected_result));
+            }
+        }
+    }
+
+    Logger::DebugLog(LOC, "OFMI_Co_Online_Test - Passed");
+}
+
+void OFMI_Key_Legacy_Test() {
+    Logger::DebugLog(LOC, "OFMI_Key_Legacy_Test...");
+    OFMIParameters params(10, 10);
+    params.PrintParameters();
+    uint64_t               d = params.GetDatabaseBitSize();
+    AdditiveSharing2P      ass(d);
+    ReplicatedSharing3P    rss(d);
+    OFMIKeyGenerator       gen(params, ass, rss);
+    std::array<OFMIKey, 3> keys = gen.GenerateKeys();
+
+    for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+        // Container layout with every nested DPF key in the legacy form
+        std::vector<uint8_t> legacy;
+        AppendBytes(keys[p].num_wm_keys, legacy);
+        AppendBytes(keys[p].num_zt_keys, legacy);
+        for (const auto &wm_key : keys[p].wm_f_keys)
+            AppendLegacyOWMKey(wm_key, legacy);
+        for (const auto &wm_key : keys[p].wm_g_keys)
+            AppendLegacyOWMKey(wm_key, legacy);
+        for (const auto &zt_key : keys[p].zt_keys) {
+            AppendLegacyDpfKey(zt_key.dpf_key, legacy);
+            AppendBytes(zt_key.shr_in, legacy);
+        }
+        if (legacy.size() != OFMIKey::CalculateLegacySerializedSize(params))
+            throw osuCrypto::UnitTestFail("Legacy OFMIKey size mismatch");
+
+        std::vector<uint8_t> packed, converted;
+        keys[p].Serialize(packed);
+        OFMIKey::ConvertLegacy(params, legacy, converted);
+        if (converted != packed)
+            throw osuCrypto::UnitTestFail("Converted legacy OFMIKey differs from the packed form");
+        OFMIKey restored(p, params);
+        restored.Deserialize(converted);
+        if (restored != keys[p])
+            throw osuCrypto::UnitTestFail("Converted legacy OFMIKey does not load the same key");
+    }
+    Logger::DebugLog(LOC, "OFMI_Key_Legacy_Test - Passed");
+}
+
 void OFMI_Fsc_Offline_Test() {
     Logger::DebugLog(LOC, "OFMI_Fsc_Offline_Test...");
     std::vector<OFMIFscParameters> params_list = {
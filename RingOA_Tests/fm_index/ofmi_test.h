@@ -9,6 +9,10 @@ void SotFMI_Offline_Test();
 void SotFMI_Online_Test(const osuCrypto::CLP &cmd);
 void OFMI_Offline_Test();
 void OFMI_Online_Test(const osuCrypto::CLP &cmd);
+void OFMI_Pipelined_Online_Test(const osuCrypto::CLP &cmd);
+void OFMI_Batch_Online_Test(const osuCrypto::CLP &cmd);
+void OFMI_Co_Online_Test(const osuCrypto::CLP &cmd);
+void OFMI_Key_Legacy_Test();
 void OFMI_Fsc_Offline_Test();
 void OFMI_Fsc_Online_Test(const osuCrypto::CLP &cmd);
 
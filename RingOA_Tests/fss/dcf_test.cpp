@@ -86,6 +86,11 @@ void Dcf_Fde_Test() {
     Logger::DebugLog(LOC, "Dcf_Fde_Test...");
     const std::vector<std::tuple<uint64_t, uint64_t>> size_pair = {
         {3, 3},
+        {10, 1},
+        {12, 8},
+        {12, 16},
+        {14, 32},
+        {16, 40},
     };
 
     // Test all combinations of parameters
@@ -102,11 +107,13 @@ void Dcf_Fde_Test() {
         std::pair<DcfKey, DcfKey> keys = gen.GenerateKeys(alpha, beta);
 
         // Evaluate keys
-        std::vector<uint64_t> outputs_0(1 << n), outputs_1(1 << n);
+        std::vector<uint64_t> outputs_0, outputs_1;
+        eval.EvaluateFullDomain(keys.first, outputs_0);
+        eval.EvaluateFullDomain(keys.second, outputs_1);
 
         for (uint64_t i = 0; i < outputs_0.size(); ++i) {
-            outputs_0[i] = eval.EvaluateAt(keys.first, i);
-            outputs_1[i] = eval.EvaluateAt(keys.second, i);
+            if (outputs_0[i] != eval.EvaluateAt(keys.first, i) || outputs_1[i] != eval.EvaluateAt(keys.second, i))
+                throw osuCrypto::UnitTestFail("EvaluateFullDomain differs from EvaluateAt at x=" + ToString(i));
         }
 
         std::vector<uint64_t> outputs(outputs_0.size());
@@ -125,4 +132,92 @@ void Dcf_Fde_Test() {
     Logger::DebugLog(LOC, "Dcf_Fde_Test - Passed");
 }
 
+void Dcf_EvalAt_Batch_Test() {
+    Logger::DebugLog(LOC, "Dcf_EvalAt_Batch_Test...");
+    // (n, e, number of key pairs)
+    const std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> batch_param = {
+        {3, 3, 5},
+        {10, 1, 33},
+        {16, 16, 50},
+        {20, 32, 20},
+        {32, 48, 100},
+    };
+
+    for (auto [n, e, num_pairs] : batch_param) {
+        DcfParameters param(n, e);
+        param.PrintParameters();
+        DcfKeyGenerator gen(param);
+        DcfEvaluator    eval(param);
+
+        // Both parties' keys in one batch, each evaluated at a point just below, at or above alpha
+        std::vector<DcfKey>   keys;
+        std::vector<uint64_t> x, expected;
+        for (uint64_t k = 0; k < num_pairs; ++k) {
+            uint64_t                  alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            uint64_t                  beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            std::pair<DcfKey, DcfKey> pair  = gen.GenerateKeys(alpha, beta);
+            uint64_t                  point = Mod2N(alpha + (k % 3) - 1, n);
+            keys.push_back(std::move(pair.first));
+            keys.push_back(std::move(pair.second));
+            x.insert(x.end(), {point, point});
+            expected.push_back(point < alpha ? beta : 0);
+        }
+
+        std::vector<uint64_t> outputs;
+        eval.EvaluateAt(keys, x, outputs);
+        for (uint64_t i = 0; i < keys.size(); ++i) {
+            if (outputs[i] != eval.EvaluateAt(keys[i], x[i]))
+                throw osuCrypto::UnitTestFail("Batched EvaluateAt differs from scalar EvaluateAt");
+        }
+        for (uint64_t k = 0; k < num_pairs; ++k) {
+            if (Mod2N(outputs[2 * k] + outputs[2 * k + 1], e) != expected[k])
+                throw osuCrypto::UnitTestFail("Batched EvaluateAt reconstructs a wrong value");
+        }
+    }
+
+    Logger::DebugLog(LOC, "Dcf_EvalAt_Batch_Test - Passed");
+}
+
+void Dcf_Key_Serialize_Test() {
+    Logger::DebugLog(LOC, "Dcf_Key_Serialize_Test...");
+    for (auto [n, e] : std::vector<std::pair<uint64_t, uint64_t>>{{3, 3}, {10, 1}, {16, 16}, {32, 48}}) {
+        DcfParameters param(n, e);
+        param.PrintParameters();
+        DcfKeyGenerator           gen(param);
+        DcfEvaluator              eval(param);
+        uint64_t                  alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        uint64_t                  beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+        std::pair<DcfKey, DcfKey> keys  = gen.GenerateKeys(alpha, beta);
+        const DcfKey             &key   = keys.first;
+
+        // Round trip
+        std::vector<uint8_t> buffer;
+        key.Serialize(buffer);
+        if (buffer.size() != key.GetSerializedSize() || DcfKey::IsLegacy(buffer))
+            throw osuCrypto::UnitTestFail("Serialized DCF key has the wrong size or no format flag");
+        DcfKey restored(0, param);
+        restored.Deserialize(buffer);
+        if (restored != key || eval.EvaluateAt(restored, alpha) != eval.EvaluateAt(key, alpha))
+            throw osuCrypto::UnitTestFail("DCF round trip differs");
+
+        // Key written before early termination: n levels and a 64-bit output, no flag
+        const uint64_t       legacy_output = 0;
+        std::vector<uint8_t> legacy(reinterpret_cast<const uint8_t *>(&key.party_id), reinterpret_cast<const uint8_t *>(&key.party_id) + sizeof(key.party_id));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&key.init_seed), reinterpret_cast<const uint8_t *>(&key.init_seed) + sizeof(block));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&n), reinterpret_cast<const uint8_t *>(&n) + sizeof(n));
+        legacy.resize(legacy.size() + (sizeof(block) + 2 + sizeof(uint64_t)) * n, 0);
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&legacy_output), reinterpret_cast<const uint8_t *>(&legacy_output) + sizeof(legacy_output));
+        if (legacy.size() != DcfKey::CalculateLegacySerializedSize(param) || !DcfKey::IsLegacy(legacy))
+            throw osuCrypto::UnitTestFail("Legacy DCF key not recognised");
+        try {
+            restored.Deserialize(legacy);
+            throw osuCrypto::UnitTestFail("Legacy DCF key was accepted");
+        } catch (const std::invalid_argument &) {
+        }
+        if (restored != key)
+            throw osuCrypto::UnitTestFail("Rejected legacy DCF key changed the target key");
+    }
+    Logger::DebugLog(LOC, "Dcf_Key_Serialize_Test - Passed");
+}
+
 }    // namespace test_ringoa
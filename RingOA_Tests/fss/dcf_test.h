@@ -5,6 +5,8 @@ namespace test_ringoa {
 
 void Dcf_EvalAt_Test();
 void Dcf_Fde_Test();
+void Dcf_EvalAt_Batch_Test();
+void Dcf_Key_Serialize_Test();
 
 }    // namespace test_ringoa
 
@@ -1,8 +1,12 @@
 #include "dpf_test.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cryptoTools/Common/TestCollection.h>
+#include <thread>
 
 #include "RingOA/fss/dpf_eval.h"
+#include "RingOA/fss/dpf_eval_t.h"
 #include "RingOA/fss/dpf_gen.h"
 #include "RingOA/fss/dpf_key.h"
 #include "RingOA/utils/logger.h"
@@ -83,6 +87,7 @@ using ringoa::TimerManager;
 using ringoa::ToString, ringoa::Format;
 using ringoa::fss::EvalType, ringoa::fss::OutputType;
 using ringoa::fss::dpf::DpfEvaluator;
+using ringoa::fss::dpf::DpfEvaluatorT;
 using ringoa::fss::dpf::DpfKey;
 using ringoa::fss::dpf::DpfKeyGenerator;
 using ringoa::fss::dpf::DpfParameters;
@@ -104,7 +109,8 @@ void Dpf_Params_Test() {
     const std::vector<EvalType> evals = {
         EvalType::kBruteforce,
         EvalType::kRecursive,
-        EvalType::kHybridBatched};
+        EvalType::kHybridBatched,
+        EvalType::kHalfTree};
 
     // Test all combinations of parameters
     for (auto [n, e] : size_pair) {
@@ -134,7 +140,8 @@ void Dpf_EvalAt_Test() {
     };
     const std::vector<EvalType> evals = {
         EvalType::kBruteforce,
-        EvalType::kHybridBatched};
+        EvalType::kHybridBatched,
+        EvalType::kHalfTree};
 
     // Test all combinations of parameters
     for (auto [n, e] : size_pair) {
@@ -169,6 +176,60 @@ void Dpf_EvalAt_Test() {
     Logger::DebugLog(LOC, "Dpf_EvalAt_Test - Passed");
 }
 
+void Dpf_EvalAt_Batch_Test() {
+    Logger::DebugLog(LOC, "Dpf_EvalAt_Batch_Test...");
+    // (n, e, eval type, output type, number of key pairs)
+    const std::vector<std::tuple<uint64_t, uint64_t, EvalType, OutputType, uint64_t>> batch_param = {
+        {3, 3, EvalType::kBruteforce, OutputType::kShiftedAdditive, 5},
+        {9, 9, EvalType::kBruteforce, OutputType::kShiftedAdditive, 20},
+        {10, 1, EvalType::kHybridBatched, OutputType::kShiftedAdditive, 4},
+        {10, 1, EvalType::kHybridBatched, OutputType::kSingleBitMask, 33},
+        {17, 17, EvalType::kHybridBatched, OutputType::kShiftedAdditive, 50},
+        {29, 29, EvalType::kHybridBatched, OutputType::kShiftedAdditive, 100},
+        {14, 6, EvalType::kHybridBatched, OutputType::kShiftedAdditive, 20},
+        {20, 48, EvalType::kHybridBatched, OutputType::kShiftedAdditive, 20},
+        {10, 1, EvalType::kHalfTree, OutputType::kSingleBitMask, 33},
+        {17, 17, EvalType::kHalfTree, OutputType::kShiftedAdditive, 50},
+        {20, 48, EvalType::kHalfTree, OutputType::kShiftedAdditive, 20},
+    };
+
+    for (auto [n, e, ev, mode, num_pairs] : batch_param) {
+        DpfParameters param(n, e, ev, mode);
+        param.PrintParameters();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+
+        // Both parties' keys in one batch, each evaluated at alpha or at a random point
+        std::vector<DpfKey>   keys;
+        std::vector<uint64_t> x, betas;
+        for (uint64_t k = 0; k < num_pairs; ++k) {
+            uint64_t                  alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            uint64_t                  beta  = mode == OutputType::kSingleBitMask ? 1 : Mod2N(GlobalRng::Rand<uint64_t>(), param.GetOutputBitsize());
+            std::pair<DpfKey, DpfKey> pair  = gen.GenerateKeys(alpha, beta);
+            uint64_t                  point = (k % 2 == 0) ? alpha : Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            keys.push_back(std::move(pair.first));
+            keys.push_back(std::move(pair.second));
+            x.insert(x.end(), {point, point});
+            betas.push_back(point == alpha ? beta : 0);
+        }
+
+        std::vector<uint64_t> outputs;
+        eval.EvaluateAt(keys, x, outputs);
+        for (uint64_t i = 0; i < keys.size(); ++i) {
+            if (outputs[i] != eval.EvaluateAt(keys[i], x[i]))
+                throw osuCrypto::UnitTestFail("Batched EvaluateAt differs from scalar EvaluateAt");
+        }
+        for (uint64_t k = 0; k < num_pairs; ++k) {
+            uint64_t y = (mode == OutputType::kSingleBitMask) ? (outputs[2 * k] ^ outputs[2 * k + 1])
+                                                              : Mod2N(outputs[2 * k] + outputs[2 * k + 1], param.GetOutputBitsize());
+            if (y != betas[k])
+                throw osuCrypto::UnitTestFail("Batched EvaluateAt reconstructs a wrong value");
+        }
+    }
+
+    Logger::DebugLog(LOC, "Dpf_EvalAt_Batch_Test - Passed");
+}
+
 void Dpf_Fde_Test() {
     Logger::DebugLog(LOC, "Dpf_Fde_Test...");
     const std::vector<std::tuple<uint64_t, uint64_t, EvalType>> fde_param = {
@@ -180,6 +241,14 @@ void Dpf_Fde_Test() {
         {9, 9, EvalType::kHybridBatched},
         {17, 17, EvalType::kRecursive},
         {17, 17, EvalType::kHybridBatched},
+        {12, 5, EvalType::kRecursive},         // 8-bit lanes
+        {12, 8, EvalType::kHybridBatched},     // 8-bit lanes
+        {16, 40, EvalType::kRecursive},        // 64-bit lanes
+        {18, 63, EvalType::kHybridBatched},    // 64-bit lanes
+        {9, 9, EvalType::kHalfTree},
+        {17, 17, EvalType::kHalfTree},
+        {12, 8, EvalType::kHalfTree},          // 8-bit lanes
+        {18, 63, EvalType::kHalfTree},         // 64-bit lanes
     };
 
     // Test all combinations of parameters
@@ -222,6 +291,8 @@ void Dpf_Fde_One_Test() {
         {3, 1, EvalType::kBruteforce},
         {10, 1, EvalType::kRecursive},
         {10, 1, EvalType::kHybridBatched},
+        {10, 1, EvalType::kHalfTree},
+        {16, 1, EvalType::kHalfTree},
     };
     // Test all combinations of parameters
     for (auto [n, e, eval_type] : fde_param) {
@@ -274,4 +345,452 @@ void Dpf_Fde_One_Test() {
     Logger::DebugLog(LOC, "Dpf_Fde_One_Test - Passed");
 }
 
+void Dpf_Fde_Parallel_Test() {
+    Logger::DebugLog(LOC, "Dpf_Fde_Parallel_Test...");
+    // (n, e, num_threads, split_depth); split_depth 0 selects it automatically
+    const std::vector<std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>> fde_param = {
+        {10, 1, 2, 0},
+        {10, 1, 4, 3},
+        {12, 12, 3, 0},
+        {17, 17, 4, 5},
+        {20, 20, 8, 0},
+        {20, 20, 8, 17},
+    };
+
+    for (auto [n, e, num_threads, split_depth] : fde_param) {
+        DpfParameters param(n, e, EvalType::kHybridBatched);
+        param.PrintParameters();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+        DpfEvaluator    eval_mt(param);
+        eval_mt.SetNumThreads(num_threads);
+        eval_mt.SetSplitDepth(split_depth);
+        uint64_t alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        uint64_t beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+
+        // Generate keys
+        Logger::DebugLog(LOC, "alpha=" + ToString(alpha) + ", beta=" + ToString(beta) +
+                                  ", threads=" + ToString(num_threads) + ", split=" + ToString(split_depth));
+        std::pair<DpfKey, DpfKey> keys = gen.GenerateKeys(alpha, beta);
+
+        // Single-threaded and multi-threaded evaluation must agree bit for bit
+        for (const DpfKey *key : {&keys.first, &keys.second}) {
+            std::vector<block> outputs(1U << param.GetTerminateBitsize());
+            std::vector<block> outputs_mt(1U << param.GetTerminateBitsize());
+            eval.EvaluateFullDomain(*key, outputs);
+            eval_mt.EvaluateFullDomain(*key, outputs_mt);
+            if (outputs != outputs_mt)
+                throw osuCrypto::UnitTestFail("Parallel FDE output differs from single-threaded output");
+        }
+
+        // Check FDE through the integer interface as well
+        if (e > 1) {
+            std::vector<uint64_t> outputs_0(1U << n), outputs_1(1U << n);
+            eval_mt.EvaluateFullDomain(keys.first, outputs_0);
+            eval_mt.EvaluateFullDomain(keys.second, outputs_1);
+            std::vector<uint64_t> outputs(outputs_0.size());
+            for (uint64_t i = 0; i < outputs_0.size(); ++i) {
+                outputs[i] = Mod2N(outputs_0[i] + outputs_1[i], e);
+            }
+            if (!DpfFullDomainCheck(alpha, beta, outputs))
+                throw osuCrypto::UnitTestFail("FDE check failed");
+        }
+    }
+    Logger::DebugLog(LOC, "Dpf_Fde_Parallel_Test - Passed");
+}
+
+void Dpf_Fde_MultiKey_Test() {
+    Logger::DebugLog(LOC, "Dpf_Fde_MultiKey_Test...");
+    // (n, e, fde_type, num_keys, num_threads)
+    const std::vector<std::tuple<uint64_t, uint64_t, EvalType, uint64_t, uint64_t>> fde_param = {
+        {10, 1, EvalType::kHybridBatched, 2, 1},
+        {10, 10, EvalType::kHybridBatched, 3, 1},
+        {12, 12, EvalType::kHybridBatched, 2, 1},
+        {12, 1, EvalType::kHybridBatched, 5, 2},
+        {17, 17, EvalType::kHybridBatched, 4, 3},
+        {20, 20, EvalType::kHybridBatched, 2, 4},
+        {12, 1, EvalType::kHalfTree, 5, 1},
+        {17, 17, EvalType::kHalfTree, 3, 1},
+    };
+
+    for (auto [n, e, fde_type, num_keys, num_threads] : fde_param) {
+        DpfParameters param(n, e, fde_type);
+        param.PrintParameters();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+        eval.SetNumThreads(num_threads);
+        uint64_t num_nodes = 1U << param.GetTerminateBitsize();
+
+        // Generate keys, alternating between the parties so that lanes mix party IDs
+        std::vector<DpfKey>   keys;
+        std::vector<uint64_t> alphas(num_keys), betas(num_keys);
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            alphas[k]                      = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            betas[k]                       = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            std::pair<DpfKey, DpfKey> pair = gen.GenerateKeys(alphas[k], betas[k]);
+            keys.push_back(k % 2 == 0 ? std::move(pair.first) : std::move(pair.second));
+        }
+        Logger::DebugLog(LOC, "keys=" + ToString(num_keys) + ", threads=" + ToString(num_threads));
+
+        // Lockstep evaluation must match the per-key evaluation bit for bit
+        std::vector<std::vector<block>> expected(num_keys, std::vector<block>(num_nodes));
+        std::vector<std::vector<block>> outputs(num_keys, std::vector<block>(num_nodes));
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            eval.EvaluateFullDomain(keys[k], expected[k]);
+        }
+        eval.EvaluateFullDomain(keys, outputs);
+        if (outputs != expected)
+            throw osuCrypto::UnitTestFail("Multi-key FDE output differs from per-key output");
+
+        // Pointer interface with keys in reverse order
+        std::vector<const DpfKey *>       key_ptrs;
+        std::vector<std::vector<block> *> output_ptrs;
+        std::vector<std::vector<block>>   outputs_rev(num_keys, std::vector<block>(num_nodes));
+        for (uint64_t k = num_keys; k-- > 0;) {
+            key_ptrs.push_back(&keys[k]);
+            output_ptrs.push_back(&outputs_rev[k]);
+        }
+        eval.EvaluateFullDomain(key_ptrs, output_ptrs);
+        if (outputs_rev != expected)
+            throw osuCrypto::UnitTestFail("Multi-key FDE (pointer interface) output differs from per-key output");
+
+        // Subtrees of one leaf, a quarter of the domain and the full domain at random positions
+        for (uint64_t count : {uint64_t{1}, std::max<uint64_t>(num_nodes / 4, 1), num_nodes}) {
+            std::vector<uint64_t>           firsts(num_keys);
+            std::vector<std::vector<block>> subtrees(num_keys, std::vector<block>(count));
+            std::vector<block *>            subtree_ptrs;
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                firsts[k] = Mod2N(GlobalRng::Rand<uint64_t>(), param.GetTerminateBitsize()) & ~(count - 1);
+                subtree_ptrs.push_back(subtrees[k].data());
+            }
+            eval.EvaluateSubtrees(key_ptrs, firsts, count, subtree_ptrs);
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                const std::vector<block> &full = expected[num_keys - 1 - k];
+                if (!std::equal(subtrees[k].begin(), subtrees[k].end(), full.begin() + firsts[k]))
+                    throw osuCrypto::UnitTestFail("Subtree of " + ToString(count) + " leaves differs from the full-domain output");
+            }
+        }
+        bool thrown = false;
+        try {
+            eval.EvaluateSubtrees(key_ptrs, std::vector<uint64_t>(num_keys - 1), 1, std::vector<block *>(num_keys));
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        if (!thrown)
+            throw osuCrypto::UnitTestFail("EvaluateSubtrees accepted fewer first leaves than keys");
+
+        // Integer interface
+        if (e > 1) {
+            std::vector<std::vector<uint64_t>>   outputs_int(num_keys, std::vector<uint64_t>(1U << n));
+            std::vector<std::vector<uint64_t> *> output_int_ptrs;
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                output_int_ptrs.push_back(&outputs_int[k]);
+            }
+            eval.EvaluateFullDomain(std::vector<const DpfKey *>(key_ptrs.rbegin(), key_ptrs.rend()), output_int_ptrs);
+            for (uint64_t k = 0; k < num_keys; ++k) {
+                std::vector<uint64_t> outputs_k(1U << n);
+                eval.EvaluateFullDomain(keys[k], outputs_k);
+                if (outputs_int[k] != outputs_k)
+                    throw osuCrypto::UnitTestFail("Multi-key FDE (integer interface) output differs from per-key output");
+            }
+        }
+    }
+    Logger::DebugLog(LOC, "Dpf_Fde_MultiKey_Test - Passed");
+}
+
+void Dpf_Fde_Stream_Test() {
+    Logger::DebugLog(LOC, "Dpf_Fde_Stream_Test...");
+    // (n, e, eval_type, num_keys)
+    const std::vector<std::tuple<uint64_t, uint64_t, EvalType, uint64_t>> fde_param = {
+        {10, 1, EvalType::kHybridBatched, 1},
+        {10, 10, EvalType::kHybridBatched, 1},
+        {12, 12, EvalType::kHybridBatched, 2},
+        {12, 1, EvalType::kHybridBatched, 3},
+        {17, 17, EvalType::kHybridBatched, 2},
+        {20, 20, EvalType::kHybridBatched, 1},
+        {12, 12, EvalType::kRecursive, 2},
+        {10, 1, EvalType::kRecursive, 1},
+        {12, 12, EvalType::kHalfTree, 2},
+    };
+
+    for (auto [n, e, eval_type, num_keys] : fde_param) {
+        DpfParameters param(n, e, eval_type);
+        param.PrintParameters();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+        uint64_t        num_nodes = 1U << param.GetTerminateBitsize();
+
+        std::vector<DpfKey>         keys;
+        std::vector<const DpfKey *> key_ptrs;
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            uint64_t                  alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            uint64_t                  beta  = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            std::pair<DpfKey, DpfKey> pair  = gen.GenerateKeys(alpha, beta);
+            keys.push_back(k % 2 == 0 ? std::move(pair.first) : std::move(pair.second));
+        }
+        for (const DpfKey &key : keys) {
+            key_ptrs.push_back(&key);
+        }
+
+        std::vector<std::vector<block>> expected(num_keys, std::vector<block>(num_nodes));
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            eval.EvaluateFullDomain(keys[k], expected[k]);
+        }
+
+        // Every leaf must be visited exactly once with the materialised value
+        std::vector<std::vector<block>>    streamed(num_keys, std::vector<block>(num_nodes, ringoa::zero_block));
+        std::vector<std::vector<uint64_t>> visits(num_keys, std::vector<uint64_t>(num_nodes, 0));
+        eval.VisitFullDomain(key_ptrs, [&](uint64_t k, uint64_t j, const block &leaf) {
+            streamed[k][j] = leaf;
+            visits[k][j]++;
+        });
+        if (streamed != expected)
+            throw osuCrypto::UnitTestFail("Streamed FDE output differs from materialised output");
+        for (uint64_t k = 0; k < num_keys; ++k) {
+            for (uint64_t j = 0; j < num_nodes; ++j) {
+                if (visits[k][j] != 1)
+                    throw osuCrypto::UnitTestFail("Streamed FDE visited leaf " + ToString(j) + " of key " + ToString(k) + " " + ToString(visits[k][j]) + " times");
+            }
+        }
+
+        // Single-key visitor
+        std::vector<block> single(num_nodes, ringoa::zero_block);
+        eval.VisitFullDomain(keys[0], [&](uint64_t j, const block &leaf) { single[j] = leaf; });
+        if (single != expected[0])
+            throw osuCrypto::UnitTestFail("Single-key streamed FDE output differs from materialised output");
+    }
+    Logger::DebugLog(LOC, "Dpf_Fde_Stream_Test - Passed");
+}
+
+void Dpf_Fde_Concurrent_Test() {
+    Logger::DebugLog(LOC, "Dpf_Fde_Concurrent_Test...");
+    const uint64_t n           = 16;
+    const uint64_t num_keys    = 8;
+    const uint64_t num_workers = 8;
+    const uint64_t num_rounds  = 4;
+
+    DpfParameters param(n, n, EvalType::kHybridBatched);
+    param.PrintParameters();
+    DpfKeyGenerator gen(param);
+    DpfEvaluator    eval(param);
+    DpfEvaluator    eval_mt(param);
+    eval_mt.SetNumThreads(4);
+
+    // Generate keys and single-threaded reference outputs
+    std::vector<DpfKey>             keys;
+    std::vector<uint64_t>           alphas(num_keys);
+    std::vector<std::vector<block>> expected(num_keys, std::vector<block>(1U << param.GetTerminateBitsize()));
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        alphas[k]                      = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        std::pair<DpfKey, DpfKey> pair = gen.GenerateKeys(alphas[k], Mod2N(GlobalRng::Rand<uint64_t>(), n));
+        keys.push_back(std::move(pair.first));
+        eval.EvaluateFullDomain(keys[k], expected[k]);
+    }
+    std::vector<uint64_t> expected_at(num_keys);
+    for (uint64_t k = 0; k < num_keys; ++k) {
+        expected_at[k] = eval.EvaluateAt(keys[k], alphas[k]);
+    }
+
+    // All workers share the same evaluators (and thus the same PRG instance)
+    std::atomic<uint64_t>    mismatches{0};
+    std::vector<std::thread> workers;
+    for (uint64_t w = 0; w < num_workers; ++w) {
+        workers.emplace_back([&, w]() {
+            const DpfEvaluator &ev = (w % 2 == 0) ? eval : eval_mt;
+            std::vector<block>  outputs(1U << param.GetTerminateBitsize());
+            for (uint64_t r = 0; r < num_rounds; ++r) {
+                for (uint64_t k = 0; k < num_keys; ++k) {
+                    uint64_t idx = (k + w) % num_keys;
+                    ev.EvaluateFullDomain(keys[idx], outputs);
+                    if (outputs != expected[idx] || ev.EvaluateAt(keys[idx], alphas[idx]) != expected_at[idx]) {
+                        mismatches.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (mismatches.load() != 0)
+        throw osuCrypto::UnitTestFail("Concurrent FDE produced " + ToString(mismatches.load()) + " mismatching outputs");
+    Logger::DebugLog(LOC, "Dpf_Fde_Concurrent_Test - Passed");
+}
+
+void Dpf_Specialized_Test() {
+    Logger::DebugLog(LOC, "Dpf_Specialized_Test...");
+    // (n, e, output type), all in the instantiated set
+    const std::vector<std::tuple<uint64_t, uint64_t, OutputType>> spec_param = {
+        {16, 1, OutputType::kShiftedAdditive},     // 1-bit lanes
+        {16, 1, OutputType::kSingleBitMask},       // 1-bit lanes
+        {16, 16, OutputType::kShiftedAdditive},    // 16-bit lanes
+        {20, 8, OutputType::kShiftedAdditive},     // 8-bit lanes
+        {20, 20, OutputType::kShiftedAdditive},    // 32-bit lanes
+        {20, 40, OutputType::kShiftedAdditive},    // 64-bit lanes
+        {24, 1, OutputType::kShiftedAdditive},     // 1-bit lanes
+    };
+
+    for (auto [n, e, mode] : spec_param) {
+        DpfParameters param(n, e, EvalType::kHybridBatched, mode);
+        DpfParameters param_ref(n, e, EvalType::kRecursive, mode);
+        param.PrintParameters();
+        if (ringoa::fss::dpf::FindDpfSpecialization(param) == nullptr)
+            throw osuCrypto::UnitTestFail("No specialisation for " + param.GetParametersInfo());
+
+        uint64_t        nu = param.GetTerminateBitsize();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+        DpfEvaluator    eval_ref(param_ref);
+        uint64_t        alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        uint64_t        beta  = mode == OutputType::kSingleBitMask ? 1 : Mod2N(GlobalRng::Rand<uint64_t>(), e);
+
+        std::pair<DpfKey, DpfKey> keys = gen.GenerateKeys(alpha, beta);
+        for (const DpfKey *key : {&keys.first, &keys.second}) {
+            // Full domain against the generic recursive evaluation
+            std::vector<block> outputs(1U << nu), outputs_ref(1U << nu);
+            eval.EvaluateFullDomain(*key, outputs);
+            eval_ref.EvaluateFullDomain(*key, outputs_ref);
+            if (outputs != outputs_ref)
+                throw osuCrypto::UnitTestFail("Specialised FDE differs from the generic evaluation");
+
+            // Point evaluation against the full-domain leaves
+            for (uint64_t x : {alpha, Mod2N(GlobalRng::Rand<uint64_t>(), n), Mod2N(GlobalRng::Rand<uint64_t>(), n)}) {
+                uint64_t expected = Mod2N(ringoa::fss::GetSplitBlockValue(outputs_ref[x >> (n - nu)], n - nu, ringoa::GetLowerNBits(x, n - nu), mode), e);
+                if (eval.EvaluateAt(*key, x) != expected)
+                    throw osuCrypto::UnitTestFail("Specialised EvaluateAt differs from the generic evaluation");
+            }
+        }
+    }
+
+    // Not instantiated / not a standard ET tree: generic code only
+    if (ringoa::fss::dpf::FindDpfSpecialization(DpfParameters(17, 17)) != nullptr ||
+        ringoa::fss::dpf::FindDpfSpecialization(DpfParameters(16, 1, EvalType::kHalfTree)) != nullptr)
+        throw osuCrypto::UnitTestFail("Unexpected specialisation");
+
+    // Direct use of an instantiated evaluator
+    DpfParameters                                      param(16, 1);
+    DpfKeyGenerator                                    gen(param);
+    DpfEvaluatorT<16, 9, OutputType::kShiftedAdditive> eval_t(param);
+    uint64_t                                           alpha = Mod2N(GlobalRng::Rand<uint64_t>(), 16);
+    std::pair<DpfKey, DpfKey>                          keys  = gen.GenerateKeys(alpha, 1);
+    if (Mod2N(eval_t.EvaluateAt(keys.first, alpha) + eval_t.EvaluateAt(keys.second, alpha), 1) != 1)
+        throw osuCrypto::UnitTestFail("DpfEvaluatorT does not reconstruct beta");
+    bool thrown = false;
+    try {
+        DpfEvaluatorT<16, 9, OutputType::kShiftedAdditive> mismatched(DpfParameters(16, 16));
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    if (!thrown)
+        throw osuCrypto::UnitTestFail("DpfEvaluatorT accepted mismatching parameters");
+
+    Logger::DebugLog(LOC, "Dpf_Specialized_Test - Passed");
+}
+
+void Dpf_Gen_Batch_Test() {
+    Logger::DebugLog(LOC, "Dpf_Gen_Batch_Test...");
+    const std::vector<DpfParameters> params_list = {
+        DpfParameters(8, 8),
+        DpfParameters(12, 1, EvalType::kRecursive),
+        DpfParameters(16, 1, EvalType::kHybridBatched, OutputType::kSingleBitMask),
+        DpfParameters(20, 20, EvalType::kHybridBatched),
+        DpfParameters(16, 1, EvalType::kHalfTree),
+    };
+
+    for (const auto &param : params_list) {
+        param.PrintParameters();
+        uint64_t        n = param.GetInputBitsize();
+        uint64_t        e = param.GetOutputBitsize();
+        DpfKeyGenerator gen(param);
+        DpfEvaluator    eval(param);
+
+        // 1, a short batch and several full batches plus a tail
+        for (uint64_t num_keys : {1, 5, 77}) {
+            std::vector<uint64_t> alphas(num_keys), betas(num_keys);
+            for (uint64_t i = 0; i < num_keys; ++i) {
+                alphas[i] = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+                betas[i]  = param.GetOutputType() == OutputType::kSingleBitMask ? 1 : Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            }
+            const block seed = GlobalRng::Rand<block>();
+
+            // Scalar reference from the same seed
+            std::vector<std::pair<DpfKey, DpfKey>> expected;
+            std::vector<block>                     expected_seeds_0(num_keys), expected_seeds_1(num_keys);
+            std::vector<bool>                      expected_control_bits_1(num_keys);
+            {
+                GlobalRng::ScopedSeed scoped(seed);
+                for (uint64_t i = 0; i < num_keys; ++i) {
+                    bool control_bit = false;
+                    expected.push_back(gen.GenerateKeys(alphas[i], betas[i], expected_seeds_0[i], expected_seeds_1[i], control_bit));
+                    expected_control_bits_1[i] = control_bit;
+                }
+            }
+
+            std::vector<std::pair<DpfKey, DpfKey>> key_pairs;
+            std::vector<block>                     final_seeds_0, final_seeds_1;
+            std::vector<bool>                      final_control_bits_1;
+            {
+                GlobalRng::ScopedSeed scoped(seed);
+                gen.GenerateKeys(alphas, betas, key_pairs, final_seeds_0, final_seeds_1, final_control_bits_1);
+            }
+
+            if (key_pairs != expected || final_seeds_0 != expected_seeds_0 || final_seeds_1 != expected_seeds_1 ||
+                final_control_bits_1 != expected_control_bits_1)
+                throw osuCrypto::UnitTestFail("Batched key generation differs from the scalar one");
+            for (uint64_t i = 0; i < num_keys; ++i) {
+                if (Mod2N(eval.EvaluateAt(key_pairs[i].first, alphas[i]) + eval.EvaluateAt(key_pairs[i].second, alphas[i]), e) != betas[i])
+                    throw osuCrypto::UnitTestFail("Batched key does not reconstruct beta");
+            }
+        }
+    }
+    Logger::DebugLog(LOC, "Dpf_Gen_Batch_Test - Passed");
+}
+
+void Dpf_Key_Serialize_Test() {
+    Logger::DebugLog(LOC, "Dpf_Key_Serialize_Test...");
+    for (auto [n, e] : std::vector<std::pair<uint64_t, uint64_t>>{{10, 1}, {16, 16}, {20, 40}, {32, 1}}) {
+        DpfParameters param(n, e);
+        param.PrintParameters();
+        DpfKeyGenerator           gen(param);
+        DpfEvaluator              eval(param);
+        uint64_t                  alpha = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        std::pair<DpfKey, DpfKey> keys  = gen.GenerateKeys(alpha, 1);
+        const DpfKey             &key   = keys.first;
+
+        // Packed round trip
+        std::vector<uint8_t> packed;
+        key.Serialize(packed);
+        if (packed.size() != key.GetSerializedSize())
+            throw osuCrypto::UnitTestFail("Packed size mismatch");
+        DpfKey restored(0, param);
+        restored.Deserialize(packed);
+        if (restored != key)
+            throw osuCrypto::UnitTestFail("Packed round trip differs");
+
+        // Legacy form: one byte per control bit
+        std::vector<uint8_t> legacy(reinterpret_cast<const uint8_t *>(&key.party_id), reinterpret_cast<const uint8_t *>(&key.party_id) + sizeof(key.party_id));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&key.init_seed), reinterpret_cast<const uint8_t *>(&key.init_seed) + sizeof(block));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&key.cw_length), reinterpret_cast<const uint8_t *>(&key.cw_length) + sizeof(key.cw_length));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(key.cw_seed.get()), reinterpret_cast<const uint8_t *>(key.cw_seed.get() + key.cw_length));
+        for (uint64_t i = 0; i < key.cw_length; ++i)
+            legacy.push_back(key.GetControlLeft(i));
+        for (uint64_t i = 0; i < key.cw_length; ++i)
+            legacy.push_back(key.GetControlRight(i));
+        legacy.insert(legacy.end(), reinterpret_cast<const uint8_t *>(&key.output), reinterpret_cast<const uint8_t *>(&key.output) + sizeof(block));
+        if (legacy.size() != DpfKey::CalculateLegacySerializedSize(param))
+            throw osuCrypto::UnitTestFail("Legacy size mismatch");
+
+        DpfKey from_legacy(0, param);
+        from_legacy.Deserialize(legacy);
+        if (from_legacy != key || eval.EvaluateAt(from_legacy, alpha) != eval.EvaluateAt(key, alpha))
+            throw osuCrypto::UnitTestFail("Legacy key read differs");
+        std::vector<uint8_t> converted;
+        DpfKey::ConvertLegacy(legacy, converted);
+        if (converted != packed)
+            throw osuCrypto::UnitTestFail("Converted legacy key differs from the packed form");
+    }
+    Logger::DebugLog(LOC, "Dpf_Key_Serialize_Test - Passed");
+}
+
 }    // namespace test_ringoa
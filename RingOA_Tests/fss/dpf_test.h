@@ -5,8 +5,16 @@ namespace test_ringoa {
 
 void Dpf_Params_Test();
 void Dpf_EvalAt_Test();
+void Dpf_EvalAt_Batch_Test();
 void Dpf_Fde_Test();
 void Dpf_Fde_One_Test();
+void Dpf_Fde_Parallel_Test();
+void Dpf_Fde_Concurrent_Test();
+void Dpf_Fde_MultiKey_Test();
+void Dpf_Fde_Stream_Test();
+void Dpf_Specialized_Test();
+void Dpf_Gen_Batch_Test();
+void Dpf_Key_Serialize_Test();
 void Dpf_Pir_Test();
 
 }    // namespace test_ringoa
@@ -1,8 +1,11 @@
 #include "prg_test.h"
 
+#include <cryptoTools/Common/TestCollection.h>
+
 #include "RingOA/fss/fss.h"
 #include "RingOA/fss/prg.h"
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/rng.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
@@ -10,10 +13,58 @@
 namespace test_ringoa {
 
 using ringoa::block;
+using ringoa::GlobalRng;
 using ringoa::Logger;
 using ringoa::ToString, ringoa::Format;
+using ringoa::fss::prg::Backend;
+using ringoa::fss::prg::PseudoRandomGenerator;
 using ringoa::fss::prg::Side;
 
+namespace {
+
+// Batched expansion must agree with the single-block (osuCrypto::AES) path.
+template <size_t N>
+bool CheckBatchedExpand(const PseudoRandomGenerator &prg) {
+    std::array<block, N> in, out;
+    for (size_t i = 0; i < N; ++i) {
+        in[i] = GlobalRng::Rand<block>();
+    }
+    bool check = true;
+    for (Side side : {Side::kLeft, Side::kRight}) {
+        prg.Expand<N>(in, out, side);
+        for (size_t i = 0; i < N; ++i) {
+            block expected;
+            prg.Expand(in[i], expected, side);
+            check &= (out[i] == expected);
+        }
+        // In-place expansion
+        std::array<block, N> inout = in;
+        prg.Expand<N>(inout, inout, side);
+        check &= (inout == out);
+    }
+    // Per-block sides
+    std::array<Side, N> sides;
+    for (size_t i = 0; i < N; ++i) {
+        sides[i] = (GlobalRng::Rand<uint64_t>() & 1) ? Side::kRight : Side::kLeft;
+    }
+    prg.Expand<N>(in, out, sides);
+    for (size_t i = 0; i < N; ++i) {
+        block expected;
+        prg.Expand(in[i], expected, sides[i]);
+        check &= (out[i] == expected);
+    }
+    // Half-tree hash
+    prg.HalfTreeHash<N>(in, out);
+    for (size_t i = 0; i < N; ++i) {
+        block expected;
+        prg.HalfTreeHash(in[i], expected);
+        check &= (out[i] == expected);
+    }
+    return check;
+}
+
+}    // namespace
+
 void Prg_Test() {
     Logger::DebugLog(LOC, "Prg_Test...");
 
@@ -42,4 +93,28 @@ void Prg_Test() {
     Logger::DebugLog(LOC, "Prg_Test - Passed");
 }
 
+void Prg_Backend_Test() {
+    Logger::DebugLog(LOC, "Prg_Backend_Test...");
+
+    Backend detected = PseudoRandomGenerator::DetectBackend();
+    Logger::DebugLog(LOC, "Detected backend: " + ringoa::fss::prg::GetBackendString(detected));
+    Logger::DebugLog(LOC, "Singleton backend: " + ringoa::fss::prg::GetBackendString(PseudoRandomGenerator::GetInstance().GetBackend()));
+
+    const block seed_l = ringoa::MakeBlock(0x00, 0x00), seed_r = ringoa::MakeBlock(0x00, 0x01);
+    const block value_l = ringoa::MakeBlock(0x01, 0x01), value_r = ringoa::MakeBlock(0x01, 0x00);
+
+    for (Backend backend : {Backend::kAesNi, Backend::kVaes256, Backend::kVaes512}) {
+        if (static_cast<uint8_t>(backend) > static_cast<uint8_t>(detected)) {
+            Logger::DebugLog(LOC, "Skip unsupported backend: " + ringoa::fss::prg::GetBackendString(backend));
+            continue;
+        }
+        PseudoRandomGenerator prg(seed_l, seed_r, value_l, value_r, backend);
+        if (prg.GetBackend() != backend)
+            throw osuCrypto::UnitTestFail("PRG did not select the requested backend");
+        if (!CheckBatchedExpand<8>(prg) || !CheckBatchedExpand<16>(prg) || !CheckBatchedExpand<32>(prg))
+            throw osuCrypto::UnitTestFail("Batched expansion mismatch for backend " + ringoa::fss::prg::GetBackendString(backend));
+    }
+    Logger::DebugLog(LOC, "Prg_Backend_Test - Passed");
+}
+
 }    // namespace test_ringoa
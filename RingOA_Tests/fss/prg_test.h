@@ -4,6 +4,7 @@
 namespace test_ringoa {
 
 void Prg_Test();
+void Prg_Backend_Test();
 
 }    // namespace test_ringoa
 
@@ -83,6 +83,53 @@ void Ddcf_EvalAt_Test() {
     Logger::DebugLog(LOC, "Ddcf_EvalAt_Test - Passed");
 }
 
+void Ddcf_EvalAt_Batch_Test() {
+    Logger::DebugLog(LOC, "Ddcf_EvalAt_Batch_Test...");
+    const std::vector<std::pair<uint64_t, uint64_t>> size_pair = {
+        {3, 3},
+        {10, 10},
+    };
+    constexpr uint64_t kBatchSize = 16;
+
+    for (auto [n, e] : size_pair) {
+        DdcfParameters param(n, e);
+        param.PrintParameters();
+        DdcfKeyGenerator gen(param);
+        DdcfEvaluator    eval(param);
+
+        // A distinct key and input point per element
+        std::vector<DdcfKey>         keys_0, keys_1;
+        std::vector<uint64_t>        alphas(kBatchSize), beta_1s(kBatchSize), beta_2s(kBatchSize), x(kBatchSize);
+        std::vector<const DdcfKey *> key_ptrs_0(kBatchSize), key_ptrs_1(kBatchSize);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            alphas[i]  = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            beta_1s[i] = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            beta_2s[i] = Mod2N(GlobalRng::Rand<uint64_t>(), e);
+            x[i]       = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            std::pair<DdcfKey, DdcfKey> keys = gen.GenerateKeys(alphas[i], beta_1s[i], beta_2s[i]);
+            keys_0.push_back(std::move(keys.first));
+            keys_1.push_back(std::move(keys.second));
+        }
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            key_ptrs_0[i] = &keys_0[i];
+            key_ptrs_1[i] = &keys_1[i];
+        }
+
+        std::vector<uint64_t> y_0(kBatchSize), y_1(kBatchSize);
+        eval.EvaluateAt(key_ptrs_0, x, y_0);
+        eval.EvaluateAt(key_ptrs_1, x, y_1);
+
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            if (y_0[i] != eval.EvaluateAt(keys_0[i], x[i]) || y_1[i] != eval.EvaluateAt(keys_1[i], x[i]))
+                throw osuCrypto::UnitTestFail("batched EvaluateAt differs from EvaluateAt at index " + ToString(i));
+            uint64_t expected = x[i] < alphas[i] ? beta_1s[i] : beta_2s[i];
+            if (Mod2N(y_0[i] + y_1[i], e) != expected)
+                throw osuCrypto::UnitTestFail("batched EvaluateAt is incorrect at index " + ToString(i));
+        }
+    }
+    Logger::DebugLog(LOC, "Ddcf_EvalAt_Batch_Test - Passed");
+}
+
 void Ddcf_Fde_Test() {
     Logger::DebugLog(LOC, "Ddcf_Fde_Test...");
     const std::vector<std::tuple<uint64_t, uint64_t>> size_pair = {
@@ -4,6 +4,7 @@
 namespace test_ringoa {
 
 void Ddcf_EvalAt_Test();
+void Ddcf_EvalAt_Batch_Test();
 void Ddcf_Fde_Test();
 
 }    // namespace test_ringoa
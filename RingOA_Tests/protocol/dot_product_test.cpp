@@ -0,0 +1,137 @@
+#include "dot_product_test.h"
+
+#include <algorithm>
+
+#include <cryptoTools/Common/TestCollection.h>
+
+#include "RingOA/protocol/dot_product.h"
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/rng.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+
+namespace {
+
+// (database bitsize, number of positions, first position); the ranges start unaligned and wrap
+const std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> kRanges = {
+    {3, 8, 0},
+    {7, 128, 0},
+    {10, 1024, 0},
+    {10, 128, 384},
+    {10, 77, 13},
+    {12, 1000, 3071},
+};
+
+}    // namespace
+
+namespace test_ringoa {
+
+using ringoa::GlobalRng;
+using ringoa::Logger;
+using ringoa::Mod2N;
+using ringoa::ToString;
+using ringoa::proto::DetectDotProductBackend;
+using ringoa::proto::DotProductBackend;
+using ringoa::proto::GetDotProductBackendString;
+using ringoa::proto::kDotProductTileEntries;
+using ringoa::proto::RotatedDotProduct;
+using ringoa::proto::RotatedSelectSum;
+using ringoa::proto::RotatedSelectSumBatch;
+using ringoa::proto::RotatedSelectSumTiled;
+
+void DotProduct_Kernel_Test() {
+    Logger::DebugLog(LOC, "DotProduct_Kernel_Test...");
+    const DotProductBackend detected = DetectDotProductBackend();
+
+    for (auto [d, count, x_begin] : kRanges) {
+        std::vector<uint64_t> database(1ULL << d), values(count), bits((count + 63) / 64);
+        for (auto &x : database)
+            x = GlobalRng::Rand<uint64_t>();
+        for (auto &x : values)
+            x = GlobalRng::Rand<uint64_t>();
+        for (auto &x : bits)
+            x = GlobalRng::Rand<uint64_t>();
+        const uint64_t shift = GlobalRng::Rand<uint64_t>() & ((1ULL << d) - 1);
+
+        // Reference: the per-element loop with modular indexing
+        uint64_t expected_select = 0, expected_dot = 0;
+        for (uint64_t k = 0; k < count; ++k) {
+            const uint64_t entry = database[Mod2N(x_begin + k + shift, d)];
+            expected_select += ((bits[k / 64] >> (k % 64)) & 1ULL) ? entry : 0;
+            expected_dot += entry * values[k];
+        }
+
+        for (DotProductBackend backend : {DotProductBackend::kScalar, DotProductBackend::kAvx2, DotProductBackend::kAvx512}) {
+            if (static_cast<uint8_t>(backend) > static_cast<uint8_t>(detected)) {
+                continue;
+            }
+            if (RotatedSelectSum(backend, database, d, bits.data(), count, x_begin, shift) != expected_select)
+                throw osuCrypto::UnitTestFail("RotatedSelectSum mismatch (" + GetDotProductBackendString(backend) + ", d=" + ToString(d) + ")");
+        }
+        if (RotatedSelectSum(database, d, bits.data(), count, x_begin, shift) != expected_select)
+            throw osuCrypto::UnitTestFail("RotatedSelectSum mismatch (detected backend, d=" + ToString(d) + ")");
+        if (RotatedDotProduct(database, d, values.data(), count, x_begin, shift) != expected_dot)
+            throw osuCrypto::UnitTestFail("RotatedDotProduct mismatch (d=" + ToString(d) + ")");
+    }
+    Logger::DebugLog(LOC, "DotProduct_Kernel_Test - Passed");
+}
+
+void DotProduct_Batch_Test() {
+    Logger::DebugLog(LOC, "DotProduct_Batch_Test...");
+    const DotProductBackend detected = DetectDotProductBackend();
+
+    // One tile, two tiles and several tiles (kDotProductTileEntries = 2^14)
+    for (uint64_t d : {10, 15, 17}) {
+        const uint64_t        size        = 1ULL << d;
+        const uint64_t        num_queries = 5;
+        std::vector<uint64_t> database(size);
+        for (auto &x : database)
+            x = GlobalRng::Rand<uint64_t>();
+
+        // Shifts at both ends of the domain, on a tile boundary and at random
+        std::vector<std::vector<uint64_t>> bits(num_queries, std::vector<uint64_t>(size / 64));
+        std::vector<const uint64_t *>      bits_ptr(num_queries);
+        std::vector<uint64_t>              shifts = {0, size - 1, size / 2, 0, 0};
+        std::vector<uint64_t>              expected(num_queries);
+        shifts[3] = GlobalRng::Rand<uint64_t>() & (size - 1);
+        shifts[4] = GlobalRng::Rand<uint64_t>() & (size - 1);
+        for (uint64_t q = 0; q < num_queries; ++q) {
+            for (auto &x : bits[q])
+                x = GlobalRng::Rand<uint64_t>();
+            bits_ptr[q] = bits[q].data();
+            expected[q] = RotatedSelectSum(DotProductBackend::kScalar, database, d, bits_ptr[q], size, 0, shifts[q]);
+        }
+
+        // Tiles copied from the full selection vectors; every tile of every query is requested once
+        const uint64_t tile_words = std::min(kDotProductTileEntries, size) / 64;
+        auto           expand     = [&](std::span<const uint64_t> queries, std::span<const uint64_t> tiles, std::span<uint64_t *const> outputs) {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                std::copy_n(bits[queries[i]].data() + tiles[i] * tile_words, tile_words, outputs[i]);
+            }
+        };
+
+        for (DotProductBackend backend : {DotProductBackend::kScalar, DotProductBackend::kAvx2, DotProductBackend::kAvx512}) {
+            if (static_cast<uint8_t>(backend) > static_cast<uint8_t>(detected)) {
+                continue;
+            }
+            std::vector<uint64_t> sums(num_queries, ~0ULL);
+            RotatedSelectSumBatch(backend, database, d, bits_ptr, shifts, sums);
+            if (sums != expected)
+                throw osuCrypto::UnitTestFail("RotatedSelectSumBatch mismatch (" + GetDotProductBackendString(backend) + ", d=" + ToString(d) + ")");
+            sums.assign(num_queries, ~0ULL);
+            RotatedSelectSumTiled(backend, database, d, shifts, expand, sums);
+            if (sums != expected)
+                throw osuCrypto::UnitTestFail("RotatedSelectSumTiled mismatch (" + GetDotProductBackendString(backend) + ", d=" + ToString(d) + ")");
+        }
+        std::vector<uint64_t> sums(num_queries);
+        RotatedSelectSumBatch(database, d, bits_ptr, shifts, sums);
+        if (sums != expected)
+            throw osuCrypto::UnitTestFail("RotatedSelectSumBatch mismatch (detected backend, d=" + ToString(d) + ")");
+        RotatedSelectSumTiled(database, d, shifts, expand, sums);
+        if (sums != expected)
+            throw osuCrypto::UnitTestFail("RotatedSelectSumTiled mismatch (detected backend, d=" + ToString(d) + ")");
+    }
+    Logger::DebugLog(LOC, "DotProduct_Batch_Test - Passed");
+}
+
+}    // namespace test_ringoa
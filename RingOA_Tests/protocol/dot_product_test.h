@@ -0,0 +1,11 @@
+#ifndef TESTS_DOT_PRODUCT_TEST_H_
+#define TESTS_DOT_PRODUCT_TEST_H_
+
+namespace test_ringoa {
+
+void DotProduct_Kernel_Test();
+void DotProduct_Batch_Test();
+
+}    // namespace test_ringoa
+
+#endif    // TESTS_DOT_PRODUCT_TEST_H_
@@ -224,4 +224,90 @@ void IntegerComparison_Online_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "IntegerComparison_Online_Test - Passed");
 }
 
+void IntegerComparison_Batch_Online_Test() {
+    Logger::DebugLog(LOC, "IntegerComparison_Batch_Online_Test...");
+    std::vector<IntegerComparisonParameters> params_list = {
+        IntegerComparisonParameters(4, 4),
+        IntegerComparisonParameters(10, 10),
+    };
+    constexpr uint64_t kBatchSize = 16;
+
+    for (const IntegerComparisonParameters &params : params_list) {
+        uint64_t                      n = params.GetParameters().GetInputBitsize();
+        uint64_t                      e = params.GetParameters().GetOutputBitsize();
+        AdditiveSharing2P             ss_in(n);
+        AdditiveSharing2P             ss_out(e);
+        IntegerComparisonKeyGenerator gen(params, ss_in, ss_out);
+        IntegerComparisonEvaluator    eval(params, ss_in, ss_out);
+
+        // A distinct key and input pair per element; both inputs below 2^(n-1) so the
+        // comparison is exact
+        std::vector<IntegerComparisonKey>         keys_0, keys_1;
+        std::vector<const IntegerComparisonKey *> key_ptrs_0(kBatchSize), key_ptrs_1(kBatchSize);
+        std::vector<uint64_t>                     x1(kBatchSize), x2(kBatchSize);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            std::pair<IntegerComparisonKey, IntegerComparisonKey> keys = gen.GenerateKeys();
+            keys_0.push_back(std::move(keys.first));
+            keys_1.push_back(std::move(keys.second));
+            x1[i] = Mod2N(GlobalRng::Rand<uint64_t>(), n - 1);
+            x2[i] = Mod2N(GlobalRng::Rand<uint64_t>(), n - 1);
+        }
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            key_ptrs_0[i] = &keys_0[i];
+            key_ptrs_1[i] = &keys_1[i];
+        }
+        std::pair<std::vector<uint64_t>, std::vector<uint64_t>> x1_sh = ss_in.Share(x1);
+        std::pair<std::vector<uint64_t>, std::vector<uint64_t>> x2_sh = ss_in.Share(x2);
+
+        // Start network communication
+        TwoPartyNetworkManager net_mgr("IntegerComparison_Batch_Online_Test");
+
+        std::vector<uint64_t> y_batch_0, y_batch_1, y_batch;
+        std::vector<uint64_t> y_scalar_0(kBatchSize), y_scalar_1(kBatchSize);
+
+        auto party_task = [&](const uint64_t party_id, oc::Channel &chl) {
+            const std::vector<const IntegerComparisonKey *> &key_ptrs   = party_id == 0 ? key_ptrs_0 : key_ptrs_1;
+            const std::vector<uint64_t>                     &x1_p       = party_id == 0 ? x1_sh.first : x1_sh.second;
+            const std::vector<uint64_t>                     &x2_p       = party_id == 0 ? x2_sh.first : x2_sh.second;
+            std::vector<uint64_t>                           &y_batch_p  = party_id == 0 ? y_batch_0 : y_batch_1;
+            std::vector<uint64_t>                           &y_scalar_p = party_id == 0 ? y_scalar_0 : y_scalar_1;
+
+            eval.EvaluateSharedInput(chl, key_ptrs, x1_p, x2_p, y_batch_p);
+            for (uint64_t i = 0; i < kBatchSize; ++i) {
+                y_scalar_p[i] = eval.EvaluateSharedInput(chl, *key_ptrs[i], x1_p[i], x2_p[i]);
+            }
+            ss_out.Reconst(party_id, chl, y_batch_0, y_batch_1, y_batch);
+        };
+
+        net_mgr.AutoConfigure(
+            -1,
+            [&](oc::Channel &chl) { party_task(0, chl); },
+            [&](oc::Channel &chl) { party_task(1, chl); });
+        net_mgr.WaitForCompletion();
+
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            if (y_batch_0[i] != y_scalar_0[i] || y_batch_1[i] != y_scalar_1[i])
+                throw osuCrypto::UnitTestFail("batched EvaluateSharedInput differs from EvaluateSharedInput at index " + ToString(i));
+            if (y_batch[i] != (x1[i] >= x2[i] ? 1U : 0U))
+                throw osuCrypto::UnitTestFail("batched EvaluateSharedInput is incorrect at index " + ToString(i));
+        }
+
+        // Masked inputs are public, so the batched and scalar paths are compared locally
+        std::vector<uint64_t> x1_masked(kBatchSize), x2_masked(kBatchSize);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            x1_masked[i] = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+            x2_masked[i] = Mod2N(GlobalRng::Rand<uint64_t>(), n);
+        }
+        std::vector<uint64_t> z_0, z_1;
+        eval.EvaluateMaskedInput(key_ptrs_0, x1_masked, x2_masked, z_0);
+        eval.EvaluateMaskedInput(key_ptrs_1, x1_masked, x2_masked, z_1);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            if (z_0[i] != eval.EvaluateMaskedInput(keys_0[i], x1_masked[i], x2_masked[i]) ||
+                z_1[i] != eval.EvaluateMaskedInput(keys_1[i], x1_masked[i], x2_masked[i]))
+                throw osuCrypto::UnitTestFail("batched EvaluateMaskedInput differs from EvaluateMaskedInput at index " + ToString(i));
+        }
+    }
+    Logger::DebugLog(LOC, "IntegerComparison_Batch_Online_Test - Passed");
+}
+
 }    // namespace test_ringoa
@@ -7,6 +7,7 @@ namespace test_ringoa {
 
 void IntegerComparison_Offline_Test();
 void IntegerComparison_Online_Test(const osuCrypto::CLP &cmd);
+void IntegerComparison_Batch_Online_Test();
 
 }    // namespace test_ringoa
 
@@ -179,4 +179,82 @@ void Min3_Online_Test() {
     Logger::DebugLog(LOC, "Min3_Online_Test - Passed");
 }
 
+void Min3_Batch_Online_Test() {
+    Logger::DebugLog(LOC, "Min3_Batch_Online_Test...");
+    std::vector<Min3Parameters> params_list = {
+        Min3Parameters(5),
+    };
+    constexpr uint64_t kBatchSize = 16;
+
+    for (const Min3Parameters &params : params_list) {
+        uint64_t          n = params.GetInputBitsize();
+        uint64_t          e = params.GetOutputBitsize();
+        AdditiveSharing2P ss_in(n);
+        AdditiveSharing2P ss_out(e);
+        Min3KeyGenerator  gen(params, ss_in, ss_out);
+
+        // Triples for the batched run and the scalar run
+        std::string triple_path = kTestEqPath + "min3batch_n" + ToString(n) + "_e" + ToString(e);
+        gen.OfflineSetUp(2 * kBatchSize, triple_path);
+
+        // A distinct key and input triple per element, all below 2^(n-1)
+        std::vector<Min3Key>                 keys_0, keys_1;
+        std::vector<const Min3Key *>         key_ptrs_0(kBatchSize), key_ptrs_1(kBatchSize);
+        std::vector<std::array<uint64_t, 3>> x(kBatchSize), x_0(kBatchSize), x_1(kBatchSize);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            std::pair<Min3Key, Min3Key> keys = gen.GenerateKeys();
+            keys_0.push_back(std::move(keys.first));
+            keys_1.push_back(std::move(keys.second));
+            for (uint64_t j = 0; j < 3; ++j) {
+                x[i][j]                        = Mod2N(GlobalRng::Rand<uint64_t>(), n - 1);
+                std::tie(x_0[i][j], x_1[i][j]) = ss_in.Share(x[i][j]);
+            }
+        }
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            key_ptrs_0[i] = &keys_0[i];
+            key_ptrs_1[i] = &keys_1[i];
+        }
+
+        // Start network communication
+        TwoPartyNetworkManager net_mgr("Min3_Batch_Online_Test");
+
+        std::vector<uint64_t> y_batch_0, y_batch_1, y_batch;
+        std::vector<uint64_t> y_scalar_0(kBatchSize), y_scalar_1(kBatchSize), y_scalar;
+
+        auto party_task = [&](const uint64_t party_id, oc::Channel &chl) {
+            AdditiveSharing2P ss_in_p(n);
+            AdditiveSharing2P ss_out_p(e);
+            Min3Evaluator     eval(params, ss_in_p, ss_out_p);
+            eval.OnlineSetUp(party_id, triple_path);
+
+            const std::vector<const Min3Key *>         &key_ptrs   = party_id == 0 ? key_ptrs_0 : key_ptrs_1;
+            const std::vector<std::array<uint64_t, 3>> &x_p        = party_id == 0 ? x_0 : x_1;
+            std::vector<uint64_t>                      &y_batch_p  = party_id == 0 ? y_batch_0 : y_batch_1;
+            std::vector<uint64_t>                      &y_scalar_p = party_id == 0 ? y_scalar_0 : y_scalar_1;
+
+            eval.EvaluateSharedInput(chl, key_ptrs, x_p, y_batch_p);
+            for (uint64_t i = 0; i < kBatchSize; ++i) {
+                y_scalar_p[i] = eval.EvaluateSharedInput(chl, *key_ptrs[i], x_p[i]);
+            }
+            ss_out_p.Reconst(party_id, chl, y_batch_0, y_batch_1, y_batch);
+            ss_out_p.Reconst(party_id, chl, y_scalar_0, y_scalar_1, y_scalar);
+        };
+
+        net_mgr.AutoConfigure(
+            -1,
+            [&](oc::Channel &chl) { party_task(0, chl); },
+            [&](oc::Channel &chl) { party_task(1, chl); });
+        net_mgr.WaitForCompletion();
+
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            uint64_t min_val = std::min({x[i][0], x[i][1], x[i][2]});
+            if (y_batch[i] != y_scalar[i])
+                throw oc::UnitTestFail("batched EvaluateSharedInput differs from EvaluateSharedInput at index " + ToString(i));
+            if (y_batch[i] != min_val)
+                throw oc::UnitTestFail("y_batch[" + ToString(i) + "] is not equal to " + ToString(min_val));
+        }
+    }
+    Logger::DebugLog(LOC, "Min3_Batch_Online_Test - Passed");
+}
+
 }    // namespace test_ringoa
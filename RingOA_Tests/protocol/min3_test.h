@@ -5,6 +5,7 @@ namespace test_ringoa {
 
 void Min3_Offline_Test();
 void Min3_Online_Test();
+void Min3_Batch_Online_Test();
 
 }    // namespace test_ringoa
 
@@ -13,11 +13,13 @@
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath = ringoa::GetCurrentDirectory();
 const std::string kTestOSPath  = kCurrentPath + "/data/test/protocol/";
+const uint64_t    kBatchSize   = 5;
 
 }    // namespace
 
@@ -117,6 +119,10 @@ void OblivSelect_Offline_Test() {
             for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
                 sh_io.SaveShare(db_path + "_" + ToString(p), database_sh[p]);
             }
+
+            // Batch keys and indices
+            SaveBatchKeys(gen, kTestOSPath + "oskeySAbatch_d" + ToString(d), kBatchSize);
+            SaveBatchIndices(bss, brss, kTestOSPath + "osbatchidx_d" + ToString(d), kBatchSize);
         }
 
         // Generate a random index
@@ -241,17 +247,22 @@ void OblivSelect_ShiftedAdditive_Online_Test(const osuCrypto::CLP &cmd) {
         ShareIo  sh_io;
 
         uint64_t              result{0};
-        std::string           key_path = kTestOSPath + "oskeySA_d" + ToString(d);
-        std::string           db_path  = kTestOSPath + "dbSA_d" + ToString(d);
-        std::string           idx_path = kTestOSPath + "idx_d" + ToString(d);
+        uint64_t              batch_mismatch{0};
+        std::string           key_path  = kTestOSPath + "oskeySA_d" + ToString(d);
+        std::string           db_path   = kTestOSPath + "dbSA_d" + ToString(d);
+        std::string           idx_path  = kTestOSPath + "idx_d" + ToString(d);
+        std::string           bidx_path = kTestOSPath + "osbatchidx_d" + ToString(d);
+        std::string           bkey_path = kTestOSPath + "oskeySAbatch_d" + ToString(d);
         std::vector<uint64_t> database;
         uint64_t              index;
+        std::vector<uint64_t> batch_index;
         file_io.ReadBinary(db_path, database);
         file_io.ReadBinary(idx_path, index);
+        file_io.ReadBinary(bidx_path, batch_index);
 
         // Define the task for each party
         auto MakeTask = [&](int party_id) {
-            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+            return [=, &result, &batch_mismatch](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
                 BinaryReplicatedSharing3P brss(d);
                 OblivSelectEvaluator      eval(params, brss);
                 Channels                  chls(party_id, chl_prev, chl_next);
@@ -260,12 +271,15 @@ void OblivSelect_ShiftedAdditive_Online_Test(const osuCrypto::CLP &cmd) {
                 OblivSelectKey key(party_id, params);
                 KeyIo          key_io;
                 key_io.LoadKey(key_path + "_" + ToString(party_id), key);
+                std::vector<OblivSelectKey> batch_keys = LoadBatchKeys<OblivSelectKey>(params, bkey_path, party_id, kBatchSize);
 
                 // Load data
                 RepShareVec64 database_sh;
                 RepShare64    index_sh;
+                RepShareVec64 batch_index_sh;
                 sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
                 sh_io.LoadShare(idx_path + "_" + ToString(party_id), index_sh);
+                sh_io.LoadShare(bidx_path + "_" + ToString(party_id), batch_index_sh);
 
                 std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
 
@@ -276,10 +290,24 @@ void OblivSelect_ShiftedAdditive_Online_Test(const osuCrypto::CLP &cmd) {
                 RepShare64 result_sh;
                 eval.Evaluate(chls, key, uv_prev, uv_next, RepShareView64(database_sh), index_sh, result_sh);
 
+                std::vector<const OblivSelectKey *> batch_key_ptrs(kBatchSize);
+                RepShareVec64                       batch_result_sh(kBatchSize);
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    batch_key_ptrs[k] = &batch_keys[k];
+                }
+                eval.EvaluateBatch(chls, batch_key_ptrs, uv_prev, uv_next, RepShareView64(database_sh), batch_index_sh, batch_result_sh);
+
                 // Open the result
-                uint64_t local_res1 = 0;
+                uint64_t              local_res1 = 0;
+                std::vector<uint64_t> local_batch_res(kBatchSize);
                 brss.Open(chls, result_sh, local_res1);
-                result = local_res1;
+                brss.Open(chls, batch_result_sh, local_batch_res);
+                uint64_t mismatch = 0;
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    mismatch += local_batch_res[k] != database[batch_index[k]];
+                }
+                result         = local_res1;
+                batch_mismatch = mismatch;
             };
         };
 
@@ -299,6 +327,9 @@ void OblivSelect_ShiftedAdditive_Online_Test(const osuCrypto::CLP &cmd) {
         if (result != database[index])
             throw osuCrypto::UnitTestFail("OblivSelect_ShiftedAdditive_Online_Test failed: result = " + ToString(result) +
                                           ", expected = " + ToString(database[index]));
+        if (batch_mismatch != 0)
+            throw osuCrypto::UnitTestFail("OblivSelect_ShiftedAdditive_Online_Test failed: " + ToString(batch_mismatch) +
+                                          " batched results differ from the database at their indices");
     }
     Logger::DebugLog(LOC, "OblivSelect_ShiftedAdditive_Online_Test - Passed");
 }
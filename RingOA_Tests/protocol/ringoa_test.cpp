@@ -1,7 +1,10 @@
 #include "ringoa_test.h"
 
+#include <algorithm>
+
 #include <cryptoTools/Common/TestCollection.h>
 
+#include "RingOA/protocol/fde_cache.h"
 #include "RingOA/protocol/key_io.h"
 #include "RingOA/protocol/ringoa.h"
 #include "RingOA/protocol/ringoa_fsc.h"
@@ -10,29 +13,37 @@
 #include "RingOA/sharing/binary_2p.h"
 #include "RingOA/sharing/binary_3p.h"
 #include "RingOA/sharing/share_io.h"
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
+#include "RingOA/utils/rng.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath = ringoa::GetCurrentDirectory();
 const std::string kTestOSPath  = kCurrentPath + "/data/test/protocol/";
+const uint64_t    kBatchSize   = 5;
+const uint64_t    kRecordWords = 3;
 
 }    // namespace
 
 namespace test_ringoa {
 
 using ringoa::Channels;
+using ringoa::CoScheduler;
 using ringoa::FileIo;
 using ringoa::Logger;
 using ringoa::Mod2N;
 using ringoa::ThreePartyNetworkManager;
 using ringoa::ToString, ringoa::Format;
 using ringoa::fss::EvalType;
+using ringoa::fss::dpf::DpfEvaluator;
 using ringoa::proto::KeyIo;
 using ringoa::proto::RingOaEvaluator;
+using ringoa::proto::RingOaFdeCache;
 using ringoa::proto::RingOaFscEvaluator;
 using ringoa::proto::RingOaFscKey;
 using ringoa::proto::RingOaFscKeyGenerator;
@@ -45,6 +56,7 @@ using ringoa::sharing::BinaryReplicatedSharing3P;
 using ringoa::sharing::BinarySharing2P;
 using ringoa::sharing::ReplicatedSharing3P;
 using ringoa::sharing::RepShare64, ringoa::sharing::RepShareBlock;
+using ringoa::sharing::RepShareMat64;
 using ringoa::sharing::RepShareVec64, ringoa::sharing::RepShareVecBlock;
 using ringoa::sharing::RepShareView64, ringoa::sharing::RepShareViewBlock;
 using ringoa::sharing::ShareIo;
@@ -53,7 +65,8 @@ void RingOa_Offline_Test() {
     Logger::DebugLog(LOC, "RingOa_Offline_Test...");
     std::vector<RingOaParameters> params_list = {
         RingOaParameters(10),
-        // RingOaParameters(15),
+        RingOaParameters(12, EvalType::kHalfTree),
+        RingOaParameters(15, EvalType::kHalfTree),    // More than one database tile
         // RingOaParameters(20),
     };
 
@@ -109,18 +122,81 @@ void RingOa_Offline_Test() {
             sh_io.SaveShare(idx_path + "_" + ToString(p), index_sh[p]);
         }
 
-        // Offline setup
-        gen.OfflineSetUp(3, kTestOSPath);
+        // Record database: kRecordWords tables of 2^d entries, row w holding (i + w) mod 2^d
+        std::vector<uint64_t> record_db(kRecordWords << d);
+        for (size_t i = 0; i < record_db.size(); ++i) {
+            record_db[i] = Mod2N((i & ((1ULL << d) - 1)) + (i >> d), d);
+        }
+        std::array<RepShareMat64, 3> record_db_sh = rss.ShareLocal(record_db, kRecordWords, 1ULL << d);
+        std::string                  rec_path     = kTestOSPath + "ringoarecdb_d" + ToString(d);
+        file_io.WriteBinary(rec_path, record_db);
+        for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+            sh_io.SaveShare(rec_path + "_" + ToString(p), record_db_sh[p]);
+        }
+
+        // Batch keys and indices
+        SaveBatchKeys(gen, kTestOSPath + "ringoabatchkey_d" + ToString(d), kBatchSize);
+        SaveBatchIndices(ass, rss, kTestOSPath + "ringoabatchidx_d" + ToString(d), kBatchSize);
+
+        // Offline setup (Evaluate, Evaluate_Parallel and EvaluateBatch; EvaluateRecord uses kRecordWords twice)
+        gen.OfflineSetUp(std::max(3 + kBatchSize, 2 * kRecordWords), kTestOSPath);
         rss.OfflineSetUp(kTestOSPath + "prf");
     }
     Logger::DebugLog(LOC, "RingOa_Offline_Test - Passed");
 }
 
+void RingOa_KeyGen_Batch_Test() {
+    Logger::DebugLog(LOC, "RingOa_KeyGen_Batch_Test...");
+    std::vector<RingOaParameters> params_list = {
+        RingOaParameters(10),
+        RingOaParameters(12, EvalType::kHalfTree),
+    };
+    const uint64_t      count = 2 * RingOaKeyGenerator::kKeyGenChunkSize + 5;
+    const ringoa::block seed  = ringoa::GlobalRng::Rand<ringoa::block>();
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t           d = params.GetParameters().GetInputBitsize();
+        AdditiveSharing2P  ass(d);
+        RingOaKeyGenerator gen(params, ass);
+        DpfEvaluator       eval(params.GetParameters());
+
+        // Same caller seed -> same keys, whatever the thread count
+        std::vector<std::array<RingOaKey, 3>> keys, keys_parallel;
+        {
+            ringoa::GlobalRng::ScopedSeed scoped(seed);
+            keys = gen.GenerateKeys(count);
+        }
+        gen.SetNumThreads(4);
+        {
+            ringoa::GlobalRng::ScopedSeed scoped(seed);
+            keys_parallel = gen.GenerateKeys(count);
+        }
+        if (keys.size() != count || keys != keys_parallel)
+            throw osuCrypto::UnitTestFail("Batched RingOA keys depend on the thread count");
+
+        // The DPF of pair p is held by parties p+1 (from prev) and p+2 (from next)
+        for (const auto &triple : keys) {
+            for (uint64_t p = 0; p < 3; ++p) {
+                const RingOaKey &holder_0 = triple[(p + 1) % 3];
+                const RingOaKey &holder_1 = triple[(p + 2) % 3];
+                uint64_t         alpha    = Mod2N(holder_0.rsh_from_prev + holder_1.rsh_from_next, d);
+                uint64_t         other    = Mod2N(alpha + 1, d);
+                if (Mod2N(eval.EvaluateAt(holder_0.key_from_prev, alpha) + eval.EvaluateAt(holder_1.key_from_next, alpha), 1) != 1 ||
+                    Mod2N(eval.EvaluateAt(holder_0.key_from_prev, other) + eval.EvaluateAt(holder_1.key_from_next, other), 1) != 0)
+                    throw osuCrypto::UnitTestFail("Batched RingOA key does not encode its shared index");
+            }
+        }
+    }
+    Logger::DebugLog(LOC, "RingOa_KeyGen_Batch_Test - Passed");
+}
+
 void RingOa_Online_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "RingOa_Online_Test...");
     std::vector<RingOaParameters> params_list = {
         RingOaParameters(10),
-        // RingOaParameters(15),
+        RingOaParameters(12, EvalType::kHalfTree),
+        RingOaParameters(15, EvalType::kHalfTree),    // More than one database tile
         // RingOaParameters(20),
     };
 
@@ -132,17 +208,22 @@ void RingOa_Online_Test(const osuCrypto::CLP &cmd) {
         ShareIo  sh_io;
 
         uint64_t              result{0};
-        std::string           key_path = kTestOSPath + "ringoakey_d" + ToString(d);
-        std::string           db_path  = kTestOSPath + "ringoadb_d" + ToString(d);
-        std::string           idx_path = kTestOSPath + "ringoaidx_d" + ToString(d);
+        uint64_t              batch_mismatch{0};
+        std::string           key_path  = kTestOSPath + "ringoakey_d" + ToString(d);
+        std::string           db_path   = kTestOSPath + "ringoadb_d" + ToString(d);
+        std::string           idx_path  = kTestOSPath + "ringoaidx_d" + ToString(d);
+        std::string           bidx_path = kTestOSPath + "ringoabatchidx_d" + ToString(d);
+        std::string           bkey_path = kTestOSPath + "ringoabatchkey_d" + ToString(d);
         std::vector<uint64_t> database;
         uint64_t              index;
+        std::vector<uint64_t> batch_index;
         file_io.ReadBinary(db_path, database);
         file_io.ReadBinary(idx_path, index);
+        file_io.ReadBinary(bidx_path, batch_index);
 
         // Define the task for each party
         auto MakeTask = [&](int party_id) {
-            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+            return [=, &result, &batch_mismatch](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
                 ReplicatedSharing3P rss(d);
                 AdditiveSharing2P   ass_prev(d);
                 AdditiveSharing2P   ass_next(d);
@@ -153,12 +234,15 @@ void RingOa_Online_Test(const osuCrypto::CLP &cmd) {
                 RingOaKey key(party_id, params);
                 KeyIo     key_io;
                 key_io.LoadKey(key_path + "_" + ToString(party_id), key);
+                std::vector<RingOaKey> batch_keys = LoadBatchKeys<RingOaKey>(params, bkey_path, party_id, kBatchSize);
 
                 // Load data
                 RepShareVec64 database_sh;
                 RepShare64    index_sh;
+                RepShareVec64 batch_index_sh;
                 sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
                 sh_io.LoadShare(idx_path + "_" + ToString(party_id), index_sh);
+                sh_io.LoadShare(bidx_path + "_" + ToString(party_id), batch_index_sh);
 
                 std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
 
@@ -175,14 +259,27 @@ void RingOa_Online_Test(const osuCrypto::CLP &cmd) {
                 index_vec_sh.Set(1, index_sh);
                 eval.Evaluate_Parallel(chls, key, key, uv_prev, uv_next, RepShareView64(database_sh), index_vec_sh, result_vec_sh);
 
+                std::vector<const RingOaKey *> batch_key_ptrs(kBatchSize);
+                RepShareVec64                  batch_result_sh(kBatchSize);
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    batch_key_ptrs[k] = &batch_keys[k];
+                }
+                eval.EvaluateBatch(chls, batch_key_ptrs, uv_prev, uv_next, RepShareView64(database_sh), batch_index_sh, batch_result_sh);
+
                 // Open the result
                 uint64_t              local_res = 0;
-                std::vector<uint64_t> local_res_vec(2);
+                std::vector<uint64_t> local_res_vec(2), local_batch_res(kBatchSize);
 
                 rss.Open(chls, result_sh, local_res);
                 rss.Open(chls, result_vec_sh, local_res_vec);
+                rss.Open(chls, batch_result_sh, local_batch_res);
                 Logger::DebugLog(LOC, "result_vec_sh: " + ToString(local_res_vec));
-                result = local_res;
+                uint64_t mismatch = 0;
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    mismatch += local_batch_res[k] != database[batch_index[k]];
+                }
+                result         = local_res;
+                batch_mismatch = mismatch;
             };
         };
 
@@ -202,10 +299,430 @@ void RingOa_Online_Test(const osuCrypto::CLP &cmd) {
         if (result != database[index])
             throw osuCrypto::UnitTestFail("RingOa_Online_Test failed: result = " + ToString(result) +
                                           ", expected = " + ToString(database[index]));
+        if (batch_mismatch != 0)
+            throw osuCrypto::UnitTestFail("RingOa_Online_Test failed: " + ToString(batch_mismatch) +
+                                          " batched results differ from the database at their indices");
     }
     Logger::DebugLog(LOC, "RingOa_Online_Test - Passed");
 }
 
+void RingOa_FdeCache_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "RingOa_FdeCache_Online_Test...");
+    std::vector<RingOaParameters> params_list = {
+        RingOaParameters(10),
+        RingOaParameters(12, EvalType::kHalfTree),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetParameters().GetInputBitsize();
+        uint64_t nu = params.GetParameters().GetTerminateBitsize();
+        FileIo   file_io;
+        ShareIo  sh_io;
+
+        std::array<uint64_t, 3> results{};
+        uint64_t                cache_errors{0};
+        std::string             key_path = kTestOSPath + "ringoakey_d" + ToString(d);
+        std::string             db_path  = kTestOSPath + "ringoadb_d" + ToString(d);
+        std::string             idx_path = kTestOSPath + "ringoaidx_d" + ToString(d);
+        std::vector<uint64_t>   database;
+        uint64_t                index;
+        file_io.ReadBinary(db_path, database);
+        file_io.ReadBinary(idx_path, index);
+
+        // Define the task for each party
+        auto MakeTask = [&](int party_id) {
+            return [=, &results, &cache_errors](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d);
+                AdditiveSharing2P   ass_next(d);
+                RingOaEvaluator     eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load keys
+                RingOaKey key(party_id, params);
+                KeyIo     key_io;
+                key_io.LoadKey(key_path + "_" + ToString(party_id), key);
+
+                // Load data
+                RepShareVec64 database_sh;
+                RepShare64    index_sh;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
+                sh_io.LoadShare(idx_path + "_" + ToString(party_id), index_sh);
+
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+                const RingOaKey           *keys[] = {&key};
+
+                // Setup the PRF keys
+                eval.OnlineSetUp(party_id, kTestOSPath);
+                rss.OnlineSetUp(party_id, kTestOSPath + "prf");
+
+                // 1. Offline precomputation: the entry is consumed by the evaluation
+                RingOaFdeCache sync_cache(params, 2 * (1ULL << nu) * sizeof(ringoa::block));
+                eval.SetFdeCache(&sync_cache);
+                if (sync_cache.Precompute(keys) != 1 || sync_cache.GetNumEntries() != 1)
+                    ++cache_errors;
+                std::array<RepShare64, 3> result_sh;
+                eval.Evaluate(chls, key, uv_prev, uv_next, RepShareView64(database_sh), index_sh, result_sh[0]);
+                if (sync_cache.GetNumEntries() != 0)
+                    ++cache_errors;
+
+                // 2. Background precomputation
+                RingOaFdeCache async_cache(params, 4 * sync_cache.GetEntryBytes(), true);
+                eval.SetFdeCache(&async_cache);
+                async_cache.Precompute(keys);
+                eval.Evaluate(chls, key, uv_prev, uv_next, RepShareView64(database_sh), index_sh, result_sh[1]);
+
+                // 3. Budget below one entry: nothing is cached, evaluation expands online
+                RingOaFdeCache small_cache(params, sync_cache.GetEntryBytes() - 1);
+                eval.SetFdeCache(&small_cache);
+                if (small_cache.Precompute(keys) != 0)
+                    ++cache_errors;
+                eval.Evaluate(chls, key, uv_prev, uv_next, RepShareView64(database_sh), index_sh, result_sh[2]);
+                eval.SetFdeCache(nullptr);
+
+                // Open the results
+                for (size_t i = 0; i < result_sh.size(); ++i) {
+                    uint64_t local_res = 0;
+                    rss.Open(chls, result_sh[i], local_res);
+                    results[i] = local_res;
+                }
+            };
+        };
+
+        // Create tasks for each party
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        // Configure network based on party ID and wait for completion
+        int party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Results: " + ToString(results[0]) + ", " + ToString(results[1]) + ", " + ToString(results[2]));
+
+        for (uint64_t result : results) {
+            if (result != database[index])
+                throw osuCrypto::UnitTestFail("RingOa_FdeCache_Online_Test failed: result = " + ToString(result) +
+                                              ", expected = " + ToString(database[index]));
+        }
+        if (cache_errors != 0)
+            throw osuCrypto::UnitTestFail("RingOa_FdeCache_Online_Test failed: unexpected cache occupancy");
+    }
+    Logger::DebugLog(LOC, "RingOa_FdeCache_Online_Test - Passed");
+}
+
+void RingOa_FdeCache_Clear_Test() {
+    Logger::DebugLog(LOC, "RingOa_FdeCache_Clear_Test...");
+    RingOaParameters   params(10);
+    uint64_t           d  = params.GetParameters().GetInputBitsize();
+    uint64_t           nu = params.GetParameters().GetTerminateBitsize();
+    AdditiveSharing2P  ass(d);
+    RingOaKeyGenerator gen(params, ass);
+
+    std::vector<std::array<RingOaKey, 3>> keys       = gen.GenerateKeys(3);
+    const RingOaKey                      *all_keys[] = {&keys[0][0], &keys[1][0], &keys[2][0]};
+    const RingOaKey                      *keys_01[]  = {&keys[0][0], &keys[1][0]};
+
+    // Two slots, both cached; key 0 is acquired when the cache is cleared
+    RingOaFdeCache cache(params, 2 * (2 * (1ULL << nu) * sizeof(ringoa::block)));
+    if (cache.GetNumSlots() != 2 || cache.Precompute(keys_01) != 2)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: initial precompute");
+    const RingOaFdeCache::Entry *entry = cache.Acquire(keys[0][0]);
+    if (entry == nullptr)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: key 0 not cached");
+    const std::vector<ringoa::block> uv_prev = entry->uv_prev;
+
+    cache.Clear();
+    if (cache.GetNumEntries() != 0 || cache.Acquire(keys[0][0]) != nullptr)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: entries left after Clear");
+    if (entry->key != &keys[0][0] || !entry->ready || entry->uv_prev != uv_prev)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: acquired entry invalidated by Clear");
+
+    // Only key 1's slot is free until the acquired entry is released
+    if (cache.Precompute(keys_01) != 1)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: acquired slot reused");
+    cache.Release(entry);
+    if (cache.GetNumEntries() != 1)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: Release dropped the re-cached key");
+    const RingOaFdeCache::Entry *recached = cache.Acquire(keys[0][0]);
+    if (recached == nullptr || recached == entry || recached->uv_prev != uv_prev)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: re-cached key 0");
+    cache.Release(recached);
+
+    // Each slot is on the free list once: three keys fit in two slots only
+    if (cache.Precompute(all_keys) != 2 || cache.GetNumEntries() != 2)
+        throw osuCrypto::UnitTestFail("RingOa_FdeCache_Clear_Test failed: slot freed twice");
+    Logger::DebugLog(LOC, "RingOa_FdeCache_Clear_Test - Passed");
+}
+
+void RingOa_Record_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "RingOa_Record_Online_Test...");
+    std::vector<RingOaParameters> params_list = {
+        RingOaParameters(10),
+        RingOaParameters(12, EvalType::kHalfTree),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetParameters().GetInputBitsize();
+        uint64_t nu = params.GetParameters().GetTerminateBitsize();
+        FileIo   file_io;
+        ShareIo  sh_io;
+
+        // Record read with output buffers, and without (leaves consumed as they are expanded)
+        std::array<std::vector<uint64_t>, 2> results;
+        std::string                          key_path = kTestOSPath + "ringoakey_d" + ToString(d);
+        std::string                          rec_path = kTestOSPath + "ringoarecdb_d" + ToString(d);
+        std::string                          idx_path = kTestOSPath + "ringoaidx_d" + ToString(d);
+        std::vector<uint64_t>                record_db;
+        uint64_t                             index;
+        file_io.ReadBinary(rec_path, record_db);
+        file_io.ReadBinary(idx_path, index);
+
+        // Define the task for each party
+        auto MakeTask = [&](int party_id) {
+            return [=, &results](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d);
+                AdditiveSharing2P   ass_next(d);
+                RingOaEvaluator     eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load keys
+                RingOaKey key(party_id, params);
+                KeyIo     key_io;
+                key_io.LoadKey(key_path + "_" + ToString(party_id), key);
+
+                // Load data
+                RepShareMat64 record_db_sh;
+                RepShare64    index_sh;
+                sh_io.LoadShare(rec_path + "_" + ToString(party_id), record_db_sh);
+                sh_io.LoadShare(idx_path + "_" + ToString(party_id), index_sh);
+
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu), no_prev, no_next;
+
+                // Setup the PRF keys
+                eval.OnlineSetUp(party_id, kTestOSPath);
+                rss.OnlineSetUp(party_id, kTestOSPath + "prf");
+
+                // Evaluate
+                std::array<RepShareVec64, 2> result_sh;
+                eval.EvaluateRecord(chls, key, uv_prev, uv_next, record_db_sh, index_sh, result_sh[0]);
+                eval.EvaluateRecord(chls, key, no_prev, no_next, record_db_sh, index_sh, result_sh[1]);
+
+                // Open the results
+                for (size_t i = 0; i < result_sh.size(); ++i) {
+                    std::vector<uint64_t> local_res;
+                    rss.Open(chls, result_sh[i], local_res);
+                    results[i] = local_res;
+                }
+            };
+        };
+
+        // Create tasks for each party
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        // Configure network based on party ID and wait for completion
+        int party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Results: " + ToString(results[0]) + ", " + ToString(results[1]));
+
+        std::vector<uint64_t> expected(kRecordWords);
+        for (uint64_t w = 0; w < kRecordWords; ++w) {
+            expected[w] = record_db[(w << d) + index];
+        }
+        for (const auto &result : results) {
+            if (result != expected)
+                throw osuCrypto::UnitTestFail("RingOa_Record_Online_Test failed: result = " + ToString(result) +
+                                              ", expected = " + ToString(expected));
+        }
+    }
+    Logger::DebugLog(LOC, "RingOa_Record_Online_Test - Passed");
+}
+
+void RingOa_Pipelined_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "RingOa_Pipelined_Online_Test...");
+    std::vector<RingOaParameters> params_list = {
+        RingOaParameters(10),
+        RingOaParameters(12, EvalType::kHalfTree),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetParameters().GetInputBitsize();
+        uint64_t nu = params.GetParameters().GetTerminateBitsize();
+        FileIo   file_io;
+        ShareIo  sh_io;
+
+        std::vector<uint64_t> results;
+        std::string           db_path   = kTestOSPath + "ringoadb_d" + ToString(d);
+        std::string           bidx_path = kTestOSPath + "ringoabatchidx_d" + ToString(d);
+        std::string           bkey_path = kTestOSPath + "ringoabatchkey_d" + ToString(d);
+        std::vector<uint64_t> database;
+        std::vector<uint64_t> batch_index;
+        file_io.ReadBinary(db_path, database);
+        file_io.ReadBinary(bidx_path, batch_index);
+
+        // Define the task for each party
+        auto MakeTask = [&](int party_id) {
+            return [=, &results](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d);
+                AdditiveSharing2P   ass_next(d);
+                RingOaEvaluator     eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load keys
+                std::vector<RingOaKey> batch_keys = LoadBatchKeys<RingOaKey>(params, bkey_path, party_id, kBatchSize);
+
+                // Load data
+                RepShareVec64 database_sh;
+                RepShareVec64 batch_index_sh;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
+                sh_io.LoadShare(bidx_path + "_" + ToString(party_id), batch_index_sh);
+
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+
+                // Setup the PRF keys
+                eval.OnlineSetUp(party_id, kTestOSPath);
+                rss.OnlineSetUp(party_id, kTestOSPath + "prf");
+
+                // Evaluate kBatchSize accesses, more than the default pipeline depth
+                std::vector<const RingOaKey *> keys(kBatchSize);
+                RepShareVec64                  result_vec_sh(kBatchSize);
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    keys[k] = &batch_keys[k];
+                }
+                eval.EvaluatePipelined(chls, keys, uv_prev, uv_next, RepShareView64(database_sh), batch_index_sh, result_vec_sh);
+
+                // Open the results
+                std::vector<uint64_t> local_res;
+                rss.Open(chls, result_vec_sh, local_res);
+                results = local_res;
+            };
+        };
+
+        // Create tasks for each party
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        // Configure network based on party ID and wait for completion
+        int party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Results: " + ToString(results));
+
+        std::vector<uint64_t> expected(kBatchSize);
+        for (uint64_t k = 0; k < kBatchSize; ++k) {
+            expected[k] = database[batch_index[k]];
+        }
+        if (results != expected)
+            throw osuCrypto::UnitTestFail("RingOa_Pipelined_Online_Test failed: result = " + ToString(results) +
+                                          ", expected = " + ToString(expected));
+    }
+    Logger::DebugLog(LOC, "RingOa_Pipelined_Online_Test - Passed");
+}
+
+void RingOa_Co_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "RingOa_Co_Online_Test...");
+    std::vector<RingOaParameters> params_list = {
+        RingOaParameters(10),
+        RingOaParameters(12, EvalType::kHalfTree),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetParameters().GetInputBitsize();
+        uint64_t nu = params.GetParameters().GetTerminateBitsize();
+        FileIo   file_io;
+        ShareIo  sh_io;
+
+        std::vector<uint64_t> results;
+        std::string           db_path   = kTestOSPath + "ringoadb_d" + ToString(d);
+        std::string           bidx_path = kTestOSPath + "ringoabatchidx_d" + ToString(d);
+        std::string           bkey_path = kTestOSPath + "ringoabatchkey_d" + ToString(d);
+        std::vector<uint64_t> database;
+        std::vector<uint64_t> batch_index;
+        file_io.ReadBinary(db_path, database);
+        file_io.ReadBinary(bidx_path, batch_index);
+
+        // Define the task for each party
+        auto MakeTask = [&](int party_id) {
+            return [=, &results](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d);
+                AdditiveSharing2P   ass_next(d);
+                RingOaEvaluator     eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load keys
+                std::vector<RingOaKey> batch_keys = LoadBatchKeys<RingOaKey>(params, bkey_path, party_id, kBatchSize);
+
+                // Load data
+                RepShareVec64 database_sh;
+                RepShareVec64 batch_index_sh;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
+                sh_io.LoadShare(bidx_path + "_" + ToString(party_id), batch_index_sh);
+
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+
+                // Setup the PRF keys
+                eval.OnlineSetUp(party_id, kTestOSPath);
+                rss.OnlineSetUp(party_id, kTestOSPath + "prf");
+
+                // Run kBatchSize sessions, fewer of them in flight than in total
+                RepShareVec64           result_vec_sh(kBatchSize);
+                std::vector<RepShare64> result_sh(kBatchSize);
+                CoScheduler             sched;
+                sched.Run(kBatchSize, kBatchSize / 2 + 1, [&](uint64_t k) {
+                    return eval.EvaluateCo(sched, chls, batch_keys[k], uv_prev, uv_next, RepShareView64(database_sh), batch_index_sh.At(k), result_sh[k]);
+                });
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    result_vec_sh.Set(k, result_sh[k]);
+                }
+
+                // Open the results
+                std::vector<uint64_t> local_res;
+                rss.Open(chls, result_vec_sh, local_res);
+                results = local_res;
+            };
+        };
+
+        // Create tasks for each party
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        // Configure network based on party ID and wait for completion
+        int party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Results: " + ToString(results));
+
+        std::vector<uint64_t> expected(kBatchSize);
+        for (uint64_t k = 0; k < kBatchSize; ++k) {
+            expected[k] = database[batch_index[k]];
+        }
+        if (results != expected)
+            throw osuCrypto::UnitTestFail("RingOa_Co_Online_Test failed: result = " + ToString(results) +
+                                          ", expected = " + ToString(expected));
+    }
+    Logger::DebugLog(LOC, "RingOa_Co_Online_Test - Passed");
+}
+
 void RingOa_Fsc_Offline_Test() {
     Logger::DebugLog(LOC, "RingOa_Fsc_Offline_Test...");
     std::vector<RingOaFscParameters> params_list = {
@@ -6,7 +6,13 @@
 namespace test_ringoa {
 
 void RingOa_Offline_Test();
+void RingOa_KeyGen_Batch_Test();
 void RingOa_Online_Test(const osuCrypto::CLP &cmd);
+void RingOa_FdeCache_Online_Test(const osuCrypto::CLP &cmd);
+void RingOa_FdeCache_Clear_Test();
+void RingOa_Record_Online_Test(const osuCrypto::CLP &cmd);
+void RingOa_Pipelined_Online_Test(const osuCrypto::CLP &cmd);
+void RingOa_Co_Online_Test(const osuCrypto::CLP &cmd);
 void RingOa_Fsc_Offline_Test();
 void RingOa_Fsc_Online_Test(const osuCrypto::CLP &cmd);
 
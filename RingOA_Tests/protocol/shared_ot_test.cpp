@@ -13,11 +13,13 @@
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath = ringoa::GetCurrentDirectory();
 const std::string kTestOSPath  = kCurrentPath + "/data/test/protocol/";
+const uint64_t    kBatchSize   = 5;
 
 }    // namespace
 
@@ -49,6 +51,7 @@ void SharedOt_Offline_Test() {
     std::vector<SharedOtParameters> params_list = {
         SharedOtParameters(10),
         SharedOtParameters(11, EvalType::kIterative),
+        SharedOtParameters(12, EvalType::kHalfTree),
         // SharedOtParameters(15),
         // SharedOtParameters(20),
     };
@@ -105,6 +108,10 @@ void SharedOt_Offline_Test() {
             sh_io.SaveShare(idx_path + "_" + ToString(p), index_sh[p]);
         }
 
+        // Batch keys and indices
+        SaveBatchKeys(gen, kTestOSPath + "sharedotbatchkey_d" + ToString(d), kBatchSize);
+        SaveBatchIndices(ass, rss, kTestOSPath + "sharedotbatchidx_d" + ToString(d), kBatchSize);
+
         // Offline setup
         rss.OfflineSetUp(kTestOSPath + "prf");
     }
@@ -116,6 +123,7 @@ void SharedOt_Online_Test(const osuCrypto::CLP &cmd) {
     std::vector<SharedOtParameters> params_list = {
         SharedOtParameters(10),
         SharedOtParameters(11, EvalType::kIterative),
+        SharedOtParameters(12, EvalType::kHalfTree),
         // SharedOtParameters(15),
         // SharedOtParameters(20),
     };
@@ -127,17 +135,22 @@ void SharedOt_Online_Test(const osuCrypto::CLP &cmd) {
         ShareIo  sh_io;
 
         uint64_t              result{0};
-        std::string           key_path = kTestOSPath + "sharedotkey_d" + ToString(d);
-        std::string           db_path  = kTestOSPath + "sharedotdb_d" + ToString(d);
-        std::string           idx_path = kTestOSPath + "sharedotidx_d" + ToString(d);
+        uint64_t              batch_mismatch{0};
+        std::string           key_path  = kTestOSPath + "sharedotkey_d" + ToString(d);
+        std::string           db_path   = kTestOSPath + "sharedotdb_d" + ToString(d);
+        std::string           idx_path  = kTestOSPath + "sharedotidx_d" + ToString(d);
+        std::string           bidx_path = kTestOSPath + "sharedotbatchidx_d" + ToString(d);
+        std::string           bkey_path = kTestOSPath + "sharedotbatchkey_d" + ToString(d);
         std::vector<uint64_t> database;
         uint64_t              index;
+        std::vector<uint64_t> batch_index;
         file_io.ReadBinary(db_path, database);
         file_io.ReadBinary(idx_path, index);
+        file_io.ReadBinary(bidx_path, batch_index);
 
         // Define the task for each party
         auto MakeTask = [&](int party_id) {
-            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+            return [=, &result, &batch_mismatch](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
                 ReplicatedSharing3P rss(d);
                 SharedOtEvaluator   eval(params, rss);
                 Channels            chls(party_id, chl_prev, chl_next);
@@ -146,12 +159,15 @@ void SharedOt_Online_Test(const osuCrypto::CLP &cmd) {
                 SharedOtKey key(party_id, params);
                 KeyIo       key_io;
                 key_io.LoadKey(key_path + "_" + ToString(party_id), key);
+                std::vector<SharedOtKey> batch_keys = LoadBatchKeys<SharedOtKey>(params, bkey_path, party_id, kBatchSize);
 
                 // Load data
                 RepShareVec64 database_sh;
                 RepShare64    index_sh;
+                RepShareVec64 batch_index_sh;
                 sh_io.LoadShare(db_path + "_" + ToString(party_id), database_sh);
                 sh_io.LoadShare(idx_path + "_" + ToString(party_id), index_sh);
+                sh_io.LoadShare(bidx_path + "_" + ToString(party_id), batch_index_sh);
 
                 std::vector<uint64_t> uv_prev(1U << d), uv_next(1U << d);
 
@@ -162,10 +178,24 @@ void SharedOt_Online_Test(const osuCrypto::CLP &cmd) {
                 RepShare64 result_sh;
                 eval.Evaluate(chls, key, uv_prev, uv_next, RepShareView64(database_sh), index_sh, result_sh);
 
+                std::vector<const SharedOtKey *> batch_key_ptrs(kBatchSize);
+                RepShareVec64                    batch_result_sh(kBatchSize);
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    batch_key_ptrs[k] = &batch_keys[k];
+                }
+                eval.EvaluateBatch(chls, batch_key_ptrs, uv_prev, uv_next, RepShareView64(database_sh), batch_index_sh, batch_result_sh);
+
                 // Open the result
-                uint64_t local_res1 = 0;
+                uint64_t              local_res1 = 0;
+                std::vector<uint64_t> local_batch_res(kBatchSize);
                 rss.Open(chls, result_sh, local_res1);
-                result = local_res1;
+                rss.Open(chls, batch_result_sh, local_batch_res);
+                uint64_t mismatch = 0;
+                for (uint64_t k = 0; k < kBatchSize; ++k) {
+                    mismatch += local_batch_res[k] != database[batch_index[k]];
+                }
+                result         = local_res1;
+                batch_mismatch = mismatch;
             };
         };
 
@@ -185,6 +215,9 @@ void SharedOt_Online_Test(const osuCrypto::CLP &cmd) {
         if (result != database[index])
             throw osuCrypto::UnitTestFail("SharedOt_Online_Test failed: result = " + ToString(result) +
                                           ", expected = " + ToString(database[index]));
+        if (batch_mismatch != 0)
+            throw osuCrypto::UnitTestFail("SharedOt_Online_Test failed: " + ToString(batch_mismatch) +
+                                          " batched results differ from the database at their indices");
     }
     Logger::DebugLog(LOC, "SharedOt_Online_Test - Passed");
 }
@@ -6,6 +6,7 @@
 #include "RingOA/utils/file_io.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
+#include "RingOA/utils/rng.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
 
@@ -19,7 +20,9 @@ const std::string kTestAdditivePath = kCurrentPath + "/data/test/ss/";
 namespace test_ringoa {
 
 using ringoa::FileIo;
+using ringoa::GlobalRng;
 using ringoa::Logger;
+using ringoa::Mod2N;
 using ringoa::ToString;
 using ringoa::TwoPartyNetworkManager;
 using ringoa::sharing::AdditiveSharing2P;
@@ -437,4 +440,79 @@ void Additive2P_EvaluateSelect_Online_Test() {
     Logger::DebugLog(LOC, "Additive2P_EvaluateSelect_Online_Test - Passed");
 }
 
+void Additive2P_Batch_Online_Test() {
+    Logger::DebugLog(LOC, "Additive2P_Batch_Online_Test...");
+    constexpr uint64_t kBatchSize = 16;
+
+    for (const uint64_t bitsize : kBitsizes) {
+        AdditiveSharing2P ss(bitsize);
+
+        // One triple per element for each of the batched and scalar Mult and Select runs
+        std::string triple_path = kTestAdditivePath + "triple_batch_n" + ToString(bitsize);
+        ss.OfflineSetUp(4 * kBatchSize, triple_path);
+
+        // Distinct inputs per element; c is a bit
+        std::vector<uint64_t> x(kBatchSize), y(kBatchSize), c(kBatchSize);
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            x[i] = Mod2N(GlobalRng::Rand<uint64_t>(), bitsize);
+            y[i] = Mod2N(GlobalRng::Rand<uint64_t>(), bitsize);
+            c[i] = GlobalRng::Rand<uint64_t>() & 1;
+        }
+        std::pair<std::vector<uint64_t>, std::vector<uint64_t>> x_sh = ss.Share(x);
+        std::pair<std::vector<uint64_t>, std::vector<uint64_t>> y_sh = ss.Share(y);
+        std::pair<std::vector<uint64_t>, std::vector<uint64_t>> c_sh = ss.Share(c);
+
+        // Start network communication
+        TwoPartyNetworkManager net_mgr("Additive2P_Batch_Test");
+
+        std::vector<uint64_t> mult_batch_0, mult_batch_1, mult_batch;
+        std::vector<uint64_t> mult_scalar_0(kBatchSize), mult_scalar_1(kBatchSize), mult_scalar;
+        std::vector<uint64_t> sel_batch_0, sel_batch_1, sel_batch;
+        std::vector<uint64_t> sel_scalar_0(kBatchSize), sel_scalar_1(kBatchSize), sel_scalar;
+
+        auto party_task = [&](const uint64_t party_id, osuCrypto::Channel &chl) {
+            AdditiveSharing2P ss_p(bitsize);
+            ss_p.OnlineSetUp(party_id, triple_path);
+
+            const std::vector<uint64_t> &x_p           = party_id == 0 ? x_sh.first : x_sh.second;
+            const std::vector<uint64_t> &y_p           = party_id == 0 ? y_sh.first : y_sh.second;
+            const std::vector<uint64_t> &c_p           = party_id == 0 ? c_sh.first : c_sh.second;
+            std::vector<uint64_t>       &mult_batch_p  = party_id == 0 ? mult_batch_0 : mult_batch_1;
+            std::vector<uint64_t>       &mult_scalar_p = party_id == 0 ? mult_scalar_0 : mult_scalar_1;
+            std::vector<uint64_t>       &sel_batch_p   = party_id == 0 ? sel_batch_0 : sel_batch_1;
+            std::vector<uint64_t>       &sel_scalar_p  = party_id == 0 ? sel_scalar_0 : sel_scalar_1;
+
+            // Evaluate Mult and Select, batched and one element at a time
+            ss_p.EvaluateMult(party_id, chl, x_p, y_p, mult_batch_p);
+            ss_p.EvaluateSelect(party_id, chl, x_p, y_p, c_p, sel_batch_p);
+            for (uint64_t i = 0; i < kBatchSize; ++i) {
+                ss_p.EvaluateMult(party_id, chl, x_p[i], y_p[i], mult_scalar_p[i]);
+                ss_p.EvaluateSelect(party_id, chl, x_p[i], y_p[i], c_p[i], sel_scalar_p[i]);
+            }
+
+            // Reconstruct
+            ss_p.Reconst(party_id, chl, mult_batch_0, mult_batch_1, mult_batch);
+            ss_p.Reconst(party_id, chl, mult_scalar_0, mult_scalar_1, mult_scalar);
+            ss_p.Reconst(party_id, chl, sel_batch_0, sel_batch_1, sel_batch);
+            ss_p.Reconst(party_id, chl, sel_scalar_0, sel_scalar_1, sel_scalar);
+        };
+
+        // Configure network based on party ID and wait for completion
+        net_mgr.AutoConfigure(
+            -1,
+            [&](osuCrypto::Channel &chl) { party_task(0, chl); },
+            [&](osuCrypto::Channel &chl) { party_task(1, chl); });
+        net_mgr.WaitForCompletion();
+
+        // Validate the result element by element
+        for (uint64_t i = 0; i < kBatchSize; ++i) {
+            if (mult_batch[i] != mult_scalar[i] || mult_batch[i] != Mod2N(x[i] * y[i], bitsize))
+                throw osuCrypto::UnitTestFail("batched EvaluateMult failed at index " + ToString(i));
+            if (sel_batch[i] != sel_scalar[i] || sel_batch[i] != (c[i] ? y[i] : x[i]))
+                throw osuCrypto::UnitTestFail("batched EvaluateSelect failed at index " + ToString(i));
+        }
+    }
+    Logger::DebugLog(LOC, "Additive2P_Batch_Online_Test - Passed");
+}
+
 }    // namespace test_ringoa
@@ -9,6 +9,7 @@ void Additive2P_EvaluateMult_Offline_Test();
 void Additive2P_EvaluateMult_Online_Test();
 void Additive2P_EvaluateSelect_Offline_Test();
 void Additive2P_EvaluateSelect_Online_Test();
+void Additive2P_Batch_Online_Test();
 
 }    // namespace test_ringoa
 
@@ -0,0 +1,61 @@
+#ifndef TESTS_TEST_COMMON_H_
+#define TESTS_TEST_COMMON_H_
+
+#include <string>
+#include <vector>
+
+#include "RingOA/protocol/key_io.h"
+#include "RingOA/sharing/share_io.h"
+#include "RingOA/sharing/share_types.h"
+#include "RingOA/utils/file_io.h"
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/to_string.h"
+
+namespace test_ringoa {
+
+// Batched tests use a distinct key triple (and index) per batched access, so that a result
+// taken from the wrong key or index does not go unnoticed. Keys are saved as <path>_<k>_<party>.
+template <typename KeyGenerator>
+void SaveBatchKeys(KeyGenerator &gen, const std::string &path, const uint64_t batch_size) {
+    ringoa::proto::KeyIo key_io;
+    for (uint64_t k = 0; k < batch_size; ++k) {
+        auto keys = gen.GenerateKeys();
+        for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+            key_io.SaveKey(path + "_" + ringoa::ToString(k) + "_" + ringoa::ToString(p), keys[p]);
+        }
+    }
+}
+
+// This party's batch_size keys saved by SaveBatchKeys.
+template <typename Key, typename Params>
+std::vector<Key> LoadBatchKeys(const Params &params, const std::string &path, const uint64_t party_id, const uint64_t batch_size) {
+    ringoa::proto::KeyIo key_io;
+    std::vector<Key>     keys;
+    keys.reserve(batch_size);
+    for (uint64_t k = 0; k < batch_size; ++k) {
+        keys.emplace_back(party_id, params);
+        key_io.LoadKey(path + "_" + ringoa::ToString(k) + "_" + ringoa::ToString(party_id), keys.back());
+    }
+    return keys;
+}
+
+// batch_size random indices from ss, saved in plaintext at 'path' and shared by rss at <path>_<party>.
+template <typename Sharing2P, typename Sharing3P>
+void SaveBatchIndices(Sharing2P &ss, Sharing3P &rss, const std::string &path, const uint64_t batch_size) {
+    ringoa::FileIo           file_io;
+    ringoa::sharing::ShareIo sh_io;
+    std::vector<uint64_t>    batch_index(batch_size);
+    for (uint64_t k = 0; k < batch_size; ++k) {
+        batch_index[k] = ss.GenerateRandomValue();
+    }
+    ringoa::Logger::DebugLog(LOC, "Batch indices: " + ringoa::ToString(batch_index));
+    auto batch_index_sh = rss.ShareLocal(batch_index);
+    file_io.WriteBinary(path, batch_index);
+    for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+        sh_io.SaveShare(path + "_" + ringoa::ToString(p), batch_index_sh[p]);
+    }
+}
+
+}    // namespace test_ringoa
+
+#endif    // TESTS_TEST_COMMON_H_
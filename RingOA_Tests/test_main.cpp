@@ -10,6 +10,7 @@
 #include "RingOA_Tests/fss/dpf_test.h"
 #include "RingOA_Tests/fss/prg_test.h"
 #include "RingOA_Tests/protocol/ddcf_test.h"
+#include "RingOA_Tests/protocol/dot_product_test.h"
 #include "RingOA_Tests/protocol/dpf_pir_test.h"
 #include "RingOA_Tests/protocol/equality_test.h"
 #include "RingOA_Tests/protocol/integer_comparison_test.h"
@@ -24,6 +25,7 @@
 #include "RingOA_Tests/sharing/binary_3p_test.h"
 #include "RingOA_Tests/utils/file_io_test.h"
 #include "RingOA_Tests/utils/network_test.h"
+#include "RingOA_Tests/utils/seq_io_test.h"
 #include "RingOA_Tests/utils/timer_test.h"
 #include "RingOA_Tests/utils/utils_test.h"
 #include "RingOA_Tests/wm/oquantile_test.h"
@@ -34,20 +36,35 @@ namespace test_ringoa {
 
 void RegisterUtilsTests(osuCrypto::TestCollection &t) {
     t.add("Utils_Test", Utils_Test);
+    t.add("ThreadPool_Nested_Test", ThreadPool_Nested_Test);
+    t.add("CoScheduler_Error_Test", CoScheduler_Error_Test);
     t.add("Timer_Test", Timer_Test);
     t.add("Network_TwoPartyManager_Test", Network_TwoPartyManager_Test);
     t.add("Network_ThreePartyManager_Test", Network_ThreePartyManager_Test);
+    t.add("Network_ThreePartyWorkers_Test", Network_ThreePartyWorkers_Test);
     t.add("File_Io_Test", File_Io_Test);
+    t.add("SeqIo_Fasta_Test", SeqIo_Fasta_Test);
 }
 
 void RegisterFssTests(osuCrypto::TestCollection &t) {
     t.add("Prg_Test", Prg_Test);
+    t.add("Prg_Backend_Test", Prg_Backend_Test);
     t.add("Dpf_Params_Test", Dpf_Params_Test);
     t.add("Dpf_EvalAt_Test", Dpf_EvalAt_Test);
+    t.add("Dpf_EvalAt_Batch_Test", Dpf_EvalAt_Batch_Test);
     t.add("Dpf_Fde_Test", Dpf_Fde_Test);
     t.add("Dpf_Fde_One_Test", Dpf_Fde_One_Test);
+    t.add("Dpf_Fde_Parallel_Test", Dpf_Fde_Parallel_Test);
+    t.add("Dpf_Fde_Concurrent_Test", Dpf_Fde_Concurrent_Test);
+    t.add("Dpf_Fde_MultiKey_Test", Dpf_Fde_MultiKey_Test);
+    t.add("Dpf_Fde_Stream_Test", Dpf_Fde_Stream_Test);
+    t.add("Dpf_Specialized_Test", Dpf_Specialized_Test);
+    t.add("Dpf_Gen_Batch_Test", Dpf_Gen_Batch_Test);
+    t.add("Dpf_Key_Serialize_Test", Dpf_Key_Serialize_Test);
     t.add("Dcf_EvalAt_Test", Dcf_EvalAt_Test);
     t.add("Dcf_Fde_Test", Dcf_Fde_Test);
+    t.add("Dcf_EvalAt_Batch_Test", Dcf_EvalAt_Batch_Test);
+    t.add("Dcf_Key_Serialize_Test", Dcf_Key_Serialize_Test);
 }
 
 void RegisterSharingTests(osuCrypto::TestCollection &t) {
@@ -57,6 +74,7 @@ void RegisterSharingTests(osuCrypto::TestCollection &t) {
     t.add("Additive2P_EvaluateMult_Online_Test", Additive2P_EvaluateMult_Online_Test);
     t.add("Additive2P_EvaluateSelect_Offline_Test", Additive2P_EvaluateSelect_Offline_Test);
     t.add("Additive2P_EvaluateSelect_Online_Test", Additive2P_EvaluateSelect_Online_Test);
+    t.add("Additive2P_Batch_Online_Test", Additive2P_Batch_Online_Test);
     t.add("Binary2P_EvaluateXor_Offline_Test", Binary2P_EvaluateXor_Offline_Test);
     t.add("Binary2P_EvaluateXor_Online_Test", Binary2P_EvaluateXor_Online_Test);
     t.add("Binary2P_EvaluateAnd_Offline_Test", Binary2P_EvaluateAnd_Offline_Test);
@@ -75,6 +93,7 @@ void RegisterSharingTests(osuCrypto::TestCollection &t) {
 
 void RegisterProtocolTests(osuCrypto::TestCollection &t) {
     t.add("Ddcf_EvalAt_Test", Ddcf_EvalAt_Test);
+    t.add("Ddcf_EvalAt_Batch_Test", Ddcf_EvalAt_Batch_Test);
     t.add("Ddcf_Fde_Test", Ddcf_Fde_Test);
     t.add("ZeroTest_Offline_Test", ZeroTest_Offline_Test);
     t.add("ZeroTest_Online_Test", ZeroTest_Online_Test);
@@ -82,8 +101,12 @@ void RegisterProtocolTests(osuCrypto::TestCollection &t) {
     t.add("Equality_Online_Test", Equality_Online_Test);
     t.add("IntegerComparison_Offline_Test", IntegerComparison_Offline_Test);
     t.add("IntegerComparison_Online_Test", IntegerComparison_Online_Test);
+    t.add("IntegerComparison_Batch_Online_Test", IntegerComparison_Batch_Online_Test);
     t.add("Min3_Offline_Test", Min3_Offline_Test);
     t.add("Min3_Online_Test", Min3_Online_Test);
+    t.add("Min3_Batch_Online_Test", Min3_Batch_Online_Test);
+    t.add("DotProduct_Kernel_Test", DotProduct_Kernel_Test);
+    t.add("DotProduct_Batch_Test", DotProduct_Batch_Test);
     t.add("DpfPir_Naive_Offline_Test", DpfPir_Naive_Offline_Test);
     t.add("DpfPir_Naive_Online_Test", DpfPir_Naive_Online_Test);
     t.add("DpfPir_Offline_Test", DpfPir_Offline_Test);
@@ -94,24 +117,37 @@ void RegisterProtocolTests(osuCrypto::TestCollection &t) {
     t.add("SharedOt_Offline_Test", SharedOt_Offline_Test);
     t.add("SharedOt_Online_Test", SharedOt_Online_Test);
     t.add("RingOa_Offline_Test", RingOa_Offline_Test);
+    t.add("RingOa_KeyGen_Batch_Test", RingOa_KeyGen_Batch_Test);
     t.add("RingOa_Online_Test", RingOa_Online_Test);
+    t.add("RingOa_FdeCache_Online_Test", RingOa_FdeCache_Online_Test);
+    t.add("RingOa_FdeCache_Clear_Test", RingOa_FdeCache_Clear_Test);
+    t.add("RingOa_Record_Online_Test", RingOa_Record_Online_Test);
+    t.add("RingOa_Pipelined_Online_Test", RingOa_Pipelined_Online_Test);
+    t.add("RingOa_Co_Online_Test", RingOa_Co_Online_Test);
     t.add("RingOa_Fsc_Offline_Test", RingOa_Fsc_Offline_Test);
     t.add("RingOa_Fsc_Online_Test", RingOa_Fsc_Online_Test);
 }
 
 void RegisterWmTests(osuCrypto::TestCollection &t) {
+    t.add("BitVector_RankSelect_Test", BitVector_RankSelect_Test);
     t.add("WaveletMatrix_Access_Test", WaveletMatrix_Access_Test);
     t.add("WaveletMatrix_Quantile_Test", WaveletMatrix_Quantile_Test);
     t.add("WaveletMatrix_RangeFreqTest", WaveletMatrix_RangeFreqTest);
     t.add("WaveletMatrix_TopK_Test", WaveletMatrix_TopK_Test);
     t.add("WaveletMatrix_RankCF_Test", WaveletMatrix_RankCF_Test);
+    t.add("WaveletMatrix_Packed_Test", WaveletMatrix_Packed_Test);
     t.add("FMIndex_Test", FMIndex_Test);
+    t.add("FMIndex_Build_Test", FMIndex_Build_Test);
+    t.add("FMIndex_OccTable_Test", FMIndex_OccTable_Test);
     t.add("OWM_Offline_Test", OWM_Offline_Test);
     t.add("OWM_Online_Test", OWM_Online_Test);
+    t.add("OWM_Pipelined_Online_Test", OWM_Pipelined_Online_Test);
     t.add("OWM_Fsc_Offline_Test", OWM_Fsc_Offline_Test);
     t.add("OWM_Fsc_Online_Test", OWM_Fsc_Online_Test);
     t.add("OQuantile_Offline_Test", OQuantile_Offline_Test);
     t.add("OQuantile_Online_Test", OQuantile_Online_Test);
+    t.add("OQuantile_Co_Online_Test", OQuantile_Co_Online_Test);
+    t.add("OQuantile_Key_Legacy_Test", OQuantile_Key_Legacy_Test);
     t.add("OQuantile_Fsc_Offline_Test", OQuantile_Fsc_Offline_Test);
     t.add("OQuantile_Fsc_Online_Test", OQuantile_Fsc_Online_Test);
 }
@@ -121,6 +157,10 @@ void RegisterFmIndexTests(osuCrypto::TestCollection &t) {
     t.add("SotFMI_Online_Test", SotFMI_Online_Test);
     t.add("OFMI_Offline_Test", OFMI_Offline_Test);
     t.add("OFMI_Online_Test", OFMI_Online_Test);
+    t.add("OFMI_Pipelined_Online_Test", OFMI_Pipelined_Online_Test);
+    t.add("OFMI_Batch_Online_Test", OFMI_Batch_Online_Test);
+    t.add("OFMI_Co_Online_Test", OFMI_Co_Online_Test);
+    t.add("OFMI_Key_Legacy_Test", OFMI_Key_Legacy_Test);
     t.add("OFMI_Fsc_Offline_Test", OFMI_Fsc_Offline_Test);
     t.add("OFMI_Fsc_Online_Test", OFMI_Fsc_Online_Test);
 }
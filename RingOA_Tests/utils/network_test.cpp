@@ -1,5 +1,7 @@
 #include "network_test.h"
 
+#include <array>
+
 #include <cryptoTools/Common/TestCollection.h>
 
 #include "RingOA/utils/logger.h"
@@ -7,13 +9,16 @@
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA/utils/worker_dispatcher.h"
 
 namespace test_ringoa {
 
+using ringoa::Channels;
 using ringoa::Logger;
 using ringoa::ThreePartyNetworkManager;
 using ringoa::ToString;
 using ringoa::TwoPartyNetworkManager;
+using ringoa::WorkerDispatcher;
 
 void Network_TwoPartyManager_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "Network_Manager_Test...");
@@ -322,4 +327,52 @@ void Network_ThreePartyManager_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "Network_ThreePartyManager_Test - Passed");
 }
 
+void Network_ThreePartyWorkers_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "Network_ThreePartyWorkers_Test...");
+
+    const uint64_t num_workers = 3;
+    const uint64_t num_queries = 10;
+
+    // received[p][q]: value for query q that party p received from its previous party
+    std::array<std::vector<uint64_t>, 3> received;
+    std::array<std::vector<uint64_t>, 3> worker_of;
+
+    auto MakeTask = [&](int party_id) {
+        return [&, party_id](std::vector<Channels> &chls) {
+            received[party_id].assign(num_queries, 0);
+            worker_of[party_id].assign(num_queries, num_workers);
+            WorkerDispatcher dispatcher(chls);
+            dispatcher.Dispatch(num_queries, [&](uint64_t w, Channels &chl, uint64_t begin, uint64_t end) {
+                for (uint64_t q = begin; q < end; ++q) {
+                    uint64_t value = party_id * 1000 + q;
+                    chl.next.send(value);
+                    chl.prev.recv(received[party_id][q]);
+                    worker_of[party_id][q] = w;
+                }
+            });
+        };
+    };
+
+    ThreePartyNetworkManager net_mgr;
+    int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+    net_mgr.AutoConfigureWorkers(party_id, num_workers, MakeTask(0), MakeTask(1), MakeTask(2));
+    net_mgr.WaitForCompletion();
+
+    for (int p = 0; p < 3; ++p) {
+        if (party_id >= 0 && p != party_id)
+            continue;
+        uint64_t prev = (p + 2) % 3;
+        for (uint64_t q = 0; q < num_queries; ++q) {
+            auto [begin, end] = WorkerDispatcher::GetShard(num_queries, num_workers, worker_of[p][q]);
+            if (q < begin || q >= end)
+                throw osuCrypto::UnitTestFail("Party " + ToString(p) + " ran query " + ToString(q) + " on the wrong worker");
+            if (received[p][q] != prev * 1000 + q)
+                throw osuCrypto::UnitTestFail("Party " + ToString(p) + " received " + ToString(received[p][q]) +
+                                              " for query " + ToString(q) + ", expected " + ToString(prev * 1000 + q));
+        }
+    }
+
+    Logger::DebugLog(LOC, "Network_ThreePartyWorkers_Test - Passed");
+}
+
 }    // namespace test_ringoa
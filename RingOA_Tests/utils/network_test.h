@@ -7,6 +7,7 @@ namespace test_ringoa {
 
 void Network_TwoPartyManager_Test(const osuCrypto::CLP &cmd);
 void Network_ThreePartyManager_Test(const osuCrypto::CLP &cmd);
+void Network_ThreePartyWorkers_Test(const osuCrypto::CLP &cmd);
 
 }    // namespace test_ringoa
 
@@ -0,0 +1,91 @@
+#include "seq_io_test.h"
+
+#include <cctype>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <cryptoTools/Common/TestCollection.h>
+
+#include "RingOA/utils/logger.h"
+#include "RingOA/utils/seq_io.h"
+#include "RingOA/utils/to_string.h"
+#include "RingOA/utils/utils.h"
+
+namespace {
+
+const std::string kCurrentPath   = ringoa::GetCurrentDirectory();
+const std::string kTestSeqIoPath = kCurrentPath + "/data/test/utils/";
+
+// Line-by-line reading, as ReadFastaSequence did before it was memory-mapped
+std::string ReadFastaByLine(const std::string &contents) {
+    std::istringstream in(contents);
+    std::string        seq, line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '>')
+            continue;
+        for (unsigned char ch : line)
+            seq.push_back(static_cast<char>(std::toupper(ch)));
+    }
+    return seq;
+}
+
+void WriteFile(const std::string &path, const std::string &contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+}    // namespace
+
+namespace test_ringoa {
+
+using ringoa::Logger;
+using ringoa::ToString;
+
+void SeqIo_Fasta_Test() {
+    Logger::DebugLog(LOC, "SeqIo_Fasta_Test...");
+
+    // Several records, lowercase and soft-masked runs, CRLF and blank lines, lines shorter
+    // and longer than a 32-byte vector, and no newline at the end of the file
+    std::mt19937_64 rng(17);
+    std::string     fasta;
+    for (int record = 0; record < 5; ++record) {
+        fasta += ">chr" + ToString(record) + " test record\n";
+        for (int line = 0; line < 40; ++line) {
+            size_t len = (line % 7 == 0) ? 0 : 1 + rng() % 90;
+            for (size_t i = 0; i < len; ++i)
+                fasta += "ACGTNacgtn"[rng() % 10];
+            fasta += (line % 3 == 0) ? "\r\n" : "\n";
+        }
+    }
+    fasta += "ACGTacgt";
+    const std::string expected = ReadFastaByLine(fasta);
+
+    const std::string path = kTestSeqIoPath + "seq_io_test.fa";
+    WriteFile(path, fasta);
+    for (uint64_t num_threads : {1, 2, 3, 7, 1000}) {
+        if (ringoa::ReadFastaSequence(path, num_threads) != expected)
+            throw osuCrypto::UnitTestFail("FASTA mismatch (threads=" + ToString(num_threads) + ")");
+    }
+
+    const std::string empty_path = kTestSeqIoPath + "seq_io_empty.fa";
+    WriteFile(empty_path, "");
+    if (!ringoa::ReadFastaSequence(empty_path, 4).empty())
+        throw osuCrypto::UnitTestFail("Empty FASTA should give an empty sequence");
+
+    // The loader appends files in order and hands out prefixes of the concatenation
+    const std::string second_path = kTestSeqIoPath + "seq_io_test2.fa";
+    WriteFile(second_path, ">second\nggccaatt\n");
+    ringoa::ChromosomeLoader loader({path, second_path}, 3);
+    const std::string        all = expected + "GGCCAATT";
+    if (loader.EnsurePrefix(10) != all.substr(0, 10) || loader.loaded_count() != 1)
+        throw osuCrypto::UnitTestFail("ChromosomeLoader prefix mismatch");
+    if (loader.EnsurePrefixView(all.size()) != all || !loader.exhausted())
+        throw osuCrypto::UnitTestFail("ChromosomeLoader full prefix mismatch");
+
+    Logger::DebugLog(LOC, "SeqIo_Fasta_Test - Passed");
+}
+
+}    // namespace test_ringoa
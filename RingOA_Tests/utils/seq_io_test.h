@@ -0,0 +1,10 @@
+#ifndef TESTS_SEQ_IO_TEST_H_
+#define TESTS_SEQ_IO_TEST_H_
+
+namespace test_ringoa {
+
+void SeqIo_Fasta_Test();
+
+}    // namespace test_ringoa
+
+#endif    // TESTS_SEQ_IO_TEST_H_
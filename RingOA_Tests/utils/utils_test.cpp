@@ -1,8 +1,15 @@
 #include "utils_test.h"
 
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
 #include <cryptoTools/Common/TestCollection.h>
 
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
 
@@ -11,6 +18,32 @@ namespace {
 const std::string kCurrentPath    = ringoa::GetCurrentDirectory();
 const std::string kTestFileIoPath = kCurrentPath + "/data/test/utils/";
 
+ringoa::CoTask YieldingSession(ringoa::CoScheduler &sched, uint64_t &completed) {
+    co_await sched.Yield();
+    co_await sched.Yield();
+    ++completed;
+}
+
+ringoa::CoTask FailingReceiveSession(ringoa::CoScheduler &sched) {
+    std::promise<void> recv;
+    recv.set_exception(std::make_exception_ptr(std::runtime_error("receive failed")));
+    co_await sched.Wait(recv.get_future());
+}
+
+// Stands in for an asyncRecv into the session frame that lands after the other sessions failed
+ringoa::CoTask SlowReceiveSession(ringoa::CoScheduler &sched, std::thread &receiver, std::atomic<bool> &landed) {
+    uint64_t           buf = 0;
+    std::promise<void> recv;
+    std::future<void>  f = recv.get_future();
+    receiver             = std::thread([&buf, &landed, recv = std::move(recv)]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        buf    = 1;
+        landed = true;
+        recv.set_value();
+    });
+    co_await sched.Wait(std::move(f));
+}
+
 }    // namespace
 
 namespace test_ringoa {
@@ -104,4 +137,99 @@ void Utils_Test() {
     Logger::DebugLog(LOC, "Utils_Test - Passed");
 }
 
+void ThreadPool_Nested_Test() {
+    Logger::DebugLog(LOC, "ThreadPool_Nested_Test...");
+
+    // Every task re-enters the pool twice; with all workers inside a task this deadlocked
+    // before nested loops ran inline
+    ringoa::ThreadPool    pool(4);
+    std::atomic<uint64_t> sum{0};
+    for (int round = 0; round < 50; ++round) {
+        pool.ParallelFor(8, [&](uint64_t i) {
+            pool.ParallelFor(8, [&](uint64_t j) {
+                pool.ParallelFor(4, [&](uint64_t k) { sum += i * 32 + j * 4 + k; });
+            });
+        });
+    }
+    const uint64_t expected = 50 * (255 * 256 / 2);
+    if (sum != expected)
+        throw osuCrypto::UnitTestFail("Nested ParallelFor sum = " + ToString(sum.load()) + ", expected " + ToString(expected));
+
+    // Two pools whose tasks call into each other: with every worker of both pools waiting
+    // on the other pool, this deadlocked when only same-pool nesting ran inline
+    ringoa::ThreadPool other(4);
+    sum = 0;
+    for (int round = 0; round < 50; ++round) {
+        pool.ParallelFor(8, [&](uint64_t i) {
+            other.ParallelFor(8, [&](uint64_t j) {
+                pool.ParallelFor(4, [&](uint64_t k) { sum += i * 32 + j * 4 + k; });
+            });
+        });
+        other.ParallelFor(8, [&](uint64_t i) {
+            pool.ParallelFor(32, [&](uint64_t j) { sum += i * 32 + j; });
+        });
+    }
+    const uint64_t expected_cross = 2 * expected;
+    if (sum != expected_cross)
+        throw osuCrypto::UnitTestFail("Cross-pool ParallelFor sum = " + ToString(sum.load()) + ", expected " + ToString(expected_cross));
+
+    Logger::DebugLog(LOC, "ThreadPool_Nested_Test - Passed");
+}
+
+void CoScheduler_Error_Test() {
+    Logger::DebugLog(LOC, "CoScheduler_Error_Test...");
+
+    // Each failure leaves sessions suspended; the next Run must start from an empty scheduler
+    ringoa::CoScheduler sched;
+    uint64_t            completed         = 0;
+    auto                expect_clean_fail = [&](const std::string &name, const std::function<ringoa::CoTask(uint64_t)> &make_session) {
+        bool threw = false;
+        try {
+            sched.Run(4, 3, make_session);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        if (!threw)
+            throw osuCrypto::UnitTestFail("CoScheduler::Run did not rethrow the " + name + " failure");
+
+        completed = 0;
+        sched.Run(4, 3, [&](uint64_t) { return YieldingSession(sched, completed); });
+        if (completed != 4)
+            throw osuCrypto::UnitTestFail("Run after a " + name + " failure completed " + ToString(completed) + " of 4 sessions");
+    };
+
+    // make_session throws while sessions 0 and 1 wait to start
+    expect_clean_fail("make_session", [&](uint64_t s) -> ringoa::CoTask {
+        if (s == 2)
+            throw std::runtime_error("make_session failed");
+        return YieldingSession(sched, completed);
+    });
+    // Session 2's receive fails while sessions 0 and 1 are suspended
+    expect_clean_fail("receive", [&](uint64_t s) {
+        return s == 2 ? FailingReceiveSession(sched) : YieldingSession(sched, completed);
+    });
+
+    // Session 0's receive fails while session 1 still has a receive in flight into its frame:
+    // Run must not destroy that frame before the receive lands
+    std::thread       receiver;
+    std::atomic<bool> landed{false};
+    bool              threw = false;
+    try {
+        sched.Run(3, 3, [&](uint64_t s) {
+            if (s == 0)
+                return FailingReceiveSession(sched);
+            return s == 1 ? SlowReceiveSession(sched, receiver, landed) : YieldingSession(sched, completed);
+        });
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    const bool landed_on_return = landed;
+    if (receiver.joinable())
+        receiver.join();
+    if (!threw || !landed_on_return)
+        throw osuCrypto::UnitTestFail("CoScheduler::Run returned before a pending receive landed");
+
+    Logger::DebugLog(LOC, "CoScheduler_Error_Test - Passed");
+}
+
 }    // namespace test_ringoa
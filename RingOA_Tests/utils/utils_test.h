@@ -4,6 +4,8 @@
 namespace test_ringoa {
 
 void Utils_Test();
+void ThreadPool_Nested_Test();
+void CoScheduler_Error_Test();
 
 }    // namespace test_ringoa
 
@@ -8,6 +8,7 @@
 #include "RingOA/sharing/additive_2p.h"
 #include "RingOA/sharing/additive_3p.h"
 #include "RingOA/sharing/share_io.h"
+#include "RingOA/utils/coro.h"
 #include "RingOA/utils/logger.h"
 #include "RingOA/utils/network.h"
 #include "RingOA/utils/timer.h"
@@ -16,12 +17,14 @@
 #include "RingOA/wm/oquantile.h"
 #include "RingOA/wm/oquantile_fsc.h"
 #include "RingOA/wm/plain_wm.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath       = ringoa::GetCurrentDirectory();
 const std::string kTestOQuantilePath = kCurrentPath + "/data/test/wm/";
 const uint64_t    kFixedSeed         = 6;
+const uint64_t    kQuantileQueries   = 3;
 
 std::vector<uint64_t> GenerateRandomVector(size_t length, uint64_t sigma) {
     if (length == 0)
@@ -35,11 +38,55 @@ std::vector<uint64_t> GenerateRandomVector(size_t length, uint64_t sigma) {
     return result;
 }
 
+template <typename T>
+void AppendBytes(const T &value, std::vector<uint8_t> &buffer) {
+    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t *>(&value), reinterpret_cast<const uint8_t *>(&value) + sizeof(T));
+}
+
+// Legacy DPF key form (one byte per control bit), as written before DpfKey was packed
+void AppendLegacyDpfKey(const ringoa::fss::dpf::DpfKey &key, std::vector<uint8_t> &buffer) {
+    AppendBytes(key.party_id, buffer);
+    AppendBytes(key.init_seed, buffer);
+    AppendBytes(key.cw_length, buffer);
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        AppendBytes(key.cw_seed[i], buffer);
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        buffer.push_back(key.GetControlLeft(i));
+    for (uint64_t i = 0; i < key.cw_length; ++i)
+        buffer.push_back(key.GetControlRight(i));
+    AppendBytes(key.output, buffer);
+}
+
+void AppendLegacyRingOaKey(const ringoa::proto::RingOaKey &key, std::vector<uint8_t> &buffer) {
+    AppendBytes(key.party_id, buffer);
+    AppendLegacyDpfKey(key.key_from_prev, buffer);
+    AppendLegacyDpfKey(key.key_from_next, buffer);
+    AppendBytes(key.rsh_from_prev, buffer);
+    AppendBytes(key.rsh_from_next, buffer);
+    AppendBytes(key.wsh_from_prev, buffer);
+    AppendBytes(key.wsh_from_next, buffer);
+}
+
+// IntegerComparison key as written before DCF keys terminated early: the DCF key has n levels
+// of (seed, two control bytes, value) and a 64-bit output
+void AppendLegacyIcKey(const ringoa::proto::IntegerComparisonKey &key, const uint64_t n, std::vector<uint8_t> &buffer) {
+    const ringoa::fss::dcf::DcfKey &dcf_key = key.ddcf_key.dcf_key;
+    AppendBytes(dcf_key.party_id, buffer);
+    AppendBytes(dcf_key.init_seed, buffer);
+    AppendBytes(n, buffer);
+    buffer.resize(buffer.size() + (sizeof(ringoa::block) + 2 + sizeof(uint64_t)) * n, 0);
+    AppendBytes(uint64_t{0}, buffer);
+    AppendBytes(key.ddcf_key.mask, buffer);
+    AppendBytes(key.shr1_in, buffer);
+    AppendBytes(key.shr2_in, buffer);
+}
+
 }    // namespace
 
 namespace test_ringoa {
 
 using ringoa::Channels;
+using ringoa::CoScheduler;
 using ringoa::FileIo;
 using ringoa::Logger;
 using ringoa::ThreePartyNetworkManager;
@@ -116,8 +163,24 @@ void OQuantile_Offline_Test() {
             sh_io.SaveShare(q_arg_path + "_" + ToString(p), q_arg_sh[p]);
         }
 
+        // Batch keys and queries: a (left, right, k) per session
+        SaveBatchKeys(gen, kTestOQuantilePath + "oquantilebatchkey_d" + ToString(d), kQuantileQueries);
+        std::vector<uint64_t> batch_q_arg(3 * kQuantileQueries);
+        std::string           bq_arg_path = kTestOQuantilePath + "batchquery_d" + ToString(d);
+        for (uint64_t q = 0; q < kQuantileQueries; ++q) {
+            batch_q_arg[3 * q]     = 100 + 20 * q;    // left
+            batch_q_arg[3 * q + 1] = 150 + 30 * q;    // right
+            batch_q_arg[3 * q + 2] = 49 - 10 * q;     // k
+        }
+        Logger::DebugLog(LOC, "Batch (left, right, k): " + ToString(batch_q_arg));
+        std::array<RepShareVec64, 3> batch_q_arg_sh = rss.ShareLocal(batch_q_arg);
+        file_io.WriteBinary(bq_arg_path, batch_q_arg);
+        for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+            sh_io.SaveShare(bq_arg_path + "_" + ToString(p), batch_q_arg_sh[p]);
+        }
+
         // Offline setup
-        gen.OfflineSetUp(kTestOQuantilePath);
+        gen.OfflineSetUp(kTestOQuantilePath, kQuantileQueries);
         rss.OfflineSetUp(kTestOQuantilePath + "prf");
     }
     Logger::DebugLog(LOC, "OQuantile_Offline_Test - Passed");
@@ -212,6 +275,142 @@ void OQuantile_Online_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "OQuantile_Online_Test - Passed");
 }
 
+void OQuantile_Co_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "OQuantile_Co_Online_Test...");
+    std::vector<OQuantileParameters> params_list = {
+        OQuantileParameters(10, 7),
+        // OQuantileParameters(15),
+        // OQuantileParameters(20),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetDatabaseBitSize();
+        uint64_t s  = params.GetShareSize();
+        uint64_t nu = params.GetOaParameters().GetParameters().GetTerminateBitsize();
+
+        FileIo file_io;
+
+        std::vector<uint64_t> result;
+        std::string           key_path   = kTestOQuantilePath + "oquantilebatchkey_d" + ToString(d);
+        std::string           db_path    = kTestOQuantilePath + "db_d" + ToString(d);
+        std::string           q_arg_path = kTestOQuantilePath + "batchquery_d" + ToString(d);
+
+        std::vector<uint64_t> database;
+        std::vector<uint64_t> q_arg;
+        file_io.ReadBinary(db_path, database);
+        file_io.ReadBinary(q_arg_path, q_arg);
+
+        // Create a task factory that captures everything needed by value,
+        // and captures `result` and `sh_io` by reference.
+        auto MakeTask = [&](int party_id) {
+            return [=, &result](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                // Set up replicated sharing and evaluator for this party
+                ReplicatedSharing3P rss(s);
+                AdditiveSharing2P   ass_prev(s), ass_next(s);
+                OQuantileEvaluator  eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load this party's key for each session
+                std::vector<OQuantileKey> keys = LoadBatchKeys<OQuantileKey>(params, key_path, party_id, kQuantileQueries);
+
+                // Load this party's shares of the database and query
+                RepShareMat64 db_sh;
+                RepShareVec64 q_arg_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), db_sh);
+                sh_io.LoadShare(q_arg_path + "_" + ToString(party_id), q_arg_sh);
+
+                // Perform the PRF setup step
+                eval.OnlineSetUp(party_id, kTestOQuantilePath);
+                rss.OnlineSetUp(party_id, kTestOQuantilePath + "prf");
+
+                // Run kQuantileQueries queries as interleaved sessions
+                std::vector<RepShare64>    result_sh(kQuantileQueries);
+                RepShareVec64              result_vec_sh(kQuantileQueries);
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+                CoScheduler                sched;
+                sched.Run(kQuantileQueries, kQuantileQueries - 1, [&](uint64_t q) {
+                    return eval.EvaluateQuantile_Co(sched, chls, keys[q], uv_prev, uv_next,
+                                                    db_sh, q_arg_sh.At(3 * q), q_arg_sh.At(3 * q + 1), q_arg_sh.At(3 * q + 2), result_sh[q]);
+                });
+                for (uint64_t q = 0; q < kQuantileQueries; ++q) {
+                    result_vec_sh.Set(q, result_sh[q]);
+                }
+
+                // Open the resulting shares to recover the final values
+                rss.Open(chls, result_vec_sh, result);
+            };
+        };
+
+        // Instantiate tasks for parties 0, 1, and 2
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Result: " + ToString(result));
+
+        // Verify against the plain-wavelet-matrix rank computation
+        WaveletMatrix         wm(database, params.GetSigma());
+        std::vector<uint64_t> expected_result(kQuantileQueries);
+        for (uint64_t q = 0; q < kQuantileQueries; ++q) {
+            expected_result[q] = wm.Quantile(q_arg[3 * q], q_arg[3 * q + 1], q_arg[3 * q + 2]);
+        }
+        if (result != expected_result) {
+            throw osuCrypto::UnitTestFail(
+                "OQuantile_Co_Online_Test failed: result = " + ToString(result) +
+                ", expected = " + ToString(expected_result));
+        }
+    }
+
+    Logger::DebugLog(LOC, "OQuantile_Co_Online_Test - Passed");
+}
+
+void OQuantile_Key_Legacy_Test() {
+    Logger::DebugLog(LOC, "OQuantile_Key_Legacy_Test...");
+    OQuantileParameters params(10, 7);
+    params.PrintParameters();
+    uint64_t                    s = params.GetShareSize();
+    AdditiveSharing2P           ass(s);
+    ReplicatedSharing3P         rss(s);
+    OQuantileKeyGenerator       gen(params, ass, rss);
+    std::array<OQuantileKey, 3> keys = gen.GenerateKeys();
+
+    for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+        // Container layout written before this series: legacy DPF keys and full-depth DCF keys
+        std::vector<uint8_t> legacy;
+        AppendBytes(keys[p].num_oa_keys, legacy);
+        AppendBytes(keys[p].num_ic_keys, legacy);
+        for (const auto &oa_key : keys[p].oa_keys)
+            AppendLegacyRingOaKey(oa_key, legacy);
+        for (const auto &ic_key : keys[p].ic_keys)
+            AppendLegacyIcKey(ic_key, params.GetIcParameters().GetInputBitsize(), legacy);
+        if (legacy.size() != OQuantileKey::CalculateLegacySerializedSize(params))
+            throw osuCrypto::UnitTestFail("Legacy OQuantileKey size mismatch");
+
+        // The DCF keys cannot be rewritten, so the key is rejected rather than loaded as garbage
+        OQuantileKey restored(p, params);
+        try {
+            restored.Deserialize(legacy);
+            throw osuCrypto::UnitTestFail("Legacy OQuantileKey was accepted");
+        } catch (const std::invalid_argument &) {
+        }
+
+        // The current form still round-trips
+        std::vector<uint8_t> packed;
+        keys[p].Serialize(packed);
+        restored.Deserialize(packed);
+        if (restored != keys[p])
+            throw osuCrypto::UnitTestFail("OQuantileKey round trip differs");
+    }
+    Logger::DebugLog(LOC, "OQuantile_Key_Legacy_Test - Passed");
+}
+
 void OQuantile_Fsc_Offline_Test() {
     Logger::DebugLog(LOC, "OQuantile_Fsc_Offline_Test...");
     std::vector<OQuantileFscParameters> params_list = {
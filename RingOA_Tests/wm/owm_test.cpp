@@ -16,12 +16,14 @@
 #include "RingOA/wm/owm.h"
 #include "RingOA/wm/owm_fsc.h"
 #include "RingOA/wm/plain_wm.h"
+#include "RingOA_Tests/test_common.h"
 
 namespace {
 
 const std::string kCurrentPath = ringoa::GetCurrentDirectory();
 const std::string kTestOWMPath = kCurrentPath + "/data/test/wm/";
 const uint64_t    kFixedSeed   = 6;
+const uint64_t    kRankQueries = 4;
 
 std::string GenerateRandomString(size_t length, const std::string &charset = "ATGC") {
     if (charset.empty() || length == 0)
@@ -124,8 +126,29 @@ void OWM_Offline_Test() {
             sh_io.SaveShare(position_path + "_" + ToString(p), position_sh[p]);
         }
 
-        // Offline setup
-        gen.GetRingOaKeyGenerator().OfflineSetUp(params.GetSigma(), kTestOWMPath);
+        // Queries for OWM_Pipelined_Online_Test: a key, character and position per query
+        SaveBatchKeys(gen, kTestOWMPath + "owmbatchkey_d" + ToString(d), kRankQueries);
+        uint64_t              sigma = params.GetSigma();
+        std::vector<uint64_t> batch_query(kRankQueries * sigma), batch_position(kRankQueries);
+        std::string           bquery_path    = kTestOWMPath + "owmbatchquery_d" + ToString(d);
+        std::string           bposition_path = kTestOWMPath + "owmbatchposition_d" + ToString(d);
+        for (uint64_t k = 0; k < kRankQueries; ++k) {
+            for (uint64_t i = 0; i < sigma; ++i) {
+                batch_query[k * sigma + i] = rss.GenerateRandomValue() & 1;
+            }
+            batch_position[k] = rss.GenerateRandomValue();
+        }
+        Logger::DebugLog(LOC, "Batch query   : " + ToString(batch_query));
+        Logger::DebugLog(LOC, "Batch position: " + ToString(batch_position));
+        std::array<RepShareMat64, 3> batch_query_sh    = rss.ShareLocal(batch_query, kRankQueries, sigma);
+        std::array<RepShareVec64, 3> batch_position_sh = rss.ShareLocal(batch_position);
+        for (size_t p = 0; p < ringoa::sharing::kThreeParties; ++p) {
+            sh_io.SaveShare(bquery_path + "_" + ToString(p), batch_query_sh[p]);
+            sh_io.SaveShare(bposition_path + "_" + ToString(p), batch_position_sh[p]);
+        }
+
+        // Offline setup (OWM_Pipelined_Online_Test runs each query twice)
+        gen.GetRingOaKeyGenerator().OfflineSetUp(2 * kRankQueries * params.GetSigma(), kTestOWMPath);
         rss.OfflineSetUp(kTestOWMPath + "prf");
     }
     Logger::DebugLog(LOC, "OWM_Offline_Test - Passed");
@@ -222,6 +245,89 @@ void OWM_Online_Test(const osuCrypto::CLP &cmd) {
     Logger::DebugLog(LOC, "OWM_Online_Test - Passed");
 }
 
+void OWM_Pipelined_Online_Test(const osuCrypto::CLP &cmd) {
+    Logger::DebugLog(LOC, "OWM_Pipelined_Online_Test...");
+    std::vector<OWMParameters> params_list = {
+        OWMParameters(10),
+        // OWMParameters(15),
+        // OWMParameters(20),
+    };
+
+    for (const auto &params : params_list) {
+        params.PrintParameters();
+        uint64_t d  = params.GetDatabaseBitSize();
+        uint64_t nu = params.GetOaParameters().GetParameters().GetTerminateBitsize();
+
+        std::vector<uint64_t> result_scalar(kRankQueries), result_pipelined(kRankQueries);
+        std::string           key_path      = kTestOWMPath + "owmbatchkey_d" + ToString(d);
+        std::string           db_path       = kTestOWMPath + "db_d" + ToString(d);
+        std::string           query_path    = kTestOWMPath + "owmbatchquery_d" + ToString(d);
+        std::string           position_path = kTestOWMPath + "owmbatchposition_d" + ToString(d);
+
+        auto MakeTask = [&](int party_id) {
+            return [=, &result_scalar, &result_pipelined](osuCrypto::Channel &chl_next, osuCrypto::Channel &chl_prev) {
+                ReplicatedSharing3P rss(d);
+                AdditiveSharing2P   ass_prev(d), ass_next(d);
+                OWMEvaluator        eval(params, rss, ass_prev, ass_next);
+                Channels            chls(party_id, chl_prev, chl_next);
+
+                // Load this party's key, query and position for each query
+                std::vector<OWMKey> keys = LoadBatchKeys<OWMKey>(params, key_path, party_id, kRankQueries);
+
+                RepShareMat64 db_sh;
+                RepShareMat64 query_sh;
+                RepShareVec64 position_sh;
+                ShareIo       sh_io;
+                sh_io.LoadShare(db_path + "_" + ToString(party_id), db_sh);
+                sh_io.LoadShare(query_path + "_" + ToString(party_id), query_sh);
+                sh_io.LoadShare(position_path + "_" + ToString(party_id), position_sh);
+
+                eval.GetRingOaEvaluator().OnlineSetUp(party_id, kTestOWMPath);
+                rss.OnlineSetUp(party_id, kTestOWMPath + "prf");
+
+                // One query at a time
+                std::vector<ringoa::block> uv_prev(1U << nu), uv_next(1U << nu);
+                for (uint64_t k = 0; k < kRankQueries; ++k) {
+                    RepShare64 start_sh = position_sh.At(k), result_sh;
+                    eval.EvaluateRankCF(chls, keys[k], uv_prev, uv_next, db_sh, query_sh.RowView(k), start_sh, result_sh);
+                    rss.Open(chls, result_sh, result_scalar[k]);
+                }
+
+                // All queries pipelined
+                std::vector<const OWMKey *> key_ptrs(kRankQueries);
+                std::vector<RepShareView64> char_sh;
+                RepShareVec64               start_sh(kRankQueries), result_sh(kRankQueries);
+                for (uint64_t k = 0; k < kRankQueries; ++k) {
+                    key_ptrs[k] = &keys[k];
+                    char_sh.push_back(query_sh.RowView(k));
+                    start_sh.Set(k, position_sh.At(k));
+                }
+                eval.EvaluateRankCF_Pipelined(chls, key_ptrs, uv_prev, uv_next, db_sh, char_sh, start_sh, result_sh);
+                rss.Open(chls, result_sh, result_pipelined);
+            };
+        };
+
+        auto task_p0 = MakeTask(0);
+        auto task_p1 = MakeTask(1);
+        auto task_p2 = MakeTask(2);
+
+        ThreePartyNetworkManager net_mgr;
+        int                      party_id = cmd.isSet("party") ? cmd.get<int>("party") : -1;
+        net_mgr.AutoConfigure(party_id, task_p0, task_p1, task_p2);
+        net_mgr.WaitForCompletion();
+
+        Logger::DebugLog(LOC, "Scalar results   : " + ToString(result_scalar));
+        Logger::DebugLog(LOC, "Pipelined results: " + ToString(result_pipelined));
+        if (result_pipelined != result_scalar) {
+            throw osuCrypto::UnitTestFail(
+                "OWM_Pipelined_Online_Test failed: pipelined = " + ToString(result_pipelined) +
+                ", scalar = " + ToString(result_scalar));
+        }
+    }
+
+    Logger::DebugLog(LOC, "OWM_Pipelined_Online_Test - Passed");
+}
+
 void OWM_Fsc_Offline_Test() {
     Logger::DebugLog(LOC, "OWM_Fsc_Offline_Test...");
     std::vector<OWMFscParameters> params_list = {
@@ -7,6 +7,7 @@ namespace test_ringoa {
 
 void OWM_Offline_Test();
 void OWM_Online_Test(const osuCrypto::CLP &cmd);
+void OWM_Pipelined_Online_Test(const osuCrypto::CLP &cmd);
 void OWM_Fsc_Offline_Test();
 void OWM_Fsc_Online_Test(const osuCrypto::CLP &cmd);
 
@@ -1,22 +1,103 @@
 #include "wm_test.h"
 
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
 #include <cryptoTools/Common/TestCollection.h>
 
 #include "RingOA/utils/logger.h"
+#include "RingOA/utils/thread_pool.h"
 #include "RingOA/utils/timer.h"
 #include "RingOA/utils/to_string.h"
 #include "RingOA/utils/utils.h"
+#include "RingOA/wm/bwt_builder.h"
 #include "RingOA/wm/plain_wm.h"
 
+namespace {
+
+const std::string kCurrentPath = ringoa::GetCurrentDirectory();
+const std::string kTestWmPath  = kCurrentPath + "/data/test/wm/";
+
+}    // namespace
+
 namespace test_ringoa {
 
 using ringoa::Logger;
+using ringoa::ThreadPool;
 using ringoa::ToString;
+using ringoa::wm::BitVector;
 using ringoa::wm::BuildOrder;
+using ringoa::wm::BwtBuilder;
+using ringoa::wm::BwtBuildOptions;
 using ringoa::wm::CharType;
 using ringoa::wm::FMIndex;
+using ringoa::wm::OccTable;
+using ringoa::wm::PackedSymbols;
 using ringoa::wm::WaveletMatrix;
 
+void BitVector_RankSelect_Test() {
+    Logger::DebugLog(LOC, "BitVector_RankSelect_Test...");
+
+    std::mt19937_64 rng(7);
+    // Sizes around word and superblock boundaries; densities from sparse to all ones
+    for (size_t n : {1, 63, 64, 65, 511, 512, 513, 1024, 5000}) {
+        for (uint64_t density : {0, 3, 50, 97, 100}) {
+            std::vector<bool> bits(n);
+            BitVector         bv(n);
+            for (size_t i = 0; i < n; ++i) {
+                bits[i] = (rng() % 100) < density;
+                if (bits[i])
+                    bv.Set(i);
+            }
+            bv.Build();
+
+            const std::string tag = "n=" + ToString(n) + " density=" + ToString(density);
+            size_t            ones = 0;
+            for (size_t i = 0; i <= n; ++i) {
+                if (bv.Rank1(i) != ones || bv.Rank0(i) != i - ones)
+                    throw osuCrypto::UnitTestFail("Rank mismatch at i=" + ToString(i) + " (" + tag + ")");
+                if (i == n)
+                    break;
+                if (bv.Access(i) != bits[i])
+                    throw osuCrypto::UnitTestFail("Access mismatch at i=" + ToString(i) + " (" + tag + ")");
+                if (bits[i]) {
+                    if (bv.Select1(ones) != i)
+                        throw osuCrypto::UnitTestFail("Select1 mismatch at k=" + ToString(ones) + " (" + tag + ")");
+                    ++ones;
+                } else if (bv.Select0(i - ones) != i) {
+                    throw osuCrypto::UnitTestFail("Select0 mismatch at k=" + ToString(i - ones) + " (" + tag + ")");
+                }
+            }
+            if (bv.GetNumOnes() != ones || bv.GetNumZeros() != n - ones)
+                throw osuCrypto::UnitTestFail("Count mismatch (" + tag + ")");
+        }
+    }
+
+    // The exported rank0 tables match the prefix zero counts of every level
+    std::vector<uint64_t> data(3000);
+    for (auto &v : data)
+        v = rng() % 8;
+    WaveletMatrix         wm(data, 3, BuildOrder::LSBFirst);
+    std::vector<uint64_t> rank0_tables = wm.GetRank0Tables();
+    const size_t          stride       = data.size() + 1;
+    for (size_t bit = 0; bit < 3; ++bit) {
+        for (size_t i = 0; i <= data.size(); ++i) {
+            if (rank0_tables[bit * stride + i] != wm.GetLevel(bit).Rank0(i))
+                throw osuCrypto::UnitTestFail("Rank0 table mismatch at bit=" + ToString(bit) + " i=" + ToString(i));
+        }
+    }
+    // RankCF(c, p) == C[c] + rank_c(p)
+    for (uint64_t c = 0; c < 8; ++c) {
+        uint64_t smaller = std::count_if(data.begin(), data.end(), [c](uint64_t v) { return v < c; });
+        for (size_t p = 0; p <= data.size(); p += 97) {
+            uint64_t rank = std::count(data.begin(), data.begin() + p, c);
+            if (wm.RankCF(c, p) != smaller + rank)
+                throw osuCrypto::UnitTestFail("RankCF mismatch at c=" + ToString(c) + " p=" + ToString(p));
+        }
+    }
+}
+
 void WaveletMatrix_Access_Test() {
     Logger::DebugLog(LOC, "WaveletMatrix_Access_Test...");
 
@@ -236,4 +317,188 @@ void FMIndex_Test() {
     Logger::DebugLog(LOC, "FMIndex_Test - Passed");
 }
 
+void FMIndex_Build_Test() {
+    Logger::DebugLog(LOC, "FMIndex_Build_Test...");
+
+    std::mt19937_64 rng(11);
+    std::string     random_text(5000, 'A');
+    for (auto &c : random_text)
+        c = "ACGT"[rng() % 4];
+    std::string repeat_text;
+    for (size_t i = 0; i < 600; ++i)
+        repeat_text += "ACGTTA";
+    // Homopolymer runs far longer than the bucket sort's comparison depth
+    const std::string run_text = std::string(3000, 'A') + random_text.substr(0, 700) + std::string(2000, 'T') + "A";
+    const std::string query    = random_text.substr(1200, 24);
+
+    for (const std::string &text : {random_text, repeat_text, run_text, std::string("G")}) {
+        FMIndex ref(text, CharType::DNA);    // sdsl construction
+
+        // In memory: threads and memory caps must not change the BWT or the wavelet matrix
+        for (uint64_t num_threads : {1, 4}) {
+            for (uint64_t memory_limit : {0, 1024}) {
+                BwtBuildOptions options;
+                options.num_threads  = num_threads;
+                options.memory_limit = memory_limit;
+                FMIndex           fm(text, CharType::DNA, options);
+                const std::string tag = "n=" + ToString(text.size()) + " threads=" + ToString(num_threads) +
+                                        " memory_limit=" + ToString(memory_limit);
+                if (fm.GetBwt() != ref.GetBwt())
+                    throw osuCrypto::UnitTestFail("BWT mismatch (" + tag + ")");
+                if (fm.GetRank0Tables() != ref.GetRank0Tables())
+                    throw osuCrypto::UnitTestFail("Rank0 tables mismatch (" + tag + ")");
+                if (fm.ComputeLPMfromWM(query) != ref.ComputeLPMfromWM(query))
+                    throw osuCrypto::UnitTestFail("LPM mismatch (" + tag + ")");
+            }
+        }
+
+        // Disk-backed: BWT streamed to a file in several passes, then indexed from the file
+        BwtBuildOptions options;
+        options.num_threads  = 2;
+        options.memory_limit = 4096;
+        std::string reversed(text.rbegin(), text.rend());
+        BwtBuilder  builder(options);
+        builder.BuildToFile(reversed, kTestWmPath + "bwt_test");
+        Logger::DebugLog(LOC, "passes=" + ToString(builder.GetNumPasses()) + " peak_suffix_bytes=" + ToString(builder.GetPeakSuffixBytes()));
+        if (text.size() > 1000 && builder.GetNumPasses() < 2)
+            throw osuCrypto::UnitTestFail("Expected several passes under memory_limit");
+        FMIndex fm = FMIndex::FromBwt(BwtBuilder::LoadBwt(kTestWmPath + "bwt_test"), CharType::DNA, 2);
+        if (fm.GetBwt() != ref.GetBwt())
+            throw osuCrypto::UnitTestFail("BWT file mismatch (n=" + ToString(text.size()) + ")");
+        if (fm.ComputeLPMfromWM(query) != ref.ComputeLPMfromWM(query))
+            throw osuCrypto::UnitTestFail("LPM mismatch from BWT file (n=" + ToString(text.size()) + ")");
+    }
+
+    // Parallel level partition matches the serial build in both orders
+    std::vector<uint64_t> data(4099);
+    for (auto &v : data)
+        v = rng() % 8;
+    for (BuildOrder order : {BuildOrder::MSBFirst, BuildOrder::LSBFirst}) {
+        WaveletMatrix serial(data, 3, order);
+        WaveletMatrix parallel(data, 3, order, 3);
+        if (serial.GetRank0Tables() != parallel.GetRank0Tables())
+            throw osuCrypto::UnitTestFail("Parallel wavelet matrix build mismatch");
+    }
+}
+
+void FMIndex_OccTable_Test() {
+    Logger::DebugLog(LOC, "FMIndex_OccTable_Test...");
+
+    std::mt19937_64 rng(13);
+    std::string     text(3000, 'A');
+    for (auto &c : text)
+        c = "ACGT"[rng() % 4];
+    FMIndex            fm(text, CharType::DNA);
+    const std::string &bwt = fm.GetBwt();
+
+    // Occ against prefix counts at every position, for sample rates below, at and above 32
+    for (uint64_t sample_rate : {1, 7, 32, 100, 128, 4096}) {
+        OccTable occ(bwt, sample_rate);
+        for (char c : std::string("$ACGTN")) {
+            uint64_t count = 0;
+            for (uint64_t i = 0; i <= bwt.size(); ++i) {
+                if (occ.Occ(c, i) != count)
+                    throw osuCrypto::UnitTestFail("Occ mismatch (sample_rate=" + ToString(sample_rate) + ", c=" +
+                                                  std::string(1, c) + ", i=" + ToString(i) + ")");
+                if (i < bwt.size() && bwt[i] == c)
+                    count++;
+            }
+        }
+    }
+
+    // LPM against the wavelet matrix: substrings of the text (reversed), mutated and random reads
+    std::vector<std::string> queries;
+    for (size_t q = 0; q < 1000; ++q) {
+        std::string query;
+        if (q % 3 == 0) {
+            for (size_t i = 0; i < 40; ++i)
+                query += "ACGT"[rng() % 4];
+        } else {
+            uint64_t start = rng() % (text.size() - 40);
+            query          = text.substr(start, 40);
+            std::reverse(query.begin(), query.end());
+            if (q % 3 == 2) {
+                char &c = query[rng() % query.size()];
+                c       = (c == 'A') ? 'C' : 'A';
+            }
+        }
+        queries.push_back(query);
+    }
+    ThreadPool            pool(4);
+    std::vector<uint64_t> batch        = fm.ComputeLPMfromBWTBatch(queries);
+    std::vector<uint64_t> batch_pooled = fm.ComputeLPMfromBWTBatch(queries, pool);
+    for (size_t q = 0; q < queries.size(); ++q) {
+        uint64_t expected = fm.ComputeLPMfromWM(queries[q]);
+        if (fm.ComputeLPMfromBWT(queries[q]) != expected || batch[q] != expected || batch_pooled[q] != expected)
+            throw osuCrypto::UnitTestFail("LPM mismatch for query " + ToString(q) + ": WM = " + ToString(expected) +
+                                          ", BWT = " + ToString(fm.ComputeLPMfromBWT(queries[q])) + ", batch = " + ToString(batch[q]) +
+                                          ", pooled batch = " + ToString(batch_pooled[q]));
+    }
+
+    Logger::DebugLog(LOC, "FMIndex_OccTable_Test - Passed");
+}
+
+void WaveletMatrix_Packed_Test() {
+    Logger::DebugLog(LOC, "WaveletMatrix_Packed_Test...");
+
+    std::mt19937_64 rng(19);
+    std::string     text(5003, 'A');
+    for (auto &c : text)
+        c = "ACGT"[rng() % 4];
+
+    // Encoding round trip at 2 (bare ACGT), 3 (DNA) and 5 (protein) bits, serial and threaded
+    const ringoa::wm::CharMapper dna(CharType::DNA), protein(CharType::PROTEIN);
+    const std::string            protein_text = "ARNDCQILVVFPYWMHKGEST" + text.substr(0, 1000);
+    struct Case {
+        const std::string            &text;
+        const ringoa::wm::SymbolTable table;
+        uint64_t                      bits;
+    };
+    for (const Case &tc : {Case{text, ringoa::wm::MakeSymbolTable("ACGT"), 2}, Case{text, dna.GetSymbolTable(), 3},
+                           Case{protein_text, protein.GetSymbolTable(), 5}}) {
+        for (uint64_t num_threads : {1, 3}) {
+            PackedSymbols packed = ringoa::wm::EncodeSymbols(tc.text, tc.table, tc.bits, num_threads);
+            if (packed.Size() != tc.text.size() || packed.GetMemoryBytes() != (tc.text.size() + 64 / tc.bits - 1) / (64 / tc.bits) * 8)
+                throw osuCrypto::UnitTestFail("Packed size mismatch (bits=" + ToString(tc.bits) + ")");
+            PackedSymbols::Reader reader(packed, 0);
+            for (size_t i = 0; i < tc.text.size(); ++i) {
+                const uint64_t id = tc.table[static_cast<unsigned char>(tc.text[i])];
+                if (packed.Get(i) != id || reader.Next() != id)
+                    throw osuCrypto::UnitTestFail("Packed symbol mismatch at " + ToString(i) + " (bits=" + ToString(tc.bits) + ")");
+            }
+        }
+    }
+    bool thrown = false;
+    try {
+        dna.ToPacked(text.substr(0, 100) + "x" + text.substr(0, 100), 2);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    if (!thrown)
+        throw osuCrypto::UnitTestFail("Encoding a character outside the alphabet should throw");
+
+    // Wavelet matrices from strings, ID vectors and packed symbols (including 2-bit input
+    // under a 3-level matrix) agree
+    std::vector<uint64_t> ids = dna.ToIds(text);
+    for (BuildOrder order : {BuildOrder::MSBFirst, BuildOrder::LSBFirst}) {
+        WaveletMatrix ref(ids, 3, order);
+        for (uint64_t num_threads : {1, 4}) {
+            WaveletMatrix from_text(text, CharType::DNA, order, num_threads);
+            WaveletMatrix from_packed(dna.ToPacked(text, num_threads), CharType::DNA, order, num_threads);
+            if (from_text.GetRank0Tables() != ref.GetRank0Tables() || from_packed.GetRank0Tables() != ref.GetRank0Tables())
+                throw osuCrypto::UnitTestFail("Packed wavelet matrix mismatch (threads=" + ToString(num_threads) + ")");
+            if (from_packed.GetData() != ids)
+                throw osuCrypto::UnitTestFail("Packed wavelet matrix data mismatch");
+        }
+        WaveletMatrix         two_bit(ringoa::wm::EncodeSymbols(text, ringoa::wm::MakeSymbolTable("ACGT"), 2), 3, order, 2);
+        std::vector<uint64_t> expected(text.size());
+        for (size_t i = 0; i < text.size(); ++i)
+            expected[i] = std::string("ACGT").find(text[i]);
+        if (two_bit.GetRank0Tables() != WaveletMatrix(expected, 3, order).GetRank0Tables())
+            throw osuCrypto::UnitTestFail("2-bit packed wavelet matrix mismatch");
+    }
+
+    Logger::DebugLog(LOC, "WaveletMatrix_Packed_Test - Passed");
+}
+
 }    // namespace test_ringoa
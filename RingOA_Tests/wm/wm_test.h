@@ -3,12 +3,16 @@
 
 namespace test_ringoa {
 
+void BitVector_RankSelect_Test();
 void WaveletMatrix_Access_Test();
 void WaveletMatrix_Quantile_Test();
 void WaveletMatrix_RangeFreqTest();
 void WaveletMatrix_TopK_Test();
 void WaveletMatrix_RankCF_Test();
+void WaveletMatrix_Packed_Test();
 void FMIndex_Test();
+void FMIndex_Build_Test();
+void FMIndex_OccTable_Test();
 
 }    // namespace test_ringoa
 